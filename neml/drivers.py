@@ -8,6 +8,7 @@ from numpy.polynomial.legendre import leggauss
 import numpy.random as ra
 
 from neml.nlsolvers import MaximumIterations, MaximumSubdivisions, newton, scalar_newton
+from neml.sensitivity import SensitivityModel
 
 class Driver(object):
   """
@@ -175,6 +176,8 @@ class Driver_sd(Driver):
         e_np1:       next strain
         t_np1:       next time
         T_np1:       next temperature
+
+      Returns the algorithmic tangent of the step
     """
     enext = self.update_thermal_strain(T_np1)
     s_np1, h_np1, A_np1, u_np1, p_np1 = self.model.update_sd(e_np1 - enext, 
@@ -192,6 +195,8 @@ class Driver_sd(Driver):
     self.u_int.append(u_np1)
     self.p_int.append(p_np1)
 
+    return A_np1
+
   def stress_step(self, s_np1, t_np1, T_np1):
     """
       Take a stress-controlled step
@@ -357,6 +362,199 @@ class Driver_sd(Driver):
 
     self.strain_step(e_np1, t_np1, T_np1)
 
+class SensitivityDriver_sd(Driver_sd):
+  """
+    Small strain driver that carries the sensitivities of the response to
+    the parameters of a SensitivityModel along with the state.
+
+    Strain controlled steps take the strain sensitivities as given, zero
+    by default.  Stress and mixed control steps find the strain
+    sensitivities that keep the controlled quantities fixed from the
+    tangent of the converged step.  So the whole history is one pass,
+    with one sensitivity solve per parameter for a strain controlled step
+    and two for the others (see SensitivityModel).  The thermal strains
+    are taken to not depend on the parameters.
+  """
+  def __init__(self, sens, *args, **kwargs):
+    """
+      Parameters:
+        sens:        SensitivityModel with the model and parameters
+
+      Other parameters are passed on to Driver_sd
+    """
+    super(SensitivityDriver_sd, self).__init__(sens.model, *args, **kwargs)
+    self.sens = sens
+    self.resolve = None
+
+    n = sens.nsens
+    h0, dh0 = sens.init_store()
+    self.dstrain_int = [np.zeros((n,6))]
+    self.dstress_int = [np.zeros((n,6))]
+    self.dstored_int = [dh0]
+    self.du_int = [np.zeros((n,))]
+    self.dp_int = [np.zeros((n,))]
+
+  @property
+  def dstrain(self):
+    return np.array(self.dstrain_int)
+
+  @property
+  def dstress(self):
+    return np.array(self.dstress_int)
+
+  @property
+  def dstored(self):
+    return np.array(self.dstored_int)
+
+  @property
+  def du(self):
+    return np.array(self.du_int)
+
+  @property
+  def dp(self):
+    return np.array(self.dp_int)
+
+  def _sensitivity(self, k, de_np1):
+    """
+      Sensitivity of the last step to parameter k, for a strain
+      sensitivity de_np1
+    """
+    return self.sens.sensitivity_sd(k, self.mechanical_strain_int[-1],
+        self.mechanical_strain_int[-2], self.T_int[-1], self.T_int[-2],
+        self.t_int[-1], self.t_int[-2], self.stress_int[-1],
+        self.stress_int[-2], self.stored_int[-1], self.stored_int[-2],
+        self.u_int[-1], self.u_int[-2], self.p_int[-1], self.p_int[-2],
+        de_np1, self.dstrain_int[-1][k], self.dstress_int[-1][k],
+        self.dstored_int[-1][k], self.du_int[-1][k], self.dp_int[-1][k])
+
+  def strain_step(self, e_np1, t_np1, T_np1, de_np1 = None):
+    """
+      Take a strain-controlled step
+
+      Parameters:
+        e_np1:       next strain
+        t_np1:       next time
+        T_np1:       next temperature
+
+      Keyword Args:
+        de_np1:      sensitivities of the next strain, nsens x 6
+
+      Returns the algorithmic tangent of the step
+    """
+    A = super(SensitivityDriver_sd, self).strain_step(e_np1, t_np1, T_np1)
+
+    n = self.sens.nsens
+    if de_np1 is None:
+      de_np1 = np.zeros((n,6))
+    de_np1 = np.array(de_np1, dtype = float)
+
+    if self.resolve is not None:
+      for k in range(n):
+        ds0, dh0, du0, dp0 = self._sensitivity(k, self.dstrain_int[-1][k])
+        de_np1[k] = self.dstrain_int[-1][k] + self.resolve(k, ds0, A)
+
+    ds = np.zeros((n,6))
+    dh = np.zeros((n,self.sens.nstore))
+    du = np.zeros((n,))
+    dp = np.zeros((n,))
+    for k in range(n):
+      ds[k], dh[k], du[k], dp[k] = self._sensitivity(k, de_np1[k])
+
+    self.dstrain_int.append(de_np1)
+    self.dstress_int.append(ds)
+    self.dstored_int.append(dh)
+    self.du_int.append(du)
+    self.dp_int.append(dp)
+
+    return A
+
+  def _mixed(self, resolve, step, *args, **kwargs):
+    """
+      Take a step with the strain sensitivities found by resolve from the
+      stress sensitivity at fixed strain and the tangent
+    """
+    self.resolve = resolve
+    try:
+      return step(*args, **kwargs)
+    finally:
+      self.resolve = None
+
+  def stress_step(self, s_np1, t_np1, T_np1):
+    """
+      Take a stress-controlled step
+
+      Parameters:
+        s_np1:       next stress
+        t_np1:       next time
+        T_np1:       next temperature
+    """
+    def resolve(k, ds0, A):
+      # The stress does not depend on the parameters
+      return la.solve(A, -ds0)
+
+    return self._mixed(resolve, super(SensitivityDriver_sd, self).stress_step,
+        s_np1, t_np1, T_np1)
+
+  def erate_step(self, sdir, erate, t_np1, T_np1, **kwargs):
+    """
+      Drive in a given stress direction at a prescribed strain rate
+
+      Parameters:
+        sdir:        stress direction
+        erate:       strain rate (in the direction)
+        t_np1:       next time
+        T_np1:       next temperature
+
+      Other keyword arguments are passed on to Driver_sd.erate_step
+    """
+    ndir = sdir / la.norm(sdir)
+    dt = t_np1 - self.t_int[-1]
+
+    def resolve(k, ds0, A):
+      # Same jacobian as the step, for the stress amplitude and strain
+      J = np.zeros((7,7))
+      J[:6,0] = -ndir
+      J[:6,1:] = A
+      J[6,1:] = ndir / dt
+      R = np.zeros((7,))
+      R[:6] = ds0 - self.dstress_int[-1][k]
+      return la.solve(J, -R)[1:]
+
+    return self._mixed(resolve, super(SensitivityDriver_sd, self).erate_step,
+        sdir, erate, t_np1, T_np1, **kwargs)
+
+  def strain_hold_step(self, i, t_np1, T_np1, q = 1.0, E = -1.0):
+    """
+      A special, mixed step which holds the strain in index i constant
+      while holding the stress in the other directions to their previous
+      values
+
+      Parameters:
+        i:           index to hold
+        t_np1:       next time
+        T_np1:       next temperature
+        q:           follow up factor
+        E:           Young's modulus to use
+    """
+    oset = sorted(list(set(range(6)) - set([i])))
+
+    def resolve(k, ds0, A):
+      # Same constraints as the step, with E taken to not depend on the
+      # parameters
+      ds_n = self.dstress_int[-1][k]
+      R = np.zeros((6,))
+      J = np.zeros((6,6))
+      R[0] = (ds0[i] - ds_n[i]) / E * (q - 1)
+      R[1:] = ds0[oset] - ds_n[oset]
+      J[0,i] = 1.0
+      J[0,:] += A[i,:] / E * (q - 1)
+      J[1:,:] = A[oset,:]
+      return la.solve(J, -R)
+
+    return self._mixed(resolve,
+        super(SensitivityDriver_sd, self).strain_hold_step, i, t_np1, T_np1,
+        q = q, E = E)
+
 def uniaxial_test(model, erate, T = 300.0, emax = 0.05, nsteps = 250, 
     sdir = np.array([1,0,0,0,0,0]), verbose = False,
     offset = 0.2/100.0, history = None, tdir = np.array([0,1,0,0,0,0])):
@@ -392,10 +590,15 @@ def uniaxial_test(model, erate, T = 300.0, emax = 0.05, nsteps = 250,
       youngs            young's modulus of initial curve
       yield             yield stress implied by curve
       poissons          poisson's ratio implied by non-axial strains
+      dstress           sensitivities of the stress to the parameters,
+                        if model is a SensitivityModel
       ================= ============================================
   """
   e_inc = emax / nsteps
-  driver = Driver_sd(model, verbose = verbose, T_init = T)
+  if isinstance(model, SensitivityModel):
+    driver = SensitivityDriver_sd(model, verbose = verbose, T_init = T)
+  else:
+    driver = Driver_sd(model, verbose = verbose, T_init = T)
   if history is not None:
     driver.stored_int[0] = history
 
@@ -425,10 +628,14 @@ def uniaxial_test(model, erate, T = 300.0, emax = 0.05, nsteps = 250,
   except Exception:
     sY = np.inf
 
-  return {'strain': strain, 'stress': stress, 
+  res = {'strain': strain, 'stress': stress, 
       'energy_density': np.copy(driver.u),
       'plastic_work': np.copy(driver.p),
       'youngs': E, 'yield': sY, 'poissons': nu}
+  if isinstance(model, SensitivityModel):
+    res['dstress'] = np.dot(driver.dstress, sdir)
+
+  return res
 
 def strain_cyclic(model, emax, R, erate, ncycles, T = 300.0, nsteps = 50,
     sdir = np.array([1,0,0,0,0,0]), hold_time = None, n_hold = 25,
@@ -0,0 +1,403 @@
+#include "capture.h"
+
+#include "nemlerror.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+namespace neml {
+
+// Every log starts with this
+static const char capture_magic[8] = {'N','E','M','L','C','A','P','1'};
+
+// The running capture
+struct CaptureState {
+  CaptureState() : active(false), fraction(1.0), seed(0) {}
+
+  std::mutex lock;
+  std::atomic<bool> active;
+  std::ofstream out;
+  double fraction;
+  uint64_t seed;
+  // Keyed by model id, as a new model can take the address of an old one
+  std::map<size_t, CaptureModel> names;
+  std::map<size_t, int> ids;   // Models already in the log
+};
+
+static CaptureState & capture_state()
+{
+  static CaptureState state;
+  return state;
+}
+
+// Sample the calls with a hash of their inputs, so the choice does not
+// depend on the order the threads make the calls in
+static bool sampled(const CaptureState & state, const CaptureRecord & rec)
+{
+  if (state.fraction >= 1.0) return true;
+
+  // FNV-1a on the raw bytes of the inputs
+  uint64_t h = 14695981039346656037ULL;
+  auto mix = [&h](const double * v, size_t n) {
+    const unsigned char * bytes = reinterpret_cast<const unsigned char*>(v);
+    for (size_t i=0; i<n*sizeof(double); i++) {
+      h = (h ^ bytes[i]) * 1099511628211ULL;
+    }
+  };
+  mix(&rec.T_np1, 1);
+  mix(&rec.T_n, 1);
+  mix(&rec.t_np1, 1);
+  mix(&rec.t_n, 1);
+  mix(rec.e_np1, 6);
+  mix(rec.e_n, 6);
+  mix(rec.w_np1, 3);
+  mix(rec.w_n, 3);
+  mix(rec.s_n, 6);
+  mix(rec.h_n.data(), rec.h_n.size());
+
+  // Then a splitmix finalizer with the seed
+  uint64_t z = state.seed + 0x9E3779B97F4A7C15ULL * h;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z = z ^ (z >> 31);
+  return (double) (z >> 11) / 9007199254740992.0 < state.fraction;
+}
+
+template <class T>
+static void put(std::vector<char> & buf, const T & v)
+{
+  const char * p = reinterpret_cast<const char *>(&v);
+  buf.insert(buf.end(), p, p + sizeof(T));
+}
+
+static void put(std::vector<char> & buf, const double * v, size_t n)
+{
+  const char * p = reinterpret_cast<const char *>(v);
+  buf.insert(buf.end(), p, p + n * sizeof(double));
+}
+
+static void put(std::vector<char> & buf, const std::string & s)
+{
+  put(buf, (uint32_t) s.size());
+  buf.insert(buf.end(), s.begin(), s.end());
+}
+
+CaptureRecord::CaptureRecord() :
+    kind(CAPTURE_SD), id(-1), ier(SUCCESS), T_np1(0), T_n(0), t_np1(0),
+    t_n(0), u_n(0), p_n(0)
+{
+  std::fill(e_np1, e_np1+6, 0.0);
+  std::fill(e_n, e_n+6, 0.0);
+  std::fill(w_np1, w_np1+3, 0.0);
+  std::fill(w_n, w_n+3, 0.0);
+  std::fill(s_n, s_n+6, 0.0);
+  std::fill(s_np1, s_np1+6, 0.0);
+}
+
+void start_capture(const std::string & fname, double fraction,
+                   unsigned int seed)
+{
+  CaptureState & state = capture_state();
+  std::lock_guard<std::mutex> guard(state.lock);
+
+  state.active = false;
+  if (state.out.is_open()) state.out.close();
+  state.out.open(fname, std::ios::binary | std::ios::trunc);
+  if (!state.out.good()) {
+    throw std::runtime_error("Cannot open capture file " + fname);
+  }
+  state.out.write(capture_magic, sizeof(capture_magic));
+  state.fraction = fraction;
+  state.seed = seed;
+  state.ids.clear();
+  state.active = true;
+}
+
+void stop_capture()
+{
+  CaptureState & state = capture_state();
+  std::lock_guard<std::mutex> guard(state.lock);
+
+  state.active = false;
+  if (state.out.is_open()) state.out.close();
+  state.ids.clear();
+}
+
+bool capturing()
+{
+  return capture_state().active;
+}
+
+void capture_from_environment()
+{
+  static std::once_flag once;
+  std::call_once(once, []() {
+    const char * fname = std::getenv("NEML_CAPTURE_FILE");
+    if ((fname == nullptr) || (std::strlen(fname) == 0)) return;
+    const char * fraction = std::getenv("NEML_CAPTURE_FRACTION");
+    start_capture(fname, (fraction == nullptr) ? 1.0 : std::atof(fraction));
+  });
+}
+
+void capture_model(const NEMLModel * model, const std::string & fname,
+                   const std::string & mname)
+{
+  CaptureState & state = capture_state();
+  std::lock_guard<std::mutex> guard(state.lock);
+
+  state.names[model->model_id()] = {fname, mname};
+}
+
+void capture_forget_model(const NEMLModel * model)
+{
+  CaptureState & state = capture_state();
+  std::lock_guard<std::mutex> guard(state.lock);
+
+  state.names.erase(model->model_id());
+}
+
+void capture_sd_inputs(CaptureRecord & rec, const NEMLModel & model,
+                       const double * const e_np1, const double * const e_n,
+                       double T_np1, double T_n,
+                       double t_np1, double t_n,
+                       const double * const s_n, const double * const h_n,
+                       double u_n, double p_n)
+{
+  rec.kind = CAPTURE_SD;
+  std::copy(e_np1, e_np1+6, rec.e_np1);
+  std::copy(e_n, e_n+6, rec.e_n);
+  rec.T_np1 = T_np1;
+  rec.T_n = T_n;
+  rec.t_np1 = t_np1;
+  rec.t_n = t_n;
+  std::copy(s_n, s_n+6, rec.s_n);
+  rec.h_n.assign(h_n, h_n + model.nstore());
+  rec.u_n = u_n;
+  rec.p_n = p_n;
+}
+
+void capture_ld_inputs(CaptureRecord & rec, const NEMLModel & model,
+                       const double * const d_np1, const double * const d_n,
+                       const double * const w_np1, const double * const w_n,
+                       double T_np1, double T_n,
+                       double t_np1, double t_n,
+                       const double * const s_n, const double * const h_n,
+                       double u_n, double p_n)
+{
+  capture_sd_inputs(rec, model, d_np1, d_n, T_np1, T_n, t_np1, t_n, s_n, h_n,
+                    u_n, p_n);
+  rec.kind = CAPTURE_LD;
+  std::copy(w_np1, w_np1+3, rec.w_np1);
+  std::copy(w_n, w_n+3, rec.w_n);
+}
+
+void capture_result(const NEMLModel & model, CaptureRecord & rec, int ier,
+                    const double * const s_np1)
+{
+  CaptureState & state = capture_state();
+  if (!state.active) return;
+  if ((ier == SUCCESS) && !sampled(state, rec)) return;
+
+  rec.ier = ier;
+  if (s_np1 != nullptr) std::copy(s_np1, s_np1+6, rec.s_np1);
+  else std::fill(rec.s_np1, rec.s_np1+6, 0.0);
+
+  std::lock_guard<std::mutex> guard(state.lock);
+  if (!state.active) return;
+
+  std::vector<char> buf;
+  auto it = state.ids.find(model.model_id());
+  if (it == state.ids.end()) {
+    int id = (int) state.ids.size();
+    it = state.ids.emplace(model.model_id(), id).first;
+    auto name = state.names.find(model.model_id());
+    put(buf, CAPTURE_MODEL);
+    put(buf, (int32_t) id);
+    put(buf, (name == state.names.end()) ? std::string() : name->second.fname);
+    put(buf, (name == state.names.end()) ? std::string() : name->second.mname);
+  }
+  rec.id = it->second;
+
+  put(buf, rec.kind);
+  put(buf, (int32_t) rec.id);
+  put(buf, (int32_t) rec.ier);
+  put(buf, (uint32_t) rec.h_n.size());
+  put(buf, &rec.T_np1, 1);
+  put(buf, &rec.T_n, 1);
+  put(buf, &rec.t_np1, 1);
+  put(buf, &rec.t_n, 1);
+  put(buf, &rec.u_n, 1);
+  put(buf, &rec.p_n, 1);
+  put(buf, rec.e_np1, 6);
+  put(buf, rec.e_n, 6);
+  if (rec.kind == CAPTURE_LD) {
+    put(buf, rec.w_np1, 3);
+    put(buf, rec.w_n, 3);
+  }
+  put(buf, rec.s_n, 6);
+  put(buf, rec.s_np1, 6);
+  put(buf, rec.h_n.data(), rec.h_n.size());
+
+  state.out.write(buf.data(), buf.size());
+  // Make sure the failures survive if the calling program dies
+  if (ier != SUCCESS) state.out.flush();
+}
+
+int captured_update_sd(
+    NEMLModel & model,
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1,
+    double & u_np1, double u_n,
+    double & p_np1, double p_n)
+{
+  if (!capturing()) {
+    return model.update_sd(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1, s_n,
+                           h_np1, h_n, A_np1, u_np1, u_n, p_np1, p_n);
+  }
+
+  // The outputs may overwrite the inputs
+  CaptureRecord rec;
+  capture_sd_inputs(rec, model, e_np1, e_n, T_np1, T_n, t_np1, t_n, s_n, h_n,
+                    u_n, p_n);
+  int ier;
+  try {
+    ier = model.update_sd(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1, s_n,
+                          h_np1, h_n, A_np1, u_np1, u_n, p_np1, p_n);
+  }
+  catch (...) {
+    capture_result(model, rec, UNKNOWN_ERROR, nullptr);
+    throw;
+  }
+  capture_result(model, rec, ier, s_np1);
+
+  return ier;
+}
+
+int captured_update_ld_inc(
+    NEMLModel & model,
+    const double * const d_np1, const double * const d_n,
+    const double * const w_np1, const double * const w_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1, double * const B_np1,
+    double & u_np1, double u_n,
+    double & p_np1, double p_n)
+{
+  if (!capturing()) {
+    return model.update_ld_inc(d_np1, d_n, w_np1, w_n, T_np1, T_n, t_np1,
+                               t_n, s_np1, s_n, h_np1, h_n, A_np1, B_np1,
+                               u_np1, u_n, p_np1, p_n);
+  }
+
+  CaptureRecord rec;
+  capture_ld_inputs(rec, model, d_np1, d_n, w_np1, w_n, T_np1, T_n, t_np1,
+                    t_n, s_n, h_n, u_n, p_n);
+  int ier;
+  try {
+    ier = model.update_ld_inc(d_np1, d_n, w_np1, w_n, T_np1, T_n, t_np1,
+                              t_n, s_np1, s_n, h_np1, h_n, A_np1, B_np1,
+                              u_np1, u_n, p_np1, p_n);
+  }
+  catch (...) {
+    capture_result(model, rec, UNKNOWN_ERROR, nullptr);
+    throw;
+  }
+  capture_result(model, rec, ier, s_np1);
+
+  return ier;
+}
+
+template <class T>
+static void get(std::ifstream & in, T & v)
+{
+  in.read(reinterpret_cast<char *>(&v), sizeof(T));
+  if (!in.good()) throw std::runtime_error("Truncated capture file");
+}
+
+static void get(std::ifstream & in, double * v, size_t n)
+{
+  in.read(reinterpret_cast<char *>(v), n * sizeof(double));
+  if (!in.good()) throw std::runtime_error("Truncated capture file");
+}
+
+static void get(std::ifstream & in, std::string & s)
+{
+  uint32_t n;
+  get(in, n);
+  s.resize(n);
+  in.read(&s[0], n);
+  if (!in.good()) throw std::runtime_error("Truncated capture file");
+}
+
+void read_capture(const std::string & fname,
+                  std::map<int, CaptureModel> & models,
+                  std::vector<CaptureRecord> & records)
+{
+  std::ifstream in(fname, std::ios::binary);
+  if (!in.good()) {
+    throw std::runtime_error("Cannot open capture file " + fname);
+  }
+
+  char magic[sizeof(capture_magic)];
+  in.read(magic, sizeof(magic));
+  if (!in.good() || !std::equal(magic, magic+sizeof(magic), capture_magic)) {
+    throw std::runtime_error(fname + " is not a capture file");
+  }
+
+  char kind;
+  while (in.read(&kind, 1)) {
+    if (kind == CAPTURE_MODEL) {
+      int32_t id;
+      CaptureModel model;
+      get(in, id);
+      get(in, model.fname);
+      get(in, model.mname);
+      models[id] = model;
+    }
+    else if ((kind == CAPTURE_SD) || (kind == CAPTURE_LD)) {
+      CaptureRecord rec;
+      int32_t id, ier;
+      uint32_t nstore;
+      rec.kind = kind;
+      get(in, id);
+      get(in, ier);
+      get(in, nstore);
+      rec.id = id;
+      rec.ier = ier;
+      get(in, &rec.T_np1, 1);
+      get(in, &rec.T_n, 1);
+      get(in, &rec.t_np1, 1);
+      get(in, &rec.t_n, 1);
+      get(in, &rec.u_n, 1);
+      get(in, &rec.p_n, 1);
+      get(in, rec.e_np1, 6);
+      get(in, rec.e_n, 6);
+      if (kind == CAPTURE_LD) {
+        get(in, rec.w_np1, 3);
+        get(in, rec.w_n, 3);
+      }
+      get(in, rec.s_n, 6);
+      get(in, rec.s_np1, 6);
+      rec.h_n.resize(nstore);
+      get(in, rec.h_n.data(), nstore);
+      records.push_back(rec);
+    }
+    else {
+      throw std::runtime_error("Unknown record in capture file " + fname);
+    }
+  }
+}
+
+} // namespace neml
@@ -0,0 +1,114 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include "models.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace neml {
+
+/// Kinds of records in a capture log
+const char CAPTURE_MODEL = 'M';
+const char CAPTURE_SD = 'S';
+const char CAPTURE_LD = 'L';
+
+/// A model named in a capture log by the XML file and model name
+struct CaptureModel {
+  std::string fname;
+  std::string mname;
+};
+
+/// One captured update, with the inputs needed to run it again
+//  Large strain updates keep the deformation rates in e_np1 and e_n and the
+//  vorticities in w_np1 and w_n.
+struct CaptureRecord {
+  CaptureRecord();
+
+  char kind;
+  int id;                 // Model id in the log
+  int ier;                // Error code the update returned
+  double T_np1, T_n, t_np1, t_n, u_n, p_n;
+  double e_np1[6], e_n[6];
+  double w_np1[3], w_n[3];
+  double s_n[6];
+  double s_np1[6];        // Stress from the update
+  std::vector<double> h_n;
+};
+
+/// Start capturing the updates made through the C interface and the
+/// captured_update functions to a binary log
+//  A fraction of the successful updates are sampled, picked by a hash of
+//  their inputs and the seed so the same calls are captured each run
+//  whatever the threads do, and every failure is captured.
+//  Throws std::runtime_error if the file cannot be opened.
+void start_capture(const std::string & fname, double fraction = 1.0,
+                   unsigned int seed = 0);
+/// Stop capturing and close the log
+void stop_capture();
+/// Is a capture running?
+bool capturing();
+/// Start a capture to NEML_CAPTURE_FILE if it is set, sampling the fraction
+/// NEML_CAPTURE_FRACTION of the updates (default all)
+void capture_from_environment();
+
+/// Name a model in the log by the XML file and model name that define it
+//  Models that are not named are still captured, with empty names.
+void capture_model(const NEMLModel * model, const std::string & fname,
+                   const std::string & mname);
+/// Drop the name of a model that is about to be destroyed
+void capture_forget_model(const NEMLModel * model);
+
+/// Keep the inputs to a small strain update
+void capture_sd_inputs(CaptureRecord & rec, const NEMLModel & model,
+                       const double * const e_np1, const double * const e_n,
+                       double T_np1, double T_n,
+                       double t_np1, double t_n,
+                       const double * const s_n, const double * const h_n,
+                       double u_n, double p_n);
+/// Keep the inputs to a large strain incremental update
+void capture_ld_inputs(CaptureRecord & rec, const NEMLModel & model,
+                       const double * const d_np1, const double * const d_n,
+                       const double * const w_np1, const double * const w_n,
+                       double T_np1, double T_n,
+                       double t_np1, double t_n,
+                       const double * const s_n, const double * const h_n,
+                       double u_n, double p_n);
+/// Log an update once its result is known, if it is sampled or failed
+void capture_result(const NEMLModel & model, CaptureRecord & rec, int ier,
+                    const double * const s_np1);
+
+/// Small strain update, captured if a capture is running
+int captured_update_sd(
+    NEMLModel & model,
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1,
+    double & u_np1, double u_n,
+    double & p_np1, double p_n);
+
+/// Large strain incremental update, captured if a capture is running
+int captured_update_ld_inc(
+    NEMLModel & model,
+    const double * const d_np1, const double * const d_n,
+    const double * const w_np1, const double * const w_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1, double * const B_np1,
+    double & u_np1, double u_n,
+    double & p_np1, double p_n);
+
+/// Read a whole capture log, throwing std::runtime_error if it is not one
+void read_capture(const std::string & fname,
+                  std::map<int, CaptureModel> & models,
+                  std::vector<CaptureRecord> & records);
+
+} // namespace neml
+
+#endif // CAPTURE_H
@@ -0,0 +1,130 @@
+#include "pyhelp.h" // include first to avoid annoying redef warning
+
+#include "capture.h"
+
+#include "nemlerror.h"
+
+namespace py = pybind11;
+
+PYBIND11_DECLARE_HOLDER_TYPE(T, std::shared_ptr<T>)
+
+namespace neml {
+
+PYBIND11_MODULE(capture, m) {
+  py::module::import("neml.objects");
+  py::module::import("neml.models");
+
+  m.doc() = "Capture material point updates to a log for replay.";
+
+  py::class_<CaptureModel>(m, "CaptureModel")
+      .def_readonly("fname", &CaptureModel::fname)
+      .def_readonly("mname", &CaptureModel::mname)
+      ;
+
+  py::class_<CaptureRecord>(m, "CaptureRecord")
+      .def_property_readonly("large",
+                             [](const CaptureRecord & r) -> bool
+                             {
+                              return r.kind == CAPTURE_LD;
+                             }, "Large strain incremental update?")
+      .def_readonly("id", &CaptureRecord::id)
+      .def_readonly("ier", &CaptureRecord::ier)
+      .def_readonly("T_np1", &CaptureRecord::T_np1)
+      .def_readonly("T_n", &CaptureRecord::T_n)
+      .def_readonly("t_np1", &CaptureRecord::t_np1)
+      .def_readonly("t_n", &CaptureRecord::t_n)
+      .def_readonly("u_n", &CaptureRecord::u_n)
+      .def_readonly("p_n", &CaptureRecord::p_n)
+      .def_property_readonly("e_np1",
+                             [](const CaptureRecord & r) -> py::array_t<double>
+                             {
+                              auto v = alloc_vec<double>(6);
+                              std::copy(r.e_np1, r.e_np1+6, arr2ptr<double>(v));
+                              return v;
+                             }, "Strain or deformation rate at the next step.")
+      .def_property_readonly("e_n",
+                             [](const CaptureRecord & r) -> py::array_t<double>
+                             {
+                              auto v = alloc_vec<double>(6);
+                              std::copy(r.e_n, r.e_n+6, arr2ptr<double>(v));
+                              return v;
+                             }, "Strain or deformation rate at the last step.")
+      .def_property_readonly("s_n",
+                             [](const CaptureRecord & r) -> py::array_t<double>
+                             {
+                              auto v = alloc_vec<double>(6);
+                              std::copy(r.s_n, r.s_n+6, arr2ptr<double>(v));
+                              return v;
+                             }, "Stress at the last step.")
+      .def_property_readonly("s_np1",
+                             [](const CaptureRecord & r) -> py::array_t<double>
+                             {
+                              auto v = alloc_vec<double>(6);
+                              std::copy(r.s_np1, r.s_np1+6, arr2ptr<double>(v));
+                              return v;
+                             }, "Stress from the update.")
+      .def_property_readonly("h_n",
+                             [](const CaptureRecord & r) -> py::array_t<double>
+                             {
+                              auto v = alloc_vec<double>(r.h_n.size());
+                              std::copy(r.h_n.begin(), r.h_n.end(),
+                                        arr2ptr<double>(v));
+                              return v;
+                             }, "History at the last step.")
+      ;
+
+  m.def("start_capture", &start_capture, "Start capturing updates to a log.",
+        py::arg("fname"), py::arg("fraction") = 1.0, py::arg("seed") = 0);
+  m.def("stop_capture", &stop_capture, "Stop capturing and close the log.");
+  m.def("capturing", &capturing, "Is a capture running?");
+  m.def("capture_model",
+        [](std::shared_ptr<NEMLModel> model, std::string fname, std::string mname)
+        {
+          capture_model(model.get(), fname, mname);
+        }, "Name a model in the log by its XML file and model name.");
+  m.def("capture_forget_model",
+        [](std::shared_ptr<NEMLModel> model)
+        {
+          capture_forget_model(model.get());
+        }, "Drop the name of a model.");
+
+  m.def("captured_update_sd",
+        [](NEMLModel & m, py::array_t<double, py::array::c_style> e_np1, py::array_t<double, py::array::c_style> e_n, double T_np1, double T_n, double t_np1, double t_n, py::array_t<double, py::array::c_style> s_n, py::array_t<double, py::array::c_style> h_n, double u_n, double p_n) -> std::tuple<py::array_t<double>, py::array_t<double>, py::array_t<double>, double, double>
+        {
+          auto s_np1 = alloc_vec<double>(6);
+          auto h_np1 = alloc_vec<double>(m.nstore());
+          auto A_np1 = alloc_mat<double>(6,6);
+          double u_np1, p_np1;
+
+          int ier = captured_update_sd(m, arr2ptr<double>(e_np1), arr2ptr<double>(e_n), T_np1, T_n, t_np1, t_n, arr2ptr<double>(s_np1), arr2ptr<double>(s_n), arr2ptr<double>(h_np1), arr2ptr<double>(h_n), arr2ptr<double>(A_np1), u_np1, u_n, p_np1, p_n);
+          py_error(ier);
+
+          return std::make_tuple(s_np1, h_np1, A_np1, u_np1, p_np1);
+        }, "Small deformation update, captured if a capture is running.");
+
+  m.def("captured_update_ld_inc",
+        [](NEMLModel & m, py::array_t<double, py::array::c_style> d_np1, py::array_t<double, py::array::c_style> d_n, py::array_t<double, py::array::c_style> w_np1, py::array_t<double, py::array::c_style> w_n, double T_np1, double T_n, double t_np1, double t_n, py::array_t<double, py::array::c_style> s_n, py::array_t<double, py::array::c_style> h_n, double u_n, double p_n) -> std::tuple<py::array_t<double>, py::array_t<double>, py::array_t<double>, py::array_t<double>, double, double>
+        {
+          auto s_np1 = alloc_vec<double>(6);
+          auto h_np1 = alloc_vec<double>(m.nstore());
+          auto A_np1 = alloc_mat<double>(6,6);
+          auto B_np1 = alloc_mat<double>(6,3);
+          double u_np1, p_np1;
+
+          int ier = captured_update_ld_inc(m, arr2ptr<double>(d_np1), arr2ptr<double>(d_n), arr2ptr<double>(w_np1), arr2ptr<double>(w_n), T_np1, T_n, t_np1, t_n, arr2ptr<double>(s_np1), arr2ptr<double>(s_n), arr2ptr<double>(h_np1), arr2ptr<double>(h_n), arr2ptr<double>(A_np1), arr2ptr<double>(B_np1), u_np1, u_n, p_np1, p_n);
+          py_error(ier);
+
+          return std::make_tuple(s_np1, h_np1, A_np1, B_np1, u_np1, p_np1);
+        }, "Large deformation incremental update, captured if a capture is running.");
+
+  m.def("read_capture",
+        [](std::string fname) -> std::tuple<std::map<int, CaptureModel>, std::vector<CaptureRecord>>
+        {
+          std::map<int, CaptureModel> models;
+          std::vector<CaptureRecord> records;
+          read_capture(fname, models, records);
+          return std::make_tuple(models, records);
+        }, "Read the models and records in a capture log.");
+}
+
+} // namespace neml
@@ -1,11 +1,48 @@
 #include "cinterface.h"
+#include "capture.h"
+#include "trace.h"
 #include "nemlerror.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Newton settings for the out of plane strain of plane stress VUMAT calls
+const double plane_stress_tol = 1.0e-10;
+const int plane_stress_miter = 25;
+
+// Capture and trace are diagnostics, so a bad NEML_CAPTURE_FILE or
+// NEML_TRACE_FILE warns and the model runs without them
+static void diagnostics_from_environment(const neml::NEMLModel * model,
+                                         const char * fname,
+                                         const char * mname)
+{
+  try {
+    neml::capture_from_environment();
+    neml::capture_model(model, fname, mname);
+  }
+  catch (std::exception & e) {
+    std::cerr << "NEML: not capturing calls: " << e.what() << std::endl;
+  }
+
+  try {
+    neml::trace_from_environment();
+  }
+  catch (std::exception & e) {
+    std::cerr << "NEML: not tracing solves: " << e.what() << std::endl;
+  }
+}
+
 NEMLMODEL * create_nemlmodel(const char * fname, const char * mname, int * ier)
 {
   try {
     // Remember, releasing the unique_ptr means you have to reference count!
     std::unique_ptr<neml::NEMLModel> umodel = neml::parse_xml_unique(fname, mname);
+    diagnostics_from_environment(umodel.get(), fname, mname);
     *ier = 0;
 
     return umodel.release();
@@ -19,6 +56,7 @@ NEMLMODEL * create_nemlmodel(const char * fname, const char * mname, int * ier)
 void destroy_nemlmodel(NEMLMODEL * model, int * ier)
 {
   try {
+    neml::capture_forget_model(model);
     delete model;
     *ier = 0;
   }
@@ -80,10 +118,370 @@ void update_sd_nemlmodel(NEMLMODEL * model, double * e_np1, double * e_n,
                          int * ier)
 {
   try {
-    *ier = model->update_sd(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1, s_n,
-                            h_np1, h_n, A_np1, *u_np1, u_n, *p_np1, p_n);
+    *ier = neml::captured_update_sd(*model, e_np1, e_n, T_np1, T_n, t_np1,
+                                    t_n, s_np1, s_n, h_np1, h_n, A_np1,
+                                    *u_np1, u_n, *p_np1, p_n);
+  }
+  catch (...) {
+    *ier = neml::UNKNOWN_ERROR;
+  }
+}
+
+void update_sd_scale_nemlmodel(NEMLMODEL * model, double * e_np1, double * e_n,
+                               double T_np1, double T_n,
+                               double t_np1, double t_n,
+                               double * s_np1, double * s_n,
+                               double * h_np1, double * h_n,
+                               double * A_np1,
+                               double * u_np1, double u_n,
+                               double * p_np1, double p_n,
+                               double * dt_scale, int * ier)
+{
+  bool capture = neml::capturing();
+  neml::CaptureRecord rec;
+  if (capture) {
+    neml::capture_sd_inputs(rec, *model, e_np1, e_n, T_np1, T_n, t_np1, t_n,
+                            s_n, h_n, u_n, p_n);
+  }
+
+  try {
+    *ier = model->update_sd_scale(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1,
+                                  s_n, h_np1, h_n, A_np1, *u_np1, u_n,
+                                  *p_np1, p_n, *dt_scale);
+  }
+  catch (...) {
+    *dt_scale = neml::suggest_step_scale(neml::SolveStats(), 0.0,
+                                         neml::UNKNOWN_ERROR);
+    *ier = neml::UNKNOWN_ERROR;
+  }
+
+  if (capture) neml::capture_result(*model, rec, *ier, s_np1);
+}
+
+NEMLMODEL * cached_nemlmodel(const char * fname, const char * mname, int * ier)
+{
+  static std::map<std::pair<std::string,std::string>,
+      std::unique_ptr<neml::NEMLModel>> models;
+  static std::mutex lock;
+
+  try {
+    std::lock_guard<std::mutex> guard(lock);
+    auto key = std::make_pair(std::string(fname), std::string(mname));
+    auto it = models.find(key);
+    if (it == models.end()) {
+      it = models.emplace(key, neml::parse_xml_unique(fname, mname)).first;
+      diagnostics_from_environment(it->second.get(), fname, mname);
+    }
+    *ier = 0;
+
+    return it->second.get();
+  }
+  catch (...) {
+    *ier = neml::UNKNOWN_ERROR;
+    return NULL;
+  }
+}
+
+void point_cost_nemlmodel(NEMLMODEL * model, int npts, double * h,
+                          double * cost, int * ier)
+{
+  try {
+    int nstore = model->nstore();
+    for (int i=0; i<npts; i++) cost[i] = model->point_cost(&h[nstore*i]);
+    *ier = 0;
+  }
+  catch (...) {
+    *ier = neml::UNKNOWN_ERROR;
+  }
+}
+
+int failed_nemlmodel(NEMLMODEL * model, double * h, int * ier)
+{
+  try {
+    *ier = 0;
+    return model->failed(h) ? 1 : 0;
+  }
+  catch (...) {
+    *ier = neml::UNKNOWN_ERROR;
+    return 0;
+  }
+}
+
+void update_sd_block_nemlmodel(NEMLMODEL * model, int nblock,
+                               double * e_np1, double * e_n,
+                               double * T_np1, double * T_n,
+                               double t_np1, double t_n,
+                               double * s_np1, double * s_n,
+                               double * h_np1, double * h_n,
+                               double * A_np1,
+                               double * u_np1, double * u_n,
+                               double * p_np1, double * p_n,
+                               int * ier)
+{
+  int nstore = model->nstore();
+
+  // Threads take chunks of points the model can solve in lockstep
+  int W = (int) neml::batch_width;
+  int nchunk = (nblock + W - 1) / W;
+
+  // Hand out the expensive chunks first so a slow one does not finish last
+  std::vector<double> cost(nchunk, 0.0);
+  std::vector<int> order(nchunk);
+  for (int c=0; c<nchunk; c++) {
+    order[c] = c;
+    for (int i=c*W; i<std::min((c+1)*W, nblock); i++) {
+      cost[c] += model->point_cost(&h_n[nstore*i]);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&cost](int a, int b) {return cost[a] > cost[b];});
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int k=0; k<nchunk; k++) {
+    int c = order[k];
+    int i0 = c * W;
+    int np = std::min(W, nblock - i0);
+
+    // Keep the inputs, as the caller may update the block in place
+    bool capture = neml::capturing();
+    std::vector<neml::CaptureRecord> recs(capture ? np : 0);
+    for (int i=0; i<(int) recs.size(); i++) {
+      int ip = i0 + i;
+      neml::capture_sd_inputs(recs[i], *model, &e_np1[6*ip], &e_n[6*ip],
+                              T_np1[ip], T_n[ip], t_np1, t_n, &s_n[6*ip],
+                              &h_n[nstore*ip], u_n[ip], p_n[ip]);
+    }
+
+    // The chunk is solved together, so it is traced under its first point
+    NEML_TRACE_POINT(i0);
+    try {
+      model->update_sd_batch(np, &e_np1[6*i0], &e_n[6*i0], &T_np1[i0],
+                             &T_n[i0], t_np1, t_n, &s_np1[6*i0],
+                             &s_n[6*i0], &h_np1[nstore*i0],
+                             &h_n[nstore*i0], &A_np1[36*i0], &u_np1[i0],
+                             &u_n[i0], &p_np1[i0], &p_n[i0], &ier[i0]);
+    }
+    catch (...) {
+      // Find the point that threw
+      for (int i=i0; i<i0+np; i++) {
+        try {
+          ier[i] = model->update_sd(&e_np1[6*i], &e_n[6*i], T_np1[i], T_n[i],
+                                    t_np1, t_n, &s_np1[6*i], &s_n[6*i],
+                                    &h_np1[nstore*i], &h_n[nstore*i],
+                                    &A_np1[36*i], u_np1[i], u_n[i],
+                                    p_np1[i], p_n[i]);
+        }
+        catch (...) {
+          ier[i] = neml::UNKNOWN_ERROR;
+        }
+      }
+    }
+
+    for (int i=0; i<(int) recs.size(); i++) {
+      neml::capture_result(*model, recs[i], ier[i0+i], &s_np1[6*(i0+i)]);
+    }
+  }
+}
+
+// VUMAT arrays are dimensioned (nblock, ncomponents) in column major order,
+// the components are ordered 11, 22, 33, 12, 23, 31, and the shear
+// components are tensor (not engineering) components.  VUMAT only provides
+// strain increments so the total strain is kept after the NEML history in
+// the state variables.  totalTime is taken as the time at the start of the
+// increment.
+void vumat_nemlmodel(NEMLMODEL * model, int nblock, int ndir, int nshr,
+                     int nstatev, double stepTime, double totalTime,
+                     double dt, double * density, double * strainInc,
+                     double * tempOld, double * stressOld, double * stateOld,
+                     double * enerInternOld, double * enerInelasOld,
+                     double * tempNew, double * stressNew, double * stateNew,
+                     double * enerInternNew, double * enerInelasNew,
+                     int * ier)
+{
+  int nstore = model->nstore();
+  int ntens = ndir + nshr;
+
+  if ((nstatev < nstore + 6) || (ndir < 2) || (ndir > 3) || (nshr < 1) ||
+      (nshr > 3) || ((ndir == 2) && (nshr != 1))) {
+    *ier = neml::INCOMPATIBLE_VUMAT;
+    return;
+  }
+
+  // Map VUMAT components to Mandel components
+  const int shear[3] = {5, 3, 4};
+  int imap[6];
+  double mult[6];
+  for (int k=0; k<ndir; k++) {
+    imap[k] = k;
+    mult[k] = 1.0;
+  }
+  for (int k=0; k<nshr; k++) {
+    imap[ndir+k] = shear[k];
+    mult[ndir+k] = sqrt(2.0);
+  }
+
+  std::vector<int> errors(nblock, neml::SUCCESS);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    std::vector<double> h_nv(nstore);
+    std::vector<double> h_np1v(nstore);
+    double * h_n = &h_nv[0];
+    double * h_np1 = &h_np1v[0];
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (int i=0; i<nblock; i++) {
+      double e_n[6], de[6], e_np1[6], s_n[6], s_np1[6], A_np1[36];
+      std::fill(de, de+6, 0.0);
+      std::fill(s_n, s_n+6, 0.0);
+      for (int k=0; k<ntens; k++) {
+        de[imap[k]] = strainInc[i+k*nblock] * mult[k];
+        s_n[imap[k]] = stressOld[i+k*nblock] * mult[k];
+      }
+      for (int j=0; j<nstore; j++) h_n[j] = stateOld[i+j*nblock];
+      for (int k=0; k<6; k++) e_n[k] = stateOld[i+(nstore+k)*nblock];
+
+      // Plane stress: Abaqus does not give the out of plane strain, so
+      // start from the elastic one that leaves s33 zero
+      double K = model->bulk(tempNew[i]);
+      double G = model->shear(tempNew[i]);
+      if (ndir == 2) {
+        de[2] = -(3.0 * K - 2.0 * G) / (3.0 * K + 4.0 * G) * (de[0] + de[1])
+            - s_n[2] / (K + 4.0 * G / 3.0);
+      }
+      for (int k=0; k<6; k++) e_np1[k] = e_n[k] + de[k];
+
+      double u_n = enerInternOld[i] * density[i];
+      double p_n = enerInelasOld[i] * density[i];
+      double u_np1, p_np1;
+
+      int res;
+      if (stepTime == 0.0) {
+        // Abaqus packager call: respond elastically
+        double dv = (de[0] + de[1] + de[2]) / 3.0;
+        for (int k=0; k<6; k++) {
+          s_np1[k] = s_n[k] + 2.0 * G * de[k];
+        }
+        for (int k=0; k<3; k++) {
+          s_np1[k] += (3.0 * K - 2.0 * G) * dv;
+        }
+        std::copy(h_n, h_n+nstore, h_np1);
+        p_np1 = p_n;
+        res = neml::SUCCESS;
+      }
+      else {
+        NEML_TRACE_POINT(i);
+        int ures;   // What the model itself returned for the last update
+        bool threw = false;
+        try {
+          res = ures = model->update_sd(e_np1, e_n, tempNew[i], tempOld[i],
+                                        totalTime + dt, totalTime, s_np1,
+                                        s_n, h_np1, h_n, A_np1, u_np1, u_n,
+                                        p_np1, p_n);
+
+          // Plane stress: Newton on the out of plane strain for s33 = 0
+          for (int it=0; (ndir == 2) && (res == neml::SUCCESS); it++) {
+            double snorm = 0.0;
+            for (int k=0; k<6; k++) snorm += s_np1[k] * s_np1[k];
+            if (fabs(s_np1[2]) <= plane_stress_tol * std::max(sqrt(snorm),
+                                                              1.0)) {
+              break;
+            }
+            if ((it == plane_stress_miter) || (A_np1[14] == 0.0)) {
+              res = neml::MAX_ITERATIONS;
+              break;
+            }
+            e_np1[2] -= s_np1[2] / A_np1[14];
+            res = ures = model->update_sd(e_np1, e_n, tempNew[i], tempOld[i],
+                                          totalTime + dt, totalTime, s_np1,
+                                          s_n, h_np1, h_n, A_np1, u_np1, u_n,
+                                          p_np1, p_n);
+          }
+        }
+        catch (...) {
+          res = ures = neml::UNKNOWN_ERROR;
+          threw = true;
+        }
+
+        // Only the last update is captured, not the plane stress trial
+        // strains, and the inputs are still intact to record it
+        if (neml::capturing()) {
+          neml::CaptureRecord rec;
+          neml::capture_sd_inputs(rec, *model, e_np1, e_n, tempNew[i],
+                                  tempOld[i], totalTime + dt, totalTime, s_n,
+                                  h_n, u_n, p_n);
+          neml::capture_result(*model, rec, ures, threw ? nullptr : s_np1);
+        }
+      }
+
+      // Failed points keep their old state
+      if (res != neml::SUCCESS) {
+        errors[i] = res;
+        std::copy(s_n, s_n+6, s_np1);
+        std::copy(h_n, h_n+nstore, h_np1);
+        std::copy(e_n, e_n+6, e_np1);
+        p_np1 = p_n;
+      }
+
+      // Trapezoid rule energy, as in the models, for points NEML skipped
+      if ((stepTime == 0.0) || (res != neml::SUCCESS)) {
+        u_np1 = u_n;
+        for (int k=0; k<6; k++) {
+          u_np1 += (s_np1[k] + s_n[k]) * (e_np1[k] - e_n[k]) / 2.0;
+        }
+      }
+
+      for (int k=0; k<ntens; k++) {
+        stressNew[i+k*nblock] = s_np1[imap[k]] / mult[k];
+      }
+      for (int j=0; j<nstore; j++) stateNew[i+j*nblock] = h_np1[j];
+      for (int k=0; k<6; k++) stateNew[i+(nstore+k)*nblock] = e_np1[k];
+      for (int j=nstore+6; j<nstatev; j++) {
+        stateNew[i+j*nblock] = stateOld[i+j*nblock];
+      }
+      enerInternNew[i] = u_np1 / density[i];
+      enerInelasNew[i] = p_np1 / density[i];
+    }
+  }
+
+  *ier = neml::SUCCESS;
+  for (int i=0; i<nblock; i++) {
+    if (errors[i] != neml::SUCCESS) {
+      *ier = errors[i];
+      break;
+    }
+  }
+}
+
+void start_capture_nemlmodel(const char * fname, double fraction, int * ier)
+{
+  try {
+    neml::start_capture(fname, fraction);
+    *ier = 0;
+  }
+  catch (...) {
+    *ier = neml::FILE_NOT_FOUND;
+  }
+}
+
+void stop_capture_nemlmodel(int * ier)
+{
+  try {
+    neml::stop_capture();
+    *ier = 0;
   }
   catch (...) {
     *ier = neml::UNKNOWN_ERROR;
   }
 }
+
+void trace_point_nemlmodel(int id)
+{
+  neml::trace_set_point(id);
+}
@@ -35,6 +35,64 @@ void update_sd_nemlmodel(NEMLMODEL * model, double * e_np1, double * e_n,
                          double * p_np1, double p_n,
                          int * ier);
 
+// Update and suggest a scale factor for the time step
+void update_sd_scale_nemlmodel(NEMLMODEL * model, double * e_np1, double * e_n,
+                               double T_np1, double T_n,
+                               double t_np1, double t_n,
+                               double * s_np1, double * s_n,
+                               double * h_np1, double * h_n,
+                               double * A_np1,
+                               double * u_np1, double u_n,
+                               double * p_np1, double p_n,
+                               double * dt_scale, int * ier);
+
+// Estimated cost of updating each of npts points, with the stored
+// variables of the points one after the other, for weighting partitions
+void point_cost_nemlmodel(NEMLMODEL * model, int npts, double * h,
+                          double * cost, int * ier);
+
+// Has the point with stored variables h failed, so the calling code can
+// delete the element?  Returns 1 if so and 0 otherwise.  Only damage
+// models can fail.
+int failed_nemlmodel(NEMLMODEL * model, double * h, int * ier);
+
+// Load a model once and keep it for the life of the program
+NEMLMODEL * cached_nemlmodel(const char * fname, const char * mname, int * ier);
+
+// Update nblock points, stored one after the other, with per-point errors.
+// The threads take the most expensive points first.
+void update_sd_block_nemlmodel(NEMLMODEL * model, int nblock,
+                               double * e_np1, double * e_n,
+                               double * T_np1, double * T_n,
+                               double t_np1, double t_n,
+                               double * s_np1, double * s_n,
+                               double * h_np1, double * h_n,
+                               double * A_np1,
+                               double * u_np1, double * u_n,
+                               double * p_np1, double * p_n,
+                               int * ier);
+
+// Update a block of points with the Abaqus VUMAT array layout
+//  With ndir = 2 the points are in plane stress, and the out of plane
+//  strain is solved for so that s33 is zero.
+void vumat_nemlmodel(NEMLMODEL * model, int nblock, int ndir, int nshr,
+                     int nstatev, double stepTime, double totalTime,
+                     double dt, double * density, double * strainInc,
+                     double * tempOld, double * stressOld, double * stateOld,
+                     double * enerInternOld, double * enerInelasOld,
+                     double * tempNew, double * stressNew, double * stateNew,
+                     double * enerInternNew, double * enerInelasNew,
+                     int * ier);
+
+// Record the inputs of a fraction of the updates, and all the failures, to
+// a binary log that the replay tool can run again
+void start_capture_nemlmodel(const char * fname, double fraction, int * ier);
+void stop_capture_nemlmodel(int * ier);
+
+// Label the next updates on this thread with a point id in the trace, if
+// the library was built with tracing
+void trace_point_nemlmodel(int id);
+
 #ifdef __cplusplus
 }
 #endif
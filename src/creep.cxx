@@ -60,15 +60,15 @@ std::unique_ptr<NEMLObject> PowerLawCreep::initialize(ParameterSet & params)
 
 int PowerLawCreep::g(double seq, double eeq, double t, double T, double & g) const
 {
-  g = A_->value(T) * pow(seq, n_->value(T));
+  g = (*A_)(T) * pow(seq, (*n_)(T));
   return 0;
 }
 
 int PowerLawCreep::dg_ds(double seq, double eeq, double t, double T, double & dg) const
 {
-  double nv = n_->value(T);
+  double nv = (*n_)(T);
 
-  dg = A_->value(T) * nv * pow(seq, nv - 1.0);
+  dg = (*A_)(T) * nv * pow(seq, nv - 1.0);
   return 0;
 }
 
@@ -80,12 +80,12 @@ int PowerLawCreep::dg_de(double seq, double eeq, double t, double T, double & dg
 
 double PowerLawCreep::A(double T) const
 {
-  return A_->value(T);
+  return (*A_)(T);
 }
 
 double PowerLawCreep::n(double T) const
 {
-  return n_->value(T);
+  return (*n_)(T);
 }
 
 // Implementation of the mechanism switching model
@@ -228,9 +228,9 @@ std::unique_ptr<NEMLObject> NortonBaileyCreep::initialize(ParameterSet & params)
 
 int NortonBaileyCreep::g(double seq, double eeq, double t, double T, double & g) const
 {
-  double A = A_->value(T);
-  double m = m_->value(T);
-  double n = n_->value(T);
+  double A = (*A_)(T);
+  double m = (*m_)(T);
+  double n = (*n_)(T);
 
   // Hack, really should figure out limits
   if (seq < std::numeric_limits<double>::epsilon()) {
@@ -247,9 +247,9 @@ int NortonBaileyCreep::g(double seq, double eeq, double t, double T, double & g)
 
 int NortonBaileyCreep::dg_ds(double seq, double eeq, double t, double T, double & dg) const
 {
-  double A = A_->value(T);
-  double m = m_->value(T);
-  double n = n_->value(T);
+  double A = (*A_)(T);
+  double m = (*m_)(T);
+  double n = (*n_)(T);
 
   // Hack, really should figure out limits
   if (seq < std::numeric_limits<double>::epsilon()) {
@@ -266,9 +266,9 @@ int NortonBaileyCreep::dg_ds(double seq, double eeq, double t, double T, double
 
 int NortonBaileyCreep::dg_de(double seq, double eeq, double t, double T, double & dg) const
 {
-  double A = A_->value(T);
-  double m = m_->value(T);
-  double n = n_->value(T);
+  double A = (*A_)(T);
+  double m = (*m_)(T);
+  double n = (*n_)(T);
 
   // Hack, really should figure out limits
   if (seq < std::numeric_limits<double>::epsilon()) {
@@ -285,17 +285,17 @@ int NortonBaileyCreep::dg_de(double seq, double eeq, double t, double T, double
 
 double NortonBaileyCreep::A(double T) const
 {
-  return A_->value(T);
+  return (*A_)(T);
 }
 
 double NortonBaileyCreep::m(double T) const
 {
-  return m_->value(T);
+  return (*m_)(T);
 }
 
 double NortonBaileyCreep::n(double T) const
 {
-  return n_->value(T);
+  return (*n_)(T);
 }
 
 
@@ -431,13 +431,13 @@ ParameterSet GenericCreep::parameters()
 
 int GenericCreep::g(double seq, double eeq, double t, double T, double & g) const
 {
-  g = exp(cfn_->value(log(seq)));
+  g = exp((*cfn_)(log(seq)));
   return 0;
 }
 
 int GenericCreep::dg_ds(double seq, double eeq, double t, double T, double & dg) const
 {
-  double f = cfn_->value(log(seq));
+  double f = (*cfn_)(log(seq));
   double df = cfn_->derivative(log(seq));
   
   if (seq > 0.0) {
@@ -497,18 +497,18 @@ std::unique_ptr<NEMLObject> BlackburnSinhCreep::initialize(ParameterSet & params
 
 int BlackburnSinhCreep::g(double seq, double eeq, double t, double T, double & g) const
 {
-  double A = A_->value(T);
-  double B = beta_->value(T);
-  double n = n_->value(T);
+  double A = (*A_)(T);
+  double B = (*beta_)(T);
+  double n = (*n_)(T);
   g = A * pow(sinh(B*seq/n),n) * exp(-Q_/(R_*T));
   return 0;
 }
 
 int BlackburnSinhCreep::dg_ds(double seq, double eeq, double t, double T, double & dg) const
 {
-  double A = A_->value(T);
-  double B = beta_->value(T);
-  double n = n_->value(T);
+  double A = (*A_)(T);
+  double B = (*beta_)(T);
+  double n = (*n_)(T);
 
   dg = A * B * exp(-Q_/(R_*T)) * cosh(B*seq/n) * pow(sinh(B*seq/n),n-1.0);
   return 0;
@@ -570,6 +570,16 @@ int CreepModel::update(const double * const s_np1,
   return calc_tangent_(e_np1, ts, A_np1);
 }
 
+int CreepModel::relax(const double * const s_n, const double * const e_n,
+                      double G, double T, double t_np1, double t_n,
+                      double * const s_np1, double * const e_np1,
+                      double * const A_np1, bool & valid)
+{
+  // Not supported by default
+  valid = false;
+  return 0;
+}
+
 int CreepModel::make_trial_state(const double * const s_np1, 
                                  const double * const e_n,
                                  double T_np1, double T_n,
@@ -646,8 +656,9 @@ int CreepModel::calc_tangent_(const double * const e_np1,
 
 // Implementation of J2 creep
 J2CreepModel::J2CreepModel(std::shared_ptr<ScalarCreepRule> rule,
-                           double tol, int miter, bool verbose) :
-    CreepModel(tol, miter, verbose), rule_(rule)
+                           double tol, int miter, bool verbose,
+                           double relax_tol) :
+    CreepModel(tol, miter, verbose), rule_(rule), relax_tol_(relax_tol)
 {
 
 }
@@ -666,6 +677,7 @@ ParameterSet J2CreepModel::parameters()
   pset.add_optional_parameter<double>("tol", 1.0e-10);
   pset.add_optional_parameter<int>("miter", 25);
   pset.add_optional_parameter<bool>("verbose", false);
+  pset.add_optional_parameter<double>("relax_tol", 1.0e-6);
 
   return pset;
 }
@@ -676,7 +688,8 @@ std::unique_ptr<NEMLObject> J2CreepModel::initialize(ParameterSet & params)
       params.get_object_parameter<ScalarCreepRule>("rule"),
       params.get_parameter<double>("tol"),
       params.get_parameter<int>("miter"),
-      params.get_parameter<bool>("verbose")
+      params.get_parameter<bool>("verbose"),
+      params.get_parameter<double>("relax_tol")
       ); 
 }
 
@@ -847,6 +860,111 @@ int J2CreepModel::df_dT(const double * const s, const double * const e,
 }
 
 // Helpers for J2 plasticity
+int J2CreepModel::relax(const double * const s_n, const double * const e_n,
+                        double G, double T, double t_np1, double t_n,
+                        double * const s_np1, double * const e_np1,
+                        double * const A_np1, bool & valid)
+{
+  valid = true;
+
+  // With isotropic elasticity the deviatoric stress direction stays fixed
+  // and the creep strain increment is 3/2 * de * dir
+  double dir[6];
+  std::copy(s_n, s_n+6, dir);
+  int ier = sdir(dir);
+  if (ier != SUCCESS) return ier;
+
+  double se0 = seq(s_n);
+  double se = se0;    // Current equivalent stress
+  double de = 0.0;    // Current equivalent creep strain increment
+  double t = t_n;
+  double dt = t_np1 - t_n;
+  double h = dt;
+
+  // Step doubling on the equivalent stress
+  while ((se0 >= std::numeric_limits<double>::epsilon()) && (se > 0.0)
+         && (t < t_np1)) {
+    bool last = (t + h >= t_np1);
+    if (last) h = t_np1 - t;
+
+    double se1, de1, se2, de2, se3, de3;
+    if ((relax_step_(se, de, e_n, dir, G, T, t, h, se1, de1) != SUCCESS) ||
+        (relax_step_(se, de, e_n, dir, G, T, t, h / 2.0, se2, de2)
+         != SUCCESS) ||
+        (relax_step_(se2, de2, e_n, dir, G, T, t + h / 2.0, h / 2.0, se3, de3)
+         != SUCCESS)) {
+      valid = false;
+      return 0;
+    }
+
+    if (fabs(se1 - se3) <= relax_tol_ * se0) {
+      t = last ? t_np1 : t + h;
+      se = se3;
+      de = de3;
+      h *= 2.0;
+    }
+    else {
+      h /= 2.0;
+      if (h < dt * std::numeric_limits<double>::epsilon()) {
+        valid = false;
+        return 0;
+      }
+    }
+  }
+
+  for (int i=0; i<6; i++) {
+    e_np1[i] = e_n[i] + 3.0 / 2.0 * de * dir[i];
+    s_np1[i] = s_n[i] - 3.0 * G * de * dir[i];
+  }
+
+  // The tangent is the backward Euler tangent at the final state
+  CreepModelTrialState ts;
+  ier = make_trial_state(s_np1, e_n, T, T, t_np1, t_n, ts);
+  if (ier != SUCCESS) return ier;
+
+  return calc_tangent_(e_np1, ts, A_np1);
+}
+
+int J2CreepModel::relax_step_(double se, double de, const double * const e_n,
+                              const double * const dir, double G, double T,
+                              double t, double dt, double & se_np1,
+                              double & de_np1) const
+{
+  double e[6];
+  for (int i=0; i<6; i++) e[i] = e_n[i] + 3.0 / 2.0 * de * dir[i];
+  double ee = eeq(e);
+
+  double g, dg;
+  int ier = rule_->g(se, ee, t, T, g);
+  if (ier != SUCCESS) return ier;
+  ier = rule_->dg_ds(se, ee, t, T, dg);
+  if (ier != SUCCESS) return ier;
+
+  if (g <= 0.0) {
+    se_np1 = se;
+    de_np1 = de;
+    return 0;
+  }
+
+  // Exact solution of dse/dt = -3 G g(se) for g = g0 (se / se0)^m, where
+  // the exponent m comes from the local slope of the rule
+  double lambda = 3.0 * G * g / se;
+  double m = se * dg / g;
+  double r;
+  if (fabs(m - 1.0) < 1.0e-8) {
+    r = exp(-lambda * dt);
+  }
+  else {
+    double base = 1.0 + (m - 1.0) * lambda * dt;
+    r = (base > 0.0) ? pow(base, -1.0 / (m - 1.0)) : 0.0;
+  }
+
+  se_np1 = se * r;
+  de_np1 = de + (se - se_np1) / (3.0 * G);
+
+  return 0;
+}
+
 double J2CreepModel::seq(const double * const s) const
 {
   double sdev[6];
@@ -257,6 +257,16 @@ class CreepModel: public NEMLObject, public Solvable {
              double T_np1, double T_n,
              double t_np1, double t_n,
              double * const A_np1);
+
+  /// Relax the stress over a hold at fixed total strain and temperature,
+  /// for an isotropic elastic material with shear modulus G, returning
+  /// the new stress, creep strain, and the creep tangent as in update.
+  /// Sets valid to false if the model cannot do this, in which case
+  /// use update instead.
+  virtual int relax(const double * const s_n, const double * const e_n,
+                    double G, double T, double t_np1, double t_n,
+                    double * const s_np1, double * const e_np1,
+                    double * const A_np1, bool & valid);
   
   /// The creep rate as a function of stress, strain, time, and temperature
   virtual int f(const double * const s, const double * const e, double t, double T, 
@@ -289,7 +299,7 @@ class CreepModel: public NEMLObject, public Solvable {
   virtual int RJ(const double * const x, TrialState * ts, double * const R,
                  double * const J);
 
- private:
+ protected:
   int calc_tangent_(const double * const e_np1, CreepModelTrialState & ts, 
                     double * const A_np1);
 
@@ -303,9 +313,10 @@ class CreepModel: public NEMLObject, public Solvable {
 class J2CreepModel: public CreepModel {
  public:
   /// Parameters: scalar creep rule, nonlinear tolerance, maximum solver
-  /// iterations, and a verbosity flag
+  /// iterations, a verbosity flag, and the relative tolerance for
+  /// semi-analytic stress relaxation
   J2CreepModel(std::shared_ptr<ScalarCreepRule> rule,
-               double tol, int miter, bool verbose);
+               double tol, int miter, bool verbose, double relax_tol);
   
   /// String type for the object system
   static std::string type();
@@ -331,6 +342,14 @@ class J2CreepModel: public CreepModel {
   virtual int df_dT(const double * const s, const double * const e, double t, double T, 
                 double * const df) const;
 
+  /// Relax along the fixed deviatoric stress direction, integrating
+  /// the scalar equivalent stress equation piecewise exactly for a local
+  /// power law fit to the rule
+  virtual int relax(const double * const s_n, const double * const e_n,
+                    double G, double T, double t_np1, double t_n,
+                    double * const s_np1, double * const e_np1,
+                    double * const A_np1, bool & valid);
+
  private:
   // Helpers for computing the above
   double seq(const double * const s) const;
@@ -338,8 +357,14 @@ class J2CreepModel: public CreepModel {
   int sdir(double * const s) const;
   int edir(double * const e) const;
 
+  // One relaxation step of the equivalent stress and strain
+  int relax_step_(double se, double de, const double * const e_n,
+                  const double * const dir, double G, double T, double t,
+                  double dt, double & se_np1, double & de_np1) const;
+
  private:
   std::shared_ptr<ScalarCreepRule> rule_;
+  double relax_tol_;
 };
 
 static Register<J2CreepModel> regJ2CreepModel;
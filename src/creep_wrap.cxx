@@ -33,6 +33,21 @@ PYBIND11_MODULE(creep, m) {
 
            }, "Update to the next creep strain & tangent derivative.")
 
+      .def("relax",
+           [](CreepModel & m, py::array_t<double, py::array::c_style> s_n, py::array_t<double, py::array::c_style> e_n, double G, double T, double t_np1, double t_n) -> std::tuple<py::array_t<double>, py::array_t<double>, py::array_t<double>, bool>
+           {
+            auto s_np1 = alloc_vec<double>(6);
+            auto e_np1 = alloc_vec<double>(6);
+            auto A_np1 = alloc_mat<double>(6,6);
+            bool valid;
+
+            int ier = m.relax(arr2ptr<double>(s_n), arr2ptr<double>(e_n), G, T, t_np1, t_n, arr2ptr<double>(s_np1), arr2ptr<double>(e_np1), arr2ptr<double>(A_np1), valid);
+            py_error(ier);
+
+            return std::make_tuple(s_np1, e_np1, A_np1, valid);
+
+           }, "Relax the stress over a strain hold.")
+
       .def("f",
            [](const CreepModel & m, py::array_t<double, py::array::c_style> s, py::array_t<double, py::array::c_style> e, double t, double T) -> py::array_t<double>
            {
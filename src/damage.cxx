@@ -1,5 +1,6 @@
 #include "damage.h"
 #include "elasticity.h"
+#include "trace.h"
 
 #include <cmath>
 
@@ -37,10 +38,10 @@ NEMLScalarDamagedModel_sd::NEMLScalarDamagedModel_sd(
     std::shared_ptr<LinearElasticModel> elastic,
     std::shared_ptr<NEMLModel_sd> base, 
     std::shared_ptr<Interpolate> alpha,
-    double tol, int miter, bool verbose,
+    double tol, int miter, bool verbose, double w_fail,
     bool truesdell) :
       NEMLDamagedModel_sd(elastic, base, alpha, truesdell), tol_(tol), miter_(miter),
-      verbose_(verbose)
+      verbose_(verbose), w_fail_(w_fail)
 {
 
 }
@@ -55,6 +56,13 @@ int NEMLScalarDamagedModel_sd::update_sd(
     double & u_np1, double u_n,
     double & p_np1, double p_n)
 {
+  NEML_TRACE_SCOPE("NEMLScalarDamagedModel_sd::update_sd");
+  // Failed points skip the solve and the base model
+  if (failed(h_n)) {
+    return failed_update_(e_np1, e_n, T_np1, s_np1, s_n, h_np1, h_n, A_np1,
+                          u_np1, u_n, p_np1, p_n);
+  }
+
   // Make trial state
   SDTrialState tss;
   int ier = make_trial_state(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_n, h_n, u_n, p_n, tss);
@@ -66,31 +74,28 @@ int NEMLScalarDamagedModel_sd::update_sd(
   ier = solve(this, x, &tss, tol_, miter_, verbose_);
   if (ier != SUCCESS) return ier;
   
-  // Do actual stress update
-  double s_prime_np1[6];
-  double s_prime_n[6];
-  double A_prime_np1[36];
-  std::copy(s_n, s_n+6, s_prime_n);
-  for (int i=0; i<6; i++) s_prime_n[i] /= (1-h_n[0]);
-
-  ier = base_->update_sd(e_np1, e_n, T_np1, T_n,
-                   t_np1, t_n, s_prime_np1, s_prime_n,
-                   &h_np1[1], &h_n[1],
-                   A_prime_np1, u_np1, u_n, p_np1, p_n);
-  if (ier != SUCCESS) return ier;
-  
-  for (int i=0; i<6; i++) s_np1[i] = (1-x[6]) * s_prime_np1[i];
+  // The base model update was done once when making the trial state
+  std::copy(tss.h_prime_np1.begin(), tss.h_prime_np1.end(), &h_np1[1]);
+  u_np1 = tss.u_prime_np1;
+  p_np1 = tss.p_prime_np1;
+
+  for (int i=0; i<6; i++) s_np1[i] = (1-x[6]) * tss.s_prime_np1[i];
   h_np1[0] = x[6];
   
   // Create the tangent
   ier = tangent_(e_np1, e_n, s_np1, s_n,
                  T_np1, T_n, t_np1, t_n, 
-                 x[6], h_n[0], A_prime_np1, A_np1);
+                 x[6], h_n[0], tss.A_prime_np1, A_np1);
   if (ier != SUCCESS) return ier;
 
   return 0;
 }
 
+bool NEMLScalarDamagedModel_sd::failed(const double * const hist) const
+{
+  return hist[0] >= w_fail_;
+}
+
 size_t NEMLScalarDamagedModel_sd::ndamage() const
 {
   return 1;
@@ -107,6 +112,17 @@ size_t NEMLScalarDamagedModel_sd::nparams() const
   return 7;
 }
 
+double NEMLScalarDamagedModel_sd::iteration_cost() const
+{
+  return newton_cost(nparams());
+}
+
+double NEMLScalarDamagedModel_sd::cost() const
+{
+  // The base model updates once per step, outside the iterations
+  return base_->cost() + solve_cost(iteration_cost()) - 1.0;
+}
+
 int NEMLScalarDamagedModel_sd::init_x(double * const x, TrialState * ts)
 {
   SDTrialState * tss = static_cast<SDTrialState *>(ts);
@@ -126,23 +142,9 @@ int NEMLScalarDamagedModel_sd::RJ(const double * const x, TrialState * ts,
   for (int i=0; i<6; i++)  s_prime_curr[i] = s_curr[i] / (1-w_curr);
 
   int res;
-  double s_prime_np1[6];
-  double s_prime_n[6];
-  double A_prime_np1[36];
-  std::vector<double> h_np1_v(base_->nhist());
-  double * h_np1 = &h_np1_v[0];
-  double u_np1;
-  double p_np1;
-  
-  std::copy(tss->s_n, tss->s_n+6, s_prime_n);
-  for (int i=0; i<6; i++) s_prime_n[i] /= (1-tss->w_n);
+  const double * s_prime_n = tss->s_prime_n;
+  const double * s_prime_np1 = tss->s_prime_np1;
 
-  res = base_->update_sd(tss->e_np1, tss->e_n, tss->T_np1, tss->T_n,
-                   tss->t_np1, tss->t_n, s_prime_np1, s_prime_n,
-                   h_np1, &tss->h_n[0],
-                   A_prime_np1, u_np1, tss->u_n, p_np1, tss->p_n);
-  if (res != SUCCESS) return res;
-  
   for (int i=0; i<6; i++) R[i] = s_curr[i] - (1-w_curr) * s_prime_np1[i];
 
   double w_np1;
@@ -186,6 +188,7 @@ int NEMLScalarDamagedModel_sd::make_trial_state(
     double u_n, double p_n,
     SDTrialState & tss)
 {
+  NEML_TRACE_SCOPE("NEMLScalarDamagedModel_sd::make_trial_state");
   std::copy(e_np1, e_np1+6, tss.e_np1);
   std::copy(e_n, e_n+6, tss.e_n);
   tss.T_np1 = T_np1;
@@ -199,7 +202,17 @@ int NEMLScalarDamagedModel_sd::make_trial_state(
   tss.p_n = p_n;
   tss.w_n = h_n[0];
 
-  return 0;
+  // None of the inputs to the base model depend on the damage, so update it
+  // here once rather than in every iteration
+  std::copy(s_n, s_n+6, tss.s_prime_n);
+  for (int i=0; i<6; i++) tss.s_prime_n[i] /= (1-tss.w_n);
+  tss.h_prime_np1.resize(base_->nhist());
+
+  return base_->update_sd(e_np1, e_n, T_np1, T_n, t_np1, t_n,
+                          tss.s_prime_np1, tss.s_prime_n,
+                          &tss.h_prime_np1[0], &tss.h_n[0],
+                          tss.A_prime_np1, tss.u_prime_np1, u_n,
+                          tss.p_prime_np1, p_n);
 }
 
 int NEMLScalarDamagedModel_sd::tangent_(
@@ -228,20 +241,41 @@ int NEMLScalarDamagedModel_sd::tangent_(
   if (ier != SUCCESS) return ier;
 
   double k1 = 1.0 - 1.0 / (1.0 - w_np1) * dot_vec(dw_ds, s_prime_np1, 6) - dw_dw;
-  double B[36];
-  std::fill(B, B+36, 0);
-  for (int i=0; i<6; i++) B[CINDEX(i,i,6)] = 1.0;
   for (int i=0; i<6; i++) dw_ds[i] /= (k1 * (1.0 - w_np1));
-  outer_update(s_prime_np1, 6, dw_ds, 6, B);
-  ier = invert_mat(B, 6);
-  if (ier != SUCCESS) return ier;
 
-  double C[36];
-  std::copy(A_prime, A_prime+36, C);
-  for (int i=0; i<36; i++) C[i] *= (1 - w_np1);
+  std::copy(A_prime, A_prime+36, A);
+  for (int i=0; i<36; i++) A[i] *= (1 - w_np1);
   for (int i=0; i<6; i++) dw_de[i] /= k1;
-  outer_update_minus(s_prime_np1, 6, dw_de, 6, C);
-  mat_mat(6, 6, 6, B, C, A);
+  outer_update_minus(s_prime_np1, 6, dw_de, 6, A);
+
+  // The left factor (I + s' dw_ds)^-1 is a rank one update of the identity
+  return rank_one_solve(s_prime_np1, dw_ds, 6, A, 6);
+}
+
+int NEMLScalarDamagedModel_sd::failed_update_(
+    const double * const e_np1, const double * const e_n, double T_np1,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1,
+    double & u_np1, double u_n, double & p_np1, double p_n)
+{
+  // The damage and base history stay fixed and the stress changes with
+  // the remaining elastic stiffness
+  std::copy(h_n, h_n+nhist(), h_np1);
+
+  int ier = elastic_->C(T_np1, A_np1);
+  if (ier != SUCCESS) return ier;
+  for (int i=0; i<36; i++) A_np1[i] *= (1.0 - h_n[0]);
+
+  double de[6];
+  sub_vec(e_np1, e_n, 6, de);
+  mat_vec(A_np1, 6, de, 6, s_np1);
+  for (int i=0; i<6; i++) s_np1[i] += s_n[i];
+
+  double ds[6];
+  add_vec(s_np1, s_n, 6, ds);
+  u_np1 = u_n + dot_vec(ds, de, 6) / 2.0;
+  p_np1 = p_n;
 
   return 0;
 }
@@ -252,8 +286,10 @@ CombinedDamageModel_sd::CombinedDamageModel_sd(
     std::vector<std::shared_ptr<NEMLScalarDamagedModel_sd>> models,
     std::shared_ptr<NEMLModel_sd> base,
     std::shared_ptr<Interpolate> alpha,
-    double tol, int miter, bool verbose, bool truesdell) :
-      NEMLScalarDamagedModel_sd(elastic, base, alpha, tol, miter, verbose, truesdell),
+    double tol, int miter, bool verbose, double w_fail,
+    bool truesdell) :
+      NEMLScalarDamagedModel_sd(elastic, base, alpha, tol, miter, verbose,
+                                w_fail, truesdell),
       models_(models)
 {
 
@@ -278,6 +314,7 @@ ParameterSet CombinedDamageModel_sd::parameters()
   pset.add_optional_parameter<double>("tol", 1.0e-8);
   pset.add_optional_parameter<int>("miter", 50);
   pset.add_optional_parameter<bool>("verbose", false);
+  pset.add_optional_parameter<double>("w_fail", 1.0);
   pset.add_optional_parameter<bool>("truesdell", true);
 
   return pset;
@@ -293,6 +330,7 @@ std::unique_ptr<NEMLObject> CombinedDamageModel_sd::initialize(ParameterSet & pa
       params.get_parameter<double>("tol"),
       params.get_parameter<int>("miter"),
       params.get_parameter<bool>("verbose"),
+      params.get_parameter<double>("w_fail"),
       params.get_parameter<bool>("truesdell")
       ); 
 }
@@ -396,8 +434,9 @@ ClassicalCreepDamageModel_sd::ClassicalCreepDamageModel_sd(
     std::shared_ptr<NEMLModel_sd> base,
     std::shared_ptr<Interpolate> alpha,
     double tol, int miter,
-    bool verbose, bool truesdell) :
-      NEMLScalarDamagedModel_sd(elastic, base, alpha, tol, miter, verbose, truesdell),
+    bool verbose, double w_fail, bool truesdell) :
+      NEMLScalarDamagedModel_sd(elastic, base, alpha, tol, miter, verbose,
+                                w_fail, truesdell),
       A_(A), xi_(xi), phi_(phi)
 {
 
@@ -424,6 +463,7 @@ ParameterSet ClassicalCreepDamageModel_sd::parameters()
   pset.add_optional_parameter<double>("tol", 1.0e-8);
   pset.add_optional_parameter<int>("miter", 50);
   pset.add_optional_parameter<bool>("verbose", false);
+  pset.add_optional_parameter<double>("w_fail", 1.0);
   pset.add_optional_parameter<bool>("truesdell", true);
 
   return pset;
@@ -441,6 +481,7 @@ std::unique_ptr<NEMLObject> ClassicalCreepDamageModel_sd::initialize(ParameterSe
       params.get_parameter<double>("tol"),
       params.get_parameter<int>("miter"),
       params.get_parameter<bool>("verbose"),
+      params.get_parameter<double>("w_fail"),
       params.get_parameter<bool>("truesdell")
       ); 
 }
@@ -453,9 +494,9 @@ int ClassicalCreepDamageModel_sd::damage(
     double t_np1, double t_n,
     double * const dd) const
 {
-  double xi = xi_->value(T_np1);
-  double A = A_->value(T_np1);
-  double phi = phi_->value(T_np1);
+  double xi = (*xi_)(T_np1);
+  double A = (*A_)(T_np1);
+  double phi = (*phi_)(T_np1);
 
   double se = this->se(s_np1);
   double dt = t_np1 - t_n;
@@ -473,9 +514,9 @@ int ClassicalCreepDamageModel_sd::ddamage_dd(
     double t_np1, double t_n,
     double * const dd) const
 {
-  double xi = xi_->value(T_np1);
-  double A = A_->value(T_np1);
-  double phi = phi_->value(T_np1);
+  double xi = (*xi_)(T_np1);
+  double A = (*A_)(T_np1);
+  double phi = (*phi_)(T_np1);
 
   double se = this->se(s_np1);
   double dt = t_np1 - t_n;
@@ -506,9 +547,9 @@ int ClassicalCreepDamageModel_sd::ddamage_ds(
     double t_np1, double t_n,
     double * const dd) const
 {
-  double xi = xi_->value(T_np1);
-  double A = A_->value(T_np1);
-  double phi = phi_->value(T_np1);
+  double xi = (*xi_)(T_np1);
+  double A = (*A_)(T_np1);
+  double phi = (*phi_)(T_np1);
 
   double se = this->se(s_np1);
   double dt = t_np1 - t_n;
@@ -540,8 +581,10 @@ NEMLStandardScalarDamagedModel_sd::NEMLStandardScalarDamagedModel_sd(
     std::shared_ptr<LinearElasticModel> elastic,
     std::shared_ptr<NEMLModel_sd> base,
     std::shared_ptr<Interpolate> alpha,
-    double tol, int miter, bool verbose, bool truesdell) :
-      NEMLScalarDamagedModel_sd(elastic, base, alpha, tol, miter, verbose, truesdell) 
+    double tol, int miter, bool verbose, double w_fail,
+    bool truesdell) :
+      NEMLScalarDamagedModel_sd(elastic, base, alpha, tol, miter, verbose,
+                                w_fail, truesdell) 
 {
 
 }
@@ -706,9 +749,9 @@ NEMLPowerLawDamagedModel_sd::NEMLPowerLawDamagedModel_sd(
     std::shared_ptr<NEMLModel_sd> base,
     std::shared_ptr<Interpolate> alpha,
     double tol, int miter,
-    bool verbose, bool truesdell) :
+    bool verbose, double w_fail, bool truesdell) :
       NEMLStandardScalarDamagedModel_sd(elastic, base, alpha, tol, miter, 
-                                        verbose, truesdell), 
+                                        verbose, w_fail, truesdell), 
       A_(A), a_(a)
 {
 
@@ -733,6 +776,7 @@ ParameterSet NEMLPowerLawDamagedModel_sd::parameters()
   pset.add_optional_parameter<double>("tol", 1.0e-8);
   pset.add_optional_parameter<int>("miter", 50);
   pset.add_optional_parameter<bool>("verbose", false);
+  pset.add_optional_parameter<double>("w_fail", 1.0);
 
   pset.add_optional_parameter<bool>("truesdell", true);
 
@@ -750,6 +794,7 @@ std::unique_ptr<NEMLObject> NEMLPowerLawDamagedModel_sd::initialize(ParameterSet
       params.get_parameter<double>("tol"),
       params.get_parameter<int>("miter"),
       params.get_parameter<bool>("verbose"),
+      params.get_parameter<double>("w_fail"),
       params.get_parameter<bool>("truesdell")
       ); 
 }
@@ -758,8 +803,8 @@ int NEMLPowerLawDamagedModel_sd::f(const double * const s_np1, double d_np1,
                                 double T_np1, double & f) const
 {
   double sev = se(s_np1);
-  double A = A_->value(T_np1);
-  double a = a_->value(T_np1);
+  double A = (*A_)(T_np1);
+  double a = (*a_)(T_np1);
 
   f = A * pow(sev, a);
 
@@ -770,8 +815,8 @@ int NEMLPowerLawDamagedModel_sd::df_ds(const double * const s_np1, double d_np1,
                                  double * const df) const
 {
   double sev = se(s_np1);
-  double A = A_->value(T_np1);
-  double a = a_->value(T_np1);
+  double A = (*A_)(T_np1);
+  double a = (*a_)(T_np1);
 
   if (sev == 0.0) {
     std::fill(df, df+6, 0.0);
@@ -808,9 +853,9 @@ NEMLExponentialWorkDamagedModel_sd::NEMLExponentialWorkDamagedModel_sd(
     std::shared_ptr<NEMLModel_sd> base,
     std::shared_ptr<Interpolate> alpha,
     double tol, int miter,
-    bool verbose, bool truesdell) :
+    bool verbose, double w_fail, bool truesdell) :
       NEMLStandardScalarDamagedModel_sd(elastic, base, alpha, tol, miter, 
-                                        verbose, truesdell), 
+                                        verbose, w_fail, truesdell), 
       W0_(W0), k0_(k0), af_(af)
 {
 
@@ -836,6 +881,7 @@ ParameterSet NEMLExponentialWorkDamagedModel_sd::parameters()
   pset.add_optional_parameter<double>("tol", 1.0e-8);
   pset.add_optional_parameter<int>("miter", 50);
   pset.add_optional_parameter<bool>("verbose", false);
+  pset.add_optional_parameter<double>("w_fail", 1.0);
 
   pset.add_optional_parameter<bool>("truesdell", true);
 
@@ -854,6 +900,7 @@ std::unique_ptr<NEMLObject> NEMLExponentialWorkDamagedModel_sd::initialize(Param
       params.get_parameter<double>("tol"),
       params.get_parameter<int>("miter"),
       params.get_parameter<bool>("verbose"),
+      params.get_parameter<double>("w_fail"),
       params.get_parameter<bool>("truesdell")
       ); 
 }
@@ -862,9 +909,9 @@ int NEMLExponentialWorkDamagedModel_sd::f(const double * const s_np1, double d_n
                                 double T_np1, double & f) const
 {
   double sev = se(s_np1);
-  double W0 = W0_->value(T_np1);
-  double k0 = k0_->value(T_np1);
-  double af = af_->value(T_np1);
+  double W0 = (*W0_)(T_np1);
+  double k0 = (*k0_)(T_np1);
+  double af = (*af_)(T_np1);
   
   // Sign, odd case during iteration
   if ((d_np1 + k0) < 0.0) {
@@ -881,9 +928,9 @@ int NEMLExponentialWorkDamagedModel_sd::df_ds(const double * const s_np1, double
                                  double * const df) const
 {
   double sev = se(s_np1);
-  double W0 = W0_->value(T_np1);
-  double k0 = k0_->value(T_np1);
-  double af = af_->value(T_np1);
+  double W0 = (*W0_)(T_np1);
+  double k0 = (*k0_)(T_np1);
+  double af = (*af_)(T_np1);
 
   if (sev == 0.0) {
     std::fill(df, df+6, 0.0);
@@ -907,9 +954,9 @@ int NEMLExponentialWorkDamagedModel_sd::df_dd(const double * const s_np1, double
                                  double & df) const
 {
   double sev = se(s_np1);
-  double W0 = W0_->value(T_np1);
-  double k0 = k0_->value(T_np1);
-  double af = af_->value(T_np1);
+  double W0 = (*W0_)(T_np1);
+  double k0 = (*k0_)(T_np1);
+  double af = (*af_)(T_np1);
 
   if ((d_np1 + k0) < 0.0) {
     df = 0.0;
@@ -57,19 +57,26 @@ class SDTrialState: public TrialState {
   double s_n[6];
   double w_n;
   std::vector<double> h_n;
+  /// Undamaged base model update, which does not depend on the damage
+  double s_prime_n[6];
+  double s_prime_np1[6];
+  double A_prime_np1[36];
+  std::vector<double> h_prime_np1;
+  double u_prime_np1, p_prime_np1;
 };
 
 /// Special case where the damage variable is a scalar
 class NEMLScalarDamagedModel_sd: public NEMLDamagedModel_sd, public Solvable {
  public:
   /// Parameters are an elastic model, a base model, the CTE, a solver
-  /// tolerance, the maximum number of solver iterations, and a verbosity
-  /// flag
+  /// tolerance, the maximum number of solver iterations, a verbosity
+  /// flag, and the damage at which the point fails
   NEMLScalarDamagedModel_sd(std::shared_ptr<LinearElasticModel> elastic,
                             std::shared_ptr<NEMLModel_sd> base,
                             std::shared_ptr<Interpolate> alpha,
                             double tol, int miter,
-                            bool verbose, bool truesdell);
+                            bool verbose, double w_fail,
+                            bool truesdell);
   
   /// Stress update using the scalar damage model
   virtual int update_sd(
@@ -86,6 +93,9 @@ class NEMLScalarDamagedModel_sd: public NEMLDamagedModel_sd, public Solvable {
   virtual size_t ndamage() const;
   /// Initialize to zero
   virtual int init_damage(double * const damage) const;
+
+  /// Failed once the damage reaches the failure threshold
+  virtual bool failed(const double * const hist) const;
   
   /// Number of parameters for the solver
   virtual size_t nparams() const;
@@ -94,7 +104,12 @@ class NEMLScalarDamagedModel_sd: public NEMLDamagedModel_sd, public Solvable {
   /// The actual nonlinear residual and Jacobian to solve
   virtual int RJ(const double * const x, TrialState * ts,double * const R,
                  double * const J);
-  /// Setup a trial state from known information
+  /// Cost of a Newton iteration on the damage equations
+  virtual double iteration_cost() const;
+  /// Includes one update of the base model
+  virtual double cost() const;
+  /// Setup a trial state from known information, including the
+  /// update of the base model
   int make_trial_state(const double * const e_np1, const double * const e_n,
                        double T_np1, double T_n, double t_np1, double t_n,
                        const double * const s_n, const double * const h_n,
@@ -137,24 +152,35 @@ class NEMLScalarDamagedModel_sd: public NEMLDamagedModel_sd, public Solvable {
                double w_np1, double w_n, const double * const A_prime,
                double * const A);
 
+ private:
+  int failed_update_(const double * const e_np1, const double * const e_n,
+                     double T_np1,
+                     double * const s_np1, const double * const s_n,
+                     double * const h_np1, const double * const h_n,
+                     double * const A_np1,
+                     double & u_np1, double u_n, double & p_np1, double p_n);
+
  protected:
   double tol_;
   int miter_;
   bool verbose_;
+  double w_fail_;
 };
 
 /// Stack multiple scalar damage models together
 class CombinedDamageModel_sd: public NEMLScalarDamagedModel_sd {
  public:
   /// Parameters: elastic model, vector of damage models, the base model
-  /// CTE, solver tolerance, solver max iterations, and a verbosity flag
+  /// CTE, solver tolerance, solver max iterations, a verbosity flag, and
+  /// the failure damage
   CombinedDamageModel_sd(
       std::shared_ptr<LinearElasticModel> elastic,
       std::vector<std::shared_ptr<NEMLScalarDamagedModel_sd>> models,
       std::shared_ptr<NEMLModel_sd> base,
       std::shared_ptr<Interpolate> alpha,
       double tol, int miter,
-      bool verbose, bool truesdell);
+      bool verbose, double w_fail,
+      bool truesdell);
   
   /// String type for the object system
   static std::string type();
@@ -206,7 +232,7 @@ class ClassicalCreepDamageModel_sd: public NEMLScalarDamagedModel_sd {
  public:
   /// Parameters are the elastic model, the parameters A, xi, phi, the
   /// base model, the CTE, the solver tolerance, maximum iterations, 
-  /// and the verbosity flag.
+  /// the verbosity flag, and the failure damage.
   ClassicalCreepDamageModel_sd(
                             std::shared_ptr<LinearElasticModel> elastic,
                             std::shared_ptr<Interpolate> A,
@@ -215,7 +241,8 @@ class ClassicalCreepDamageModel_sd: public NEMLScalarDamagedModel_sd {
                             std::shared_ptr<NEMLModel_sd> base,
                             std::shared_ptr<Interpolate> alpha,
                             double tol, int miter,
-                            bool verbose, bool truesdell);
+                            bool verbose, double w_fail,
+                            bool truesdell);
   
   /// String type for the object system
   static std::string type();
@@ -268,13 +295,14 @@ static Register<ClassicalCreepDamageModel_sd> regClassicalCreepDamageModel_sd;
 class NEMLStandardScalarDamagedModel_sd: public NEMLScalarDamagedModel_sd {
  public:
   /// Parameters: elastic model, base model, CTE, solver tolerance, 
-  /// solver maximum number of iterations, verbosity flag
+  /// solver maximum number of iterations, verbosity flag, failure damage
   NEMLStandardScalarDamagedModel_sd(
       std::shared_ptr<LinearElasticModel> elastic,
       std::shared_ptr<NEMLModel_sd> base,
       std::shared_ptr<Interpolate> alpha,
       double tol, int miter,
-      bool verbose, bool truesdell);
+      bool verbose, double w_fail,
+      bool truesdell);
   
   /// Damage, now only proportional to the inelastic effective strain
   virtual int damage(double d_np1, double d_n, 
@@ -327,14 +355,15 @@ class NEMLPowerLawDamagedModel_sd: public NEMLStandardScalarDamagedModel_sd {
  public:
   /// Parameters are an elastic model, the constants A and a, the base
   /// material model, the CTE, a solver tolerance, solver maximum number
-  /// of iterations, and a verbosity flag
+  /// of iterations, a verbosity flag, and the failure damage
   NEMLPowerLawDamagedModel_sd(
       std::shared_ptr<LinearElasticModel> elastic,
       std::shared_ptr<Interpolate> A, std::shared_ptr<Interpolate> a, 
       std::shared_ptr<NEMLModel_sd> base,
       std::shared_ptr<Interpolate> alpha,
       double tol, int miter,
-      bool verbose, bool truesdell);
+      bool verbose, double w_fail,
+      bool truesdell);
 
   /// String type for the object system
   static std::string type();
@@ -368,7 +397,7 @@ class NEMLExponentialWorkDamagedModel_sd: public NEMLStandardScalarDamagedModel_
  public:
   /// Parameters are the elastic model, parameters W0, k0, and af, the
   /// base material model, the CTE, a solver tolerance, maximum number 
-  /// of iterations, and a verbosity flag.
+  /// of iterations, a verbosity flag, and the failure damage.
   NEMLExponentialWorkDamagedModel_sd(
       std::shared_ptr<LinearElasticModel> elastic,
       std::shared_ptr<Interpolate> W0, std::shared_ptr<Interpolate> k0,
@@ -376,7 +405,8 @@ class NEMLExponentialWorkDamagedModel_sd: public NEMLStandardScalarDamagedModel_
       std::shared_ptr<NEMLModel_sd> base,
       std::shared_ptr<Interpolate> alpha,
       double tol, int miter,
-      bool verbose, bool truesdell);
+      bool verbose, double w_fail,
+      bool truesdell);
 
   /// String type for the object system
   static std::string type();
@@ -0,0 +1,289 @@
+#ifndef DUAL_H
+#define DUAL_H
+
+#include "nemlmath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+/// Fully unroll the loops over the directions
+//  At -O2 the compilers leave these short loops rolled, which makes the
+//  dual numbers several times slower.
+#if defined(__clang__) || defined(__INTEL_COMPILER)
+#define NEML_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && (__GNUC__ >= 8)
+#define NEML_UNROLL _Pragma("GCC unroll 16")
+#else
+#define NEML_UNROLL
+#endif
+
+namespace neml {
+
+/// Forward mode automatic differentiation with N derivative directions
+//  A value carries its derivatives along N directions through every
+//  operation, so a function written once against a template type gives
+//  exact derivatives when called with Dual<N> in place of double.  The
+//  size is fixed at compile time so a value needs no allocation and the
+//  loops over the directions unroll.  Comparisons only look at the value,
+//  so branches follow the value like the double version.
+template <size_t N>
+class Dual {
+ public:
+  /// Zero
+  Dual() : v_(0.0)
+  {
+    NEML_UNROLL for (size_t i = 0; i < N; i++) d_[i] = 0.0;
+  }
+
+  /// A constant
+  Dual(double v) : v_(v)
+  {
+    NEML_UNROLL for (size_t i = 0; i < N; i++) d_[i] = 0.0;
+  }
+
+  /// An input, with a unit derivative in direction i
+  Dual(double v, size_t i) : v_(v)
+  {
+    NEML_UNROLL for (size_t j = 0; j < N; j++) d_[j] = 0.0;
+    d_[i] = 1.0;
+  }
+
+  /// Number of directions
+  static constexpr size_t size() {return N;}
+
+  /// The value
+  double value() const {return v_;}
+  /// The derivative in direction i
+  double deriv(size_t i) const {return d_[i];}
+  /// The derivative in direction i
+  double & deriv(size_t i) {return d_[i];}
+
+  Dual & operator+=(const Dual & b)
+  {
+    v_ += b.v_;
+    NEML_UNROLL for (size_t i = 0; i < N; i++) d_[i] += b.d_[i];
+    return *this;
+  }
+
+  Dual & operator-=(const Dual & b)
+  {
+    v_ -= b.v_;
+    NEML_UNROLL for (size_t i = 0; i < N; i++) d_[i] -= b.d_[i];
+    return *this;
+  }
+
+  Dual & operator*=(const Dual & b)
+  {
+    NEML_UNROLL for (size_t i = 0; i < N; i++)
+      d_[i] = d_[i] * b.v_ + v_ * b.d_[i];
+    v_ *= b.v_;
+    return *this;
+  }
+
+  Dual & operator/=(const Dual & b)
+  {
+    double ib = 1.0 / b.v_;
+    v_ *= ib;
+    NEML_UNROLL for (size_t i = 0; i < N; i++)
+      d_[i] = (d_[i] - v_ * b.d_[i]) * ib;
+    return *this;
+  }
+
+  Dual & operator+=(double b)
+  {
+    v_ += b;
+    return *this;
+  }
+
+  Dual & operator-=(double b)
+  {
+    v_ -= b;
+    return *this;
+  }
+
+  Dual & operator*=(double b)
+  {
+    v_ *= b;
+    NEML_UNROLL for (size_t i = 0; i < N; i++) d_[i] *= b;
+    return *this;
+  }
+
+  Dual & operator/=(double b)
+  {
+    return *this *= (1.0 / b);
+  }
+
+  friend Dual operator-(const Dual & a)
+  {
+    Dual r(a);
+    r.v_ = -r.v_;
+    NEML_UNROLL for (size_t i = 0; i < N; i++) r.d_[i] = -r.d_[i];
+    return r;
+  }
+
+  friend Dual operator+(Dual a, const Dual & b) {return a += b;}
+  friend Dual operator+(Dual a, double b) {return a += b;}
+  friend Dual operator+(double a, Dual b) {return b += a;}
+  friend Dual operator-(Dual a, const Dual & b) {return a -= b;}
+  friend Dual operator-(Dual a, double b) {return a -= b;}
+  friend Dual operator-(double a, const Dual & b) {return -b + a;}
+  friend Dual operator*(Dual a, const Dual & b) {return a *= b;}
+  friend Dual operator*(Dual a, double b) {return a *= b;}
+  friend Dual operator*(double a, Dual b) {return b *= a;}
+  friend Dual operator/(Dual a, const Dual & b) {return a /= b;}
+  friend Dual operator/(Dual a, double b) {return a /= b;}
+  friend Dual operator/(double a, const Dual & b) {return Dual(a) /= b;}
+
+  friend bool operator<(const Dual & a, const Dual & b) {return a.v_ < b.v_;}
+  friend bool operator<=(const Dual & a, const Dual & b) {return a.v_ <= b.v_;}
+  friend bool operator>(const Dual & a, const Dual & b) {return a.v_ > b.v_;}
+  friend bool operator>=(const Dual & a, const Dual & b) {return a.v_ >= b.v_;}
+  friend bool operator==(const Dual & a, const Dual & b) {return a.v_ == b.v_;}
+  friend bool operator!=(const Dual & a, const Dual & b) {return a.v_ != b.v_;}
+
+  friend Dual sqrt(const Dual & a)
+  {
+    double v = std::sqrt(a.v_);
+    return chain_(a, v, 0.5 / v);
+  }
+
+  friend Dual exp(const Dual & a)
+  {
+    double v = std::exp(a.v_);
+    return chain_(a, v, v);
+  }
+
+  friend Dual log(const Dual & a)
+  {
+    return chain_(a, std::log(a.v_), 1.0 / a.v_);
+  }
+
+  friend Dual log10(const Dual & a)
+  {
+    return chain_(a, std::log10(a.v_), 1.0 / (a.v_ * std::log(10.0)));
+  }
+
+  friend Dual pow(const Dual & a, double b)
+  {
+    double v = std::pow(a.v_, b);
+    if (a.v_ != 0.0) return chain_(a, v, b * v / a.v_);
+
+    // At a zero base the slope is zero for b = 0 and b > 1 and one for
+    // b = 1.  Below that it is unbounded, but only along the directions
+    // that move the base.
+    Dual r(v);
+    if ((b == 0.0) || (b > 1.0)) return r;
+    double df = (b == 1.0) ? 1.0 : b * std::numeric_limits<double>::infinity();
+    NEML_UNROLL for (size_t i = 0; i < N; i++) {
+      r.d_[i] = (a.d_[i] == 0.0) ? 0.0 : df * a.d_[i];
+    }
+    return r;
+  }
+
+  friend Dual pow(double a, const Dual & b)
+  {
+    double v = std::pow(a, b.v_);
+    return chain_(b, v, v * std::log(a));
+  }
+
+  friend Dual pow(const Dual & a, const Dual & b)
+  {
+    return exp(b * log(a));
+  }
+
+  friend Dual fabs(const Dual & a)
+  {
+    return (a.v_ < 0.0) ? -a : a;
+  }
+
+  friend Dual copysign(const Dual & a, const Dual & b)
+  {
+    return ((a.v_ < 0.0) == (b.v_ < 0.0)) ? a : -a;
+  }
+
+  friend Dual sin(const Dual & a)
+  {
+    return chain_(a, std::sin(a.v_), std::cos(a.v_));
+  }
+
+  friend Dual cos(const Dual & a)
+  {
+    return chain_(a, std::cos(a.v_), -std::sin(a.v_));
+  }
+
+  friend Dual sinh(const Dual & a)
+  {
+    return chain_(a, std::sinh(a.v_), std::cosh(a.v_));
+  }
+
+  friend Dual cosh(const Dual & a)
+  {
+    return chain_(a, std::cosh(a.v_), std::sinh(a.v_));
+  }
+
+  friend Dual tanh(const Dual & a)
+  {
+    double v = std::tanh(a.v_);
+    return chain_(a, v, 1.0 - v * v);
+  }
+
+ private:
+  // f(a) with value v and derivative df
+  static Dual chain_(const Dual & a, double v, double df)
+  {
+    Dual r;
+    r.v_ = v;
+    NEML_UNROLL for (size_t i = 0; i < N; i++) r.d_[i] = df * a.d_[i];
+    return r;
+  }
+
+  double v_;
+  double d_[N];
+};
+
+/// The value of a double, for code templated on double or Dual
+inline double dual_value(double a) {return a;}
+/// The value of a Dual
+template <size_t N>
+double dual_value(const Dual<N> & a) {return a.value();}
+
+/// Jacobian of a function of two vectors wrt one of them
+//  f(x, y, out) takes arrays of Dual<N> and writes m outputs.  The
+//  jacobian wrt x (wrt_x true) or y is written as an m x n row major
+//  matrix, in chunks of N directions, so it takes n/N calls rounded up.
+template <size_t N, class F>
+int dual_jacobian(const F & f, const double * const x, size_t nx,
+                  const double * const y, size_t ny, size_t m, bool wrt_x,
+                  double * const J)
+{
+  // Per thread scratch, reused between calls, with its own buffers for a
+  // nested call
+  Scratch<Dual<N>> xd(nx), yd(ny), out(m);
+  size_t n = wrt_x ? nx : ny;
+
+  for (size_t c = 0; c < n; c += N) {
+    size_t nc = std::min(N, n - c);
+    for (size_t i = 0; i < nx; i++) xd[i] = Dual<N>(x[i]);
+    for (size_t i = 0; i < ny; i++) yd[i] = Dual<N>(y[i]);
+    Dual<N> * seed = wrt_x ? xd.data() : yd.data();
+    const double * base = wrt_x ? x : y;
+    for (size_t j = 0; j < nc; j++) seed[c+j] = Dual<N>(base[c+j], j);
+
+    int ier = f(xd.data(), yd.data(), out.data());
+    if (ier != 0) return ier;
+
+    for (size_t i = 0; i < m; i++) {
+      for (size_t j = 0; j < nc; j++) {
+        J[i*n+c+j] = out[i].deriv(j);
+      }
+    }
+  }
+
+  return 0;
+}
+
+} // namespace neml
+
+#endif // DUAL_H
@@ -13,6 +13,11 @@ bool LinearElasticModel::valid() const
   return false;
 }
 
+bool LinearElasticModel::constant() const
+{
+  return false;
+}
+
 IsotropicLinearElasticModel::IsotropicLinearElasticModel(
       std::shared_ptr<Interpolate> m1,
       std::string m1_type,
@@ -29,6 +34,14 @@ IsotropicLinearElasticModel::IsotropicLinearElasticModel(
   if (valid_types_.find(m2_type) == valid_types_.end()) {
     throw std::invalid_argument("Unknown elastic constant " + m2_type);
   }
+
+  // Work out the tensors once, instead of on every call
+  constant_ = m1_->constant() && m2_->constant();
+  if (constant_) {
+    convert_GK_((*m1_)(0.0), (*m2_)(0.0), G_, K_);
+    C_calc_(G_, K_, C_);
+    S_calc_(G_, K_, S_);
+  }
 }
 
 std::string IsotropicLinearElasticModel::type()
@@ -60,6 +73,10 @@ std::unique_ptr<NEMLObject> IsotropicLinearElasticModel::initialize(ParameterSet
 
 int IsotropicLinearElasticModel::C(double T, double * const Cv) const
 {
+  if (constant_) {
+    std::copy(C_, C_+36, Cv);
+    return 0;
+  }
   double G, K;
   get_GK_(T, G, K);
 
@@ -68,6 +85,10 @@ int IsotropicLinearElasticModel::C(double T, double * const Cv) const
 
 int IsotropicLinearElasticModel::S(double T, double * const Sv) const
 {
+  if (constant_) {
+    std::copy(S_, S_+36, Sv);
+    return 0;
+  }
   double G, K;
   get_GK_(T, G, K);
 
@@ -165,11 +186,24 @@ bool IsotropicLinearElasticModel::valid() const
   return true;
 }
 
+bool IsotropicLinearElasticModel::constant() const
+{
+  return constant_;
+}
+
 void IsotropicLinearElasticModel::get_GK_(double T, double & G, double & K) const
 {
-  double m1 = m1_->value(T);
-  double m2 = m2_->value(T);
+  if (constant_) {
+    G = G_;
+    K = K_;
+    return;
+  }
+  convert_GK_((*m1_)(T), (*m2_)(T), G, K);
+}
 
+void IsotropicLinearElasticModel::convert_GK_(double m1, double m2,
+                                              double & G, double & K) const
+{
   if (m1_type_ == "shear" and m2_type_ == "bulk") {
     G = m1;
     K = m2;
@@ -31,6 +31,8 @@ class LinearElasticModel: public NEMLObject {
   
   /// Is this a valid, usable model?
   virtual bool valid() const;
+  /// Are the properties independent of temperature?
+  virtual bool constant() const;
 };
 
 /// Isotropic shear modulus generating properties from shear and bulk models
@@ -66,16 +68,22 @@ class IsotropicLinearElasticModel: public LinearElasticModel {
   
   /// This is a valid model
   virtual bool valid() const;
+  /// Constant if both the elastic constants are
+  virtual bool constant() const;
 
  private:
   int C_calc_(double G, double K, double * const Cv) const;
   int S_calc_(double G, double K, double * const Sv) const;
 
   void get_GK_(double T, double & G, double & K) const;
+  void convert_GK_(double m1, double m2, double & G, double & K) const;
   
  private:
   std::shared_ptr<Interpolate> m1_, m2_;
   std::string m1_type_, m2_type_;
+  // Properties folded at construction when both constants are constant
+  bool constant_;
+  double G_, K_, C_[36], S_[36];
   const std::set<std::string> valid_types_ = {"bulk", "shear", 
     "youngs", "poissons"};
 };
@@ -38,6 +38,7 @@ PYBIND11_MODULE(elasticity, m) {
       .def("G", &LinearElasticModel::G, "Shear modulus as a function of temperature.")
       .def("K", &LinearElasticModel::K, "Bulk modulus as a function of temperature.")
       .def_property_readonly("valid", &LinearElasticModel::valid, "Good or dummy model.")
+      .def_property_readonly("constant", &LinearElasticModel::constant, "Independent of temperature.")
       ;
 
   py::class_<IsotropicLinearElasticModel, LinearElasticModel, std::shared_ptr<IsotropicLinearElasticModel>>(m, "IsotropicLinearElasticModel")
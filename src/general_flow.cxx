@@ -85,10 +85,13 @@ int TVPFlowRule::s(const double * const s, const double * const alpha,
     erate[i] -= yv * temp[i];
   }
 
-  ier = flow_->g_temp(s, alpha, T, temp);
-  if (ier != SUCCESS) return ier;
-  for (int i=0; i<6; i++) {
-    erate[i] -= Tdot * temp[i];
+  // Isothermal steps skip the temperature rate terms
+  if (Tdot != 0.0) {
+    ier = flow_->g_temp(s, alpha, T, temp);
+    if (ier != SUCCESS) return ier;
+    for (int i=0; i<6; i++) {
+      erate[i] -= Tdot * temp[i];
+    }
   }
 
   ier = flow_->g_time(s, alpha, T, temp);
@@ -131,10 +134,12 @@ int TVPFlowRule::ds_ds(const double * const s, const double * const alpha,
   outer_update_minus(t1, 6, t2, 6, work);
   
   double t3[36];
-  ier = flow_->dg_ds_temp(s, alpha, T, t3);
-  if (ier != SUCCESS) return ier;
-  for (int i=0; i<36; i++) {
-    work[i] -= t3[i] * Tdot;
+  if (Tdot != 0.0) {
+    ier = flow_->dg_ds_temp(s, alpha, T, t3);
+    if (ier != SUCCESS) return ier;
+    for (int i=0; i<36; i++) {
+      work[i] -= t3[i] * Tdot;
+    }
   }
 
   ier = flow_->dg_ds_time(s, alpha, T, t3);
@@ -181,10 +186,12 @@ int TVPFlowRule::ds_da(const double * const s, const double * const alpha,
   
   std::vector<double> t3v(sz);
   double * t3 = &t3v[0];
-  ier = flow_->dg_da_temp(s, alpha, T, t3);
-  if (ier != SUCCESS) return ier; 
-  for (int i=0; i<sz; i++) {
-    work[i] -= t3[i] * Tdot;
+  if (Tdot != 0.0) {
+    ier = flow_->dg_da_temp(s, alpha, T, t3);
+    if (ier != SUCCESS) return ier;
+    for (int i=0; i<sz; i++) {
+      work[i] -= t3[i] * Tdot;
+    }
   }
 
   ier = flow_->dg_da_time(s, alpha, T, t3);
@@ -225,9 +232,11 @@ int TVPFlowRule::a(const double * const s, const double * const alpha,
   
   std::vector<double> tempv(nhist());
   double * temp = &tempv[0];
-  ier = flow_->h_temp(s, alpha, T, temp);
-  if (ier != SUCCESS) return ier;
-  for (size_t i=0; i<nhist(); i++) adot[i] += temp[i] * Tdot;
+  if (Tdot != 0.0) {
+    ier = flow_->h_temp(s, alpha, T, temp);
+    if (ier != SUCCESS) return ier;
+    for (size_t i=0; i<nhist(); i++) adot[i] += temp[i] * Tdot;
+  }
 
   ier = flow_->h_time(s, alpha, T, temp);
   if (ier != SUCCESS) return ier;
@@ -265,9 +274,11 @@ int TVPFlowRule::da_ds(const double * const s, const double * const alpha,
   
   std::vector<double> t3v(sz);
   double * t3 = &t3v[0];
-  ier = flow_->dh_ds_temp(s, alpha, T, t3);
-  if (ier != SUCCESS) return ier;
-  for (int i=0; i<sz; i++) d_adot[i] += t3[i] * Tdot;
+  if (Tdot != 0.0) {
+    ier = flow_->dh_ds_temp(s, alpha, T, t3);
+    if (ier != SUCCESS) return ier;
+    for (int i=0; i<sz; i++) d_adot[i] += t3[i] * Tdot;
+  }
 
   ier = flow_->dh_ds_time(s, alpha, T, t3);
   if (ier != SUCCESS) return ier;
@@ -306,9 +317,11 @@ int TVPFlowRule::da_da(const double * const s, const double * const alpha,
   
   std::vector<double> t3v(sz);
   double * t3 = &t3v[0];
-  ier = flow_->dh_da_temp(s, alpha, T, t3);
-  if (ier != SUCCESS) return ier;
-  for (int i=0; i<sz; i++) d_adot[i] += t3[i] * Tdot;
+  if (Tdot != 0.0) {
+    ier = flow_->dh_da_temp(s, alpha, T, t3);
+    if (ier != SUCCESS) return ier;
+    for (int i=0; i<sz; i++) d_adot[i] += t3[i] * Tdot;
+  }
 
   ier = flow_->dh_da_time(s, alpha, T, t3);
   if (ier != SUCCESS) return ier;
@@ -346,10 +359,12 @@ int TVPFlowRule::work_rate(const double * const s,
     erate[i] += yv * temp[i];
   }
 
-  ier = flow_->g_temp(s, alpha, T, temp);
-  if (ier != SUCCESS) return ier;
-  for (int i=0; i<6; i++) {
-    erate[i] += Tdot * temp[i];
+  if (Tdot != 0.0) {
+    ier = flow_->g_temp(s, alpha, T, temp);
+    if (ier != SUCCESS) return ier;
+    for (int i=0; i<6; i++) {
+      erate[i] += Tdot * temp[i];
+    }
   }
 
   ier = flow_->g_time(s, alpha, T, temp);
@@ -56,7 +56,7 @@ std::unique_ptr<NEMLObject> LinearIsotropicHardeningRule::initialize(ParameterSe
 int LinearIsotropicHardeningRule::q(const double * const alpha, 
                                     double T, double * const qv) const
 {
-  qv[0] = -s0_->value(T) - K_->value(T) * alpha[0];
+  qv[0] = -(*s0_)(T) - (*K_)(T) * alpha[0];
 
   return 0;
 }
@@ -64,19 +64,19 @@ int LinearIsotropicHardeningRule::q(const double * const alpha,
 int LinearIsotropicHardeningRule::dq_da(const double * const alpha, 
                                     double T, double * const dqv) const
 {
-  dqv[0] = -K_->value(T);
+  dqv[0] = -(*K_)(T);
 
   return 0;
 }
 
 double LinearIsotropicHardeningRule::s0(double T) const
 {
-  return s0_->value(T);
+  return (*s0_)(T);
 }
 
 double LinearIsotropicHardeningRule::K(double T) const
 {
-  return K_->value(T);
+  return (*K_)(T);
 }
 
 
@@ -111,7 +111,7 @@ std::unique_ptr<NEMLObject> InterpolatedIsotropicHardeningRule::initialize(Param
 int InterpolatedIsotropicHardeningRule::q(const double * const alpha,
                                           double T, double * const qv) const
 {
-  qv[0] = -flow_->value(alpha[0]);
+  qv[0] = -(*flow_)(alpha[0]);
   return 0;
 }
 
@@ -158,7 +158,7 @@ std::unique_ptr<NEMLObject> VoceIsotropicHardeningRule::initialize(ParameterSet
 int VoceIsotropicHardeningRule::q(const double * const alpha, 
                                     double T, double * const qv) const
 {
-  qv[0] = -s0_->value(T) - R_->value(T) * (1.0 - exp(-d_->value(T) * alpha[0]));
+  qv[0] = -(*s0_)(T) - (*R_)(T) * (1.0 - exp(-(*d_)(T) * alpha[0]));
 
   return 0;
 }
@@ -166,24 +166,24 @@ int VoceIsotropicHardeningRule::q(const double * const alpha,
 int VoceIsotropicHardeningRule::dq_da(const double * const alpha, 
                                     double T, double * const dqv) const
 {
-  dqv[0] = -d_->value(T) * R_->value(T) * exp(-d_->value(T) * alpha[0]);
+  dqv[0] = -(*d_)(T) * (*R_)(T) * exp(-(*d_)(T) * alpha[0]);
 
   return 0;
 }
 
 double VoceIsotropicHardeningRule::s0(double T) const
 {
-  return s0_->value(T);
+  return (*s0_)(T);
 }
 
 double VoceIsotropicHardeningRule::R(double T) const
 {
-  return R_->value(T);
+  return (*R_)(T);
 }
 
 double VoceIsotropicHardeningRule::d(double T) const
 {
-  return d_->value(T);
+  return (*d_)(T);
 }
 
 // Implementation of combined isotropic class
@@ -295,7 +295,7 @@ int LinearKinematicHardeningRule::q(const double * const alpha,
                                     double T, double * const qv) const
 {
   for (int i=0; i<6; i++) {
-    qv[i] = -H_->value(T) * alpha[i];
+    qv[i] = -(*H_)(T) * alpha[i];
   }
 
   return 0;
@@ -306,7 +306,7 @@ int LinearKinematicHardeningRule::dq_da(const double * const alpha,
 {
   std::fill(dqv, dqv+36, 0.0);
   for (int i=0; i<6; i++) {
-    dqv[CINDEX(i,i,6)] = -H_->value(T);
+    dqv[CINDEX(i,i,6)] = -(*H_)(T);
   }
 
   return 0;
@@ -314,7 +314,7 @@ int LinearKinematicHardeningRule::dq_da(const double * const alpha,
 
 double LinearKinematicHardeningRule::H(double T) const
 {
-  return H_->value(T);
+  return (*H_)(T);
 }
 
 CombinedHardeningRule::CombinedHardeningRule(
@@ -484,7 +484,7 @@ std::unique_ptr<NEMLObject> ConstantGamma::initialize(ParameterSet & params)
 }
 
 double ConstantGamma::gamma(double ep, double T) const {
-  return g_->value(T);
+  return (*g_)(T);
 }
 
 double ConstantGamma::dgamma(double ep, double T) const {
@@ -492,7 +492,7 @@ double ConstantGamma::dgamma(double ep, double T) const {
 }
 
 double ConstantGamma::g(double T) const {
-  return g_->value(T);
+  return (*g_)(T);
 }
 
 //
@@ -530,23 +530,23 @@ std::unique_ptr<NEMLObject> SatGamma::initialize(ParameterSet & params)
 }
 
 double SatGamma::gamma(double ep, double T) const {
-  return gs_->value(T) + (g0_->value(T) - gs_->value(T)) * exp(-beta_->value(T) * ep);
+  return (*gs_)(T) + ((*g0_)(T) - (*gs_)(T)) * exp(-(*beta_)(T) * ep);
 }
 
 double SatGamma::dgamma(double ep, double T) const {
-  return beta_->value(T) * (gs_->value(T) - g0_->value(T)) * exp(-beta_->value(T) * ep);
+  return (*beta_)(T) * ((*gs_)(T) - (*g0_)(T)) * exp(-(*beta_)(T) * ep);
 }
 
 double SatGamma::gs(double T) const {
-  return gs_->value(T);
+  return (*gs_)(T);
 }
 
 double SatGamma::g0(double T) const {
-  return g0_->value(T);
+  return (*g0_)(T);
 }
 
 double SatGamma::beta(double T) const {
-  return beta_->value(T);
+  return (*beta_)(T);
 }
 
 //
@@ -9,14 +9,15 @@
 namespace neml {
 
 Interpolate::Interpolate() :
-    valid_(true)
+    valid_(true), folded_(false), folded_value_(0.0)
 {
 
 }
 
-double Interpolate::operator()(double x) const
+void Interpolate::fold_()
 {
-  return value(x);
+  folded_ = valid_ && constant();
+  if (folded_) folded_value_ = value(0.0);
 }
 
 bool Interpolate::valid() const
@@ -24,14 +25,20 @@ bool Interpolate::valid() const
   return valid_;
 }
 
+bool Interpolate::constant() const
+{
+  return false;
+}
+
 PolynomialInterpolate::PolynomialInterpolate(const std::vector<double> coefs) :
     Interpolate(), coefs_(coefs)
 {
   int n = coefs_.size();
-  deriv_.resize(n - 1);
+  deriv_.resize(std::max(n - 1, 0));
   for (int i = 0; i < n - 1; i++) {
     deriv_[i] = coefs_[i] * ((double) (n - 1 - i));
   }
+  fold_();
 }
 
 std::string PolynomialInterpolate::type()
@@ -57,12 +64,17 @@ std::unique_ptr<NEMLObject> PolynomialInterpolate::initialize(ParameterSet & par
 
 double PolynomialInterpolate::value(double x) const
 {
-  return polyval(&coefs_[0], coefs_.size(), x);
+  return polyval(coefs_.data(), coefs_.size(), x);
 }
 
 double PolynomialInterpolate::derivative(double x) const
 {
-  return polyval(&deriv_[0], deriv_.size(), x);
+  return polyval(deriv_.data(), deriv_.size(), x);
+}
+
+bool PolynomialInterpolate::constant() const
+{
+  return coefs_.size() <= 1;
 }
 
 
@@ -79,6 +91,8 @@ PiecewiseLinearInterpolate::PiecewiseLinearInterpolate(
   if (points.size() != values.size()) {
     valid_ = false;
   }
+
+  fold_();
 }
 
 std::string PiecewiseLinearInterpolate::type()
@@ -150,6 +164,13 @@ double PiecewiseLinearInterpolate::derivative(double x) const
   }
 }
 
+bool PiecewiseLinearInterpolate::constant() const
+{
+  if (not valid_ || values_.empty()) return false;
+  return std::all_of(values_.begin(), values_.end(),
+                     [this](double v) {return v == values_.front();});
+}
+
 GenericPiecewiseInterpolate::GenericPiecewiseInterpolate(
     std::vector<double> points,
     std::vector<std::shared_ptr<Interpolate>> functions) :
@@ -318,7 +339,7 @@ double PiecewiseLogLinearInterpolate::derivative(double x) const
 ConstantInterpolate::ConstantInterpolate(double v) :
     Interpolate(), v_(v)
 {
-
+  fold_();
 }
 
 std::string ConstantInterpolate::type()
@@ -352,6 +373,11 @@ double ConstantInterpolate::derivative(double x) const
   return 0.0;
 }
 
+bool ConstantInterpolate::constant() const
+{
+  return true;
+}
+
 ExpInterpolate::ExpInterpolate(double A, double B) :
     Interpolate(), A_(A), B_(B)
 {
@@ -447,7 +473,7 @@ std::vector<double> eval_vector(
 {
   std::vector<double> vt;
   for (auto it = iv.begin(); it != iv.end(); ++it) {
-    vt.push_back((*it)->value(x));
+    vt.push_back((**it)(x));
   }
   return vt;
 }
@@ -18,13 +18,31 @@ class Interpolate: public NEMLObject {
   virtual double value(double x) const = 0;
   /// Returns the derivative of the function
   virtual double derivative(double x) const = 0;
-  /// Nice wrapper for function call syntax
-  double operator()(double x) const;
+  /// Nice wrapper for function call syntax, which returns a folded
+  /// constant without the virtual call
+  double operator()(double x) const
+  {
+    if (folded_) return folded_value_;
+    return value(x);
+  }
   /// Is the interpolate valid?
   bool valid() const;
+  /// Is the function independent of x?
+  //  Objects can check this when they are built and fold the value into a
+  //  constant instead of calling value every time.
+  virtual bool constant() const;
+
+ protected:
+  /// Fold a constant function for operator(), called at the end of the
+  /// constructors of the classes that can be constant
+  void fold_();
 
  protected:
   bool valid_;
+
+ private:
+  bool folded_;
+  double folded_value_;
 };
 
 /// Simple polynomial interpolation
@@ -42,6 +60,8 @@ class PolynomialInterpolate : public Interpolate {
   
   virtual double value(double x) const;
   virtual double derivative(double x) const;
+  /// Constant if it has only the zeroth order term
+  virtual bool constant() const;
 
  private:
   const std::vector<double> coefs_;
@@ -90,6 +110,8 @@ class PiecewiseLinearInterpolate: public Interpolate {
 
   virtual double value(double x) const;
   virtual double derivative(double x) const;
+  /// Constant if all the values are the same
+  virtual bool constant() const;
 
  private:
   const std::vector<double> points_, values_;
@@ -137,6 +159,8 @@ class ConstantInterpolate : public Interpolate {
 
   virtual double value(double x) const;
   virtual double derivative(double x) const;
+  /// Always constant
+  virtual bool constant() const;
 
  private:
   const double v_;
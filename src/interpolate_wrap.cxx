@@ -24,6 +24,7 @@ PYBIND11_MODULE(interpolate, m) {
             return m(x);
            }, "Operator overload ()")
       .def_property_readonly("valid", &Interpolate::valid)
+      .def_property_readonly("constant", &Interpolate::constant, "Independent of x.")
       ;
 
   py::class_<PolynomialInterpolate, Interpolate, std::shared_ptr<PolynomialInterpolate>>(m, "PolynomialInterpolate")
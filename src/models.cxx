@@ -2,12 +2,272 @@
 
 #include "nemlmath.h"
 #include "nemlerror.h"
+#include "trace.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
 #include <limits>
+#include <stdexcept>
 
 namespace neml {
 
+// Settings for the suggested step scale
+const double scale_min = 0.25;    // Largest cut
+const double scale_max = 1.5;     // Largest growth
+const double scale_fail = 0.5;    // Plain cut for a failed solve
+const int iter_target = 6;        // Newton iterations to aim for
+const double rate_target = 0.25;  // Acceptable residual contraction
+const double dep_target = 5.0e-3; // Equivalent inelastic strain per step
+
+double suggest_step_scale(const SolveStats & stats, double dep, int ier)
+{
+  if (ier != SUCCESS) {
+    // Substepping gave up or the solve diverged: cut hard
+    if (stats.exhausted || (stats.rate >= 1.0)) return scale_min;
+    return scale_fail;
+  }
+
+  double scale = scale_max;
+
+  // Each subdivision means the step was twice as large as it should be
+  if (stats.ndivide > 0) {
+    scale = std::min(scale, pow(0.5, stats.ndivide));
+  }
+
+  // Iteration count and rate of convergence
+  if (stats.max_iter > 0) {
+    scale = std::min(scale, sqrt((double) iter_target / 
+                                 (double) stats.max_iter));
+  }
+  if (stats.rate > rate_target) {
+    scale = std::min(scale, sqrt(rate_target / stats.rate));
+  }
+
+  // Accuracy limit on the inelastic strain
+  if (dep > 0.0) {
+    scale = std::min(scale, dep_target / dep);
+  }
+
+  return std::max(scale_min, std::min(scale_max, scale));
+}
+
+// Cash-Karp embedded Runge-Kutta tableau
+const double ck_c[6] = {0.0, 1.0/5.0, 3.0/10.0, 3.0/5.0, 1.0, 7.0/8.0};
+const double ck_a[6][5] = {
+  {0.0, 0.0, 0.0, 0.0, 0.0},
+  {1.0/5.0, 0.0, 0.0, 0.0, 0.0},
+  {3.0/40.0, 9.0/40.0, 0.0, 0.0, 0.0},
+  {3.0/10.0, -9.0/10.0, 6.0/5.0, 0.0, 0.0},
+  {-11.0/54.0, 5.0/2.0, -70.0/27.0, 35.0/27.0, 0.0},
+  {1631.0/55296.0, 175.0/512.0, 575.0/13824.0, 44275.0/110592.0,
+    253.0/4096.0}};
+const double ck_b5[6] = {37.0/378.0, 0.0, 250.0/621.0, 125.0/594.0, 0.0,
+  512.0/1771.0};
+const double ck_b4[6] = {2825.0/27648.0, 0.0, 18575.0/48384.0,
+  13525.0/55296.0, 277.0/14336.0, 1.0/4.0};
+
+// Integrate y' = f(y, tau) from tau = 0 to dt with the Cash-Karp pair,
+// subcycling to keep the error below etol.  The error in each component
+// is measured relative to 1 + |y| after multiplying by the weight w.
+// This is the stability guard as well: stiff problems force tiny steps,
+// so give up with MAX_ITERATIONS as soon as the remaining steps will
+// not fit in max_steps.
+template <class F>
+int cash_karp(F f, std::vector<double> & y, double dt,
+              const std::vector<double> & w, double etol, int max_steps)
+{
+  size_t n = y.size();
+  std::vector<double> k(6*n);
+  std::vector<double> ys(n);
+  std::vector<double> yn(n);
+
+  double tau = 0.0;
+  double h = dt;
+  int nsteps = 0;
+  while (tau < dt) {
+    if (++nsteps > max_steps) return MAX_ITERATIONS;
+    bool last = (h >= dt - tau);
+    if (last) h = dt - tau;
+
+    int ier = SUCCESS;
+    for (int s=0; s<6; s++) {
+      ys = y;
+      for (int j=0; j<s; j++) {
+        for (size_t i=0; i<n; i++) ys[i] += h * ck_a[s][j] * k[j*n+i];
+      }
+      ier = f(&ys[0], tau + ck_c[s] * h, &k[s*n]);
+      if (ier != SUCCESS) break;
+    }
+
+    // Scaled so that one is just acceptable
+    double err = 0.0;
+    if (ier == SUCCESS) {
+      for (size_t i=0; i<n; i++) {
+        double d = 0.0;
+        yn[i] = y[i];
+        for (int s=0; s<6; s++) {
+          yn[i] += h * ck_b5[s] * k[s*n+i];
+          d += h * (ck_b5[s] - ck_b4[s]) * k[s*n+i];
+        }
+        double ei = w[i] * fabs(d) / (etol * (1.0 + w[i] *
+                    std::max(fabs(y[i]), fabs(yn[i]))));
+        if (!(ei <= err)) err = ei;   // Keeps NaNs
+      }
+    }
+
+    double fact;
+    if ((ier != SUCCESS) || !std::isfinite(err)) {
+      fact = 0.2;
+    }
+    else {
+      if (err <= 1.0) {
+        y = yn;
+        tau = last ? dt : tau + h;
+      }
+      fact = (err > 0.0) ? 0.9 * pow(err, -0.2) : 5.0;
+      fact = std::max(0.2, std::min(5.0, fact));
+    }
+    h *= fact;
+
+    if ((tau < dt) && ((dt - tau) / h > (double) (max_steps - nsteps))) {
+      return MAX_ITERATIONS;
+    }
+  }
+
+  return 0;
+}
+
+// NEMLModel implementation
+static std::atomic<size_t> model_next_id(0);
+
+NEMLModel::NEMLModel() :
+    model_id_(model_next_id++)
+{
+
+}
+
+NEMLModel::NEMLModel(const NEMLModel & other) :
+    NEMLObject(other), model_id_(model_next_id++)
+{
+
+}
+
+size_t NEMLModel::model_id() const
+{
+  return model_id_;
+}
+
+int NEMLModel::update_sd_scale(
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1,
+    double & u_np1, double u_n,
+    double & p_np1, double p_n,
+    double & dt_scale)
+{
+  SolveStats & stats = solve_stats();
+  stats.reset();
+
+  int ier = update_sd(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1, s_n,
+                      h_np1, h_n, A_np1, u_np1, u_n, p_np1, p_n);
+
+  // Inelastic strain increment: total minus elastic
+  double dep = 0.0;
+  if (ier == SUCCESS) {
+    double ee_np1[6];
+    double ee_n[6];
+    int ierr = elastic_strains(s_np1, T_np1, h_np1, ee_np1);
+    if (ierr == SUCCESS) ierr = elastic_strains(s_n, T_n, h_n, ee_n);
+    if (ierr == SUCCESS) {
+      double dei[6];
+      for (int i=0; i<6; i++) {
+        dei[i] = (e_np1[i] - e_n[i]) - (ee_np1[i] - ee_n[i]);
+      }
+      dep = sqrt(2.0/3.0) * norm2_vec(dei, 6);
+    }
+  }
+
+  dt_scale = suggest_step_scale(stats, dep, ier);
+
+  return ier;
+}
+
+int NEMLModel::update_sd_batch(
+    size_t npts,
+    const double * const e_np1, const double * const e_n,
+    const double * const T_np1, const double * const T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1,
+    double * const u_np1, const double * const u_n,
+    double * const p_np1, const double * const p_n,
+    int * const ier)
+{
+  size_t ns = nstore();
+  for (size_t i=0; i<npts; i++) {
+    ier[i] = update_sd(&e_np1[6*i], &e_n[6*i], T_np1[i], T_n[i],
+                       t_np1, t_n, &s_np1[6*i], &s_n[6*i],
+                       &h_np1[ns*i], &h_n[ns*i], &A_np1[36*i],
+                       u_np1[i], u_n[i], p_np1[i], p_n[i]);
+  }
+
+  for (size_t i=0; i<npts; i++) {
+    if (ier[i] != SUCCESS) return ier[i];
+  }
+
+  return SUCCESS;
+}
+
+double NEMLModel::cost() const
+{
+  return solve_cost(iteration_cost());
+}
+
+double NEMLModel::iteration_cost() const
+{
+  return 0.0;
+}
+
+double NEMLModel::point_cost(const double * const h) const
+{
+  return cost();
+}
+
+double NEMLModel::update_cost(size_t niter) const
+{
+  return 1.0 + niter * iteration_cost();
+}
+
+bool NEMLModel::failed(const double * const h) const
+{
+  return false;
+}
+
+// Newton iterations in a typical inelastic update
+const double nominal_iterations = 3.0;
+
+double newton_cost(size_t n)
+{
+  // LU factorization plus the residual and jacobian, in units of the 36
+  // multiply-adds of an elastic update
+  double nd = (double) n;
+  return (nd*nd*nd/3.0 + 4.0*nd*nd) / 36.0;
+}
+
+double solve_cost(double iteration_cost, double inner_cost)
+{
+  return 1.0 + nominal_iterations * (iteration_cost + inner_cost);
+}
+
 // NEMLModel_sd implementation
 NEMLModel_sd::NEMLModel_sd(
     std::shared_ptr<LinearElasticModel> emodel,
@@ -78,7 +338,7 @@ int NEMLModel_sd::init_store(double * const store) const
 
 double NEMLModel_sd::alpha(double T) const
 {
-  return alpha_->value(T);
+  return (*alpha_)(T);
 }
 
 const std::shared_ptr<const LinearElasticModel> NEMLModel_sd::elastic() const
@@ -212,6 +472,7 @@ int SmallStrainElasticity::update_sd(
        double & u_np1, double u_n,
        double & p_np1, double p_n)
 {
+  NEML_TRACE_SCOPE("SmallStrainElasticity::update_sd");
   int ier = elastic_->C(T_np1, A_np1);
   if (ier != SUCCESS) return ier;
   mat_vec(A_np1, 6, e_np1, 6, s_np1);
@@ -235,10 +496,12 @@ SmallStrainPerfectPlasticity::SmallStrainPerfectPlasticity(
     std::shared_ptr<Interpolate> ys,
     std::shared_ptr<Interpolate> alpha,
     double tol, int miter,
-    bool verbose, int max_divide, bool truesdell) :
+    bool verbose, int max_divide, double rtol, bool auto_scale,
+    bool truesdell) :
       NEMLModel_sd(elastic, alpha, truesdell),
       surface_(surface), ys_(ys),
-      tol_(tol), miter_(miter), verbose_(verbose), max_divide_(max_divide)
+      tol_(tol), miter_(miter), verbose_(verbose), max_divide_(max_divide),
+      rtol_(rtol), auto_scale_(auto_scale)
 {
 
 }
@@ -262,6 +525,8 @@ ParameterSet SmallStrainPerfectPlasticity::parameters()
   pset.add_optional_parameter<int>("miter", 50);
   pset.add_optional_parameter<bool>("verbose", false);
   pset.add_optional_parameter<int>("max_divide", 8);
+  pset.add_optional_parameter<double>("rtol", 0.0);
+  pset.add_optional_parameter<bool>("auto_scale", false);
 
   pset.add_optional_parameter<bool>("truesdell", true);
 
@@ -279,6 +544,8 @@ std::unique_ptr<NEMLObject> SmallStrainPerfectPlasticity::initialize(ParameterSe
       params.get_parameter<int>("miter"),
       params.get_parameter<bool>("verbose"),
       params.get_parameter<int>("max_divide"),
+      params.get_parameter<double>("rtol"),
+      params.get_parameter<bool>("auto_scale"),
       params.get_parameter<bool>("truesdell")
       ); 
 }
@@ -293,6 +560,7 @@ int SmallStrainPerfectPlasticity::update_sd(
     double & u_np1, double u_n,
     double & p_np1, double p_n)
 {
+  NEML_TRACE_SCOPE("SmallStrainPerfectPlasticity::update_sd");
   // Setup for substepping
   int nd = 0;                     // How many times we subdivided
   int tf = pow(2, max_divide_);   // Total integer step count
@@ -328,6 +596,7 @@ int SmallStrainPerfectPlasticity::update_sd(
     T_next = T_n + sm * T_diff;
     t_next = t_n + sm * t_diff;
 
+    NEML_TRACE_SCOPE_ARG("substep", "fraction", (double) cm / (double) tf);
     int ier = update_substep_(e_next, e_past, T_next, T_past, t_next,
                               t_past, s_next, s_past, h_np1, h_n,
                               A_np1, u_next, u_past, p_next, p_past);
@@ -336,9 +605,14 @@ int SmallStrainPerfectPlasticity::update_sd(
     if (ier != SUCCESS) {
       nd += 1;
       if (nd >= max_divide_) {
+        solve_stats().ndivide = std::max(solve_stats().ndivide, nd);
+        solve_stats().exhausted = true;
+        NEML_TRACE_ERROR(ier);
         return ier;
       }
       cm /= 2;
+      NEML_TRACE_INSTANT2("subdivide", "ier", ier, "fraction",
+                          (double) cm / (double) tf);
       continue;
     }
 
@@ -356,6 +630,7 @@ int SmallStrainPerfectPlasticity::update_sd(
   std::copy(s_next, s_next+6, s_np1);
   u_np1 = u_next;
   p_np1 = p_next;
+  solve_stats().ndivide = std::max(solve_stats().ndivide, nd);
 
   return 0; 
 }
@@ -379,6 +654,7 @@ int SmallStrainPerfectPlasticity::update_substep_(
   double fv;
   ier = surface_->f(ts.s_tr, &ts.ys, T_np1, fv);
   if (ier != SUCCESS) return ier;
+  NEML_TRACE_INSTANT("yield check", "f", fv);
   if (fv < tol_) {
     std::copy(ts.s_tr, ts.s_tr+6, s_np1);
     std::copy(ts.C, ts.C+36, A_np1);
@@ -389,26 +665,11 @@ int SmallStrainPerfectPlasticity::update_substep_(
     // Newton
     std::vector<double> xv(nparams());
     double * x = &xv[0];
-    int ier = solve(this, x, &ts, tol_, miter_, verbose_);
+    int ier = solve(this, x, &ts, tol_, miter_, verbose_, false, rtol_);
     if (ier != SUCCESS) return ier;
-    
-    // Extract
-    std::copy(x, x+6, s_np1);
 
-    // Calculate tangent
-    ier = calc_tangent_(ts, s_np1, x[6], A_np1);
+    ier = plastic_finish_(ts, x, s_np1, A_np1, p_np1, p_n);
     if (ier != SUCCESS) return ier;
-
-    // Plastic work calculation
-    double de[6];
-    double ds[6];
-    sub_vec(e_np1, e_n, 6, de);
-    add_vec(s_np1, s_n, 6, ds);
-    double ee_np1[6];
-    mat_vec(ts.S, 6, s_np1, 6, ee_np1);
-    sub_vec(de, ee_np1, 6, de);
-    add_vec(de, ts.ee_n, 6, de);
-    p_np1 = p_n + dot_vec(ds, de, 6) / 2.0;
   }
 
   // Energy calculation (trapezoid rule)
@@ -421,6 +682,88 @@ int SmallStrainPerfectPlasticity::update_substep_(
   return 0;
 }
 
+int SmallStrainPerfectPlasticity::update_sd_batch(
+    size_t npts,
+    const double * const e_np1, const double * const e_n,
+    const double * const T_np1, const double * const T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1,
+    double * const u_np1, const double * const u_n,
+    double * const p_np1, const double * const p_n,
+    int * const ier)
+{
+  size_t ns = nstore();
+  size_t n = nparams();
+
+  // Finish the elastic points and collect the plastic ones
+  std::vector<SSPPTrialState> tss(npts);
+  std::vector<size_t> plastic;
+  std::vector<bool> retry(npts, false);
+  for (size_t i=0; i<npts; i++) {
+    SSPPTrialState & ts = tss[i];
+    ier[i] = make_trial_state(&e_np1[6*i], &e_n[6*i], T_np1[i], T_n[i],
+                              t_np1, t_n, &s_n[6*i], &h_n[ns*i], ts);
+    double fv = 0.0;
+    if (ier[i] == SUCCESS) {
+      ier[i] = surface_->f(ts.s_tr, &ts.ys, T_np1[i], fv);
+    }
+    if (ier[i] != SUCCESS) {
+      retry[i] = true;
+    }
+    else if (fv < tol_) {
+      std::copy(ts.s_tr, ts.s_tr+6, &s_np1[6*i]);
+      std::copy(ts.C, ts.C+36, &A_np1[36*i]);
+      p_np1[i] = p_n[i];
+    }
+    else {
+      plastic.push_back(i);
+    }
+  }
+
+  // Return map the plastic points together
+  std::vector<double> x(n * plastic.size());
+  std::vector<TrialState*> pts(plastic.size());
+  std::vector<int> pier(plastic.size());
+  for (size_t k=0; k<plastic.size(); k++) pts[k] = &tss[plastic[k]];
+  solve_batch(this, plastic.size(), x.data(), pts.data(), pier.data(),
+              tol_, miter_, verbose_, rtol_);
+
+  for (size_t k=0; k<plastic.size(); k++) {
+    size_t i = plastic[k];
+    ier[i] = pier[k];
+    if (ier[i] == SUCCESS) {
+      ier[i] = plastic_finish_(tss[i], &x[k*n], &s_np1[6*i], &A_np1[36*i],
+                               p_np1[i], p_n[i]);
+    }
+    if (ier[i] != SUCCESS) retry[i] = true;
+  }
+
+  // Energy calculation (trapezoid rule), with the failures going back
+  // through the scalar update to substep
+  for (size_t i=0; i<npts; i++) {
+    if (retry[i]) {
+      ier[i] = update_sd(&e_np1[6*i], &e_n[6*i], T_np1[i], T_n[i],
+                         t_np1, t_n, &s_np1[6*i], &s_n[6*i],
+                         &h_np1[ns*i], &h_n[ns*i], &A_np1[36*i],
+                         u_np1[i], u_n[i], p_np1[i], p_n[i]);
+      continue;
+    }
+    double de[6];
+    double ds[6];
+    sub_vec(&e_np1[6*i], &e_n[6*i], 6, de);
+    add_vec(&s_np1[6*i], &s_n[6*i], 6, ds);
+    u_np1[i] = u_n[i] + dot_vec(ds, de, 6) / 2.0;
+  }
+
+  for (size_t i=0; i<npts; i++) {
+    if (ier[i] != SUCCESS) return ier[i];
+  }
+
+  return SUCCESS;
+}
+
 size_t SmallStrainPerfectPlasticity::nhist() const
 {
   return 0;
@@ -436,6 +779,11 @@ size_t SmallStrainPerfectPlasticity::nparams() const
   return 7;
 }
 
+double SmallStrainPerfectPlasticity::iteration_cost() const
+{
+  return newton_cost(nparams());
+}
+
 int SmallStrainPerfectPlasticity::init_x(double * const x, TrialState * ts)
 {
   SSPPTrialState * tss = static_cast<SSPPTrialState *>(ts);
@@ -496,9 +844,82 @@ int SmallStrainPerfectPlasticity::RJ(
   return 0;
 }
 
+void SmallStrainPerfectPlasticity::RJ_batch(
+    size_t nbatch, const double * const x, TrialState * const * ts,
+    const bool * const active, double * const R, double * const J,
+    int * const ier)
+{
+  // The yield surface is evaluated point by point
+  std::vector<double> fv(nbatch, 0.0), dg(nbatch, 0.0);
+  std::vector<double> df(6*nbatch, 0.0), ddf(36*nbatch, 0.0);
+  for (size_t b=0; b<nbatch; b++) {
+    if (!active[b]) continue;
+    SSPPTrialState * tss = static_cast<SSPPTrialState *>(ts[b]);
+    double s[6], dfb[6], ddfb[36];
+    for (int i=0; i<6; i++) s[i] = x[i*nbatch+b];
+    dg[b] = x[6*nbatch+b];
+    ier[b] = surface_->f(s, &tss->ys, tss->T, fv[b]);
+    if (ier[b] == SUCCESS) ier[b] = surface_->df_ds(s, &tss->ys, tss->T, dfb);
+    if (ier[b] == SUCCESS) {
+      ier[b] = surface_->df_dsds(s, &tss->ys, tss->T, ddfb);
+    }
+    if (ier[b] != SUCCESS) continue;
+    for (int i=0; i<6; i++) df[i*nbatch+b] = dfb[i];
+    for (int i=0; i<36; i++) ddf[i*nbatch+b] = ddfb[i];
+  }
+
+  // The rest runs across the points
+  std::vector<double> S(36*nbatch, 0.0), e(6*nbatch, 0.0);
+  for (size_t b=0; b<nbatch; b++) {
+    if (!active[b] || (ier[b] != SUCCESS)) continue;
+    SSPPTrialState * tss = static_cast<SSPPTrialState *>(ts[b]);
+    for (int i=0; i<36; i++) S[i*nbatch+b] = tss->S[i];
+    for (int i=0; i<6; i++) {
+      e[i*nbatch+b] = tss->e_np1[i] - tss->e_n[i] + tss->ee_n[i];
+    }
+  }
+
+  // R1 and R2
+  for (int i=0; i<6; i++) {
+    double * Ri = &R[i*nbatch];
+    for (size_t b=0; b<nbatch; b++) {
+      Ri[b] = -e[i*nbatch+b] + df[i*nbatch+b] * dg[b];
+    }
+    for (int j=0; j<6; j++) {
+      const double * Sij = &S[CINDEX(i,j,6)*nbatch];
+      const double * sj = &x[j*nbatch];
+      for (size_t b=0; b<nbatch; b++) Ri[b] += Sij[b] * sj[b];
+    }
+  }
+  for (size_t b=0; b<nbatch; b++) R[6*nbatch+b] = fv[b];
+
+  // J11, J12, J21, and J22
+  for (int i=0; i<6; i++) {
+    for (int j=0; j<6; j++) {
+      double * Jij = &J[CINDEX(i,j,7)*nbatch];
+      const double * Sij = &S[CINDEX(i,j,6)*nbatch];
+      const double * ddfij = &ddf[CINDEX(i,j,6)*nbatch];
+      for (size_t b=0; b<nbatch; b++) Jij[b] = ddfij[b] * dg[b] + Sij[b];
+    }
+    std::copy(&df[i*nbatch], &df[(i+1)*nbatch], &J[CINDEX(i,6,7)*nbatch]);
+    std::copy(&df[i*nbatch], &df[(i+1)*nbatch], &J[CINDEX(6,i,7)*nbatch]);
+  }
+  std::fill(&J[CINDEX(6,6,7)*nbatch], &J[CINDEX(6,6,7)*nbatch]+nbatch, 0.0);
+}
+
 // Getter
+int SmallStrainPerfectPlasticity::residual_scales(TrialState * ts,
+                                                  double * const scales)
+{
+  SSPPTrialState * tss = static_cast<SSPPTrialState *>(ts);
+  std::fill(scales, scales+nparams(), 1.0);
+  if (auto_scale_) scales[6] = 1.0 / elastic_->E(tss->T);
+
+  return 0;
+}
+
 double SmallStrainPerfectPlasticity::ys(double T) const {
-  return ys_->value(T);
+  return (*ys_)(T);
 }
 
 
@@ -509,7 +930,8 @@ int SmallStrainPerfectPlasticity::make_trial_state(
     const double * const s_n, const double * const h_n,
     SSPPTrialState & ts)
 {
-  ts.ys = -ys_->value(T_np1);
+  NEML_TRACE_SCOPE("SmallStrainPerfectPlasticity::make_trial_state");
+  ts.ys = -(*ys_)(T_np1);
 
   int ier = elastic_->S(T_np1, ts.S);
   if (ier != SUCCESS) return ier;
@@ -542,6 +964,7 @@ int SmallStrainPerfectPlasticity::calc_tangent_(SSPPTrialState ts,
                                                 double dg, 
                                                 double * const A_np1)
 {
+  NEML_TRACE_SCOPE("SmallStrainPerfectPlasticity::calc_tangent_");
   // Useful
   double df[6];
   int ier = surface_->df_ds(s_np1, &ts.ys, ts.T, df);
@@ -549,9 +972,22 @@ int SmallStrainPerfectPlasticity::calc_tangent_(SSPPTrialState ts,
   ier = surface_->df_dsds(s_np1, &ts.ys, ts.T, A_np1);
   if (ier != SUCCESS) return ier;
 
-  // Tangent calc
+  // Tangent calc, where an isotropic compliance and a J2-type surface give
+  // an isotropic matrix plus a rank one update along the deviatoric flow
+  // direction that inverts in closed form
   for (int i=0; i<36; i++) A_np1[i] = ts.S[i] + dg * A_np1[i];
-  ier = invert_mat(A_np1, 6);
+  double n[6];
+  std::copy(df, df+6, n);
+  dev_vec(n);
+  IsoLowRank op;
+  if (iso_rank_one(A_np1, n, op)) {
+    std::fill(A_np1, A_np1+36, 0.0);
+    for (int i=0; i<6; i++) A_np1[CINDEX(i,i,6)] = 1.0;
+    ier = iso_low_rank_solve(op, A_np1, 6);
+  }
+  else {
+    ier = invert_mat(A_np1, 6);
+  }
   if (ier != SUCCESS) return ier;
 
   double Bv[6];
@@ -568,6 +1004,33 @@ int SmallStrainPerfectPlasticity::calc_tangent_(SSPPTrialState ts,
   return 0;
 }
 
+int SmallStrainPerfectPlasticity::plastic_finish_(SSPPTrialState & ts,
+                                                  const double * const x,
+                                                  double * const s_np1,
+                                                  double * const A_np1,
+                                                  double & p_np1, double p_n)
+{
+  // Extract
+  std::copy(x, x+6, s_np1);
+
+  // Calculate tangent
+  int ier = calc_tangent_(ts, s_np1, x[6], A_np1);
+  if (ier != SUCCESS) return ier;
+
+  // Plastic work calculation
+  double de[6];
+  double ds[6];
+  sub_vec(ts.e_np1, ts.e_n, 6, de);
+  add_vec(s_np1, ts.s_n, 6, ds);
+  double ee_np1[6];
+  mat_vec(ts.S, 6, s_np1, 6, ee_np1);
+  sub_vec(de, ee_np1, 6, de);
+  add_vec(de, ts.ee_n, 6, de);
+  p_np1 = p_n + dot_vec(ds, de, 6) / 2.0;
+
+  return 0;
+}
+
 
 
 // Implementation of small strain rate independent plasticity
@@ -577,12 +1040,14 @@ SmallStrainRateIndependentPlasticity::SmallStrainRateIndependentPlasticity(
     std::shared_ptr<RateIndependentFlowRule> flow, 
     std::shared_ptr<Interpolate> alpha, double tol,
     int miter, bool verbose, double kttol, bool check_kt,
-    bool truesdell) :
+    double rtol, bool auto_scale, bool truesdell, std::string algorithm) :
       NEMLModel_sd(elastic, alpha, truesdell),
-      flow_(flow), tol_(tol), kttol_(kttol), miter_(miter),
-      verbose_(verbose), check_kt_(check_kt)
+      flow_(flow), tol_(tol), kttol_(kttol), rtol_(rtol), miter_(miter),
+      verbose_(verbose), check_kt_(check_kt), auto_scale_(auto_scale)
 {
-
+  if (algorithm == "closest_point") algorithm_ = CLOSEST_POINT;
+  else if (algorithm == "cutting_plane") algorithm_ = CUTTING_PLANE;
+  else throw std::invalid_argument("Unknown return algorithm " + algorithm);
 }
 
 std::string SmallStrainRateIndependentPlasticity::type()
@@ -604,8 +1069,12 @@ ParameterSet SmallStrainRateIndependentPlasticity::parameters()
   pset.add_optional_parameter<bool>("verbose", false);
   pset.add_optional_parameter<double>("kttol", 1.0e-2);
   pset.add_optional_parameter<bool>("check_kt", false);
+  pset.add_optional_parameter<double>("rtol", 0.0);
+  pset.add_optional_parameter<bool>("auto_scale", false);
 
   pset.add_optional_parameter<bool>("truesdell", true);
+  pset.add_optional_parameter<std::string>("algorithm",
+                                           std::string("closest_point"));
 
   return pset;
 }
@@ -621,7 +1090,10 @@ std::unique_ptr<NEMLObject> SmallStrainRateIndependentPlasticity::initialize(Par
       params.get_parameter<bool>("verbose"),
       params.get_parameter<double>("kttol"),
       params.get_parameter<bool>("check_kt"),
-      params.get_parameter<bool>("truesdell")
+      params.get_parameter<double>("rtol"),
+      params.get_parameter<bool>("auto_scale"),
+      params.get_parameter<bool>("truesdell"),
+      params.get_parameter<std::string>("algorithm")
       ); 
 }
 
@@ -645,6 +1117,7 @@ int SmallStrainRateIndependentPlasticity::update_sd(
        double & u_np1, double u_n,
        double & p_np1, double p_n)
 {
+  NEML_TRACE_SCOPE("SmallStrainRateIndependentPlasticity::update_sd");
   // Setup and store the trial state for the solver
   SSRIPTrialState ts;
   int ier = make_trial_state(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_n, h_n, ts);
@@ -654,6 +1127,7 @@ int SmallStrainRateIndependentPlasticity::update_sd(
   double fv;
   ier = flow_->f(ts.s_tr, &ts.h_tr[0], T_np1, fv);
   if (ier != SUCCESS) return ier;
+  NEML_TRACE_INSTANT("yield check", "f", fv);
 
   double dg;
 
@@ -668,9 +1142,35 @@ int SmallStrainRateIndependentPlasticity::update_sd(
   }
   // Else solve and extract updated parameters from the solver vector
   else {
-    std::vector<double> xv(nparams());
-    double * x = &xv[0];
-    int ier = solve(this, x, &ts, tol_, miter_, verbose_);
+    // Per thread scratch, so the return and tangent don't allocate
+    size_t n = nparams();
+    Scratch<double> xv(n), Jv(n*n);
+    double * x = xv.data();
+    double * J = Jv.data();
+    ier = MAX_ITERATIONS;
+    if (algorithm_ == CUTTING_PLANE) {
+      ier = cutting_plane_return_(ts, x);
+      // The cutting plane state only satisfies the closest point residual
+      // to first order, so take one Newton step on that residual before
+      // forming the tangent from the jacobian at the corrected state
+      if (ier == SUCCESS) {
+        Scratch<double> R(n);
+        Scratch<int> ipiv(n);
+        ier = RJ(x, &ts, R.data(), J);
+        if (ier == SUCCESS) ier = factor_mat(J, n, ipiv.data());
+        if (ier == SUCCESS) ier = solve_factored(J, n, ipiv.data(), R.data());
+        if (ier == SUCCESS) {
+          for (size_t j=0; j<n; j++) x[j] -= R[j];
+          ier = RJ(x, &ts, R.data(), J);
+        }
+      }
+      else {
+        NEML_TRACE_INSTANT("cutting plane fallback", "ier", ier);
+      }
+    }
+    if (ier != SUCCESS) {
+      ier = solve(this, x, &ts, tol_, miter_, verbose_, false, rtol_, J);
+    }
     if (ier != SUCCESS) return ier;
 
     // Extract solved parameters
@@ -680,8 +1180,8 @@ int SmallStrainRateIndependentPlasticity::update_sd(
     sub_vec(e_np1, x, 6, ee);
     mat_vec(ts.C, 6, ee, 6, s_np1);
 
-    // Complicated tangent calc...
-    ier = calc_tangent_(x, &ts, s_np1, h_np1, dg, A_np1);
+    // Tangent from the jacobian at the solution
+    ier = calc_tangent_(ts, J, A_np1);
     if (ier != SUCCESS) return ier;
 
     // Plastic work calculation
@@ -710,6 +1210,11 @@ size_t SmallStrainRateIndependentPlasticity::nparams() const
   return 6 + flow_->nhist() + 1;
 }
 
+double SmallStrainRateIndependentPlasticity::iteration_cost() const
+{
+  return newton_cost(nparams());
+}
+
 int SmallStrainRateIndependentPlasticity::init_x(double * const x, TrialState * ts)
 {
   SSRIPTrialState * tss = static_cast<SSRIPTrialState *>(ts);
@@ -846,6 +1351,16 @@ int SmallStrainRateIndependentPlasticity::RJ(const double * const x,
   return 0;
 }
 
+int SmallStrainRateIndependentPlasticity::residual_scales(TrialState * ts,
+                                                          double * const scales)
+{
+  SSRIPTrialState * tss = static_cast<SSRIPTrialState *>(ts);
+  std::fill(scales, scales+nparams(), 1.0);
+  if (auto_scale_) scales[6+flow_->nhist()] = 1.0 / elastic_->E(tss->T);
+
+  return 0;
+}
+
 const std::shared_ptr<const LinearElasticModel> SmallStrainRateIndependentPlasticity::elastic() const
 {
   return elastic_;
@@ -857,6 +1372,7 @@ int SmallStrainRateIndependentPlasticity::make_trial_state(
     const double * const s_n, const double * const h_n,
     SSRIPTrialState & ts)
 {
+  NEML_TRACE_SCOPE("SmallStrainRateIndependentPlasticity::make_trial_state");
   // Save e_np1
   std::copy(e_np1, e_np1+6, ts.e_np1);
   // ep_tr = ep_n
@@ -884,112 +1400,115 @@ int SmallStrainRateIndependentPlasticity::make_trial_state(
 
 
 int SmallStrainRateIndependentPlasticity::calc_tangent_(
-    const double * const x, TrialState * ts, const double * const s_np1,
-    const double * const h_np1, double dg, double * const A_np1)
-{
-  SSRIPTrialState * tss = static_cast<SSRIPTrialState *>(ts);
-  
-  std::vector<double> Rv(nparams());
-  double * R = &Rv[0];
-  std::vector<double> Jv(nparams() * nparams());
-  double * J = &Jv[0];
-  
-  int ier = RJ(x, ts, R, J);
+    const SSRIPTrialState & ts, double * const J, double * const A_np1)
+{
+  NEML_TRACE_SCOPE("SmallStrainRateIndependentPlasticity::calc_tangent_");
+  // The residual depends on the strain only through the stress, so
+  // dR/de = -(dR/dep + [I 0 0]^T) and the plastic strain sensitivity
+  // reduces to dep/de = I + (J^-1)_kk, where kk is the plastic strain
+  // block.  Then A = C (I - dep/de) = -C (J^-1)_kk, which takes one
+  // factorization, in place in J, and six solves.  Newton only keeps
+  // the factors of the previous iterate, so the converged jacobian is
+  // factored here.
+  int n = nparams();
+  Scratch<int> ipiv(n);
+  Scratch<double> Xv(6*n);
+  double * X = Xv.data();
+
+  int ier = factor_mat(J, n, ipiv.data());
   if (ier != SUCCESS) return ier;
 
-  int n = nparams();
-  int nk = 6;
-  int ne = nparams() - nk;
-  
-  std::vector<double> Jkkv(nk*nk);
-  double * Jkk = &Jkkv[0];
-  for (int i=0; i<nk; i++) {
-    for (int j=0; j<nk; j++) {
-      Jkk[CINDEX(i,j,nk)] = J[CINDEX(i,j,n)];
-    }
-  }
-  
-  std::vector<double> Jkev(nk*ne);
-  double * Jke = &Jkev[0];
-  for (int i=0; i<nk; i++) {
-    for (int j=0; j<ne; j++) {
-      Jke[CINDEX(i,j,ne)] = J[CINDEX(i,(j+nk),n)];
-    }
-  }
-  
-  std::vector<double> Jekv(ne*nk);
-  double * Jek = &Jekv[0];
-  for (int i=0; i<ne; i++) {
-    for (int j=0; j<nk; j++) {
-      Jek[CINDEX(i,j,nk)] = J[CINDEX((i+nk),(j),n)];
-    }
-  }
-  
-  std::vector<double> Jeev(ne*ne);
-  double * Jee = &Jeev[0];
-  for (int i=0; i<ne; i++) {
-    for (int j=0; j<ne; j++) {
-      Jee[CINDEX(i,j,ne)] = J[CINDEX((i+nk),(j+nk),n)];
+  std::fill(X, X+6*n, 0.0);
+  for (int j=0; j<6; j++) X[j*n+j] = 1.0;
+  ier = solve_factored(J, n, ipiv.data(), X, 6);
+  if (ier != SUCCESS) return ier;
+
+  for (int i=0; i<6; i++) {
+    for (int j=0; j<6; j++) {
+      double v = 0.0;
+      for (int k=0; k<6; k++) v += ts.C[CINDEX(i,k,6)] * X[j*n+k];
+      A_np1[CINDEX(i,j,6)] = -v;
     }
   }
 
-  ier = invert_mat(Jee, ne);
-  if (ier != SUCCESS) return ier;
-  
-  std::vector<double> Av(nk*6);
-  double * A = &Av[0];
-  std::vector<double> Bv(ne*6);
-  double * B = &Bv[0];
-  
+  return 0;
+}
+
+int SmallStrainRateIndependentPlasticity::cutting_plane_return_(
+    SSRIPTrialState & ts, double * const x)
+{
+  NEML_TRACE_SCOPE("SmallStrainRateIndependentPlasticity::cutting_plane_return_");
+  // Convex cutting plane return: linearize the yield function about the
+  // current state, step the consistency parameter to zero it, and update
+  // the plastic strain and history along the flow directions there.  Each
+  // iteration takes only first derivatives and a scalar division.  The
+  // return gives up with MAX_ITERATIONS if the yield function stops
+  // decreasing so the caller can fall back on closest point projection.
   int nh = flow_->nhist();
-  
-  std::vector<double> dg_dsv(6*6);
-  double * dg_ds = &dg_dsv[0];
-  ier = flow_->dg_ds(s_np1, h_np1, tss->T, dg_ds);
-  if (ier != SUCCESS) return ier;
+  init_x(x, &ts);
+  double * const ep = &x[0];
+  double * const alpha = &x[6];
+  double & dg = x[6+nh];
 
-  std::vector<double> dh_dsv(nh*6);
-  double * dh_ds = &dh_dsv[0];
-  ier = flow_->dh_ds(s_np1, h_np1, tss->T, dh_ds);
-  if (ier != SUCCESS) return ier;
-  double df_ds[6];
-  ier = flow_->df_ds(s_np1, h_np1, tss->T, df_ds);
-  if (ier != SUCCESS) return ier;
+  double w = auto_scale_ ? 1.0 / elastic_->E(ts.T) : 1.0;
 
-  mat_mat(6, 6, 6, dg_ds, tss->C, A);
-  for (int i=0; i<nk*6; i++) A[i] *= dg;
-  
-  mat_mat(nh, 6, 6, dh_ds, tss->C, B);
-  for (int i=0; i<nh*6; i++) B[i] *= dg;
-  mat_vec_trans(tss->C, 6, df_ds, 6, &B[nh*6]);
+  Scratch<double> hv(nh), fav(nh);
+  double * h = hv.data();
+  double * fa = fav.data();
+  double s[6], ee[6], g[6], fs[6], Cg[6];
+  double f, nf0 = 0.0, nf_prev = 0.0;
 
-  std::vector<double> T1v(ne*nk); 
-  double * T1 = &T1v[0];
-  mat_mat(ne, nk, ne, Jee, Jek, T1);
-  std::vector<double> T2v(nk*nk);
-  double * T2 = &T2v[0];
-  mat_mat(nk, nk, ne, Jke, T1, T2);
-  for (int i=0; i<nk*nk; i++) T2[i] = Jkk[i] - T2[i];
-  ier = invert_mat(T2, nk);
-  if (ier != SUCCESS) return ier;
-  
-  std::vector<double> T3v(ne*nk);
-  double * T3 = &T3v[0];
-  mat_mat(ne, nk, ne, Jee, B, T3);
-  std::vector<double> T4v(nk*nk);
-  double * T4 = &T4v[0];
-  mat_mat(nk, nk, ne, Jke, T3, T4);
-  for (int i=0; i<nk*nk; i++) T4[i] -= A[i];
+  int i = 0;
+  int ier;
+  for (;; i++) {
+    sub_vec(ts.e_np1, ep, 6, ee);
+    mat_vec(ts.C, 6, ee, 6, s);
+    ier = flow_->f(s, alpha, ts.T, f);
+    if (ier != SUCCESS) return ier;
 
-  double dep[36];
-  mat_mat(6, 6, 6, T2, T4, dep);
+    double nf = w * fabs(f);
+    if (i == 0) nf0 = nf;
+    NEML_TRACE_INSTANT2("cutting plane iteration", "i", i, "norm", nf);
+    if (verbose_) {
+      std::cout << "Cutting plane " << i << "\t" << nf << std::endl;
+    }
+    if (nf <= tol_ + rtol_ * nf0) break;
+    if ((i == miter_) || ((i > 0) && (nf >= nf_prev))) {
+      ier = MAX_ITERATIONS;
+      break;
+    }
+    nf_prev = nf;
 
-  for (int i=0; i<36; i++) dep[i] = -dep[i];
-  for (int i=0; i<6; i++) dep[CINDEX(i,i,6)] += 1.0;
+    ier = flow_->g(s, alpha, ts.T, g);
+    if (ier != SUCCESS) return ier;
+    ier = flow_->h(s, alpha, ts.T, h);
+    if (ier != SUCCESS) return ier;
+    ier = flow_->df_ds(s, alpha, ts.T, fs);
+    if (ier != SUCCESS) return ier;
+    ier = flow_->df_da(s, alpha, ts.T, fa);
+    if (ier != SUCCESS) return ier;
 
-  mat_mat(6, 6, 6, tss->C, dep, A_np1);
+    mat_vec(ts.C, 6, g, 6, Cg);
+    double denom = dot_vec(fs, Cg, 6) - dot_vec(fa, h, nh);
+    if (not (denom > 0.0)) {
+      ier = MAX_ITERATIONS;
+      break;
+    }
+    double ddg = f / denom;
 
-  return 0;
+    for (int j=0; j<6; j++) ep[j] += ddg * g[j];
+    for (int j=0; j<nh; j++) alpha[j] += ddg * h[j];
+    dg += ddg;
+  }
+
+  SolveStats & stats = solve_stats();
+  stats.nsolves++;
+  stats.niter += i;
+  stats.max_iter = std::max(stats.max_iter, i);
+
+  if ((ier == SUCCESS) && (dg < 0.0)) ier = MAX_ITERATIONS;
+
+  return ier;
 }
 
 int SmallStrainRateIndependentPlasticity::check_K_T_(
@@ -1001,14 +1520,10 @@ int SmallStrainRateIndependentPlasticity::check_K_T_(
 
   double fv;
   flow_->f(s_np1, h_np1, T_np1, fv);
+  NEML_TRACE_INSTANT2("KT check", "f", fv, "dg", dg);
 
-  if (fv > kttol_) {
-    return KT_VIOLATION;
-  }
-  if (dg < -kttol_) {
-    return KT_VIOLATION;
-  }
-  if ((dg > kttol_) && (fv > kttol_)) {
+  if ((fv > kttol_) || (dg < -kttol_) || ((dg > kttol_) && (fv > kttol_))) {
+    NEML_TRACE_ERROR(KT_VIOLATION);
     return KT_VIOLATION;
   }
 
@@ -1023,10 +1538,14 @@ SmallStrainCreepPlasticity::SmallStrainCreepPlasticity(
     std::shared_ptr<NEMLModel_sd> plastic,
     std::shared_ptr<CreepModel> creep,
     std::shared_ptr<Interpolate> alpha, double tol,
-    int miter, bool verbose, double sf, bool truesdell) :
+    int miter, bool verbose, double sf, double rtol, bool auto_scale,
+    bool relax_holds, bool use_explicit, double etol, int max_divide,
+    bool truesdell) :
       NEMLModel_sd(elastic, alpha, truesdell),
-      plastic_(plastic), creep_(creep), tol_(tol), sf_(sf),
-      miter_(miter), verbose_(verbose)
+      plastic_(plastic), creep_(creep), tol_(tol), sf_(sf), rtol_(rtol),
+      etol_(etol), miter_(miter), max_divide_(max_divide),
+      verbose_(verbose), auto_scale_(auto_scale),
+      relax_holds_(relax_holds), explicit_(use_explicit)
 {
 
 }
@@ -1050,6 +1569,12 @@ ParameterSet SmallStrainCreepPlasticity::parameters()
   pset.add_optional_parameter<int>("miter", 50);
   pset.add_optional_parameter<bool>("verbose", false);
   pset.add_optional_parameter<double>("sf", 1.0e6);
+  pset.add_optional_parameter<double>("rtol", 0.0);
+  pset.add_optional_parameter<bool>("auto_scale", false);
+  pset.add_optional_parameter<bool>("relax_holds", false);
+  pset.add_optional_parameter<bool>("explicit", false);
+  pset.add_optional_parameter<double>("etol", 1.0e-6);
+  pset.add_optional_parameter<int>("max_divide", 8);
 
   pset.add_optional_parameter<bool>("truesdell", true);
 
@@ -1067,6 +1592,12 @@ std::unique_ptr<NEMLObject> SmallStrainCreepPlasticity::initialize(ParameterSet
       params.get_parameter<int>("miter"),
       params.get_parameter<bool>("verbose"),
       params.get_parameter<double>("sf"),
+      params.get_parameter<double>("rtol"),
+      params.get_parameter<bool>("auto_scale"),
+      params.get_parameter<bool>("relax_holds"),
+      params.get_parameter<bool>("explicit"),
+      params.get_parameter<double>("etol"),
+      params.get_parameter<int>("max_divide"),
       params.get_parameter<bool>("truesdell")
       ); 
 }
@@ -1093,47 +1624,72 @@ int SmallStrainCreepPlasticity::update_sd(
        double & u_np1, double u_n,
        double & p_np1, double p_n)
 {
+  NEML_TRACE_SCOPE("SmallStrainCreepPlasticity::update_sd");
 
-  // Solve the system to get the update
   SSCPTrialState ts;
   int ier = make_trial_state(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_n, h_n, ts);
   if (ier != SUCCESS) return ier;
 
   std::vector<double> xv(nparams());
   double * x = &xv[0];
-  ier = solve(this, x, &ts, tol_, miter_, verbose_);
-  if (ier != 0) return ier;
-
-  // Store the ep strain
-  std::copy(x, x+6, h_np1);
-
-  // Do the plastic update to get the new history and stress
   double A[36];
-  ier =  plastic_->update_sd(x, ts.ep_strain, T_np1, T_n,
-                             t_np1, t_n, s_np1, s_n,
-                             &h_np1[6], &h_n[6],
-                             A, u_np1, u_n, p_np1, p_n);
-  if (ier != 0) return ier;
-
-  // Do the creep update to get a tangent component
   double creep_old[6];
   double creep_new[6];
   double B[36];
   for (int i=0; i<6; i++) {
     creep_old[i] = e_n[i] - ts.ep_strain[i];
   }
-  ier = creep_->update(s_np1, creep_new, creep_old, T_np1, T_n,
-                 t_np1, t_n, B);
-  if (ier != 0) return ier;
+
+  // Strain holds can skip the nonlinear solve
+  bool done = false;
+  double de[6];
+  sub_vec(e_np1, e_n, 6, de);
+  if (relax_holds_ && (t_np1 > t_n) && (T_np1 == T_n) &&
+      (norm2_vec(de, 6) <= std::numeric_limits<double>::epsilon() *
+       norm2_vec(e_n, 6))) {
+    ier = relax_(ts, creep_old, x, s_np1, h_np1, A, creep_new, B,
+                 u_np1, u_n, p_np1, p_n, done);
+    if (ier != SUCCESS) return ier;
+  }
+
+  // As can explicit integration, unless the step is too large for it
+  if (!done && explicit_) {
+    ier = explicit_update_(ts, creep_old, x, s_np1, h_np1, A, creep_new,
+                           u_np1, u_n, p_np1, p_n);
+    if (ier == SUCCESS) {
+      // The tangent is just the base model's
+      std::fill(B, B+36, 0.0);
+      done = true;
+    }
+  }
+
+  if (!done) {
+    // Solve the system to get the update
+    ier = solve(this, x, &ts, tol_, miter_, verbose_, false, rtol_);
+    if (ier != 0) return ier;
+
+    // Store the ep strain
+    std::copy(x, x+6, h_np1);
+
+    // Do the plastic update to get the new history and stress
+    ier =  plastic_->update_sd(x, ts.ep_strain, T_np1, T_n,
+                               t_np1, t_n, s_np1, s_n,
+                               &h_np1[6], &h_n[6],
+                               A, u_np1, u_n, p_np1, p_n);
+    if (ier != 0) return ier;
+
+    // Do the creep update to get a tangent component
+    ier = creep_->update(s_np1, creep_new, creep_old, T_np1, T_n,
+                   t_np1, t_n, B);
+    if (ier != 0) return ier;
+  }
 
   // Form the relatively simple tangent
-  ier = form_tangent_(A, B, A_np1);
+  ier = form_tangent_(A, B, s_np1, A_np1);
   if (ier != 0) return ier;
 
   // Energy calculation (trapezoid rule)
-  double de[6];
   double ds[6];
-  sub_vec(e_np1, e_n, 6, de);
   add_vec(s_np1, s_n, 6, ds);
   u_np1 = u_n + dot_vec(ds, de, 6) / 2.0;
   
@@ -1151,6 +1707,16 @@ size_t SmallStrainCreepPlasticity::nparams() const
   return 6;
 }
 
+double SmallStrainCreepPlasticity::iteration_cost() const
+{
+  return newton_cost(nparams());
+}
+
+double SmallStrainCreepPlasticity::cost() const
+{
+  return solve_cost(iteration_cost(), plastic_->cost());
+}
+
 int SmallStrainCreepPlasticity::init_x(double * const x, TrialState * ts)
 {
   SSCPTrialState * tss = static_cast<SSCPTrialState*>(ts);
@@ -1200,23 +1766,32 @@ int SmallStrainCreepPlasticity::RJ(const double * const x, TrialState * ts,
 
   // Form the residual
   for (int i=0; i<6; i++) {
-    R[i] = (x[i] + creep_new[i] - tss->e_np1[i]) * sf_;
+    R[i] = x[i] + creep_new[i] - tss->e_np1[i];
   }
   
   // The Jacobian is a straightforward combination of the two derivatives
   ier = mat_mat(6, 6, 6, B, A_np1, J);
   for (int i=0; i<6; i++) J[CINDEX(i,i,6)] += 1.0;
-  for (int i=0; i<36; i++) J[i] *= sf_;
 
   return ier;
 }
 
+int SmallStrainCreepPlasticity::residual_scales(TrialState * ts,
+                                                double * const scales)
+{
+  // The equations are all strains, so the automatic scale is just one
+  std::fill(scales, scales+nparams(), auto_scale_ ? 1.0 : sf_);
+
+  return 0;
+}
+
 int SmallStrainCreepPlasticity::make_trial_state(
     const double * const e_np1, const double * const e_n,
     double T_np1, double T_n, double t_np1, double t_n,
     const double * const s_n, const double * const h_n,
     SSCPTrialState & ts)
 {
+  NEML_TRACE_SCOPE("SmallStrainCreepPlasticity::make_trial_state");
   int nh = plastic_->nhist();
   ts.h_n.resize(nh);
 
@@ -1235,8 +1810,10 @@ int SmallStrainCreepPlasticity::make_trial_state(
 }
 
 int SmallStrainCreepPlasticity::form_tangent_(
-    double * const A, double * const B, double * const A_np1)
+    double * const A, double * const B, const double * const s_np1,
+    double * const A_np1)
 {
+  NEML_TRACE_SCOPE("SmallStrainCreepPlasticity::form_tangent_");
   // Okay, what we really want to do is
   // (A^-1 + B)^-1
   // BUT A can be singular (i.e. if it's perfectly plastic)
@@ -1254,6 +1831,41 @@ int SmallStrainCreepPlasticity::form_tangent_(
   //
   // That said, it seems to work quite nicely.
   //
+  // Written as (I + A B)^-1 A, isotropic elasticity with J2 plasticity and
+  // creep makes A and B isotropic plus rank one along the stress deviator,
+  // so I + A B is isotropic plus rank two and Sherman-Morrison-Woodbury
+  // gives the solve directly.
+  double n[6];
+  std::copy(s_np1, s_np1+6, n);
+  dev_vec(n);
+  IsoLowRank opA, opB;
+  if (iso_rank_one(A, n, opA) && iso_rank_one(B, n, opB)) {
+    // With A = PA + p q^T and B = PB + r t^T
+    //  A B = PA PB + (PA r) t^T + p (PB q + (q . r) t)^T
+    IsoLowRank op;
+    op.a = 1.0 + opA.a * opB.a;
+    op.b = 1.0 + opA.b * opB.b;
+    op.rank = 0;
+    double qr = 0.0;
+    if (opB.rank == 1) {
+      iso_apply(opA.a, opA.b, opB.U, op.U);
+      std::copy(opB.V, opB.V+6, op.V);
+      if (opA.rank == 1) qr = dot_vec(opA.V, opB.U, 6);
+      op.rank++;
+    }
+    if (opA.rank == 1) {
+      double * U = &op.U[6*op.rank];
+      double * V = &op.V[6*op.rank];
+      std::copy(opA.U, opA.U+6, U);
+      iso_apply(opB.a, opB.b, opA.V, V);
+      for (int i=0; i<6; i++) V[i] += qr * opB.V[i];
+      op.rank++;
+    }
+
+    std::copy(A, A+36, A_np1);
+    return iso_low_rank_solve(op, A_np1, 6);
+  }
+
   double C[36];
   mat_mat(6,6,6,A,B,C);
   for (int i=0; i<6; i++) C[CINDEX(i,i,6)] += 1.0;
@@ -1277,18 +1889,108 @@ int SmallStrainCreepPlasticity::set_elastic_model(std::shared_ptr<LinearElasticM
   return plastic_->set_elastic_model(emodel);
 }
 
+int SmallStrainCreepPlasticity::relax_(
+    SSCPTrialState & ts, const double * const creep_old, double * const x,
+    double * const s_np1, double * const h_np1, double * const A,
+    double * const creep_new, double * const B,
+    double & u_np1, double u_n, double & p_np1, double p_n, bool & relaxed)
+{
+  // Failures here just send us back to the full solve
+  relaxed = false;
+
+  double s_relax[6];
+  bool valid;
+  int ier = creep_->relax(ts.s_n, creep_old, elastic_->G(ts.T_np1), ts.T_np1,
+                          ts.t_np1, ts.t_n, s_relax, creep_new, B, valid);
+  if ((ier != SUCCESS) || (!valid)) return 0;
+
+  // The plastic model has to agree, which means it stayed elastic and
+  // the elasticity is isotropic
+  for (int i=0; i<6; i++) x[i] = ts.e_np1[i] - creep_new[i];
+  std::copy(x, x+6, h_np1);
+  double * hist = (ts.h_n.empty() ? nullptr : &(ts.h_n[0]));
+  ier = plastic_->update_sd(x, ts.ep_strain, ts.T_np1, ts.T_n,
+                            ts.t_np1, ts.t_n, s_np1, ts.s_n,
+                            &h_np1[6], hist,
+                            A, u_np1, u_n, p_np1, p_n);
+  if (ier != SUCCESS) return 0;
+
+  double diff[6];
+  sub_vec(s_np1, s_relax, 6, diff);
+  if (norm2_vec(diff, 6) > 1.0e-8 * std::max(norm2_vec(ts.s_n, 6), 1.0)) {
+    return 0;
+  }
+
+  relaxed = true;
+  return 0;
+}
+
+int SmallStrainCreepPlasticity::explicit_update_(
+    SSCPTrialState & ts, const double * const creep_old, double * const x,
+    double * const s_np1, double * const h_np1, double * const A,
+    double * const creep_new,
+    double & u_np1, double u_n, double & p_np1, double p_n)
+{
+  double dt = ts.t_np1 - ts.t_n;
+  std::vector<double> h(plastic_->nhist());
+  double * hist = (ts.h_n.empty() ? nullptr : &(ts.h_n[0]));
+  double * h_s = (h.empty() ? nullptr : &h[0]);
+
+  // Creep rate with the base model stress for a creep strain at a time
+  // in the step, the strain and temperature varying linearly
+  auto f = [&](const double * const ec, double tau, double * const rate) -> int
+  {
+    double frac = (dt > 0.0) ? tau / dt : 1.0;
+    double e[6];
+    for (int i=0; i<6; i++) {
+      e[i] = ts.e_n[i] + frac * (ts.e_np1[i] - ts.e_n[i]) - ec[i];
+    }
+    double T = ts.T_n + frac * (ts.T_np1 - ts.T_n);
+    double s[6];
+    double As[36];
+    double u, p;
+    int ier = plastic_->update_sd(e, ts.ep_strain, T, ts.T_n,
+                                  ts.t_n + tau, ts.t_n, s, ts.s_n,
+                                  h_s, hist, As, u, 0.0, p, 0.0);
+    if (ier != SUCCESS) return ier;
+    return creep_->f(s, ec, ts.t_n + tau, T, rate);
+  };
+
+  // Measure the creep strain error in units of stress
+  std::vector<double> y(creep_old, creep_old+6);
+  std::vector<double> w(6, elastic_->E(ts.T_np1));
+  int ier = cash_karp(f, y, dt, w, etol_, 1 << max_divide_);
+  if (ier != SUCCESS) return ier;
+
+  // Final base model update
+  std::copy(y.begin(), y.end(), creep_new);
+  for (int i=0; i<6; i++) x[i] = ts.e_np1[i] - creep_new[i];
+  std::copy(x, x+6, h_np1);
+  return plastic_->update_sd(x, ts.ep_strain, ts.T_np1, ts.T_n,
+                             ts.t_np1, ts.t_n, s_np1, ts.s_n,
+                             &h_np1[6], hist,
+                             A, u_np1, u_n, p_np1, p_n);
+}
+
 // Start general integrator implementation
 GeneralIntegrator::GeneralIntegrator(std::shared_ptr<LinearElasticModel> elastic,
                                      std::shared_ptr<GeneralFlowRule> rule,
                                      std::shared_ptr<Interpolate> alpha,
                                      double tol, int miter,
                                      bool verbose, int max_divide, 
+                                     double rtol, bool auto_scale,
+                                     std::string scheme, double etol,
                                      bool truesdell) :
     NEMLModel_sd(elastic, alpha, truesdell),
-    rule_(rule), tol_(tol), miter_(miter), max_divide_(max_divide),
-    verbose_(verbose) 
+    rule_(rule), tol_(tol), rtol_(rtol), etol_(etol), miter_(miter),
+    max_divide_(max_divide), verbose_(verbose), auto_scale_(auto_scale)
 {
-
+  if (scheme == "backward_euler") scheme_ = BACKWARD_EULER;
+  else if (scheme == "trapezoidal") scheme_ = TRAPEZOIDAL;
+  else if (scheme == "bdf2") scheme_ = BDF2;
+  else if (scheme == "sdirk") scheme_ = SDIRK;
+  else if (scheme == "explicit") scheme_ = EXPLICIT;
+  else throw std::invalid_argument("Unknown integration scheme " + scheme);
 }
 
 std::string GeneralIntegrator::type()
@@ -1309,6 +2011,11 @@ ParameterSet GeneralIntegrator::parameters()
   pset.add_optional_parameter<int>("miter", 50);
   pset.add_optional_parameter<bool>("verbose", false);
   pset.add_optional_parameter<int>("max_divide", 8);
+  pset.add_optional_parameter<double>("rtol", 0.0);
+  pset.add_optional_parameter<bool>("auto_scale", false);
+  pset.add_optional_parameter<std::string>("scheme",
+                                           std::string("backward_euler"));
+  pset.add_optional_parameter<double>("etol", 1.0e-6);
 
   pset.add_optional_parameter<bool>("truesdell", true);
 
@@ -1325,6 +2032,10 @@ std::unique_ptr<NEMLObject> GeneralIntegrator::initialize(ParameterSet & params)
       params.get_parameter<int>("miter"),
       params.get_parameter<bool>("verbose"),
       params.get_parameter<int>("max_divide"),
+      params.get_parameter<double>("rtol"),
+      params.get_parameter<bool>("auto_scale"),
+      params.get_parameter<std::string>("scheme"),
+      params.get_parameter<double>("etol"),
       params.get_parameter<bool>("truesdell")
       ); 
 }
@@ -1338,9 +2049,47 @@ int GeneralIntegrator::update_sd(
     double * const A_np1,
     double & u_np1, double u_n,
     double & p_np1, double p_n)
+{
+  NEML_TRACE_SCOPE("GeneralIntegrator::update_sd");
+  // The trial state of the last step, reused for the tangent if we
+  // did not need to substep
+  GITrialState ts;
+
+  // Explicit integration goes back to the implicit path below if the
+  // step is too large for it
+  if (scheme_ == EXPLICIT) {
+    int ier = explicit_update_(e_np1, e_n, T_np1, T_n, t_np1, t_n,
+                               s_np1, s_n, h_np1, h_n, A_np1, ts);
+    if (ier == SUCCESS) {
+      calc_work_(e_np1, e_n, T_np1, T_n, s_np1, s_n, h_np1, h_n, ts,
+                 u_np1, u_n, p_np1, p_n);
+      return 0;
+    }
+    if (verbose_) {
+      std::cout << "Explicit integration failed, switching to implicit"
+          << std::endl;
+    }
+  }
+
+  int nd;
+  int ier = substep_(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1, s_n,
+                     h_np1, h_n, ts, nd, SubstepFn());
+  if (ier != SUCCESS) return ier;
+
+  return finish_step_(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1, s_n,
+                      h_np1, h_n, A_np1, u_np1, u_n, p_np1, p_n, ts, nd);
+}
+
+int GeneralIntegrator::substep_(
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    GITrialState & ts, int & nd, const SubstepFn & substep)
 {
   // Setup for substepping
-  int nd = 0;                   // Number of times we divided
+  nd = 0;                       // Number of times we divided
   int tf = pow(2,max_divide_);  // Total integer step, to avoid floating math
   int cm = tf;                  // Current attempted step
   int cs = 0;                   // Current integer proportion of step completed
@@ -1369,7 +2118,7 @@ int GeneralIntegrator::update_sd(
   double s_next[6];
   double T_next;
   double t_next;
-  
+
   while (cs < tf) {
     // Figure out our float step multiplier
     double sm = (double) (cs + cm) / (double) tf;
@@ -1379,22 +2128,20 @@ int GeneralIntegrator::update_sd(
     T_next = T_n + sm * T_diff;
     t_next = t_n + sm * t_diff;
 
-    // Set trial state
-    GITrialState ts;
-    int ier = make_trial_state(e_next, e_past, T_next, T_past, t_next, t_past, 
-                     s_past, h_past, ts);
-    if (ier != SUCCESS) return ier; // Do not recover from something so dumb
-
     // Solve for x
+    NEML_TRACE_SCOPE_ARG("substep", "fraction", (double) cm / (double) tf);
     std::vector<double> xv(nparams());
     double * x = &xv[0];
-    ier = solve(this, x, &ts, tol_, miter_, verbose_);
+    int ier = integrate_step_(e_next, e_past, T_next, T_past, t_next, t_past,
+                              s_past, h_past, x, ts, cm == tf);
 
     // Decide what to do if we fail
     if (ier != SUCCESS) {
       // Subdivide the step
       nd += 1;
       cm /= 2;
+      NEML_TRACE_INSTANT2("subdivide", "ier", ier, "fraction",
+                          (double) cm / (double) tf);
       if (verbose_) {
         std::cout << "Substepping:" << std::endl;
         std::cout << "New step fraction " << ((double) cm / (double) tf) << std::endl;
@@ -1406,6 +2153,9 @@ int GeneralIntegrator::update_sd(
         if (verbose_) {
           std::cout << "Substepping failed..." << std::endl;
         }
+        solve_stats().ndivide = std::max(solve_stats().ndivide, nd);
+        solve_stats().exhausted = true;
+        NEML_TRACE_ERROR(ier);
         return ier;
       }
       continue;
@@ -1413,7 +2163,14 @@ int GeneralIntegrator::update_sd(
 
     // Extract solved parameters
     std::copy(x, x+6, s_next);
-    std::copy(x+6, x+6+nhist(), h_next);
+    std::copy(x+6, x+6+nrule_(), h_next);
+    if (scheme_ == BDF2) record_rates_(x, ts, h_past, h_next);
+
+    if (substep) {
+      ier = substep(e_next, e_past, T_next, T_past, t_next, t_past,
+                    s_past, h_past, x, (double) cs / (double) tf, sm);
+      if (ier != SUCCESS) return ier;
+    }
 
     // Increment next step
     cs += cm;
@@ -1428,50 +2185,131 @@ int GeneralIntegrator::update_sd(
   // Extract final values
   std::copy(s_next, s_next+6, s_np1);
   std::copy(h_next, h_next+nhist(), h_np1);
-  
-  // Get tangent over full step
-  GITrialState ts;
-  int ier = make_trial_state(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_n, h_n, ts);
-  if (ier != SUCCESS) return ier;
+  solve_stats().ndivide = std::max(solve_stats().ndivide, nd);
+
+  return 0;
+}
+
+int GeneralIntegrator::finish_step_(
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    const double * const s_np1, const double * const s_n,
+    const double * const h_np1, const double * const h_n,
+    double * const A_np1,
+    double & u_np1, double u_n,
+    double & p_np1, double p_n,
+    GITrialState & ts, int nd)
+{
+  // Get tangent over full step, approximating it with backward Euler
+  // if we had to substep
+  if (nd > 0) {
+    int ier = make_trial_state(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_n, h_n,
+                               ts);
+    if (ier != SUCCESS) return ier;
+  }
   std::vector<double> yv(nparams());
   double * y = &yv[0];
   std::copy(s_np1, s_np1+6, y);
-  std::copy(h_np1, h_np1+nhist(), &y[6]);
+  std::copy(h_np1, h_np1+nrule_(), &y[6]);
   
-  ier = calc_tangent_(y, &ts, A_np1);
+  int ier = calc_tangent_(y, &ts, A_np1);
   if (ier != SUCCESS) return ier;
 
-  // Energy calculation (trapezoid rule)
-  double de[6];
-  double ds[6];
-  sub_vec(e_np1, e_n, 6, de);
-  add_vec(s_np1, s_n, 6, ds);
-  for (int i=0; i<6; i++) ds[i] /= 2.0;
-  u_np1 = u_n + dot_vec(ds, de, 6);
-
-  // Need a special call
-  double p_dot_np1;
-  rule_->work_rate(s_np1, h_np1, ts.e_dot, T_np1, ts.Tdot, p_dot_np1);
-  double p_dot_n;
-  rule_->work_rate(s_n, h_n, ts.e_dot, T_n, ts.Tdot, p_dot_n);
-  p_np1 = p_n + (p_dot_np1 + p_dot_n)/2.0 * ts.dt;
+  calc_work_(e_np1, e_n, T_np1, T_n, s_np1, s_n, h_np1, h_n, ts,
+             u_np1, u_n, p_np1, p_n);
 
   return 0;
 }
 
+int GeneralIntegrator::update_sd_batch(
+    size_t npts,
+    const double * const e_np1, const double * const e_n,
+    const double * const T_np1, const double * const T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1,
+    double * const u_np1, const double * const u_n,
+    double * const p_np1, const double * const p_n,
+    int * const ier)
+{
+  // Only backward Euler is a single solve per step
+  if (scheme_ != BACKWARD_EULER) {
+    return NEMLModel_sd::update_sd_batch(npts, e_np1, e_n, T_np1, T_n,
+                                         t_np1, t_n, s_np1, s_n, h_np1, h_n,
+                                         A_np1, u_np1, u_n, p_np1, p_n, ier);
+  }
+
+  size_t ns = nstore();
+  size_t n = nparams();
+
+  std::vector<GITrialState> tss(npts);
+  std::vector<size_t> solved;
+  for (size_t i=0; i<npts; i++) {
+    ier[i] = make_trial_state(&e_np1[6*i], &e_n[6*i], T_np1[i], T_n[i],
+                              t_np1, t_n, &s_n[6*i], &h_n[ns*i], tss[i]);
+    if (ier[i] == SUCCESS) solved.push_back(i);
+  }
+
+  std::vector<double> x(n * solved.size());
+  std::vector<TrialState*> pts(solved.size());
+  std::vector<int> pier(solved.size());
+  for (size_t k=0; k<solved.size(); k++) pts[k] = &tss[solved[k]];
+  solve_batch(this, solved.size(), x.data(), pts.data(), pier.data(),
+              tol_, miter_, verbose_, rtol_);
+
+  for (size_t k=0; k<solved.size(); k++) {
+    size_t i = solved[k];
+    ier[i] = pier[k];
+    if (ier[i] != SUCCESS) continue;
+    std::copy(&x[k*n], &x[k*n]+6, &s_np1[6*i]);
+    std::copy(&x[k*n+6], &x[k*n+6]+nrule_(), &h_np1[ns*i]);
+    ier[i] = calc_tangent_(&x[k*n], &tss[i], &A_np1[36*i]);
+    if (ier[i] != SUCCESS) continue;
+    calc_work_(&e_np1[6*i], &e_n[6*i], T_np1[i], T_n[i], &s_np1[6*i],
+               &s_n[6*i], &h_np1[ns*i], &h_n[ns*i], tss[i], u_np1[i],
+               u_n[i], p_np1[i], p_n[i]);
+  }
+
+  // Failures go back through the scalar update to substep
+  for (size_t i=0; i<npts; i++) {
+    if (ier[i] == SUCCESS) continue;
+    ier[i] = update_sd(&e_np1[6*i], &e_n[6*i], T_np1[i], T_n[i],
+                       t_np1, t_n, &s_np1[6*i], &s_n[6*i],
+                       &h_np1[ns*i], &h_n[ns*i], &A_np1[36*i],
+                       u_np1[i], u_n[i], p_np1[i], p_n[i]);
+  }
+
+  for (size_t i=0; i<npts; i++) {
+    if (ier[i] != SUCCESS) return ier[i];
+  }
+
+  return SUCCESS;
+}
+
 size_t GeneralIntegrator::nhist() const
 {
-  return rule_->nhist();
+  // BDF2 also keeps the rates, strain rate, and time increment of the
+  // last step
+  if (scheme_ == BDF2) return nrule_() + nparams() + 7;
+  return nrule_();
 }
 
 int GeneralIntegrator::init_hist(double * const hist) const
 {
+  std::fill(hist, hist+nhist(), 0.0);
   return rule_->init_hist(hist);
 }
 
 size_t GeneralIntegrator::nparams() const
 {
-  return 6 + nhist();
+  return 6 + nrule_();
+}
+
+double GeneralIntegrator::iteration_cost() const
+{
+  return newton_cost(nparams());
 }
 
 int GeneralIntegrator::init_x(double * const x, TrialState * ts)
@@ -1499,26 +2337,29 @@ int GeneralIntegrator::RJ(const double * const x, TrialState * ts,
   // Helps with vectorization
   // Really as I declared both const this shouldn't be necessary but hey
   // I don't design optimizing compilers for a living
-  int nhist = this->nhist();
+  int nhist = nrule_();
   int nparams = this->nparams();
+  double theta = tss->theta;
+  const double * const g = &(tss->g[0]);
 
   // Residual calculation
   int ier = rule_->s(s_mod, h_np1, tss->e_dot, tss->T, tss->Tdot, R);
   if (ier != SUCCESS) return ier;
   for (int i=0; i<6; i++) {
-    R[i] = -s_mod[i] + tss->s_n[i] + R[i] * tss->dt;
+    R[i] = -s_mod[i] + tss->s_n[i] + (theta * R[i] + g[i]) * tss->dt;
   }
   ier = rule_->a(s_mod, h_np1, tss->e_dot, tss->T, tss->Tdot, &R[6]);
   if (ier != SUCCESS) return ier;
   for (int i=0; i<nhist; i++) {
-    R[i+6] = -h_np1[i] + tss->h_n[i] + R[i+6] * tss->dt;
+    R[i+6] = -h_np1[i] + tss->h_n[i] + (theta * R[i+6] + g[i+6]) * tss->dt;
   }
 
   // Jacobian calculation
+  double wdt = theta * tss->dt;
   double J11[36];
   ier = rule_->ds_ds(s_mod, h_np1, tss->e_dot, tss->T, tss->Tdot, J11);
   if (ier != SUCCESS) return ier;
-  for (int i=0; i<36; i++) J11[i] *= tss->dt;
+  for (int i=0; i<36; i++) J11[i] *= wdt;
   for (int i=0; i<6; i++) J11[CINDEX(i,i,6)] -= 1.0;
   for (int i=0; i<6; i++) {
     for (int j=0; j<6; j++) {
@@ -1532,7 +2373,7 @@ int GeneralIntegrator::RJ(const double * const x, TrialState * ts,
   if (ier != SUCCESS) return ier;
   for (int i=0; i<6; i++) {
     for (int j=0; j<nhist; j++) {
-      J[CINDEX(i,(j+6),nparams)] = J12[CINDEX(i,j,nhist)] * tss->dt;
+      J[CINDEX(i,(j+6),nparams)] = J12[CINDEX(i,j,nhist)] * wdt;
     }
   }
   
@@ -1542,7 +2383,7 @@ int GeneralIntegrator::RJ(const double * const x, TrialState * ts,
   if (ier != SUCCESS) return ier;
   for (int i=0; i<nhist; i++) {
     for (int j=0; j<6; j++) {
-      J[CINDEX((i+6),j,nparams)] = J21[CINDEX(i,j,6)] * tss->dt;
+      J[CINDEX((i+6),j,nparams)] = J21[CINDEX(i,j,6)] * wdt;
     }
   }
   
@@ -1551,9 +2392,7 @@ int GeneralIntegrator::RJ(const double * const x, TrialState * ts,
   ier = rule_->da_da(s_mod, h_np1, tss->e_dot, tss->T, tss->Tdot, J22);
   if (ier != SUCCESS) return ier;
 
-  // More vectorization
-  double dt = tss->dt;
-  for (int i=0; i<nhist*nhist; i++) J22[i] *= dt;
+  for (int i=0; i<nhist*nhist; i++) J22[i] *= wdt;
   for (int i=0; i<nhist; i++) J22[CINDEX(i,i,nhist)] -= 1.0;
 
   for (int i=0; i<nhist; i++) {
@@ -1566,12 +2405,26 @@ int GeneralIntegrator::RJ(const double * const x, TrialState * ts,
 }
 
 
+int GeneralIntegrator::residual_scales(TrialState * ts, double * const scales)
+{
+  GITrialState * tss = static_cast<GITrialState *>(ts);
+  std::fill(scales, scales+nparams(), 1.0);
+  if (auto_scale_) {
+    // The history variables do not carry units, so only the stress
+    // equations are scaled
+    std::fill(scales, scales+6, 1.0 / elastic_->E(tss->T));
+  }
+
+  return 0;
+}
+
 int GeneralIntegrator::make_trial_state(
     const double * const e_np1, const double * const e_n,
     double T_np1, double T_n, double t_np1, double t_n,
     const double * const s_n, const double * const h_n,
     GITrialState & ts)
 {
+  NEML_TRACE_SCOPE("GeneralIntegrator::make_trial_state");
   // Basic
   ts.dt = t_np1 - t_n;
   ts.T = T_np1;
@@ -1592,8 +2445,279 @@ int GeneralIntegrator::make_trial_state(
   std::copy(s_n, s_n+6, ts.s_n);
 
   // Trial history
-  ts.h_n.resize(nhist());
-  std::copy(h_n, h_n+nhist(), ts.h_n.begin());
+  ts.h_n.resize(nrule_());
+  std::copy(h_n, h_n+nrule_(), ts.h_n.begin());
+
+  // Backward Euler weights, the other schemes adjust these
+  ts.theta = 1.0;
+  ts.g.assign(nparams(), 0.0);
+  ts.dg.assign(nparams()*6, 0.0);
+
+  return 0;
+}
+
+bool GeneralIntegrator::forward_sensitivities() const
+{
+  return scheme_ == BACKWARD_EULER;
+}
+
+int GeneralIntegrator::update_sensitivity_sd(
+    const std::vector<GeneralIntegrator*> & plus,
+    const std::vector<GeneralIntegrator*> & minus,
+    const std::vector<double> & dv,
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1,
+    double & u_np1, double u_n,
+    double & p_np1, double p_n,
+    const double * const de_np1, const double * const de_n,
+    double * const ds_np1, const double * const ds_n,
+    double * const dh_np1, const double * const dh_n,
+    double * const du_np1, const double * const du_n,
+    double * const dp_np1, const double * const dp_n)
+{
+  NEML_TRACE_SCOPE("GeneralIntegrator::update_sensitivity_sd");
+  if (!forward_sensitivities()) return INCOMPATIBLE_MODELS;
+  if ((plus.size() != minus.size()) || (plus.size() != dv.size())) {
+    return INCOMPATIBLE_MODELS;
+  }
+  size_t np = plus.size();
+  size_t ns = nstore();
+
+  // Sensitivities at the start of the current substep, then at its end
+  std::vector<double> ds_past(ds_n, ds_n+6*np), dh_past(dh_n, dh_n+ns*np);
+  std::vector<double> de_past(6*np), de_next(6*np);
+  auto substep = [&](const double * e_next, const double * e_past,
+                     double T_next, double T_past,
+                     double t_next, double t_past,
+                     const double * s_past, const double * h_past,
+                     const double * x, double f_past, double f_next) -> int
+  {
+    // The strain sensitivities follow the strain through the substeps
+    for (size_t i=0; i<6*np; i++) {
+      de_past[i] = de_n[i] + f_past * (de_np1[i] - de_n[i]);
+      de_next[i] = de_n[i] + f_next * (de_np1[i] - de_n[i]);
+    }
+    int ier = sensitivity_step_(plus, minus, dv, e_next, e_past, T_next,
+                                T_past, t_next, t_past, x, s_past, h_past,
+                                de_next.data(), de_past.data(), ds_np1,
+                                ds_past.data(), dh_np1, dh_past.data());
+    if (ier != SUCCESS) return ier;
+    std::copy(ds_np1, ds_np1+6*np, ds_past.begin());
+    std::copy(dh_np1, dh_np1+ns*np, dh_past.begin());
+    return 0;
+  };
+
+  GITrialState ts;
+  int nd;
+  int ier = substep_(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1, s_n,
+                     h_np1, h_n, ts, nd, substep);
+  if (ier != SUCCESS) return ier;
+
+  ier = finish_step_(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1, s_n,
+                     h_np1, h_n, A_np1, u_np1, u_n, p_np1, p_n, ts, nd);
+  if (ier != SUCCESS) return ier;
+
+  return sensitivity_work_(plus, minus, dv, e_np1, e_n, T_np1, T_n,
+                           t_np1, t_n, s_np1, s_n, h_np1, h_n, u_n, p_n,
+                           de_np1, de_n, ds_np1, ds_n, dh_np1, dh_n,
+                           du_np1, du_n, dp_np1, dp_n);
+}
+
+int GeneralIntegrator::sensitivity_sd(
+    const std::vector<GeneralIntegrator*> & plus,
+    const std::vector<GeneralIntegrator*> & minus,
+    const std::vector<double> & dv,
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    const double * const s_np1, const double * const s_n,
+    const double * const h_np1, const double * const h_n,
+    double u_np1, double u_n,
+    double p_np1, double p_n,
+    const double * const de_np1, const double * const de_n,
+    double * const ds_np1, const double * const ds_n,
+    double * const dh_np1, const double * const dh_n,
+    double * const du_np1, const double * const du_n,
+    double * const dp_np1, const double * const dp_n)
+{
+  NEML_TRACE_SCOPE("GeneralIntegrator::sensitivity_sd");
+  if (!forward_sensitivities()) return INCOMPATIBLE_MODELS;
+  if ((plus.size() != minus.size()) || (plus.size() != dv.size())) {
+    return INCOMPATIBLE_MODELS;
+  }
+  size_t n = nparams();
+  size_t nh = nhist();
+  size_t ns = nstore();
+
+  // Converged state
+  std::vector<double> xv(n);
+  double * x = &xv[0];
+  std::copy(s_np1, s_np1+6, x);
+  std::copy(h_np1, h_np1+nh, &x[6]);
+
+  // A state that does not zero the residual of the whole step came from
+  // substeps, so go through them again carrying the sensitivities
+  GITrialState ts;
+  int ier = make_trial_state(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_n, h_n,
+                             ts);
+  if (ier != SUCCESS) return ier;
+  std::vector<double> R(n), w(n), J(n*n);
+  ier = RJ(x, &ts, R.data(), J.data());
+  if (ier != SUCCESS) return ier;
+  ier = residual_scales(&ts, w.data());
+  if (ier != SUCCESS) return ier;
+  double nR = 0.0;
+  for (size_t i=0; i<n; i++) nR += (w[i] * R[i]) * (w[i] * R[i]);
+  if (sqrt(nR) > tol_) {
+    NEML_TRACE_INSTANT("sensitivity substeps", "norm", sqrt(nR));
+    std::vector<double> sv(s_np1, s_np1+6), hv(h_np1, h_np1+ns);
+    double A[36];
+    double u, p;
+    return update_sensitivity_sd(plus, minus, dv, e_np1, e_n, T_np1, T_n,
+                                 t_np1, t_n, sv.data(), s_n, hv.data(), h_n,
+                                 A, u, u_n, p, p_n, de_np1, de_n,
+                                 ds_np1, ds_n, dh_np1, dh_n, du_np1, du_n,
+                                 dp_np1, dp_n);
+  }
+
+  ier = sensitivity_step_(plus, minus, dv, e_np1, e_n, T_np1, T_n, t_np1,
+                          t_n, x, s_n, h_n, de_np1, de_n, ds_np1, ds_n,
+                          dh_np1, dh_n);
+  if (ier != SUCCESS) return ier;
+
+  return sensitivity_work_(plus, minus, dv, e_np1, e_n, T_np1, T_n,
+                           t_np1, t_n, s_np1, s_n, h_np1, h_n, u_n, p_n,
+                           de_np1, de_n, ds_np1, ds_n, dh_np1, dh_n,
+                           du_np1, du_n, dp_np1, dp_n);
+}
+
+int GeneralIntegrator::sensitivity_step_(
+    const std::vector<GeneralIntegrator*> & plus,
+    const std::vector<GeneralIntegrator*> & minus,
+    const std::vector<double> & dv,
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    const double * const x,
+    const double * const s_n, const double * const h_n,
+    const double * const de_np1, const double * const de_n,
+    double * const ds_np1, const double * const ds_n,
+    double * const dh_np1, const double * const dh_n)
+{
+  size_t n = nparams();
+  size_t nh = nhist();
+  size_t ns = nstore();
+
+  // Factored jacobian of the step
+  GITrialState ts;
+  int ier = make_trial_state(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_n, h_n,
+                             ts);
+  if (ier != SUCCESS) return ier;
+  std::vector<double> Rv(n), Rmv(n);
+  double * R = &Rv[0];
+  double * Rm = &Rmv[0];
+  std::vector<double> Jv(n*n);
+  double * J = &Jv[0];
+  ier = RJ(x, &ts, R, J);
+  if (ier != SUCCESS) return ier;
+  std::vector<int> ipiv(n);
+  ier = factor_mat(J, n, &ipiv[0]);
+  if (ier != SUCCESS) return ier;
+
+  std::vector<double> Jpv(n*n);
+  double * Jp = &Jpv[0];
+  std::vector<double> hp_nv(nh);
+  double * hp_n = hp_nv.data();
+  for (size_t k=0; k<plus.size(); k++) {
+    GeneralIntegrator * models[2] = {plus[k], minus[k]};
+    double * Rs[2] = {R, Rm};
+
+    // Step inputs moved along their sensitivities and the perturbed
+    // residuals at the converged state
+    for (int side=0; side<2; side++) {
+      if (models[side]->nparams() != n) return INCOMPATIBLE_MODELS;
+      double d = (side == 0) ? dv[k] : -dv[k];
+      double ep_np1[6], ep_n[6], sp_n[6];
+      for (int i=0; i<6; i++) {
+        ep_np1[i] = e_np1[i] + d * de_np1[6*k+i];
+        ep_n[i] = e_n[i] + d * de_n[6*k+i];
+        sp_n[i] = s_n[i] + d * ds_n[6*k+i];
+      }
+      for (size_t i=0; i<nh; i++) hp_n[i] = h_n[i] + d * dh_n[ns*k+i];
+      GITrialState tsp;
+      ier = models[side]->make_trial_state(ep_np1, ep_n, T_np1, T_n, t_np1,
+                                           t_n, sp_n, hp_n, tsp);
+      if (ier != SUCCESS) return ier;
+      ier = models[side]->RJ(x, &tsp, Rs[side], Jp);
+      if (ier != SUCCESS) return ier;
+    }
+
+    // J dx = -dR
+    for (size_t i=0; i<n; i++) R[i] = -(R[i] - Rm[i]) / (2.0 * dv[k]);
+    ier = solve_factored(J, n, &ipiv[0], R);
+    if (ier != SUCCESS) return ier;
+    std::copy(R, R+6, &ds_np1[6*k]);
+    std::copy(R+6, R+n, &dh_np1[ns*k]);
+    std::fill(&dh_np1[ns*k+nh], &dh_np1[ns*(k+1)], 0.0);
+  }
+
+  return 0;
+}
+
+int GeneralIntegrator::sensitivity_work_(
+    const std::vector<GeneralIntegrator*> & plus,
+    const std::vector<GeneralIntegrator*> & minus,
+    const std::vector<double> & dv,
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    const double * const s_np1, const double * const s_n,
+    const double * const h_np1, const double * const h_n,
+    double u_n, double p_n,
+    const double * const de_np1, const double * const de_n,
+    const double * const ds_np1, const double * const ds_n,
+    const double * const dh_np1, const double * const dh_n,
+    double * const du_np1, const double * const du_n,
+    double * const dp_np1, const double * const dp_n)
+{
+  // The work only needs a difference, not a solve
+  size_t nh = nhist();
+  size_t ns = nstore();
+  std::vector<double> hp_nv(nh), hp_np1v(nh);
+  double * hp_n = hp_nv.data();
+  double * hp_np1 = hp_np1v.data();
+  for (size_t k=0; k<plus.size(); k++) {
+    GeneralIntegrator * models[2] = {plus[k], minus[k]};
+    double up_np1[2], pp_np1[2];
+    for (int side=0; side<2; side++) {
+      double d = (side == 0) ? dv[k] : -dv[k];
+      double ep_np1[6], ep_n[6], sp_n[6], sp_np1[6];
+      for (int i=0; i<6; i++) {
+        ep_np1[i] = e_np1[i] + d * de_np1[6*k+i];
+        ep_n[i] = e_n[i] + d * de_n[6*k+i];
+        sp_n[i] = s_n[i] + d * ds_n[6*k+i];
+        sp_np1[i] = s_np1[i] + d * ds_np1[6*k+i];
+      }
+      for (size_t i=0; i<nh; i++) {
+        hp_n[i] = h_n[i] + d * dh_n[ns*k+i];
+        hp_np1[i] = h_np1[i] + d * dh_np1[ns*k+i];
+      }
+      GITrialState tsp;
+      int ier = models[side]->make_trial_state(ep_np1, ep_n, T_np1, T_n,
+                                               t_np1, t_n, sp_n, hp_n, tsp);
+      if (ier != SUCCESS) return ier;
+      models[side]->calc_work_(ep_np1, ep_n, T_np1, T_n, sp_np1, sp_n,
+                               hp_np1, hp_n, tsp, up_np1[side],
+                               u_n + d * du_n[k], pp_np1[side],
+                               p_n + d * dp_n[k]);
+    }
+    du_np1[k] = (up_np1[0] - up_np1[1]) / (2.0 * dv[k]);
+    dp_np1[k] = (pp_np1[0] - pp_np1[1]) / (2.0 * dv[k]);
+  }
 
   return 0;
 }
@@ -1601,6 +2725,7 @@ int GeneralIntegrator::make_trial_state(
 int GeneralIntegrator::calc_tangent_(const double * const x, TrialState * ts, 
                                      double * const A_np1)
 {
+  NEML_TRACE_SCOPE("GeneralIntegrator::calc_tangent_");
   // Quick note: I'm leaving  out a few dts that cancel in the end -- 
   // no point in tempting fate for small time increments
  
@@ -1615,16 +2740,18 @@ int GeneralIntegrator::calc_tangent_(const double * const x, TrialState * ts,
   const double * const h_np1 = &x[6];
 
   // Vectorization
-  int nhist = this->nhist();
+  int nhist = nrule_();
 
-  // Call for extra derivatives
+  // Call for extra derivatives, including the explicit part of the rates
   double A[36];
   int ier = rule_->ds_de(s_mod, h_np1, tss->e_dot, tss->T, tss->Tdot, A);
   if (ier != SUCCESS) return ier;
+  for (int i=0; i<36; i++) A[i] = tss->theta * A[i] + tss->dg[i];
   std::vector<double> Bv(nhist*6);
   double * B = &Bv[0];
   ier = rule_->da_de(s_mod, h_np1, tss->e_dot, tss->T, tss->Tdot, B);
   if (ier != SUCCESS) return ier;
+  for (int i=0; i<nhist*6; i++) B[i] = tss->theta * B[i] + tss->dg[i+36];
 
   // Call for the jacobian
   std::vector<double> Rv(nparams());
@@ -1703,6 +2830,220 @@ int GeneralIntegrator::set_elastic_model(std::shared_ptr<LinearElasticModel> emo
   return rule_->set_elastic_model(emodel);
 }
 
+int GeneralIntegrator::integrate_step_(
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n, double t_np1, double t_n,
+    const double * const s_n, const double * const h_n,
+    double * const x, GITrialState & ts, bool tangent)
+{
+  int ier = make_trial_state(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_n, h_n,
+                             ts);
+  if (ier != SUCCESS) return ier;
+
+  // All the schemes are the same for a zero time increment, and the
+  // implicit fallback for the explicit scheme is backward Euler
+  if ((scheme_ == BACKWARD_EULER) || (scheme_ == EXPLICIT) ||
+      (ts.dt <= 0.0)) {
+    return solve(this, x, &ts, tol_, miter_, verbose_, false, rtol_);
+  }
+
+  int n = nparams();
+  std::vector<double> yv(n);
+  double * y_n = &yv[0];
+  std::copy(s_n, s_n+6, y_n);
+  std::copy(h_n, h_n+nrule_(), &y_n[6]);
+
+  std::vector<double> fv(n);
+  double * f = &fv[0];
+  std::vector<double> Dv(n*6);
+  double * D = &Dv[0];
+
+  if (scheme_ == TRAPEZOIDAL) {
+    ier = rates_(y_n, ts, T_n, f, D);
+    if (ier != SUCCESS) return ier;
+    ts.theta = 0.5;
+    for (int i=0; i<n; i++) ts.g[i] = 0.5 * f[i];
+    for (int i=0; i<n*6; i++) ts.dg[i] = 0.5 * D[i];
+  }
+  else if (scheme_ == BDF2) {
+    // Variable step BDF2 written in terms of the average rate over the last
+    // step, which restarts with backward Euler on the first step and
+    // if the step grows beyond the zero stability limit
+    const double * const r = &h_n[nrule_()];
+    const double * const e_dot_n = &h_n[nrule_()+n];
+    double dt_n = h_n[nrule_()+n+6];
+    if (dt_n <= 0.0) {
+      return solve(this, x, &ts, tol_, miter_, verbose_, false, rtol_);
+    }
+    double w = ts.dt / dt_n;
+    if (w > 1.0 + sqrt(2.0)) {
+      return solve(this, x, &ts, tol_, miter_, verbose_, false, rtol_);
+    }
+    double a = w / (1.0 + 2.0 * w);
+    ts.theta = (1.0 + w) / (1.0 + 2.0 * w);
+
+    // Shift the old rates to the new strain rate, so that changes in the
+    // loading direction do not pollute the step
+    ier = rates_(y_n, ts, T_n, f, D);
+    if (ier != SUCCESS) return ier;
+    double de[6];
+    sub_vec(ts.e_dot, e_dot_n, 6, de);
+    mat_vec(D, n, de, 6, f);
+    for (int i=0; i<n; i++) ts.g[i] = a * (r[i] + f[i]);
+    for (int i=0; i<n*6; i++) ts.dg[i] = a * D[i];
+  }
+  else if (scheme_ == SDIRK) {
+    // Two stage, L-stable, stiffly accurate SDIRK
+    const double gamma = 1.0 - sqrt(2.0) / 2.0;
+
+    // First stage
+    ts.theta = gamma;
+    ts.T = T_n + gamma * (T_np1 - T_n);
+    ier = solve(this, x, &ts, tol_, miter_, verbose_, false, rtol_);
+    if (ier != SUCCESS) return ier;
+
+    // The stage enters the second stage through
+    // g * dt = (1 - gamma) / gamma * (Y1 - y_n)
+    if (tangent) {
+      std::vector<double> Rv(n);
+      double * R = &Rv[0];
+      std::vector<double> Jv(n*n);
+      double * J = &Jv[0];
+      ier = RJ(x, &ts, R, J);
+      if (ier != SUCCESS) return ier;
+      ier = invert_mat(J, n);
+      if (ier != SUCCESS) return ier;
+      ier = rates_(x, ts, ts.T, f, D);
+      if (ier != SUCCESS) return ier;
+      mat_mat(n, 6, n, J, D, &ts.dg[0]);
+      for (int i=0; i<n*6; i++) ts.dg[i] *= -(1.0 - gamma);
+    }
+    for (int i=0; i<n; i++) {
+      ts.g[i] = (1.0 - gamma) / gamma * (x[i] - y_n[i]) / ts.dt;
+    }
+    ts.T = T_np1;
+  }
+
+  return solve(this, x, &ts, tol_, miter_, verbose_, false, rtol_);
+}
+
+int GeneralIntegrator::rates_(const double * const y, const GITrialState & ts,
+                              double T, double * const f, double * const D)
+{
+  int nhist = nrule_();
+
+  double s_mod[6];
+  std::copy(y, y+6, s_mod);
+  if (norm2_vec(y, 6) < std::numeric_limits<double>::epsilon()) {
+    s_mod[0] = 2.0 * std::numeric_limits<double>::epsilon();
+  }
+  const double * const h = &y[6];
+
+  int ier = rule_->s(s_mod, h, ts.e_dot, T, ts.Tdot, f);
+  if (ier != SUCCESS) return ier;
+  ier = rule_->a(s_mod, h, ts.e_dot, T, ts.Tdot, &f[6]);
+  if (ier != SUCCESS) return ier;
+  if (D == nullptr) return 0;
+
+  ier = rule_->ds_de(s_mod, h, ts.e_dot, T, ts.Tdot, D);
+  if (ier != SUCCESS) return ier;
+  if (nhist > 0) {
+    ier = rule_->da_de(s_mod, h, ts.e_dot, T, ts.Tdot, &D[36]);
+    if (ier != SUCCESS) return ier;
+  }
+
+  return 0;
+}
+
+int GeneralIntegrator::explicit_update_(
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n, double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1, GITrialState & ts)
+{
+  int ier = make_trial_state(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_n, h_n,
+                             ts);
+  if (ier != SUCCESS) return ier;
+
+  size_t n = nparams();
+  std::vector<double> y(n);
+  std::copy(s_n, s_n+6, y.begin());
+  std::copy(h_n, h_n+nrule_(), y.begin()+6);
+
+  auto f = [this, &ts, T_n](const double * const yi, double tau,
+                            double * const rate) -> int
+  {
+    return rates_(yi, ts, T_n + ts.Tdot * tau, rate, nullptr);
+  };
+  std::vector<double> w(n, 1.0);
+  ier = cash_karp(f, y, ts.dt, w, etol_, 1 << max_divide_);
+  if (ier != SUCCESS) return ier;
+
+  std::copy(y.begin(), y.begin()+6, s_np1);
+  std::copy(y.begin()+6, y.end(), h_np1);
+
+  // There is no consistent tangent, but the stress rate derivative is the
+  // right limit for the small steps explicit codes take
+  std::vector<double> fv(n);
+  std::vector<double> Dv(n*6);
+  ier = rates_(&y[0], ts, T_np1, &fv[0], &Dv[0]);
+  if (ier != SUCCESS) return ier;
+  std::copy(Dv.begin(), Dv.begin()+36, A_np1);
+
+  return 0;
+}
+
+void GeneralIntegrator::calc_work_(
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    const double * const s_np1, const double * const s_n,
+    const double * const h_np1, const double * const h_n,
+    const GITrialState & ts,
+    double & u_np1, double u_n, double & p_np1, double p_n)
+{
+  // Energy calculation (trapezoid rule)
+  double de[6];
+  double ds[6];
+  sub_vec(e_np1, e_n, 6, de);
+  add_vec(s_np1, s_n, 6, ds);
+  for (int i=0; i<6; i++) ds[i] /= 2.0;
+  u_np1 = u_n + dot_vec(ds, de, 6);
+
+  // Need a special call
+  double p_dot_np1;
+  rule_->work_rate(s_np1, h_np1, ts.e_dot, T_np1, ts.Tdot, p_dot_np1);
+  double p_dot_n;
+  rule_->work_rate(s_n, h_n, ts.e_dot, T_n, ts.Tdot, p_dot_n);
+  p_np1 = p_n + (p_dot_np1 + p_dot_n)/2.0 * ts.dt;
+}
+
+void GeneralIntegrator::record_rates_(const double * const x,
+                                      const GITrialState & ts,
+                                      const double * const h_n,
+                                      double * const h_np1) const
+{
+  size_t nr = nrule_();
+  size_t n = nparams();
+
+  if (ts.dt <= 0.0) {
+    std::copy(h_n+nr, h_n+nhist(), h_np1+nr);
+    return;
+  }
+
+  for (size_t i=0; i<6; i++) h_np1[nr+i] = (x[i] - ts.s_n[i]) / ts.dt;
+  for (size_t i=0; i<nr; i++) {
+    h_np1[nr+6+i] = (x[6+i] - ts.h_n[i]) / ts.dt;
+  }
+  std::copy(ts.e_dot, ts.e_dot+6, h_np1+nr+n);
+  h_np1[nr+n+6] = ts.dt;
+}
+
+size_t GeneralIntegrator::nrule_() const
+{
+  return rule_->nhist();
+}
+
 // Start KMRegimeModel
 KMRegimeModel::KMRegimeModel(std::shared_ptr<LinearElasticModel> emodel,
                              std::vector<std::shared_ptr<NEMLModel_sd>> models,
@@ -1764,6 +3105,7 @@ int KMRegimeModel::update_sd(
     double & u_np1, double u_n,
     double & p_np1, double p_n)
 {
+  NEML_TRACE_SCOPE("KMRegimeModel::update_sd");
   // Calculate activation energy
   double g = activation_energy_(e_np1, e_n, T_np1, t_np1, t_n);
 
@@ -1818,4 +3160,388 @@ int KMRegimeModel::set_elastic_model(std::shared_ptr<LinearElasticModel> emodel)
   return 0;
 }
 
+double KMRegimeModel::cost() const
+{
+  double c = 0.0;
+  for (auto it = models_.begin(); it != models_.end(); ++it) {
+    c = std::max(c, (*it)->cost());
+  }
+  return c;
+}
+
+double KMRegimeModel::iteration_cost() const
+{
+  double c = 0.0;
+  for (auto it = models_.begin(); it != models_.end(); ++it) {
+    c = std::max(c, (*it)->iteration_cost());
+  }
+  return c;
+}
+
+// Start MemoizedModel
+CacheStats::CacheStats()
+{
+  reset();
+}
+
+void CacheStats::reset()
+{
+  hits = 0;
+  misses = 0;
+  evictions = 0;
+}
+
+// Unique ids for each MemoizedModel, addresses can be reused
+static std::atomic<size_t> memo_next_id(0);
+
+MemoizedModel::MemoizedModel(std::shared_ptr<LinearElasticModel> emodel,
+                             std::shared_ptr<NEMLModel_sd> model,
+                             int size,
+                             std::shared_ptr<Interpolate> alpha,
+                             bool truesdell) :
+    NEMLModel_sd(emodel, alpha, truesdell), model_(model), size_(size),
+    id_(memo_next_id++), generation_(0)
+{
+  if (size < 1) {
+    throw std::invalid_argument("The cache needs at least one entry");
+  }
+}
+
+MemoizedModel::~MemoizedModel()
+{
+
+}
+
+std::string MemoizedModel::type()
+{
+  return "MemoizedModel";
+}
+
+ParameterSet MemoizedModel::parameters()
+{
+  ParameterSet pset(MemoizedModel::type());
+
+  pset.add_parameter<NEMLObject>("elastic");
+  pset.add_parameter<NEMLObject>("model");
+
+  pset.add_optional_parameter<int>("size", 64);
+  pset.add_optional_parameter<NEMLObject>("alpha",
+                                          std::make_shared<ConstantInterpolate>(0.0));
+
+  pset.add_optional_parameter<bool>("truesdell", true);
+
+  return pset;
+}
+
+std::unique_ptr<NEMLObject> MemoizedModel::initialize(ParameterSet & params)
+{
+  return neml::make_unique<MemoizedModel>(
+      params.get_object_parameter<LinearElasticModel>("elastic"),
+      params.get_object_parameter<NEMLModel_sd>("model"),
+      params.get_parameter<int>("size"),
+      params.get_object_parameter<Interpolate>("alpha"),
+      params.get_parameter<bool>("truesdell")
+      ); 
+}
+
+int MemoizedModel::update_sd(
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1,
+    double & u_np1, double u_n,
+    double & p_np1, double p_n)
+{
+  NEML_TRACE_SCOPE("MemoizedModel::update_sd");
+  Cache & c = cache_();
+  size_t nh = nhist();
+  size_t nk = c.key.size();
+  size_t nv = c.values.size() / size_;
+
+  // Key is every input
+  double * key = &c.key[0];
+  std::copy(e_np1, e_np1+6, key);
+  std::copy(e_n, e_n+6, key+6);
+  key[12] = T_np1;
+  key[13] = T_n;
+  key[14] = t_np1;
+  key[15] = t_n;
+  std::copy(s_n, s_n+6, key+16);
+  std::copy(h_n, h_n+nh, key+22);
+  key[22+nh] = u_n;
+  key[23+nh] = p_n;
+
+  // FNV-1a on the raw bytes
+  const unsigned char * bytes = reinterpret_cast<const unsigned char*>(key);
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i=0; i<nk*sizeof(double); i++) {
+    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+  }
+  size_t slot = hash % size_;
+  double * ckey = &c.keys[slot*nk];
+  double * value = &c.values[slot*nv];
+
+  if (c.valid[slot] && 
+      (std::memcmp(ckey, key, nk*sizeof(double)) == 0)) {
+    c.stats.hits++;
+    std::copy(value, value+6, s_np1);
+    std::copy(value+6, value+6+nh, h_np1);
+    std::copy(value+6+nh, value+42+nh, A_np1);
+    u_np1 = value[42+nh];
+    p_np1 = value[43+nh];
+    return 0;
+  }
+
+  c.stats.misses++;
+  int ier = model_->update_sd(e_np1, e_n, T_np1, T_n, t_np1, t_n, 
+                              s_np1, s_n, h_np1, h_n, A_np1, u_np1, u_n,
+                              p_np1, p_n);
+  if (ier != SUCCESS) return ier;
+
+  if (c.valid[slot]) c.stats.evictions++;
+  c.valid[slot] = 1;
+  std::copy(key, key+nk, ckey);
+  std::copy(s_np1, s_np1+6, value);
+  std::copy(h_np1, h_np1+nh, value+6);
+  std::copy(A_np1, A_np1+36, value+6+nh);
+  value[42+nh] = u_np1;
+  value[43+nh] = p_np1;
+
+  return 0;
+}
+
+size_t MemoizedModel::nhist() const
+{
+  return model_->nhist();
+}
+
+int MemoizedModel::init_hist(double * const hist) const
+{
+  return model_->init_hist(hist);
+}
+
+int MemoizedModel::set_elastic_model(std::shared_ptr<LinearElasticModel> emodel)
+{
+  elastic_ = emodel;
+  generation_++;
+  return model_->set_elastic_model(emodel);
+}
+
+double MemoizedModel::alpha(double T) const
+{
+  return model_->alpha(T);
+}
+
+int MemoizedModel::elastic_strains(const double * const s_np1,
+                                   double T_np1, const double * const h_np1,
+                                   double * const e_np1) const
+{
+  return model_->elastic_strains(s_np1, T_np1, h_np1, e_np1);
+}
+
+double MemoizedModel::bulk(double T) const
+{
+  return model_->bulk(T);
+}
+
+double MemoizedModel::shear(double T) const
+{
+  return model_->shear(T);
+}
+
+double MemoizedModel::cost() const
+{
+  return model_->cost();
+}
+
+double MemoizedModel::iteration_cost() const
+{
+  return model_->iteration_cost();
+}
+
+double MemoizedModel::point_cost(const double * const h) const
+{
+  return model_->point_cost(h);
+}
+
+bool MemoizedModel::failed(const double * const h) const
+{
+  return model_->failed(h);
+}
+
+CacheStats MemoizedModel::cache_stats() const
+{
+  return cache_().stats;
+}
+
+void MemoizedModel::clear_cache()
+{
+  Cache & c = cache_();
+  std::fill(c.valid.begin(), c.valid.end(), 0);
+  c.stats.reset();
+}
+
+MemoizedModel::Cache & MemoizedModel::cache_() const
+{
+  // The last cache this thread used, so repeated updates skip the lock.
+  // Ids are never reused, so a cache freed with its model is never
+  // looked up through here again.
+  static thread_local size_t last_id = std::numeric_limits<size_t>::max();
+  static thread_local Cache * last = nullptr;
+  if (last_id != id_) {
+    std::lock_guard<std::mutex> lock(caches_mutex_);
+    std::unique_ptr<Cache> & p = caches_[std::this_thread::get_id()];
+    if (!p) p.reset(new Cache());
+    last = p.get();
+    last_id = id_;
+  }
+
+  Cache & c = *last;
+  size_t nh = nhist();
+  size_t generation = generation_.load();
+  if (c.key.size() != 24 + nh) {
+    c.key.resize(24 + nh);
+    c.keys.resize(size_ * (24 + nh));
+    c.values.resize(size_ * (44 + nh));
+    c.valid.assign(size_, 0);
+    c.generation = generation;
+  }
+  else if (c.generation != generation) {
+    std::fill(c.valid.begin(), c.valid.end(), 0);
+    c.generation = generation;
+  }
+  return c;
+}
+
+// Start CostTrackingModel
+CostTrackingModel::CostTrackingModel(std::shared_ptr<LinearElasticModel> emodel,
+                                     std::shared_ptr<NEMLModel_sd> model,
+                                     double weight,
+                                     std::shared_ptr<Interpolate> alpha,
+                                     bool truesdell) :
+    NEMLModel_sd(emodel, alpha, truesdell), model_(model), weight_(weight)
+{
+  if ((weight <= 0.0) || (weight > 1.0)) {
+    throw std::invalid_argument("The weight must be in (0,1]");
+  }
+}
+
+std::string CostTrackingModel::type()
+{
+  return "CostTrackingModel";
+}
+
+ParameterSet CostTrackingModel::parameters()
+{
+  ParameterSet pset(CostTrackingModel::type());
+
+  pset.add_parameter<NEMLObject>("elastic");
+  pset.add_parameter<NEMLObject>("model");
+
+  pset.add_optional_parameter<double>("weight", 0.25);
+  pset.add_optional_parameter<NEMLObject>("alpha",
+                                          std::make_shared<ConstantInterpolate>(0.0));
+
+  pset.add_optional_parameter<bool>("truesdell", true);
+
+  return pset;
+}
+
+std::unique_ptr<NEMLObject> CostTrackingModel::initialize(ParameterSet & params)
+{
+  return neml::make_unique<CostTrackingModel>(
+      params.get_object_parameter<LinearElasticModel>("elastic"),
+      params.get_object_parameter<NEMLModel_sd>("model"),
+      params.get_parameter<double>("weight"),
+      params.get_object_parameter<Interpolate>("alpha"),
+      params.get_parameter<bool>("truesdell")
+      ); 
+}
+
+int CostTrackingModel::update_sd(
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1,
+    double & u_np1, double u_n,
+    double & p_np1, double p_n)
+{
+  NEML_TRACE_SCOPE("CostTrackingModel::update_sd");
+  // The statistics are cumulative, so take the difference
+  size_t niter = solve_stats().niter;
+  int ier = model_->update_sd(e_np1, e_n, T_np1, T_n, t_np1, t_n, 
+                              s_np1, s_n, h_np1, h_n, A_np1, u_np1, u_n,
+                              p_np1, p_n);
+  if (ier != SUCCESS) return ier;
+
+  size_t nc = model_->nhist();
+  double c = model_->update_cost(solve_stats().niter - niter);
+  h_np1[nc] = weight_ * c + (1.0 - weight_) * h_n[nc];
+
+  return 0;
+}
+
+size_t CostTrackingModel::nhist() const
+{
+  return model_->nhist() + 1;
+}
+
+int CostTrackingModel::init_hist(double * const hist) const
+{
+  hist[model_->nhist()] = model_->cost();
+  return model_->init_hist(hist);
+}
+
+int CostTrackingModel::set_elastic_model(std::shared_ptr<LinearElasticModel> emodel)
+{
+  elastic_ = emodel;
+  return model_->set_elastic_model(emodel);
+}
+
+double CostTrackingModel::alpha(double T) const
+{
+  return model_->alpha(T);
+}
+
+int CostTrackingModel::elastic_strains(const double * const s_np1,
+                                       double T_np1, const double * const h_np1,
+                                       double * const e_np1) const
+{
+  return model_->elastic_strains(s_np1, T_np1, h_np1, e_np1);
+}
+
+double CostTrackingModel::bulk(double T) const
+{
+  return model_->bulk(T);
+}
+
+double CostTrackingModel::shear(double T) const
+{
+  return model_->shear(T);
+}
+
+double CostTrackingModel::cost() const
+{
+  return model_->cost();
+}
+
+double CostTrackingModel::iteration_cost() const
+{
+  return model_->iteration_cost();
+}
+
+double CostTrackingModel::point_cost(const double * const h) const
+{
+  return h[model_->nhist()];
+}
+
+bool CostTrackingModel::failed(const double * const h) const
+{
+  return model_->failed(h);
+}
+
 } // namespace neml
@@ -10,9 +10,15 @@
 #include "interpolate.h"
 #include "creep.h"
 
+#include <atomic>
 #include <cstddef>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
+#include <string>
+#include <unordered_map>
 #include <cmath>
 #include <iostream>
 
@@ -23,6 +29,10 @@ namespace neml {
 //  and provides the methods for reading in material parameters.
 class NEMLModel: public NEMLObject {
   public:
+   /// Each model, including copies, gets a new id
+   NEMLModel();
+   NEMLModel(const NEMLModel & other);
+
    /// Total number of stored internal variables
    virtual size_t nstore() const = 0;
    /// Initialize the internal variables
@@ -39,6 +49,38 @@ class NEMLModel: public NEMLObject {
        double & u_np1, double u_n,
        double & p_np1, double p_n) = 0;
 
+   /// Small strain update that also suggests a scale factor for the step
+   //  The scale is returned whether or not the update succeeds and is
+   //  based on the substepping, the Newton convergence, and the inelastic
+   //  strain increment.  Values less than one mean the step should be cut,
+   //  values greater than one mean it can grow.
+   virtual int update_sd_scale(
+       const double * const e_np1, const double * const e_n,
+       double T_np1, double T_n,
+       double t_np1, double t_n,
+       double * const s_np1, const double * const s_n,
+       double * const h_np1, const double * const h_n,
+       double * const A_np1,
+       double & u_np1, double u_n,
+       double & p_np1, double p_n,
+       double & dt_scale);
+
+   /// Update a batch of points sharing this model
+   //  The points are stored one after the other, with the history at a
+   //  stride of nstore, and each point gets its own error code.  The
+   //  default updates the points one at a time.  Returns the first error.
+   virtual int update_sd_batch(
+       size_t npts,
+       const double * const e_np1, const double * const e_n,
+       const double * const T_np1, const double * const T_n,
+       double t_np1, double t_n,
+       double * const s_np1, const double * const s_n,
+       double * const h_np1, const double * const h_n,
+       double * const A_np1,
+       double * const u_np1, const double * const u_n,
+       double * const p_np1, const double * const p_n,
+       int * const ier);
+
    /// Large strain incremental update
    virtual int update_ld_inc(
        const double * const d_np1, const double * const d_n,
@@ -66,8 +108,42 @@ class NEMLModel: public NEMLObject {
    virtual double bulk(double T) const = 0;
    /// Model effective shear modulus
    virtual double shear(double T) const = 0;
+
+   /// Rough cost of an update, relative to an elastic update
+   //  The default assumes a few Newton iterations.  Partitioners can use
+   //  this to weight the points of each model.
+   virtual double cost() const;
+   /// Rough cost of one Newton iteration, relative to an elastic update
+   virtual double iteration_cost() const;
+   /// Cost estimate for a point with the stored variables h
+   //  The default is the static cost of the model.
+   virtual double point_cost(const double * const h) const;
+   /// Cost of an update that took niter Newton iterations in total
+   double update_cost(size_t niter) const;
+
+   /// Has the point with the stored variables h reached a terminal failed
+   /// state?  Callers can use this for element deletion.  Defaults to never
+   /// failing, damage models and wrappers of other models override it.
+   virtual bool failed(const double * const h) const;
+
+   /// Id of this model, never reused in the program, unlike its address
+   size_t model_id() const;
+
+  private:
+   size_t model_id_;
 };
 
+/// Cost of a Newton iteration on n equations, relative to an elastic update
+double newton_cost(size_t n);
+
+/// Cost of an update solved in a typical number of Newton iterations, each
+/// costing iteration_cost plus an update of an inner model costing inner_cost
+double solve_cost(double iteration_cost, double inner_cost = 0.0);
+
+/// Suggest a time step scale factor from the solver statistics for an
+/// update, the equivalent inelastic strain increment, and the error code
+double suggest_step_scale(const SolveStats & stats, double dep, int ier);
+
 /// Small deformation stress update
 class NEMLModel_sd: public NEMLModel {
   public:
@@ -217,6 +293,9 @@ class GITrialState : public TrialState {
   double s_n[6];                  // Previous stress
   double T, Tdot, dt;             // Temperature, temperature rate, time inc.
   std::vector<double> h_n;        // Previous history
+  double theta;                   // Weight on the implicit rates
+  std::vector<double> g;          // Explicit part of the rates
+  std::vector<double> dg;         // Derivative of g*dt wrt the strain
 };
 
 /// Small strain, associative, perfect plasticity
@@ -229,7 +308,9 @@ class SmallStrainPerfectPlasticity: public NEMLModel_sd, public Solvable {
  public:
   /// Parameters: elastic model, yield surface, yield stress, CTE,
   /// integration tolerance, maximum number of iterations,
-  /// verbosity flag, and the maximum number of adaptive subdivisions
+  /// verbosity flag, the maximum number of adaptive subdivisions,
+  /// the relative integration tolerance, and a flag to scale the 
+  /// residual equations by the elastic modulus
   SmallStrainPerfectPlasticity(std::shared_ptr<LinearElasticModel> elastic,
                                std::shared_ptr<YieldSurface> surface,
                                std::shared_ptr<Interpolate> ys,
@@ -237,6 +318,7 @@ class SmallStrainPerfectPlasticity: public NEMLModel_sd, public Solvable {
                                double tol, int miter,
                                bool verbose,
                                int max_divide,
+                               double rtol, bool auto_scale,
                                bool truesdell);
   
   /// Type for the object system
@@ -256,6 +338,18 @@ class SmallStrainPerfectPlasticity: public NEMLModel_sd, public Solvable {
       double * const A_np1,
       double & u_np1, double u_n,
       double & p_np1, double p_n);
+  /// Batched update, solving the plastic points in lockstep
+  virtual int update_sd_batch(
+      size_t npts,
+      const double * const e_np1, const double * const e_n,
+      const double * const T_np1, const double * const T_n,
+      double t_np1, double t_n,
+      double * const s_np1, const double * const s_n,
+      double * const h_np1, const double * const h_n,
+      double * const A_np1,
+      double * const u_np1, const double * const u_n,
+      double * const p_np1, const double * const p_n,
+      int * const ier);
   /// Number of history variables (=0)
   virtual size_t nhist() const;
   /// Initialize history (nothing to do)
@@ -268,6 +362,15 @@ class SmallStrainPerfectPlasticity: public NEMLModel_sd, public Solvable {
   /// Integration residual and jacobian equations
   virtual int RJ(const double * const x, TrialState * ts, double * const R,
                  double * const J);
+  /// Integration residual and jacobian for a batch of points in lockstep
+  virtual void RJ_batch(size_t nbatch, const double * const x,
+                        TrialState * const * ts, const bool * const active,
+                        double * const R, double * const J,
+                        int * const ier);
+  /// Scale the yield surface equation to strain units, if requested
+  virtual int residual_scales(TrialState * ts, double * const scales);
+  /// Cost of a Newton iteration on the return map
+  virtual double iteration_cost() const;
 
   /// Helper to return the yield stress
   double ys(double T) const;
@@ -290,6 +393,9 @@ class SmallStrainPerfectPlasticity: public NEMLModel_sd, public Solvable {
       double & p_np1, double p_n);
   int calc_tangent_(SSPPTrialState ts, const double * const s_np1, double dg, 
                 double * const A_np1);
+  int plastic_finish_(SSPPTrialState & ts, const double * const x,
+                      double * const s_np1, double * const A_np1,
+                      double & p_np1, double p_n);
 
   std::shared_ptr<YieldSurface> surface_;
   std::shared_ptr<Interpolate> ys_;
@@ -297,6 +403,8 @@ class SmallStrainPerfectPlasticity: public NEMLModel_sd, public Solvable {
   const int miter_;
   const bool verbose_;
   const int max_divide_;
+  const double rtol_;
+  const bool auto_scale_;
 };
 
 static Register<SmallStrainPerfectPlasticity> regSmallStrainPerfectPlasticity;
@@ -313,12 +421,16 @@ class SmallStrainRateIndependentPlasticity: public NEMLModel_sd, public Solvable
  public:
   /// Parameters: elasticity model, flow rule, CTE, solver tolerance, maximum
   /// solver iterations, verbosity flag, tolerance on the Kuhn-Tucker conditions
-  /// check, and a flag on whether the KT conditions should be evaluated
+  /// check, a flag on whether the KT conditions should be evaluated, 
+  /// the relative solver tolerance, a flag to scale the residual equations
+  /// by the elastic modulus, the objective rate flag, and the return
+  /// algorithm, "closest_point" or "cutting_plane"
   SmallStrainRateIndependentPlasticity(std::shared_ptr<LinearElasticModel> elastic,
                                        std::shared_ptr<RateIndependentFlowRule> flow,
                                        std::shared_ptr<Interpolate> alpha,
                                        double tol, int miter, bool verbose,double kttol,
-                                       bool check_kt, bool truesdell);
+                                       bool check_kt, double rtol, bool auto_scale,
+                                       bool truesdell, std::string algorithm);
 
   /// Type for the object system
   static std::string type();
@@ -351,6 +463,10 @@ class SmallStrainRateIndependentPlasticity: public NEMLModel_sd, public Solvable
   /// system of equations integrating the model
   virtual int RJ(const double * const x, TrialState * ts, double * const R,
                  double * const J);
+  /// Scale the consistency equation to strain units, if requested
+  virtual int residual_scales(TrialState * ts, double * const scales);
+  /// Cost of a closest point iteration on the return map
+  virtual double iteration_cost() const;
   
   /// Return the elastic model for subobjects
   const std::shared_ptr<const LinearElasticModel> elastic() const;
@@ -362,15 +478,18 @@ class SmallStrainRateIndependentPlasticity: public NEMLModel_sd, public Solvable
                        SSRIPTrialState & ts);
 
  private:
-  int calc_tangent_(const double * const x, TrialState * ts, const double * const s_np1,
-                    const double * const h_np1, double dg, double * const A_np1);
+  int calc_tangent_(const SSRIPTrialState & ts, double * const J,
+                    double * const A_np1);
   int check_K_T_(const double * const s_np1, const double * const h_np1, double T_np1, double dg);
+  int cutting_plane_return_(SSRIPTrialState & ts, double * const x);
 
   std::shared_ptr<RateIndependentFlowRule> flow_;
 
-  double tol_, kttol_;
+  double tol_, kttol_, rtol_;
   int miter_;
-  bool verbose_, check_kt_;
+  bool verbose_, check_kt_, auto_scale_;
+  enum Algorithm {CLOSEST_POINT, CUTTING_PLANE};
+  Algorithm algorithm_;
 };
 
 static Register<SmallStrainRateIndependentPlasticity> regSmallStrainRateIndependentPlasticity;
@@ -382,8 +501,12 @@ class SmallStrainCreepPlasticity: public NEMLModel_sd, public Solvable {
  public:
   /// Parameters are an elastic model, a base NEMLModel_sd, a CreepModel,
   /// the CTE, a solution tolerance, the maximum number of nonlinear
-  /// iterations, a verbosity flag, and a scale factor to regularize
-  /// the nonlinear equations.
+  /// iterations, a verbosity flag, a scale factor to regularize
+  /// the nonlinear equations, the relative solution tolerance, a flag
+  /// to measure the residual in strain units in place of the scale factor,
+  /// a flag to relax the stress semi-analytically during strain holds,
+  /// a flag to integrate the creep strain explicitly, the explicit error
+  /// tolerance, and the maximum number of explicit subdivisions
   SmallStrainCreepPlasticity(
                              std::shared_ptr<LinearElasticModel> elastic,
                              std::shared_ptr<NEMLModel_sd> plastic,
@@ -391,6 +514,9 @@ class SmallStrainCreepPlasticity: public NEMLModel_sd, public Solvable {
                              std::shared_ptr<Interpolate> alpha,
                              double tol, int miter,
                              bool verbose, double sf,
+                             double rtol, bool auto_scale,
+                             bool relax_holds,
+                             bool use_explicit, double etol, int max_divide,
                              bool truesdell);
 
   /// Type for the object system
@@ -423,6 +549,12 @@ class SmallStrainCreepPlasticity: public NEMLModel_sd, public Solvable {
   /// Residual equation to solve and corresponding jacobian
   virtual int RJ(const double * const x, TrialState * ts, double * const R,
                  double * const J);
+  /// Apply the scale factor to the residual, unless scaling automatically
+  virtual int residual_scales(TrialState * ts, double * const scales);
+  /// Cost of a Newton iteration, not counting the plastic update
+  virtual double iteration_cost() const;
+  /// Includes an update of the plastic model each iteration
+  virtual double cost() const;
   
   /// Setup a trial state from known information
   int make_trial_state(const double * const e_np1, const double * const e_n,
@@ -435,15 +567,28 @@ class SmallStrainCreepPlasticity: public NEMLModel_sd, public Solvable {
 
  private:
   int form_tangent_(double * const A, double * const B,
-                    double * const A_np1);
+                    const double * const s_np1, double * const A_np1);
+  int relax_(SSCPTrialState & ts, const double * const creep_old,
+             double * const x, double * const s_np1, double * const h_np1,
+             double * const A, double * const creep_new, double * const B,
+             double & u_np1, double u_n, double & p_np1, double p_n,
+             bool & relaxed);
+  /// Integrate the creep strain explicitly, the plastic model supplies the
+  /// stress at each stage
+  int explicit_update_(SSCPTrialState & ts, const double * const creep_old,
+                       double * const x, double * const s_np1,
+                       double * const h_np1, double * const A,
+                       double * const creep_new,
+                       double & u_np1, double u_n, double & p_np1,
+                       double p_n);
 
  private:
   std::shared_ptr<NEMLModel_sd> plastic_;
   std::shared_ptr<CreepModel> creep_;
 
-  double tol_, sf_;
-  int miter_;
-  bool verbose_;
+  double tol_, sf_, rtol_, etol_;
+  int miter_, max_divide_;
+  bool verbose_, auto_scale_, relax_holds_, explicit_;
 };
 
 static Register<SmallStrainCreepPlasticity> regSmallStrainCreepPlasticity;
@@ -455,13 +600,18 @@ class GeneralIntegrator: public NEMLModel_sd, public Solvable {
  public:
   /// Parameters are an elastic model, a general flow rule,
   /// the CTE, the integration tolerance, the maximum
-  /// nonlinear iterations, a verbosity flag, and the
-  /// maximum number of subdivisions for adaptive integration
+  /// nonlinear iterations, a verbosity flag, the
+  /// maximum number of subdivisions for adaptive integration,
+  /// the relative integration tolerance, a flag to scale the
+  /// residual equations by the elastic modulus, the time integration
+  /// scheme, and the error tolerance for the explicit scheme
   GeneralIntegrator(std::shared_ptr<LinearElasticModel> elastic,
                     std::shared_ptr<GeneralFlowRule> rule,
                     std::shared_ptr<Interpolate> alpha,
                     double tol, int miter,
                     bool verbose, int max_divide,
+                    double rtol, bool auto_scale,
+                    std::string scheme, double etol,
                     bool truesdell);
 
   /// Type for the object system
@@ -482,6 +632,19 @@ class GeneralIntegrator: public NEMLModel_sd, public Solvable {
       double & u_np1, double u_n,
       double & p_np1, double p_n);
 
+  /// Batched update, solving backward Euler steps in lockstep
+  virtual int update_sd_batch(
+      size_t npts,
+      const double * const e_np1, const double * const e_n,
+      const double * const T_np1, const double * const T_n,
+      double t_np1, double t_n,
+      double * const s_np1, const double * const s_n,
+      double * const h_np1, const double * const h_n,
+      double * const A_np1,
+      double * const u_np1, const double * const u_n,
+      double * const p_np1, const double * const p_n,
+      int * const ier);
+
   /// Number of history variables
   virtual size_t nhist() const;
   /// Initialize the history at time zero
@@ -494,12 +657,69 @@ class GeneralIntegrator: public NEMLModel_sd, public Solvable {
   /// The residual and jacobian for the nonlinear solve
   virtual int RJ(const double * const x, TrialState * ts,
                  double * const R, double * const J);
+  /// Scale the stress equations to strain units, if requested
+  virtual int residual_scales(TrialState * ts, double * const scales);
+  /// Cost of a Newton iteration on one step or substep
+  virtual double iteration_cost() const;
 
   /// Initialize a trial state
   int make_trial_state(const double * const e_np1, const double * const e_n,
                        double T_np1, double T_n, double t_np1, double t_n,
                        const double * const s_n, const double * const h_n,
                        GITrialState & ts);
+
+  /// Can sensitivity_sd give the sensitivities of this model's steps?
+  bool forward_sensitivities() const;
+  /// Update with the forward sensitivities to a set of parameters
+  //  Each pair of perturbed models are copies of this one with one
+  //  parameter moved up and down by its step dv, and the step inputs move
+  //  along their sensitivities, stored parameter by parameter with dh at a
+  //  stride of nstore.  The central difference of the backward Euler
+  //  residual at the converged state, solved with the jacobian of the
+  //  step, gives the sensitivities of the stress and history, so each
+  //  parameter costs two residuals and one linear solve.  If the step is
+  //  subdivided the sensitivities go through each substep in turn, with
+  //  the strain sensitivities interpolated like the strain.  The stored
+  //  variables past the history do not change in a small strain update,
+  //  so their sensitivities are zero.  Only for backward Euler.
+  int update_sensitivity_sd(
+      const std::vector<GeneralIntegrator*> & plus,
+      const std::vector<GeneralIntegrator*> & minus,
+      const std::vector<double> & dv,
+      const double * const e_np1, const double * const e_n,
+      double T_np1, double T_n,
+      double t_np1, double t_n,
+      double * const s_np1, const double * const s_n,
+      double * const h_np1, const double * const h_n,
+      double * const A_np1,
+      double & u_np1, double u_n,
+      double & p_np1, double p_n,
+      const double * const de_np1, const double * const de_n,
+      double * const ds_np1, const double * const ds_n,
+      double * const dh_np1, const double * const dh_n,
+      double * const du_np1, const double * const du_n,
+      double * const dp_np1, const double * const dp_n);
+  /// Forward sensitivities of a finished step, as for
+  /// update_sensitivity_sd
+  //  A converged state that does not zero the residual of the whole step
+  //  came from substeps, which are then integrated again to carry the
+  //  sensitivities through them.
+  int sensitivity_sd(
+      const std::vector<GeneralIntegrator*> & plus,
+      const std::vector<GeneralIntegrator*> & minus,
+      const std::vector<double> & dv,
+      const double * const e_np1, const double * const e_n,
+      double T_np1, double T_n,
+      double t_np1, double t_n,
+      const double * const s_np1, const double * const s_n,
+      const double * const h_np1, const double * const h_n,
+      double u_np1, double u_n,
+      double p_np1, double p_n,
+      const double * const de_np1, const double * const de_n,
+      double * const ds_np1, const double * const ds_n,
+      double * const dh_np1, const double * const dh_n,
+      double * const du_np1, const double * const du_n,
+      double * const dp_np1, const double * const dp_n);
   
   /// Set a new elastic model
   virtual int set_elastic_model(std::shared_ptr<LinearElasticModel> emodel);
@@ -507,11 +727,98 @@ class GeneralIntegrator: public NEMLModel_sd, public Solvable {
  private:
   int calc_tangent_(const double * const x, TrialState * ts, double * const A_np1);
 
+  /// Called after each converged substep with its inputs, the solution x,
+  /// and the fractions of the whole step at its start and end
+  typedef std::function<int(const double * e_next, const double * e_past,
+                            double T_next, double T_past,
+                            double t_next, double t_past,
+                            const double * s_past, const double * h_past,
+                            const double * x, double f_past,
+                            double f_next)> SubstepFn;
+  /// Integrate the implicit schemes, subdividing the step as needed, and
+  /// return the number of divisions in nd
+  int substep_(const double * const e_np1, const double * const e_n,
+               double T_np1, double T_n, double t_np1, double t_n,
+               double * const s_np1, const double * const s_n,
+               double * const h_np1, const double * const h_n,
+               GITrialState & ts, int & nd, const SubstepFn & substep);
+  /// Tangent and work over the whole step after substep_
+  int finish_step_(const double * const e_np1, const double * const e_n,
+                   double T_np1, double T_n, double t_np1, double t_n,
+                   const double * const s_np1, const double * const s_n,
+                   const double * const h_np1, const double * const h_n,
+                   double * const A_np1,
+                   double & u_np1, double u_n, double & p_np1, double p_n,
+                   GITrialState & ts, int nd);
+  /// Stress and history sensitivities of one backward Euler (sub)step
+  /// converged to x
+  int sensitivity_step_(const std::vector<GeneralIntegrator*> & plus,
+                        const std::vector<GeneralIntegrator*> & minus,
+                        const std::vector<double> & dv,
+                        const double * const e_np1, const double * const e_n,
+                        double T_np1, double T_n, double t_np1, double t_n,
+                        const double * const x,
+                        const double * const s_n, const double * const h_n,
+                        const double * const de_np1,
+                        const double * const de_n,
+                        double * const ds_np1, const double * const ds_n,
+                        double * const dh_np1, const double * const dh_n);
+  /// Energy and work sensitivities over the whole step
+  int sensitivity_work_(const std::vector<GeneralIntegrator*> & plus,
+                        const std::vector<GeneralIntegrator*> & minus,
+                        const std::vector<double> & dv,
+                        const double * const e_np1, const double * const e_n,
+                        double T_np1, double T_n, double t_np1, double t_n,
+                        const double * const s_np1, const double * const s_n,
+                        const double * const h_np1, const double * const h_n,
+                        double u_n, double p_n,
+                        const double * const de_np1,
+                        const double * const de_n,
+                        const double * const ds_np1,
+                        const double * const ds_n,
+                        const double * const dh_np1,
+                        const double * const dh_n,
+                        double * const du_np1, const double * const du_n,
+                        double * const dp_np1, const double * const dp_n);
+
+  /// Integrate one (sub)step with the chosen scheme, optionally setting up
+  /// the trial state for the consistent tangent
+  int integrate_step_(const double * const e_np1, const double * const e_n,
+                      double T_np1, double T_n, double t_np1, double t_n,
+                      const double * const s_n, const double * const h_n,
+                      double * const x, GITrialState & ts, bool tangent);
+  /// Explicit Runge-Kutta update over the whole step
+  int explicit_update_(const double * const e_np1, const double * const e_n,
+                       double T_np1, double T_n, double t_np1, double t_n,
+                       double * const s_np1, const double * const s_n,
+                       double * const h_np1, const double * const h_n,
+                       double * const A_np1, GITrialState & ts);
+  /// Energy and work with the trapezoid rule
+  void calc_work_(const double * const e_np1, const double * const e_n,
+                  double T_np1, double T_n,
+                  const double * const s_np1, const double * const s_n,
+                  const double * const h_np1, const double * const h_n,
+                  const GITrialState & ts,
+                  double & u_np1, double u_n, double & p_np1, double p_n);
+  /// Rates and their strain derivatives at a fixed state, skipping the
+  /// derivatives if D is null
+  int rates_(const double * const y, const GITrialState & ts, double T,
+             double * const f, double * const D);
+  /// Save the BDF2 rate history after a step
+  void record_rates_(const double * const x, const GITrialState & ts,
+                     const double * const h_n, double * const h_np1) const;
+  /// Number of history variables in the flow rule
+  size_t nrule_() const;
+
+  /// Time integration schemes
+  enum Scheme {BACKWARD_EULER, TRAPEZOIDAL, BDF2, SDIRK, EXPLICIT};
+
   std::shared_ptr<GeneralFlowRule> rule_;
 
-  double tol_;
+  double tol_, rtol_, etol_;
   int miter_, max_divide_;
-  bool verbose_;
+  bool verbose_, auto_scale_;
+  Scheme scheme_;
 };
 
 static Register<GeneralIntegrator> regGeneralIntegrator;
@@ -570,6 +877,11 @@ class KMRegimeModel: public NEMLModel_sd {
   /// Set a new elastic model
   virtual int set_elastic_model(std::shared_ptr<LinearElasticModel> emodel);
 
+  /// The most expensive of the regime models
+  virtual double cost() const;
+  /// The most expensive of the regime models
+  virtual double iteration_cost() const;
+
  private:
   double activation_energy_(const double * const e_np1, 
                             const double * const e_n,
@@ -584,5 +896,187 @@ class KMRegimeModel: public NEMLModel_sd {
 
 static Register<KMRegimeModel> regKMRegimeModel;
 
+/// Hit and miss statistics for a MemoizedModel cache
+class CacheStats {
+ public:
+  CacheStats();
+
+  /// Clear the statistics
+  void reset();
+
+  size_t hits;      // Updates returned from the cache
+  size_t misses;    // Updates passed on to the model
+  size_t evictions; // Cached updates replaced by newer ones
+};
+
+/// Caches the stress updates of another small strain model
+//  Calls to update_sd with bitwise identical strains, temperatures, times,
+//  stress, history, and energy as a cached call return the stored stress,
+//  history, tangent, and energy without calling the base model.
+//  This helps when many points see the same loading, for example in
+//  purely thermal steps or uniformly loaded regions of a mesh.
+//
+//  The cache is a fixed size, direct mapped hash table.  Each thread keeps
+//  its own copy for each model, so no locking is needed.
+class MemoizedModel: public NEMLModel_sd {
+ public:
+  /// Parameters are an elastic model, the base model, the number of
+  /// cache entries, and the CTE
+  MemoizedModel(std::shared_ptr<LinearElasticModel> emodel,
+                std::shared_ptr<NEMLModel_sd> model,
+                int size,
+                std::shared_ptr<Interpolate> alpha,
+                bool truesdell);
+  virtual ~MemoizedModel();
+
+  /// Type for the object system
+  static std::string type();
+  /// Parameters for the object system
+  static ParameterSet parameters();
+  /// Setup from a ParameterSet
+  static std::unique_ptr<NEMLObject> initialize(ParameterSet & params);
+
+  /// The small strain stress update
+  virtual int update_sd(
+      const double * const e_np1, const double * const e_n,
+      double T_np1, double T_n,
+      double t_np1, double t_n,
+      double * const s_np1, const double * const s_n,
+      double * const h_np1, const double * const h_n,
+      double * const A_np1,
+      double & u_np1, double u_n,
+      double & p_np1, double p_n);
+
+  /// The number of model history variables
+  virtual size_t nhist() const;
+  /// Initialize history at time zero
+  virtual int init_hist(double * const hist) const;
+
+  /// The CTE of the base model
+  virtual double alpha(double T) const;
+  /// The elastic strains of the base model
+  virtual int elastic_strains(const double * const s_np1,
+                              double T_np1, const double * const h_np1,
+                              double * const e_np1) const;
+  /// The bulk modulus of the base model
+  virtual double bulk(double T) const;
+  /// The shear modulus of the base model
+  virtual double shear(double T) const;
+
+  /// Set a new elastic model, which also empties the caches
+  //  The caches of other threads are emptied before their next update, but
+  //  the base model itself must not be updating at the same time.
+  virtual int set_elastic_model(std::shared_ptr<LinearElasticModel> emodel);
+
+  /// The cost of the base model
+  virtual double cost() const;
+  /// The cost of the base model
+  virtual double iteration_cost() const;
+  /// The cost of the base model
+  virtual double point_cost(const double * const h) const;
+  /// Has the base model failed?
+  virtual bool failed(const double * const h) const;
+
+  /// Cache statistics for the calling thread
+  CacheStats cache_stats() const;
+  /// Empty the cache and reset the statistics for the calling thread
+  void clear_cache();
+
+ private:
+  struct Cache {
+    std::vector<double> keys;
+    std::vector<double> values;
+    std::vector<char> valid;
+    std::vector<double> key;
+    size_t generation;
+    CacheStats stats;
+  };
+
+  Cache & cache_() const;
+
+ private:
+  std::shared_ptr<NEMLModel_sd> model_;
+  size_t size_, id_;
+  // Bumped when the elastic model changes, checked by every thread's cache
+  std::atomic<size_t> generation_;
+
+  // One cache per calling thread, owned here so they go with the model
+  mutable std::mutex caches_mutex_;
+  mutable std::unordered_map<std::thread::id, std::unique_ptr<Cache>> caches_;
+};
+
+static Register<MemoizedModel> regMemoizedModel;
+
+/// Learns the cost of each point from the updates of another model
+//  The last history variable is a running average of the cost of the
+//  recent updates at the point, found from the Newton iterations they took
+//  (see NEMLModel::update_cost), and point_cost returns it.  So points in
+//  substepping or nested solves weigh more than elastic points, and a
+//  partitioner or the block driver can balance the work.  The average
+//  starts at the static cost of the model and each update moves it by the
+//  fraction weight toward the cost of that update.
+class CostTrackingModel: public NEMLModel_sd {
+ public:
+  /// Parameters are an elastic model, the base model, the weight of the
+  /// newest update in the average, and the CTE
+  CostTrackingModel(std::shared_ptr<LinearElasticModel> emodel,
+                    std::shared_ptr<NEMLModel_sd> model,
+                    double weight,
+                    std::shared_ptr<Interpolate> alpha,
+                    bool truesdell);
+
+  /// Type for the object system
+  static std::string type();
+  /// Parameters for the object system
+  static ParameterSet parameters();
+  /// Setup from a ParameterSet
+  static std::unique_ptr<NEMLObject> initialize(ParameterSet & params);
+
+  /// The small strain stress update
+  virtual int update_sd(
+      const double * const e_np1, const double * const e_n,
+      double T_np1, double T_n,
+      double t_np1, double t_n,
+      double * const s_np1, const double * const s_n,
+      double * const h_np1, const double * const h_n,
+      double * const A_np1,
+      double & u_np1, double u_n,
+      double & p_np1, double p_n);
+
+  /// The base model history plus the cost
+  virtual size_t nhist() const;
+  /// Initialize history at time zero
+  virtual int init_hist(double * const hist) const;
+
+  /// The CTE of the base model
+  virtual double alpha(double T) const;
+  /// The elastic strains of the base model
+  virtual int elastic_strains(const double * const s_np1,
+                              double T_np1, const double * const h_np1,
+                              double * const e_np1) const;
+  /// The bulk modulus of the base model
+  virtual double bulk(double T) const;
+  /// The shear modulus of the base model
+  virtual double shear(double T) const;
+
+  /// Set a new elastic model
+  virtual int set_elastic_model(std::shared_ptr<LinearElasticModel> emodel);
+
+  /// The cost of the base model
+  virtual double cost() const;
+  /// The cost of the base model
+  virtual double iteration_cost() const;
+  /// The running average cost at the point
+  virtual double point_cost(const double * const h) const;
+  /// Has the base model failed?
+  virtual bool failed(const double * const h) const;
+
+ private:
+  std::shared_ptr<NEMLModel_sd> model_;
+  double weight_;
+};
+
+static Register<CostTrackingModel> regCostTrackingModel;
+
 } // namespace neml
 #endif // MODELS_H
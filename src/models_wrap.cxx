@@ -15,6 +15,13 @@ PYBIND11_MODULE(models, m) {
   py::module::import("neml.solvers");
 
   m.doc() = "Base class for all material models.";
+
+  m.def("suggest_step_scale", &suggest_step_scale,
+        "Suggested time step scale from solver statistics, the equivalent inelastic strain increment, and the error code.");
+  m.def("newton_cost", &newton_cost,
+        "Cost of a Newton iteration on n equations, relative to an elastic update.");
+  m.def("solve_cost", &solve_cost, py::arg("iteration_cost"), py::arg("inner_cost") = 0.0,
+        "Cost of an update solved in a typical number of Newton iterations.");
   
   py::class_<NEMLModel, NEMLObject, std::shared_ptr<NEMLModel>>(m, "NEMLModel")
       .def_property_readonly("nstore", &NEMLModel::nstore, "Number of variables the program needs to store.")
@@ -36,6 +43,11 @@ PYBIND11_MODULE(models, m) {
             py_error(ier);
             return h;
            }, "Initialize history variables.")
+      .def("failed",
+           [](NEMLModel & m, py::array_t<double, py::array::c_style> h) -> bool
+           {
+            return m.failed(arr2ptr<double>(h));
+           }, "Has the point failed?")
       .def("update_sd",
            [](NEMLModel & m, py::array_t<double, py::array::c_style> e_np1, py::array_t<double, py::array::c_style> e_n, double T_np1, double T_n, double t_np1, double t_n, py::array_t<double, py::array::c_style> s_n, py::array_t<double, py::array::c_style> h_n, double u_n, double p_n) -> std::tuple<py::array_t<double>, py::array_t<double>, py::array_t<double>, double, double>
            {
@@ -50,6 +62,36 @@ PYBIND11_MODULE(models, m) {
             return std::make_tuple(s_np1, h_np1, A_np1, u_np1, p_np1);
 
            }, "Small deformation update.")
+      .def("update_sd_scale",
+           [](NEMLModel & m, py::array_t<double, py::array::c_style> e_np1, py::array_t<double, py::array::c_style> e_n, double T_np1, double T_n, double t_np1, double t_n, py::array_t<double, py::array::c_style> s_n, py::array_t<double, py::array::c_style> h_n, double u_n, double p_n) -> std::tuple<py::array_t<double>, py::array_t<double>, py::array_t<double>, double, double, double>
+           {
+            auto s_np1 = alloc_vec<double>(6);
+            auto h_np1 = alloc_vec<double>(m.nstore());
+            auto A_np1 = alloc_mat<double>(6,6);
+            double u_np1, p_np1, dt_scale;
+
+            int ier = m.update_sd_scale(arr2ptr<double>(e_np1), arr2ptr<double>(e_n), T_np1, T_n, t_np1, t_n, arr2ptr<double>(s_np1), arr2ptr<double>(s_n), arr2ptr<double>(h_np1), arr2ptr<double>(h_n), arr2ptr<double>(A_np1), u_np1, u_n, p_np1, p_n, dt_scale);
+            py_error(ier);
+
+            return std::make_tuple(s_np1, h_np1, A_np1, u_np1, p_np1, dt_scale);
+
+           }, "Small deformation update that also suggests a time step scale factor.")
+      .def("update_sd_batch",
+           [](NEMLModel & m, py::array_t<double, py::array::c_style> e_np1, py::array_t<double, py::array::c_style> e_n, py::array_t<double, py::array::c_style> T_np1, py::array_t<double, py::array::c_style> T_n, double t_np1, double t_n, py::array_t<double, py::array::c_style> s_n, py::array_t<double, py::array::c_style> h_n, py::array_t<double, py::array::c_style> u_n, py::array_t<double, py::array::c_style> p_n) -> std::tuple<py::array_t<double>, py::array_t<double>, py::array_t<double>, py::array_t<double>, py::array_t<double>, py::array_t<int>>
+           {
+            size_t npts = e_np1.request().shape[0];
+            auto s_np1 = alloc_mat<double>(npts, 6);
+            auto h_np1 = alloc_mat<double>(npts, m.nstore());
+            auto A_np1 = py::array_t<double>({npts, (size_t) 6, (size_t) 6});
+            auto u_np1 = alloc_vec<double>(npts);
+            auto p_np1 = alloc_vec<double>(npts);
+            auto ier = alloc_vec<int>(npts);
+
+            m.update_sd_batch(npts, arr2ptr<double>(e_np1), arr2ptr<double>(e_n), arr2ptr<double>(T_np1), arr2ptr<double>(T_n), t_np1, t_n, arr2ptr<double>(s_np1), arr2ptr<double>(s_n), arr2ptr<double>(h_np1), arr2ptr<double>(h_n), arr2ptr<double>(A_np1), arr2ptr<double>(u_np1), arr2ptr<double>(u_n), arr2ptr<double>(p_np1), arr2ptr<double>(p_n), arr2ptr<int>(ier));
+
+            return std::make_tuple(s_np1, h_np1, A_np1, u_np1, p_np1, ier);
+
+           }, "Small deformation update for a batch of points, with an error code for each point.")
       .def("update_ld_inc",
            [](NEMLModel & m, py::array_t<double, py::array::c_style> d_np1, py::array_t<double, py::array::c_style> d_n, py::array_t<double, py::array::c_style> w_np1, py::array_t<double, py::array::c_style> w_n, double T_np1, double T_n, double t_np1, double t_n, py::array_t<double, py::array::c_style> s_n, py::array_t<double, py::array::c_style> h_n, double u_n, double p_n) -> std::tuple<py::array_t<double>, py::array_t<double>, py::array_t<double>, py::array_t<double>, double, double>
            {
@@ -82,6 +124,14 @@ PYBIND11_MODULE(models, m) {
            }, "Calculate the elastic strains.")
       .def("bulk", &NEMLModel::bulk)
       .def("shear", &NEMLModel::shear)
+      .def_property_readonly("cost", &NEMLModel::cost, "Rough cost of an update, relative to an elastic update.")
+      .def_property_readonly("iteration_cost", &NEMLModel::iteration_cost, "Rough cost of one Newton iteration, relative to an elastic update.")
+      .def("point_cost",
+           [](NEMLModel & m, py::array_t<double, py::array::c_style> h) -> double
+           {
+            return m.point_cost(arr2ptr<double>(h));
+           }, "Cost estimate for a point with the stored variables h.")
+      .def("update_cost", &NEMLModel::update_cost, "Cost of an update that took niter Newton iterations.")
       ;
 
   py::class_<NEMLModel_sd, NEMLModel, std::shared_ptr<NEMLModel_sd>>(m, "NEMLModel_sd")
@@ -219,6 +269,32 @@ PYBIND11_MODULE(models, m) {
                                                      "b", "eps0"});
         }))
       ;
+
+  py::class_<CacheStats>(m, "CacheStats")
+      .def(py::init<>())
+      .def("reset", &CacheStats::reset, "Clear the statistics.")
+      .def_readwrite("hits", &CacheStats::hits)
+      .def_readwrite("misses", &CacheStats::misses)
+      .def_readwrite("evictions", &CacheStats::evictions)
+      ;
+
+  py::class_<MemoizedModel, NEMLModel_sd, std::shared_ptr<MemoizedModel>>(m, "MemoizedModel")
+      .def(py::init([](py::args args, py::kwargs kwargs)
+        {
+          return create_object_python<MemoizedModel>(args, kwargs, 
+                                                     {"elastic", "model"});
+        }))
+      .def("cache_stats", &MemoizedModel::cache_stats, "Cache statistics for the calling thread.")
+      .def("clear_cache", &MemoizedModel::clear_cache, "Empty the cache for the calling thread.")
+      ;
+
+  py::class_<CostTrackingModel, NEMLModel_sd, std::shared_ptr<CostTrackingModel>>(m, "CostTrackingModel")
+      .def(py::init([](py::args args, py::kwargs kwargs)
+        {
+          return create_object_python<CostTrackingModel>(args, kwargs, 
+                                                         {"elastic", "model"});
+        }))
+      ;
 }
 
 } // namespace neml
@@ -2,6 +2,7 @@
 
 #include "nemlerror.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <limits>
@@ -733,6 +734,26 @@ int solve_mat(const double * const A, int n, double * const x)
   return 0;
 }
 
+int factor_mat(double * const A, int n, int * const ipiv)
+{
+  int info;
+  dgetrf_(n, n, A, n, ipiv, info);
+  if (info > 0) return LINALG_FAILURE;
+
+  return 0;
+}
+
+int solve_factored(const double * const LU, int n, const int * const ipiv,
+                   double * const x, int nrhs)
+{
+  // LAPACK factored the transpose of our row major matrix
+  int info;
+  dgetrs_("T", n, nrhs, LU, n, ipiv, x, n, info);
+  if (info != 0) return LINALG_FAILURE;
+
+  return 0;
+}
+
 /*
  *  No error checking in this function, as it is assumed to be non-critical
  */
@@ -777,8 +798,157 @@ double condition(const double * const A, int n)
   return 1.0 / rcond;
 }
 
+void iso_apply(double a, double b, const double * const x,
+               double * const y)
+{
+  double m = (x[0] + x[1] + x[2]) / 3.0;
+  for (int i=0; i<3; i++) y[i] = b * (x[i] - m) + a * m;
+  for (int i=3; i<6; i++) y[i] = b * x[i];
+}
+
+bool iso_rank_one(const double * const A, const double * const u,
+                  IsoLowRank & op, double rtol)
+{
+  // Project A onto J, K, and u u^T through their Gram matrix, noting
+  // J:J = 1, K:K = 5, and J:K = 0
+  double uu = (u == nullptr) ? 0.0 : dot_vec(u, u, 6);
+  double ju = (u == nullptr) ? 0.0 : pow(u[0] + u[1] + u[2], 2.0) / 3.0;
+  op.rank = (uu > 0.0) ? 1 : 0;
+
+  double pJ = 0.0;
+  double pK = 0.0;
+  double pu = 0.0;
+  double scale = 0.0;
+  for (int i=0; i<3; i++) {
+    for (int j=0; j<3; j++) pJ += A[CINDEX(i,j,6)];
+  }
+  pJ /= 3.0;
+  for (int i=0; i<6; i++) pK += A[CINDEX(i,i,6)];
+  pK -= pJ;
+  if (op.rank == 1) {
+    for (int i=0; i<6; i++) {
+      for (int j=0; j<6; j++) pu += u[i] * A[CINDEX(i,j,6)] * u[j];
+    }
+  }
+  for (int i=0; i<36; i++) scale = std::max(scale, fabs(A[i]));
+
+  double c = 0.0;
+  if (op.rank == 1) {
+    // Eliminate a and b from the third equation
+    double ku = uu - ju;
+    double den = uu * uu - ju * ju - ku * ku / 5.0;
+    if (den <= std::numeric_limits<double>::epsilon() * uu * uu) {
+      // u is a multiple of the volumetric direction
+      op.rank = 0;
+    }
+    else {
+      c = (pu - ju * pJ - ku * pK / 5.0) / den;
+    }
+  }
+  op.a = pJ - c * ju;
+  op.b = (pK - c * (uu - ju)) / 5.0;
+  if (op.rank == 1) {
+    for (int i=0; i<6; i++) {
+      op.U[i] = c * u[i];
+      op.V[i] = u[i];
+    }
+  }
+
+  // Check what is left over
+  double tol = rtol * scale;
+  for (int j=0; j<6; j++) {
+    double col[6];
+    double ej[6] = {0,0,0,0,0,0};
+    ej[j] = 1.0;
+    iso_apply(op.a, op.b, ej, col);
+    for (int i=0; i<6; i++) {
+      double r = A[CINDEX(i,j,6)] - col[i];
+      if (op.rank == 1) r -= op.U[i] * op.V[j];
+      if (!(fabs(r) <= tol)) return false;
+    }
+  }
+
+  return true;
+}
+
+int iso_low_rank_solve(const IsoLowRank & op, double * const B, int m)
+{
+  if ((op.a == 0.0) || (op.b == 0.0)) return LINALG_FAILURE;
+  double ai = 1.0 / op.a;
+  double bi = 1.0 / op.b;
+  int r = op.rank;
+
+  // Isotropic solves for the right hand sides and the update columns
+  double x[6];
+  double y[6];
+  for (int j=0; j<m; j++) {
+    for (int i=0; i<6; i++) x[i] = B[CINDEX(i,j,m)];
+    iso_apply(ai, bi, x, y);
+    for (int i=0; i<6; i++) B[CINDEX(i,j,m)] = y[i];
+  }
+  if (r == 0) return 0;
+
+  double Z[12];
+  for (int k=0; k<r; k++) iso_apply(ai, bi, &op.U[6*k], &Z[6*k]);
+
+  // Capacitance matrix I + V^T Z, at most 2x2
+  double cap[4] = {1.0, 0.0, 0.0, 1.0};
+  for (int k=0; k<r; k++) {
+    for (int l=0; l<r; l++) {
+      cap[CINDEX(k,l,2)] += dot_vec(&op.V[6*k], &Z[6*l], 6);
+    }
+  }
+  double det = (r == 1) ? cap[0] : cap[0] * cap[3] - cap[1] * cap[2];
+  if (det == 0.0) return LINALG_FAILURE;
+  double ci[4];
+  if (r == 1) {
+    ci[0] = 1.0 / det;
+  }
+  else {
+    ci[0] = cap[3] / det;
+    ci[1] = -cap[1] / det;
+    ci[2] = -cap[2] / det;
+    ci[3] = cap[0] / det;
+  }
+
+  // X = Y - Z cap^-1 V^T Y
+  for (int j=0; j<m; j++) {
+    double w[2] = {0.0, 0.0};
+    for (int k=0; k<r; k++) {
+      for (int i=0; i<6; i++) w[k] += op.V[6*k+i] * B[CINDEX(i,j,m)];
+    }
+    double c[2] = {0.0, 0.0};
+    for (int k=0; k<r; k++) {
+      for (int l=0; l<r; l++) c[k] += ci[CINDEX(k,l,2)] * w[l];
+    }
+    for (int k=0; k<r; k++) {
+      for (int i=0; i<6; i++) B[CINDEX(i,j,m)] -= Z[6*k+i] * c[k];
+    }
+  }
+
+  return 0;
+}
+
+int rank_one_solve(const double * const u, const double * const v, int n,
+                   double * const B, int m)
+{
+  double den = 1.0 + dot_vec(u, v, n);
+  if (den == 0.0) return LINALG_FAILURE;
+
+  // X = B - u (v^T B) / (1 + v . u)
+  for (int j=0; j<m; j++) {
+    double w = 0.0;
+    for (int i=0; i<n; i++) w += v[i] * B[CINDEX(i,j,m)];
+    w /= den;
+    for (int i=0; i<n; i++) B[CINDEX(i,j,m)] -= u[i] * w;
+  }
+
+  return 0;
+}
+
 double polyval(const double * const poly, const int n, double x)
 {
+  if (n < 1) return 0.0;
   double res = poly[0];
   for (int i=1; i < n; i++) {
     res = res * x + poly[i];
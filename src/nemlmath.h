@@ -2,6 +2,8 @@
 #define NEMLMATH_H
 
 #include <cstddef>
+#include <memory>
+#include <vector>
 
 #define CINDEX(i,j,n) (j + i * n)
 
@@ -14,6 +16,7 @@ extern "C" {
   void dgetrf_(const int & m, const int & n, double* A, const int & lda, int* ipiv, int & info);
   void dgetri_(const int & n, double* A, const int & lda, int* ipiv, double* work, const int & lwork, int & info);
   void dgesv_(const int & n, const int & nrhs, double * A, const int & lda, int * ipiv, double * b, const int & ldb, int & info);
+  void dgetrs_(const char * trans, const int & n, const int & nrhs, const double * A, const int & lda, const int * ipiv, double * b, const int & ldb, int & info);
   void dgemv_(const char * trans, const int & m, const int & n, const double & alpha, const double * A, const int & lda, const double * x, const int & incx, const double & beta, double * y, const int & incy);
   void dgemm_(const char * transa, const char * transb, const int & m, const int & n, const int & k, const double & alpha, const double * A, const int & lda, const double * B, const int & ldb, const double & beta, double * C, const int & ldc);
   void dger_(const int & m, const int & n, const double & alpha, const double * x, const int & incx, const double * y, const int & incy, double * A, const int & lda);
@@ -110,10 +113,89 @@ int invert_mat(double* const A, int n);
 /// Solve unsymmetric system
 int solve_mat(const double * const A, int n, double * const x);
 
+/// LU factor a matrix in place, keeping the pivots for solve_factored
+int factor_mat(double * const A, int n, int * const ipiv);
+
+/// Solve A x = b with the factors from factor_mat for nrhs right hand sides
+/// stored one after the other in x
+int solve_factored(const double * const LU, int n, const int * const ipiv,
+                   double * const x, int nrhs = 1);
+
+/// Scratch space for the length of a call that only touches the heap the
+/// first time the calling thread needs that much
+//  Each thread keeps a stack of buffers that grow but never shrink, so
+//  nested scratch spaces (say a model updated inside another model's
+//  update) get buffers of their own.  Release in reverse order, which
+//  block scoping gives for free.
+template <typename T>
+class Scratch {
+ public:
+  explicit Scratch(size_t n)
+  {
+    Pool & p = pool_();
+    if (p.depth == p.buffers.size())
+      p.buffers.emplace_back(new std::vector<T>());
+    std::vector<T> & b = *p.buffers[p.depth++];
+    if (b.size() < n) b.resize(n);
+    data_ = b.data();
+  }
+  ~Scratch() { pool_().depth--; }
+  Scratch(const Scratch &) = delete;
+  Scratch & operator=(const Scratch &) = delete;
+
+  T * data() const { return data_; }
+  T & operator[](size_t i) const { return data_[i]; }
+
+ private:
+  struct Pool {
+    std::vector<std::unique_ptr<std::vector<T>>> buffers;
+    size_t depth = 0;
+  };
+  static Pool & pool_()
+  {
+    static thread_local Pool pool;
+    return pool;
+  }
+
+  T * data_;
+};
+
 /// Get the condition number of a matrix
 double condition(const double * const A, int n);
 
+/// An isotropic 6x6 operator plus a low rank update in Mandel notation
+//  The operator is a J + b K + U V^T where J is the volumetric projector,
+//  K = I - J is the deviatoric projector, and U and V hold rank <= 2
+//  columns, column k starting at entry 6*k.  Elastic tensors are usually
+//  isotropic and inelastic updates usually add rank one terms, so the
+//  tangents can use this in place of general inverses.
+struct IsoLowRank {
+  double a, b;
+  int rank;
+  double U[12];
+  double V[12];
+};
+
+/// Apply an isotropic operator, y = (a J + b K) x
+void iso_apply(double a, double b, const double * const x, double * const y);
+
+/// Split a 6x6 matrix into a J + b K + c u u^T for a given direction u,
+/// or just the isotropic part if u is null, returning false if the matrix
+/// does not have that structure
+bool iso_rank_one(const double * const A, const double * const u,
+                  IsoLowRank & op, double rtol = 1.0e-10);
+
+/// Solve op X = B in place for m right hand sides with the
+/// Sherman-Morrison-Woodbury formula, B is 6 x m
+int iso_low_rank_solve(const IsoLowRank & op, double * const B, int m);
+
+/// Solve (I + u v^T) X = B in place for m right hand sides with the
+/// Sherman-Morrison formula, B is n x m
+int rank_one_solve(const double * const u, const double * const v, int n,
+                   double * const B, int m);
+
 /// Evaluate a polynomial with Horner's method, highest order term first
+/// (an empty polynomial is zero)
 double polyval(const double * const poly, const int n, double x);
 
 }
@@ -475,6 +475,87 @@ PYBIND11_MODULE(nemlmath, m) {
           return b;
         }, "Solve Ax=b.");
 
+   m.def("rank_one_solve",
+        [](py::array_t<double, py::array::c_style> u, py::array_t<double, py::array::c_style> v, py::array_t<double, py::array::c_style> B) -> py::array_t<double>
+        {
+          if ((u.request().ndim != 1) || (v.request().ndim != 1)) {
+            throw LinalgError("u and v are not vectors!");
+          }
+          if (B.request().ndim != 2) {
+            throw LinalgError("B is not a matrix!");
+          }
+          size_t n = u.request().shape[0];
+          size_t m = B.request().shape[1];
+          if ((v.request().shape[0] != (ssize_t) n) ||
+              (B.request().shape[0] != (ssize_t) n)) {
+            throw LinalgError("u, v, and B are not conformable!");
+          }
+
+          auto X = alloc_mat<double>(n, m);
+          std::copy(arr2ptr<double>(B), arr2ptr<double>(B)+n*m,
+                    arr2ptr<double>(X));
+          int ier = rank_one_solve(arr2ptr<double>(u), arr2ptr<double>(v), n,
+                                   arr2ptr<double>(X), m);
+          py_error(ier);
+
+          return X;
+        }, "Solve (I + u v^T) X = B with the Sherman-Morrison formula.");
+
+   m.def("iso_rank_one",
+        [](py::array_t<double, py::array::c_style> A, py::array_t<double, py::array::c_style> u) -> std::tuple<bool, double, double, py::array_t<double>, py::array_t<double>>
+        {
+          if ((A.request().ndim != 2) || (A.request().shape[0] != 6) ||
+              (A.request().shape[1] != 6)) {
+            throw LinalgError("A is not a 6x6 matrix!");
+          }
+          if ((u.request().ndim != 1) || (u.request().shape[0] != 6)) {
+            throw LinalgError("u is not a length 6 vector!");
+          }
+          IsoLowRank op;
+          bool ok = iso_rank_one(arr2ptr<double>(A), arr2ptr<double>(u), op);
+          auto U = alloc_vec<double>(6);
+          auto V = alloc_vec<double>(6);
+          if (op.rank == 1) {
+            std::copy(op.U, op.U+6, arr2ptr<double>(U));
+            std::copy(op.V, op.V+6, arr2ptr<double>(V));
+          }
+
+          return std::make_tuple(ok, op.a, op.b, U, V);
+        }, "Split A into a J + b K + c u u^T for a given u, with a flag for if A has that structure.");
+
+   m.def("iso_low_rank_solve",
+        [](double a, double b, py::array_t<double, py::array::c_style> U, py::array_t<double, py::array::c_style> V, py::array_t<double, py::array::c_style> B) -> py::array_t<double>
+        {
+          if ((U.request().ndim != 2) || (V.request().ndim != 2) ||
+              (U.request().shape[0] != 6) || (V.request().shape[0] != 6) ||
+              (U.request().shape[1] != V.request().shape[1]) ||
+              (U.request().shape[1] > 2)) {
+            throw LinalgError("U and V should be 6 x r with r <= 2!");
+          }
+          if ((B.request().ndim != 2) || (B.request().shape[0] != 6)) {
+            throw LinalgError("B should be 6 x m!");
+          }
+          IsoLowRank op;
+          op.a = a;
+          op.b = b;
+          op.rank = U.request().shape[1];
+          for (int k=0; k<op.rank; k++) {
+            for (int i=0; i<6; i++) {
+              op.U[6*k+i] = arr2ptr<double>(U)[CINDEX(i,k,op.rank)];
+              op.V[6*k+i] = arr2ptr<double>(V)[CINDEX(i,k,op.rank)];
+            }
+          }
+
+          size_t m = B.request().shape[1];
+          auto X = alloc_mat<double>(6, m);
+          std::copy(arr2ptr<double>(B), arr2ptr<double>(B)+6*m,
+                    arr2ptr<double>(X));
+          int ier = iso_low_rank_solve(op, arr2ptr<double>(X), m);
+          py_error(ier);
+
+          return X;
+        }, "Solve (a J + b K + U V^T) X = B with the Sherman-Morrison-Woodbury formula.");
+
    m.def("condition",
         [](py::array_t<double, py::array::c_style> A) -> double
         {
@@ -74,6 +74,15 @@ void ParameterSet::resolve_objects_()
   defered_params_.clear();
 }
 
+std::shared_ptr<NEMLObject> ParameterSet::profile_(
+    std::type_index iface, std::shared_ptr<NEMLObject> obj,
+    const std::string & name) const
+{
+  Factory * factory = Factory::Creator();
+  if (not factory->profiling()) return obj;
+  return factory->proxy(iface, obj, name);
+}
+
 ParameterSet Factory::provide_parameters(std::string type)
 {
   try {
@@ -90,12 +99,7 @@ std::shared_ptr<NEMLObject> Factory::create(ParameterSet & params)
     throw UndefinedParameters(params);
   }
   
-  try {
-    return creators_[params.type()](params);
-  }
-  catch (std::exception & e) {
-    throw UnregisteredError(params.type());
-  }
+  return create_unique(params);
 }
 
 std::unique_ptr<NEMLObject> Factory::create_unique(ParameterSet & params)
@@ -104,12 +108,19 @@ std::unique_ptr<NEMLObject> Factory::create_unique(ParameterSet & params)
     throw UndefinedParameters(params);
   }
 
+  std::unique_ptr<NEMLObject> obj;
   try {
-    return creators_[params.type()](params);
+    obj = creators_[params.type()](params);
   }
   catch (std::exception & e) {
       throw UnregisteredError(params.type());
   }
+
+  if (profiling_) {
+    std::lock_guard<std::mutex> guard(names_mutex_);
+    names_[obj.get()] = params.type();
+  }
+  return obj;
 }
 
 void Factory::register_type(std::string type,
@@ -126,4 +137,43 @@ Factory * Factory::Creator()
   return &creator;
 }
 
+void Factory::set_profiling(bool profiling)
+{
+  profiling_ = profiling;
+  if (not profiling) {
+    std::lock_guard<std::mutex> guard(names_mutex_);
+    names_.clear();
+  }
+}
+
+bool Factory::profiling() const
+{
+  return profiling_;
+}
+
+void Factory::register_proxy(std::type_index iface,
+                             std::function<std::shared_ptr<NEMLObject>(
+                                 std::shared_ptr<NEMLObject>,
+                                 const std::string &)> maker)
+{
+  proxies_[iface] = maker;
+}
+
+std::shared_ptr<NEMLObject> Factory::proxy(std::type_index iface,
+                                           std::shared_ptr<NEMLObject> obj,
+                                           const std::string & param)
+{
+  auto maker = proxies_.find(iface);
+  if ((maker == proxies_.end()) || (obj == nullptr)) return obj;
+
+  std::string label = param;
+  {
+    std::lock_guard<std::mutex> guard(names_mutex_);
+    auto name = names_.find(obj.get());
+    if (name != names_.end()) label += " (" + name->second + ")";
+  }
+
+  return maker->second(obj, label);
+}
+
 } // namespace neml
@@ -7,8 +7,11 @@
 #include <map>
 #include <memory>
 #include <functional>
+#include <typeindex>
 #include <stdexcept>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 
 #include "boost/variant.hpp"
 
@@ -71,24 +74,23 @@ template <> constexpr ParamType GetParamType<std::string>() {return TYPE_STRING;
 /// Error if you ask for a parameter that an object doesn't recognize
 class UnknownParameter: public std::exception {
  public:
-  UnknownParameter(std::string object, std::string name) :
-      object_(object), name_(name)
+  UnknownParameter(std::string object, std::string name)
   {
-  
+    std::stringstream ss;
+    
+    ss << "Object of type " << object << " has no parameter "
+        << name << "!";
+
+    msg_ = ss.str();
   }
 
   const char* what() const throw()
   {
-    std::stringstream ss;
-    
-    ss << "Object of type " << object_ << " has no parameter "
-        << name_ << "!";
-
-    return ss.str().c_str();
+    return msg_.c_str();
   }
 
  private:
-  std::string object_, name_;
+  std::string msg_;
 };
 
 /// Error to call if you try a bad cast
@@ -101,11 +103,7 @@ class WrongTypeError: public std::exception {
 
   const char * what() const throw ()
   {
-    std::stringstream ss;
-
-    ss << "Cannot convert object to the correct type!";
-
-    return ss.str().c_str();
+    return "Cannot convert object to the correct type!";
   }
 };
 
@@ -162,7 +160,8 @@ class ParameterSet {
   template<typename T>
   std::shared_ptr<T> get_object_parameter(std::string name) 
   {
-    auto res = std::dynamic_pointer_cast<T>(get_parameter<std::shared_ptr<NEMLObject>>(name));
+    auto res = std::dynamic_pointer_cast<T>(profile_(typeid(T),
+            get_parameter<std::shared_ptr<NEMLObject>>(name), name));
     if (res == nullptr) {
       throw WrongTypeError();
     }
@@ -177,6 +176,9 @@ class ParameterSet {
   {
     std::vector<std::shared_ptr<NEMLObject>> ov = 
         get_parameter<std::vector<std::shared_ptr<NEMLObject>>>(name);
+    for (size_t i = 0; i < ov.size(); i++) {
+      ov[i] = profile_(typeid(T), ov[i], name + "[" + std::to_string(i) + "]");
+    }
     std::vector<std::shared_ptr<T>> nv(ov.size());
     std::transform(std::begin(ov), std::end(ov), std::begin(nv),
                           [](std::shared_ptr<NEMLObject> const & v)
@@ -208,6 +210,11 @@ class ParameterSet {
  private:
   /// Run down the chain of deferred objects and actually construct them
   void resolve_objects_();
+  /// Wrap an object parameter in a profiling proxy, if the factory is
+  /// profiling and has a proxy for the requested interface
+  std::shared_ptr<NEMLObject> profile_(std::type_index iface,
+                                       std::shared_ptr<NEMLObject> obj,
+                                       const std::string & name) const;
   
   std::string type_;
   
@@ -263,9 +270,35 @@ class Factory {
   /// Static factor instance
   static Factory * Creator();
 
+  /// Wrap the objects passed to other objects in profiling proxies
+  //  Only objects created while this is on are proxied, so models set up
+  //  with it off run exactly as before.  The flag is shared by all threads,
+  //  so a model parsed on another thread while it is on is profiled too.
+  void set_profiling(bool profiling);
+  /// Are new objects being profiled?
+  bool profiling() const;
+
+  /// Register a proxy for objects requested as the interface iface
+  //  The maker gets the object and a label for it in the profile.
+  void register_proxy(std::type_index iface,
+                      std::function<std::shared_ptr<NEMLObject>(
+                          std::shared_ptr<NEMLObject>,
+                          const std::string &)> maker);
+  /// Wrap an object requested as iface through the parameter param in its
+  /// proxy, returning the object itself if there is no proxy
+  std::shared_ptr<NEMLObject> proxy(std::type_index iface,
+                                    std::shared_ptr<NEMLObject> obj,
+                                    const std::string & param);
+
  private:
   std::map<std::string, std::function<std::unique_ptr<NEMLObject>(ParameterSet &)>> creators_;
   std::map<std::string, std::function<ParameterSet()>> setups_;
+
+  std::atomic<bool> profiling_{false};
+  std::mutex names_mutex_;
+  std::map<std::type_index, std::function<std::shared_ptr<NEMLObject>(
+      std::shared_ptr<NEMLObject>, const std::string &)>> proxies_;
+  std::map<const NEMLObject *, std::string> names_;
 };
 
 /// Little object used for auto registration
@@ -281,49 +314,47 @@ class Register {
 /// Error to throw if parameters are not completely defined
 class UndefinedParameters: public std::exception {
  public:
-  UndefinedParameters(ParameterSet & params) :
-      params_(params)
-  {
-
-  };
-
-  const char* what() const throw()
+  UndefinedParameters(ParameterSet & params)
   {
     std::stringstream ss;
 
     ss << "Parameter set has undefined parameters:" << std::endl;
-    auto ups = params_.unassigned_parameters();
+    auto ups = params.unassigned_parameters();
     for (auto it = ups.begin(); it != ups.end(); ++it) {
       ss << *it << " ";
     }
 
-    return ss.str().c_str();
+    msg_ = ss.str();
+  };
+
+  const char* what() const throw()
+  {
+    return msg_.c_str();
   }
 
  private:
-  ParameterSet & params_;
+  std::string msg_;
 };
 
 /// Error to throw if the class isn't registered
 class UnregisteredError: public std::exception {
  public:
-  UnregisteredError(std::string name) :
-      name_(name)
+  UnregisteredError(std::string name)
   {
+    std::stringstream ss;
+
+    ss << "Object named " << name << " not registered with factory!";
 
+    msg_ = ss.str();
   };
 
   const char * what() const throw ()
   {
-    std::stringstream ss;
-
-    ss << "Object named " << name_ << " not registered with factory!";
-
-    return ss.str().c_str();
+    return msg_.c_str();
   };
 
  private:
-  std::string name_;
+  std::string msg_;
 };
 
 } //namespace neml
@@ -1,5 +1,11 @@
 #include "parse.h"
 
+#include "profile.h"
+
+#include <iomanip>
+#include <mutex>
+#include <stdexcept>
+
 namespace neml {
 
 std::shared_ptr<NEMLModel> parse_xml(std::string fname, std::string mname)
@@ -54,6 +60,143 @@ std::unique_ptr<NEMLModel> parse_xml_unique(std::string fname, std::string mname
   }
 }
 
+/// Turn on profiling in the factory for the life of the object
+//  Profiled parses are serialized, so one cannot restore the flag while
+//  another is still using it.
+class ProfileFactory {
+ public:
+  ProfileFactory(bool profile) :
+      guard_(lock_()), was_(Factory::Creator()->profiling())
+  {
+    Factory::Creator()->set_profiling(profile);
+  }
+
+  ~ProfileFactory()
+  {
+    Factory::Creator()->set_profiling(was_);
+  }
+
+ private:
+  static std::mutex & lock_()
+  {
+    static std::mutex lock;
+    return lock;
+  }
+
+ private:
+  std::lock_guard<std::mutex> guard_;
+  bool was_;
+};
+
+std::shared_ptr<NEMLModel> parse_xml(std::string fname, std::string mname,
+                                     bool profile)
+{
+  if (not profile) return parse_xml(fname, mname);
+
+  ProfileFactory setup(true);
+  return profile_model(parse_xml(fname, mname), mname);
+}
+
+std::unique_ptr<NEMLModel> parse_xml_unique(std::string fname,
+                                            std::string mname, bool profile)
+{
+  if (not profile) return parse_xml_unique(fname, mname);
+
+  ProfileFactory setup(true);
+  return profile_model(parse_xml_unique(fname, mname), mname);
+}
+
+// The text node holding the number at path, and the entry in its list
+static rapidxml::xml_node<> * parameter_node(rapidxml::xml_node<> * model,
+                                             std::string path, size_t & entry)
+{
+  entry = 0;
+  std::string last = path;
+  size_t br = path.find('[');
+  if (br != std::string::npos) {
+    size_t end = path.find(']', br);
+    if ((end == std::string::npos) || (end != path.size() - 1)) {
+      throw std::invalid_argument("Bad parameter path " + path);
+    }
+    entry = std::stoul(path.substr(br + 1, end - br - 1));
+    last = path.substr(0, br);
+  }
+
+  rapidxml::xml_node<> * node = model;
+  std::stringstream ss(last);
+  std::string name;
+  while (std::getline(ss, name, '/')) {
+    node = (node == nullptr) ? nullptr : node->first_node(name.c_str());
+  }
+  if ((model == nullptr) || (node == nullptr) || (node == model)
+      || (node->first_node() == nullptr)
+      || (node->first_node()->type() != rapidxml::node_data)) {
+    throw std::invalid_argument("No parameter " + path);
+  }
+  if (entry >= split_string(node->first_node()->value()).size()) {
+    throw std::invalid_argument("No parameter " + path);
+  }
+
+  return node->first_node();
+}
+
+std::unique_ptr<NEMLModel> parse_xml_unique(std::string fname,
+                                            std::string mname,
+                                            std::string path, double value)
+{
+  return parse_xml_unique(fname, mname, std::vector<std::string>({path}),
+                          std::vector<double>({value}));
+}
+
+std::unique_ptr<NEMLModel> parse_xml_unique(std::string fname,
+                                            std::string mname,
+                                            std::vector<std::string> paths,
+                                            std::vector<double> values)
+{
+  if (paths.size() != values.size()) {
+    throw std::invalid_argument("Need one value for each parameter path");
+  }
+
+  rapidxml::file <> xmlFile(fname.c_str());
+  rapidxml::xml_document<> doc;
+  doc.parse<0>(xmlFile.data());
+  rapidxml::xml_node<> * found = doc.first_node()->first_node(mname.c_str());
+
+  // Write the new values into the document
+  for (size_t k = 0; k < paths.size(); k++) {
+    size_t entry;
+    rapidxml::xml_node<> * data = parameter_node(found, paths[k], entry);
+    std::vector<double> current = split_string(data->value());
+    current[entry] = values[k];
+    std::stringstream ss;
+    ss << std::setprecision(17);
+    for (size_t i = 0; i < current.size(); i++) {
+      ss << ((i > 0) ? " " : "") << current[i];
+    }
+    data->value(doc.allocate_string(ss.str().c_str()));
+  }
+
+  std::unique_ptr<NEMLObject> obj = get_object_unique(found);
+  auto res = std::unique_ptr<NEMLModel>(dynamic_cast<NEMLModel*>(obj.release()));
+  if (res == nullptr) {
+    throw InvalidType(found->name(), get_type_of_node(found), "NEMLModel");
+  }
+  return res;
+}
+
+double get_xml_parameter(std::string fname, std::string mname,
+                         std::string path)
+{
+  rapidxml::file <> xmlFile(fname.c_str());
+  rapidxml::xml_document<> doc;
+  doc.parse<0>(xmlFile.data());
+  rapidxml::xml_node<> * found = doc.first_node()->first_node(mname.c_str());
+
+  size_t entry;
+  rapidxml::xml_node<> * data = parameter_node(found, path, entry);
+  return split_string(data->value())[entry];
+}
+
 std::unique_ptr<NEMLObject> get_object_unique(const rapidxml::xml_node<> * node) {
   // Special case: could be a ConstantInterpolate
   std::string type = get_type_of_node(node);
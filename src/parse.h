@@ -4,6 +4,7 @@
 #include "objects.h"
 #include "models.h"
 #include "damage.h"
+#include "reduced.h"
 
 #include "rapidxml.hpp"
 #include "rapidxml_utils.hpp"
@@ -23,6 +24,37 @@ std::shared_ptr<NEMLModel> parse_xml(std::string fname, std::string mname);
 /// Parse from file to a unique_ptr
 std::unique_ptr<NEMLModel> parse_xml_unique(std::string fname, std::string mname);
 
+/// Parse from file to a shared_ptr, optionally profiling the model
+//  With profile set the model and the objects it is built from are wrapped
+//  in proxies that time their calls, see profile.h.
+std::shared_ptr<NEMLModel> parse_xml(std::string fname, std::string mname,
+                                     bool profile);
+
+/// Parse from file to a unique_ptr, optionally profiling the model
+std::unique_ptr<NEMLModel> parse_xml_unique(std::string fname,
+                                            std::string mname, bool profile);
+
+/// Parse from file to a unique_ptr, with one parameter changed
+//  The path names the nodes under the model, separated by slashes, and can
+//  end with an index in brackets for one entry in a list of numbers, for
+//  example flow/hardening/C[1].  Throws std::invalid_argument if the path
+//  does not name a number in the model.
+std::unique_ptr<NEMLModel> parse_xml_unique(std::string fname,
+                                            std::string mname,
+                                            std::string path, double value);
+
+/// Parse from file to a unique_ptr, with several parameters changed
+//  Each path is as for a single parameter, and the paths and values are
+//  given in the same order.
+std::unique_ptr<NEMLModel> parse_xml_unique(std::string fname,
+                                            std::string mname,
+                                            std::vector<std::string> paths,
+                                            std::vector<double> values);
+
+/// Read the parameter at a path in a model, see parse_xml_unique
+double get_xml_parameter(std::string fname, std::string mname,
+                         std::string path);
+
 /// Extract a NEMLObject from a xml node as a unique_ptr
 std::unique_ptr<NEMLObject> get_object_unique(const rapidxml::xml_node<> * node);
 
@@ -64,116 +96,109 @@ std::vector<double> split_string(std::string sval);
 /// If a node is not found
 class NodeNotFound: public std::exception {
  public:
-  NodeNotFound(std::string node_name, int line) :
-      node_name_(node_name), line_(line)
+  NodeNotFound(std::string node_name, int line)
   {
-  
+    std::stringstream ss;
+
+    ss << "Node with name " << node_name 
+        << " was not found near line " << line << "!";
+
+    msg_ = ss.str();
   };
 
   const char * what() const throw ()
   {
-    std::stringstream ss;
-
-    ss << "Node with name " << node_name_ 
-        << " was not found near line " << line_ << "!";
-
-    return ss.str().c_str();
+    return msg_.c_str();
   };
 
  private:
-  std::string node_name_;
-  int line_;
+  std::string msg_;
 };
 
 /// If a node is not unique (and it should be)
 class DuplicateNode: public std::exception {
  public:
-  DuplicateNode(std::string node_name, int line) :
-      node_name_(node_name), line_(line)
+  DuplicateNode(std::string node_name, int line)
   {
+    std::stringstream ss;
 
-  };
-
-    const char * what() const throw ()
-    {
-      std::stringstream ss;
+    ss << "Multiple nodes with name " << node_name << " were found!";
 
-      ss << "Multiple nodes with name " << node_name_ << " were found!";
+    msg_ = ss.str();
+  };
 
-      return ss.str().c_str();
-    };
+  const char * what() const throw ()
+  {
+    return msg_.c_str();
+  };
 
-  private:
-    std::string node_name_;
-    int line_;
+ private:
+  std::string msg_;
 };
 
 /// If the object can't be converted
 class InvalidType: public std::exception {
  public:
-  InvalidType(std::string name, std::string type, std::string ctype) :
-      name_(name), type_(type), ctype_(ctype)
+  InvalidType(std::string name, std::string type, std::string ctype)
   {
+    std::stringstream ss;
+
+    ss << "Node with name " << name << " and type " << type 
+        << "cannot be converted to the correct type " << ctype << "!";
 
+    msg_ = ss.str();
   };
 
   const char * what() const throw ()
   {
-    std::stringstream ss;
-
-    ss << "Node with name " << name_ << " and type " << type_ 
-        << "cannot be converted to the correct type " << ctype_ << "!";
-
-    return ss.str().c_str();
+    return msg_.c_str();
   };
 
  private:
-  const std::string name_, type_, ctype_;
+  std::string msg_;
 };
 
 /// If a parameter doesn't exist
 class UnknownParameterXML: public std::exception {
  public:
-  UnknownParameterXML(std::string name, std::string param) :
-      name_(name), param_(param)
+  UnknownParameterXML(std::string name, std::string param)
   {
+    std::stringstream ss;
 
+    ss << "Object " << name << " does not have a parameter called " << param << "!";
+
+    msg_ = ss.str();
   };
 
   const char * what() const throw ()
   {
-    std::stringstream ss;
-
-    ss << "Object " << name_ << " does not have a parameter called " << param_ << "!";
-
-    return ss.str().c_str();
+    return msg_.c_str();
   };
 
  private:
-  const std::string name_, param_;
+  std::string msg_;
 
 };
 
 /// The object isn't in the factory
 class UnregisteredXML: public std::exception {
  public:
-  UnregisteredXML(std::string name, std::string type) :
-      name_(name), type_(type)
+  UnregisteredXML(std::string name, std::string type)
   {
+    std::stringstream ss;
+
+    ss << "Node named " << name << " has an unregistered type of " << type << "!";
 
+    msg_ = ss.str();
   };
 
   const char * what() const throw ()
   {
-    std::stringstream ss;
-
-    ss << "Node named " << name_ << " has an unregistered type of " << type_ << "!";
-
-    return ss.str().c_str();
+    return msg_.c_str();
   };
 
  private:
-  const std::string name_, type_;
+  std::string msg_;
 
 };
 
@@ -11,7 +11,21 @@ namespace neml {
 PYBIND11_MODULE(parse, m) {
   m.doc() = "Python wrapper to read XML input files.";
   
-  m.def("parse_xml", &parse_xml);
+  m.def("parse_xml",
+        [](std::string fname, std::string mname, bool profile) -> std::shared_ptr<NEMLModel>
+        {
+          return parse_xml(fname, mname, profile);
+        }, "Read a model from an XML file.",
+        py::arg("fname"), py::arg("mname"), py::arg("profile") = false);
+  m.def("parse_xml",
+        [](std::string fname, std::string mname, std::string path, double value) -> std::shared_ptr<NEMLModel>
+        {
+          return std::shared_ptr<NEMLModel>(parse_xml_unique(fname, mname, path, value));
+        }, "Read a model from an XML file, with the parameter at path changed to value.",
+        py::arg("fname"), py::arg("mname"), py::arg("path"), py::arg("value"));
+  m.def("get_xml_parameter", &get_xml_parameter,
+        "Read the parameter at path in a model in an XML file.",
+        py::arg("fname"), py::arg("mname"), py::arg("path"));
 
   py::register_exception<NodeNotFound>(m, "NodeNotFound");
   py::register_exception<DuplicateNode>(m, "DuplicateNode");
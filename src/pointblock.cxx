@@ -0,0 +1,699 @@
+#include "pointblock.h"
+
+#include "solvers.h"
+#include "nemlerror.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace neml {
+
+// Page size used to align the arrays
+const size_t page_bytes = 4096;
+
+// Parse a Linux CPU list, like "0-3,8,10-11"
+static std::vector<int> parse_cpulist(const std::string & list)
+{
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item.find_first_of("0123456789") == std::string::npos) continue;
+    size_t dash = item.find('-');
+    int a = std::atoi(item.substr(0, dash).c_str());
+    int b = (dash == std::string::npos) ? a :
+        std::atoi(item.substr(dash+1).c_str());
+    for (int i=a; i<=b; i++) cpus.push_back(i);
+  }
+  return cpus;
+}
+
+// The CPUs the process may run on
+static std::vector<int> usable_cpus()
+{
+  std::vector<int> cpus;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int i=0; i<CPU_SETSIZE; i++) {
+      if (CPU_ISSET(i, &set)) cpus.push_back(i);
+    }
+  }
+#endif
+  if (cpus.empty()) {
+    int n = std::max(1u, std::thread::hardware_concurrency());
+    for (int i=0; i<n; i++) cpus.push_back(i);
+  }
+  return cpus;
+}
+
+std::vector<std::vector<int>> numa_topology()
+{
+  std::vector<int> usable = usable_cpus();
+  std::vector<std::vector<int>> nodes;
+
+  std::string base = "/sys/devices/system/node/";
+  std::ifstream online(base + "online");
+  std::string list;
+  if (online && std::getline(online, list)) {
+    for (int node : parse_cpulist(list)) {
+      std::ifstream f(base + "node" + std::to_string(node) + "/cpulist");
+      std::string cpulist;
+      if (!(f && std::getline(f, cpulist))) continue;
+      std::vector<int> cpus;
+      for (int c : parse_cpulist(cpulist)) {
+        if (std::find(usable.begin(), usable.end(), c) != usable.end()) {
+          cpus.push_back(c);
+        }
+      }
+      if (!cpus.empty()) nodes.push_back(cpus);
+    }
+  }
+
+  if (nodes.empty()) nodes.push_back(usable);
+
+  return nodes;
+}
+
+// Round to the nearest bfloat16, the upper half of a float
+static uint16_t to_bfloat16(double v)
+{
+  float f = (float) v;
+  uint32_t bits;
+  std::memcpy(&bits, &f, sizeof(bits));
+  if (std::isnan(f)) return (uint16_t) ((bits >> 16) | 0x0040);
+  bits += 0x7FFF + ((bits >> 16) & 1);
+  return (uint16_t) (bits >> 16);
+}
+
+static double from_bfloat16(uint16_t v)
+{
+  uint32_t bits = ((uint32_t) v) << 16;
+  float f;
+  std::memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+HistoryStorage::HistoryStorage(const std::vector<std::string> & precisions)
+{
+  for (auto & p : precisions) {
+    if (p == "double") precision_.push_back(DOUBLE);
+    else if (p == "single") precision_.push_back(SINGLE);
+    else if (p == "bfloat16") precision_.push_back(BFLOAT16);
+    else throw std::invalid_argument("Unknown storage precision " + p);
+  }
+
+  // Widest first
+  offset_.resize(precision_.size());
+  bytes_ = 0;
+  const size_t width[3] = {sizeof(double), sizeof(float), sizeof(uint16_t)};
+  for (Precision p : {DOUBLE, SINGLE, BFLOAT16}) {
+    for (size_t i=0; i<precision_.size(); i++) {
+      if (precision_[i] != p) continue;
+      offset_[i] = bytes_;
+      bytes_ += width[p];
+    }
+  }
+}
+
+HistoryStorage::HistoryStorage(size_t n) :
+    HistoryStorage(std::vector<std::string>(n, "double"))
+{
+
+}
+
+size_t HistoryStorage::nstore() const
+{
+  return precision_.size();
+}
+
+std::vector<std::string> HistoryStorage::precisions() const
+{
+  const char * names[3] = {"double", "single", "bfloat16"};
+  std::vector<std::string> res;
+  for (Precision p : precision_) res.push_back(names[p]);
+  return res;
+}
+
+size_t HistoryStorage::bytes() const
+{
+  return bytes_;
+}
+
+bool HistoryStorage::full() const
+{
+  return bytes_ == precision_.size() * sizeof(double);
+}
+
+void HistoryStorage::pack(size_t npts, const double * const h,
+                          unsigned char * const packed) const
+{
+  size_t n = precision_.size();
+  for (size_t k=0; k<npts; k++) {
+    unsigned char * point = packed + k * bytes_;
+    for (size_t i=0; i<n; i++) {
+      double v = h[k*n+i];
+      if (precision_[i] == DOUBLE) {
+        std::memcpy(point + offset_[i], &v, sizeof(v));
+      }
+      else if (precision_[i] == SINGLE) {
+        float f = (float) v;
+        std::memcpy(point + offset_[i], &f, sizeof(f));
+      }
+      else {
+        uint16_t b = to_bfloat16(v);
+        std::memcpy(point + offset_[i], &b, sizeof(b));
+      }
+    }
+  }
+}
+
+void HistoryStorage::unpack(size_t npts, const unsigned char * const packed,
+                            double * const h) const
+{
+  size_t n = precision_.size();
+  for (size_t k=0; k<npts; k++) {
+    const unsigned char * point = packed + k * bytes_;
+    for (size_t i=0; i<n; i++) {
+      if (precision_[i] == DOUBLE) {
+        std::memcpy(&h[k*n+i], point + offset_[i], sizeof(double));
+      }
+      else if (precision_[i] == SINGLE) {
+        float f;
+        std::memcpy(&f, point + offset_[i], sizeof(f));
+        h[k*n+i] = f;
+      }
+      else {
+        uint16_t b;
+        std::memcpy(&b, point + offset_[i], sizeof(b));
+        h[k*n+i] = from_bfloat16(b);
+      }
+    }
+  }
+}
+
+// Update n points with the stored variables packed as in storage
+//  Each batch of points is unpacked to double, updated, and packed again,
+//  unless every variable is kept in double.
+static void update_points(NEMLModel & model, const HistoryStorage & storage,
+                          size_t n, const double * const e_np1,
+                          const double * const e_n,
+                          const double * const T_np1,
+                          const double * const T_n, double t_np1, double t_n,
+                          double * const s_np1, const double * const s_n,
+                          unsigned char * const h_np1,
+                          const unsigned char * const h_n,
+                          double * const A_np1, double * const u_np1,
+                          const double * const u_n, double * const p_np1,
+                          const double * const p_n, int * const ier)
+{
+  size_t b = storage.bytes();
+  bool full = storage.full();
+  std::vector<double> hn, hnp1;
+  if (!full) {
+    hn.resize(batch_width * storage.nstore());
+    hnp1.resize(batch_width * storage.nstore());
+  }
+
+  for (size_t c=0; c<n; c+=batch_width) {
+    size_t np = std::min(batch_width, n - c);
+    const double * h_n_c = reinterpret_cast<const double*>(h_n + b*c);
+    double * h_np1_c = reinterpret_cast<double*>(h_np1 + b*c);
+    if (!full) {
+      storage.unpack(np, h_n + b*c, hn.data());
+      h_n_c = hn.data();
+      h_np1_c = hnp1.data();
+    }
+    try {
+      model.update_sd_batch(np, &e_np1[6*c], &e_n[6*c], &T_np1[c], &T_n[c],
+                            t_np1, t_n, &s_np1[6*c], &s_n[6*c], h_np1_c,
+                            h_n_c, &A_np1[36*c], &u_np1[c], &u_n[c],
+                            &p_np1[c], &p_n[c], &ier[c]);
+    }
+    catch (...) {
+      std::fill(&ier[c], &ier[c]+np, UNKNOWN_ERROR);
+    }
+    if (!full) storage.pack(np, hnp1.data(), h_np1 + b*c);
+  }
+}
+
+PointBlock::Array::Array() :
+    data(nullptr)
+{
+
+}
+
+PointBlock::Array::~Array()
+{
+  free(data);
+}
+
+void PointBlock::Array::allocate(size_t n)
+{
+  // Left untouched, so the pages go to the first thread to write them
+  void * p = nullptr;
+  if (posix_memalign(&p, page_bytes, std::max(n, (size_t) 1)
+                     * sizeof(double)) != 0) {
+    throw std::bad_alloc();
+  }
+  data = static_cast<double*>(p);
+}
+
+template <class F>
+void PointBlock::each_range_(const F & f)
+{
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads_)
+  {
+    // Fewer threads than asked for take several ranges each
+    int nt = omp_get_num_threads();
+    for (int t=omp_get_thread_num(); t<nthreads_; t+=nt) {
+      bool pinned = pin_requested_ && pin_(t);
+      f(t, ranges_[t], ranges_[t+1]);
+      if (pinned) unpin_();
+    }
+  }
+#else
+  for (int t=0; t<nthreads_; t++) {
+    bool pinned = pin_requested_ && pin_(t);
+    f(t, ranges_[t], ranges_[t+1]);
+    if (pinned) unpin_();
+  }
+#endif
+}
+
+PointBlock::PointBlock(std::shared_ptr<NEMLModel> model, size_t npts,
+                       double T, int nthreads, bool pin,
+                       std::vector<std::string> storage, bool validate) :
+    model_(model), npts_(npts), nstore_(model->nstore()),
+    pin_requested_(pin), pinned_(false),
+    storage_(storage.empty() ? HistoryStorage(model->nstore()) :
+             HistoryStorage(storage)),
+    validate_(validate), stress_drift_(0.0),
+    history_drift_(model->nstore(), 0.0), ier_(npts, 0), t_n_(0.0),
+    step_time_(0.0)
+{
+  if (storage_.nstore() != nstore_) {
+    throw std::invalid_argument("Need a storage precision for each stored "
+                                "variable");
+  }
+
+#ifdef _OPENMP
+  nthreads_ = (nthreads > 0) ? nthreads : omp_get_max_threads();
+#else
+  nthreads_ = (nthreads > 0) ? nthreads : 1;
+  pin_requested_ = false;
+#endif
+
+  ranges_.resize(nthreads_ + 1);
+  for (int t=0; t<=nthreads_; t++) ranges_[t] = t * npts_ / nthreads_;
+
+  // Spread the threads over the nodes in contiguous groups, so
+  // neighbouring ranges share a node
+  std::vector<std::vector<int>> nodes = numa_topology();
+  nnodes_ = (int) nodes.size();
+  cpus_.assign(nthreads_, -1);
+#ifdef __linux__
+  if (pin_requested_) {
+    int first = 0;
+    for (int t=0; t<nthreads_; t++) {
+      size_t k = (size_t) t * nodes.size() / nthreads_;
+      if ((t == 0) || (k != (size_t) (t - 1) * nodes.size() / nthreads_)) {
+        first = t;
+      }
+      cpus_[t] = nodes[k][(t - first) % nodes[k].size()];
+    }
+  }
+#endif
+
+  e_n_.allocate(6 * npts_);
+  e_np1_.allocate(6 * npts_);
+  T_n_.allocate(npts_);
+  T_np1_.allocate(npts_);
+  s_n_.allocate(6 * npts_);
+  s_np1_.allocate(6 * npts_);
+  // The stored variables in as many doubles as the packed bytes need
+  size_t hwords = (storage_.bytes() * npts_ + sizeof(double) - 1)
+      / sizeof(double);
+  h_n_.allocate(hwords);
+  h_np1_.allocate(hwords);
+  A_.allocate(36 * npts_);
+  u_n_.allocate(npts_);
+  u_np1_.allocate(npts_);
+  p_n_.allocate(npts_);
+  p_np1_.allocate(npts_);
+  if (validate_) {
+    f_s_n_.allocate(6 * npts_);
+    f_s_np1_.allocate(6 * npts_);
+    f_h_n_.allocate(nstore_ * npts_);
+    f_h_np1_.allocate(nstore_ * npts_);
+    f_u_n_.allocate(npts_);
+    f_u_np1_.allocate(npts_);
+    f_p_n_.allocate(npts_);
+    f_p_np1_.allocate(npts_);
+  }
+
+  // First touch each range from the thread that will update it
+  pin_ok_.assign(nthreads_, 1);
+  std::vector<int> ier(nthreads_, 0);
+  each_range_([&](int t, size_t i0, size_t i1)
+  {
+    std::fill(e_n_.data+6*i0, e_n_.data+6*i1, 0.0);
+    std::fill(e_np1_.data+6*i0, e_np1_.data+6*i1, 0.0);
+    std::fill(T_n_.data+i0, T_n_.data+i1, T);
+    std::fill(T_np1_.data+i0, T_np1_.data+i1, T);
+    std::fill(s_n_.data+6*i0, s_n_.data+6*i1, 0.0);
+    std::fill(s_np1_.data+6*i0, s_np1_.data+6*i1, 0.0);
+    std::fill(A_.data+36*i0, A_.data+36*i1, 0.0);
+    std::fill(u_n_.data+i0, u_n_.data+i1, 0.0);
+    std::fill(u_np1_.data+i0, u_np1_.data+i1, 0.0);
+    std::fill(p_n_.data+i0, p_n_.data+i1, 0.0);
+    std::fill(p_np1_.data+i0, p_np1_.data+i1, 0.0);
+    std::vector<double> h0(nstore_);
+    int res = model_->init_store(h0.data());
+    if (res != SUCCESS) ier[t] = res;
+    size_t b = storage_.bytes();
+    for (size_t i=i0; i<i1; i++) {
+      storage_.pack(1, h0.data(), packed_(h_n_) + b*i);
+      storage_.pack(1, h0.data(), packed_(h_np1_) + b*i);
+    }
+    if (validate_) {
+      std::fill(f_s_n_.data+6*i0, f_s_n_.data+6*i1, 0.0);
+      std::fill(f_s_np1_.data+6*i0, f_s_np1_.data+6*i1, 0.0);
+      for (size_t i=i0; i<i1; i++) {
+        std::copy(h0.begin(), h0.end(), f_h_n_.data+nstore_*i);
+        std::copy(h0.begin(), h0.end(), f_h_np1_.data+nstore_*i);
+      }
+      std::fill(f_u_n_.data+i0, f_u_n_.data+i1, 0.0);
+      std::fill(f_u_np1_.data+i0, f_u_np1_.data+i1, 0.0);
+      std::fill(f_p_n_.data+i0, f_p_n_.data+i1, 0.0);
+      std::fill(f_p_np1_.data+i0, f_p_np1_.data+i1, 0.0);
+    }
+  });
+
+  for (int t=0; t<nthreads_; t++) {
+    if (ier[t] != SUCCESS) {
+      throw std::runtime_error("Could not initialize the stored variables");
+    }
+  }
+
+  pinned_ = pin_requested_;
+  for (int t=0; t<nthreads_; t++) pinned_ = pinned_ && pin_ok_[t];
+}
+
+PointBlock::~PointBlock()
+{
+
+}
+
+size_t PointBlock::npts() const
+{
+  return npts_;
+}
+
+size_t PointBlock::nstore() const
+{
+  return nstore_;
+}
+
+int PointBlock::nthreads() const
+{
+  return nthreads_;
+}
+
+int PointBlock::nnodes() const
+{
+  return nnodes_;
+}
+
+bool PointBlock::pinned() const
+{
+  return pinned_;
+}
+
+const std::vector<int> & PointBlock::cpus() const
+{
+  return cpus_;
+}
+
+const std::vector<size_t> & PointBlock::ranges() const
+{
+  return ranges_;
+}
+
+void PointBlock::set_strain(const double * const e)
+{
+  each_range_([&](int t, size_t i0, size_t i1)
+  {
+    std::copy(e+6*i0, e+6*i1, e_np1_.data+6*i0);
+  });
+}
+
+void PointBlock::set_temperature(const double * const T)
+{
+  each_range_([&](int t, size_t i0, size_t i1)
+  {
+    std::copy(T+i0, T+i1, T_np1_.data+i0);
+  });
+}
+
+void PointBlock::set_temperature(double T)
+{
+  each_range_([&](int t, size_t i0, size_t i1)
+  {
+    std::fill(T_np1_.data+i0, T_np1_.data+i1, T);
+  });
+}
+
+int PointBlock::step(double t_np1)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  size_t b = storage_.bytes();
+  HistoryStorage full(nstore_);
+  each_range_([&](int t, size_t i0, size_t i1)
+  {
+    update_points(*model_, storage_, i1 - i0, &e_np1_.data[6*i0],
+                  &e_n_.data[6*i0], &T_np1_.data[i0], &T_n_.data[i0], t_np1,
+                  t_n_, &s_np1_.data[6*i0], &s_n_.data[6*i0],
+                  packed_(h_np1_) + b*i0, packed_(h_n_) + b*i0,
+                  &A_.data[36*i0], &u_np1_.data[i0], &u_n_.data[i0],
+                  &p_np1_.data[i0], &p_n_.data[i0], &ier_[i0]);
+
+    // The same step in full precision, keeping the reduced tangent
+    if (validate_) {
+      std::vector<double> A(36 * (i1 - i0));
+      std::vector<int> ier(i1 - i0);
+      update_points(*model_, full, i1 - i0, &e_np1_.data[6*i0],
+                    &e_n_.data[6*i0], &T_np1_.data[i0], &T_n_.data[i0],
+                    t_np1, t_n_, &f_s_np1_.data[6*i0], &f_s_n_.data[6*i0],
+                    packed_(f_h_np1_) + sizeof(double)*nstore_*i0,
+                    packed_(f_h_n_) + sizeof(double)*nstore_*i0, A.data(),
+                    &f_u_np1_.data[i0], &f_u_n_.data[i0], &f_p_np1_.data[i0],
+                    &f_p_n_.data[i0], ier.data());
+      for (size_t i=i0; i<i1; i++) {
+        if (ier_[i] == SUCCESS) ier_[i] = ier[i-i0];
+      }
+    }
+  });
+
+  step_time_ = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  for (size_t i=0; i<npts_; i++) {
+    if (ier_[i] != SUCCESS) return ier_[i];
+  }
+
+  std::swap(s_n_.data, s_np1_.data);
+  std::swap(h_n_.data, h_np1_.data);
+  std::swap(u_n_.data, u_np1_.data);
+  std::swap(p_n_.data, p_np1_.data);
+  each_range_([&](int t, size_t i0, size_t i1)
+  {
+    std::copy(e_np1_.data+6*i0, e_np1_.data+6*i1, e_n_.data+6*i0);
+    std::copy(T_np1_.data+i0, T_np1_.data+i1, T_n_.data+i0);
+  });
+  t_n_ = t_np1;
+
+  if (validate_) {
+    std::swap(f_s_n_.data, f_s_np1_.data);
+    std::swap(f_h_n_.data, f_h_np1_.data);
+    std::swap(f_u_n_.data, f_u_np1_.data);
+    std::swap(f_p_n_.data, f_p_np1_.data);
+    measure_drift_();
+  }
+
+  return SUCCESS;
+}
+
+const double * PointBlock::stress() const
+{
+  return s_n_.data;
+}
+
+const double * PointBlock::history() const
+{
+  if (storage_.full()) return h_n_.data;
+  if (h_unpacked_.data == nullptr) h_unpacked_.allocate(nstore_ * npts_);
+  storage_.unpack(npts_, packed_(h_n_), h_unpacked_.data);
+  return h_unpacked_.data;
+}
+
+const double * PointBlock::tangent() const
+{
+  return A_.data;
+}
+
+const double * PointBlock::strain() const
+{
+  return e_n_.data;
+}
+
+const double * PointBlock::temperature() const
+{
+  return T_n_.data;
+}
+
+double PointBlock::time() const
+{
+  return t_n_;
+}
+
+const int * PointBlock::errors() const
+{
+  return ier_.data();
+}
+
+const HistoryStorage & PointBlock::storage() const
+{
+  return storage_;
+}
+
+const unsigned char * PointBlock::packed_history() const
+{
+  return packed_(h_n_);
+}
+
+bool PointBlock::validating() const
+{
+  return validate_;
+}
+
+double PointBlock::stress_drift() const
+{
+  return stress_drift_;
+}
+
+const std::vector<double> & PointBlock::history_drift() const
+{
+  return history_drift_;
+}
+
+double PointBlock::bytes_per_step() const
+{
+  // Strains, temperatures, stresses, energies, and the tangent, the
+  // stored variables at both steps, and the error codes, plus the full
+  // precision stresses, energies, tangent, and stored variables when
+  // validating
+  double bytes = 66.0 * sizeof(double) + 2.0 * storage_.bytes()
+      + sizeof(int);
+  if (validate_) bytes += (52.0 + 2.0 * nstore_) * sizeof(double);
+  return (double) npts_ * bytes;
+}
+
+double PointBlock::step_time() const
+{
+  return step_time_;
+}
+
+double PointBlock::bandwidth() const
+{
+  return (step_time_ > 0.0) ? bytes_per_step() / step_time_ : 0.0;
+}
+
+unsigned char * PointBlock::packed_(const Array & a)
+{
+  return reinterpret_cast<unsigned char*>(a.data);
+}
+
+void PointBlock::measure_drift_()
+{
+  double ds = 0.0;
+  double smax = 0.0;
+  for (size_t i=0; i<6*npts_; i++) {
+    ds = std::max(ds, fabs(s_n_.data[i] - f_s_n_.data[i]));
+    smax = std::max(smax, fabs(f_s_n_.data[i]));
+  }
+  stress_drift_ = (smax > 0.0) ? ds / smax : ds;
+
+  std::vector<double> dh(nstore_, 0.0);
+  std::vector<double> hmax(nstore_, 0.0);
+  std::vector<double> h(nstore_);
+  for (size_t k=0; k<npts_; k++) {
+    storage_.unpack(1, packed_(h_n_) + storage_.bytes()*k, h.data());
+    for (size_t j=0; j<nstore_; j++) {
+      double f = f_h_n_.data[nstore_*k+j];
+      dh[j] = std::max(dh[j], fabs(h[j] - f));
+      hmax[j] = std::max(hmax[j], fabs(f));
+    }
+  }
+  for (size_t j=0; j<nstore_; j++) {
+    history_drift_[j] = (hmax[j] > 0.0) ? dh[j] / hmax[j] : dh[j];
+  }
+}
+
+#ifdef __linux__
+// The mask the thread had before pin_ bound it
+static thread_local cpu_set_t saved_mask;
+#endif
+
+bool PointBlock::pin_(int t)
+{
+#ifdef __linux__
+  int cpu = cpus_[t];
+  if (cpu < 0) return false;
+
+  if (sched_getaffinity(0, sizeof(saved_mask), &saved_mask) != 0) {
+    pin_ok_[t] = 0;
+    return false;
+  }
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    pin_ok_[t] = 0;
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void PointBlock::unpin_()
+{
+#ifdef __linux__
+  sched_setaffinity(0, sizeof(saved_mask), &saved_mask);
+#endif
+}
+
+} // namespace neml
@@ -0,0 +1,194 @@
+#ifndef POINTBLOCK_H
+#define POINTBLOCK_H
+
+#include "models.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace neml {
+
+/// The CPUs this process may run on, grouped by NUMA node
+//  Read from /sys/devices/system/node on Linux.  Nodes with no usable CPUs
+//  are dropped, and if the topology cannot be read every usable CPU is put
+//  in a single node.
+std::vector<std::vector<int>> numa_topology();
+
+/// How each stored variable of a point is kept between steps
+//  Each variable is "double", "single" (float32), or "bfloat16", which
+//  keeps the exponent range of a float but only 8 bits of the mantissa,
+//  about 3 significant digits.  The variables of a point are packed with
+//  the doubles first, then the singles, then the bfloat16s.  Packing
+//  rounds to nearest, and unpacking is exact.
+class HistoryStorage {
+ public:
+  /// The precision of each stored variable
+  HistoryStorage(const std::vector<std::string> & precisions);
+  /// Every one of n variables in double precision
+  HistoryStorage(size_t n);
+
+  /// Number of stored variables
+  size_t nstore() const;
+  /// The precision of each variable
+  std::vector<std::string> precisions() const;
+  /// Packed bytes per point
+  size_t bytes() const;
+  /// Is every variable kept in double precision?
+  bool full() const;
+
+  /// Pack the variables of npts points
+  void pack(size_t npts, const double * const h,
+            unsigned char * const packed) const;
+  /// Unpack the variables of npts points
+  void unpack(size_t npts, const unsigned char * const packed,
+              double * const h) const;
+
+ private:
+  enum Precision {DOUBLE, SINGLE, BFLOAT16};
+  std::vector<Precision> precision_;
+  std::vector<size_t> offset_;
+  size_t bytes_;
+};
+
+/// A block of material points whose state is owned by the driver
+//  The block splits the points into one fixed range per thread.  The
+//  state of each range is first touched by the thread that updates it, so
+//  on a NUMA machine its pages live on that thread's node, and every step
+//  the same thread updates the same range.  With pinning on, the threads
+//  are also spread over the nodes and bound to CPUs while they work on
+//  their ranges, so they stay next to their memory, and then get their
+//  old CPU masks back.  Without OpenMP the ranges run one after the other on
+//  the calling thread and nothing is pinned.
+//
+//  Arrays are stored point by point: strain and stress are npts x 6, the
+//  stored variables npts x nstore, and the tangent npts x 36.
+//
+//  The stored variables can be kept in reduced precision between steps
+//  with a HistoryStorage policy.  Each batch of points is unpacked to
+//  double, updated in double, and packed again.  With validation on, the
+//  block also carries a full precision copy of the stress, stored
+//  variables, and energies through the same steps and reports how far the
+//  reduced state has drifted from it.
+class PointBlock {
+ public:
+  /// Points updated with model, starting at temperature T, on nthreads
+  /// threads (0 for the OpenMP default), optionally pinning the threads
+  /// to CPUs, with the stored variables kept as given by storage (empty
+  /// for all double), and optionally validating reduced storage against
+  /// full precision
+  PointBlock(std::shared_ptr<NEMLModel> model, size_t npts, double T,
+             int nthreads = 0, bool pin = false,
+             std::vector<std::string> storage = std::vector<std::string>(),
+             bool validate = false);
+  ~PointBlock();
+
+  /// Number of points
+  size_t npts() const;
+  /// Number of stored variables per point
+  size_t nstore() const;
+  /// Number of threads, each with its own range of points
+  int nthreads() const;
+  /// Number of NUMA nodes available to the block
+  int nnodes() const;
+  /// Were the threads pinned to CPUs?
+  bool pinned() const;
+  /// The CPU each thread is pinned to, or -1
+  const std::vector<int> & cpus() const;
+  /// The first point of each thread's range, plus npts at the end
+  const std::vector<size_t> & ranges() const;
+
+  /// Set the strain for the next step (npts x 6)
+  void set_strain(const double * const e);
+  /// Set the temperature for the next step
+  void set_temperature(const double * const T);
+  /// Set the same temperature at every point for the next step
+  void set_temperature(double T);
+
+  /// Update every point to the time t_np1
+  //  If any point fails the state stays at the last step and the first
+  //  error is returned.
+  int step(double t_np1);
+
+  /// Current stress
+  const double * stress() const;
+  /// Current stored variables
+  //  With reduced storage these are unpacked into a copy on each call.
+  const double * history() const;
+  /// Tangent from the last step
+  const double * tangent() const;
+  /// Current strain
+  const double * strain() const;
+  /// Current temperature
+  const double * temperature() const;
+  /// Current time
+  double time() const;
+  /// Error code of each point from the last step
+  const int * errors() const;
+
+  /// How the stored variables are kept
+  const HistoryStorage & storage() const;
+  /// The packed stored variables, storage().bytes() per point
+  const unsigned char * packed_history() const;
+  /// Is the reduced storage checked against full precision?
+  bool validating() const;
+  /// Largest stress difference from full precision over the largest
+  /// full precision stress, zero unless validating
+  double stress_drift() const;
+  /// Largest difference of each stored variable from full precision over
+  /// its largest full precision value, zero unless validating
+  const std::vector<double> & history_drift() const;
+
+  /// Bytes of state read and written in a step
+  double bytes_per_step() const;
+  /// Seconds taken by the last step
+  double step_time() const;
+  /// Memory bandwidth achieved by the last step, in bytes per second
+  double bandwidth() const;
+
+ private:
+  // One array, aligned to pages so ranges share as few pages as possible
+  struct Array {
+    Array();
+    ~Array();
+    Array(const Array &) = delete;
+    Array & operator=(const Array &) = delete;
+    void allocate(size_t n);
+    double * data;
+  };
+
+  // Bind the calling thread to its CPU, returning true if it was bound
+  bool pin_(int t);
+  // Give the calling thread back the mask it had before pin_
+  void unpin_();
+  // Run f(t, first, last) for each range on its own thread
+  template <class F> void each_range_(const F & f);
+  // The stored variables of an array as packed bytes
+  static unsigned char * packed_(const Array & a);
+  // Measure the drift from the full precision copy
+  void measure_drift_();
+
+  std::shared_ptr<NEMLModel> model_;
+  size_t npts_, nstore_;
+  int nthreads_, nnodes_;
+  bool pin_requested_, pinned_;
+  std::vector<int> cpus_;
+  std::vector<int> pin_ok_;
+  std::vector<size_t> ranges_;
+
+  Array e_n_, e_np1_, T_n_, T_np1_, s_n_, s_np1_, h_n_, h_np1_, A_;
+  Array u_n_, u_np1_, p_n_, p_np1_;
+  HistoryStorage storage_;
+  bool validate_;
+  Array f_s_n_, f_s_np1_, f_h_n_, f_h_np1_, f_u_n_, f_u_np1_, f_p_n_, f_p_np1_;
+  mutable Array h_unpacked_;
+  double stress_drift_;
+  std::vector<double> history_drift_;
+  std::vector<int> ier_;
+  double t_n_;
+  double step_time_;
+};
+
+} // namespace neml
+
+#endif // POINTBLOCK_H
@@ -0,0 +1,151 @@
+#include "pyhelp.h" // include first to avoid annoying redef warning
+
+#include "pointblock.h"
+
+namespace py = pybind11;
+
+namespace neml {
+
+// Copy an array owned by the block
+template<class T> py::array_t<T> copy_mat(const T * data, size_t m, size_t n)
+{
+  auto arr = alloc_mat<T>(m, n);
+  std::copy(data, data + m * n, arr2ptr<T>(arr));
+  return arr;
+}
+
+PYBIND11_MODULE(pointblock, m) {
+  py::module::import("neml.models");
+
+  m.doc() = "Blocks of material points with NUMA aware storage.";
+
+  m.def("numa_topology", &numa_topology,
+        "The usable CPUs grouped by NUMA node.");
+
+  py::class_<HistoryStorage, std::shared_ptr<HistoryStorage>>(m, "HistoryStorage")
+      .def(py::init<const std::vector<std::string> &>(),
+           py::arg("precisions"))
+      .def(py::init<size_t>(), py::arg("n"))
+      .def_property_readonly("nstore", &HistoryStorage::nstore,
+                             "Number of stored variables.")
+      .def_property_readonly("precisions", &HistoryStorage::precisions,
+                             "The precision of each variable.")
+      .def_property_readonly("bytes", &HistoryStorage::bytes,
+                             "Packed bytes per point.")
+      .def_property_readonly("full", &HistoryStorage::full,
+                             "Is every variable kept in double precision?")
+      .def("round",
+           [](HistoryStorage & s, py::array_t<double, py::array::c_style> h)
+           {
+            if (h.size() != (py::ssize_t) s.nstore()) {
+              throw std::invalid_argument("Need nstore values");
+            }
+            std::vector<unsigned char> packed(s.bytes());
+            auto res = alloc_vec<double>(s.nstore());
+            s.pack(1, arr2ptr<double>(h), packed.data());
+            s.unpack(1, packed.data(), arr2ptr<double>(res));
+            return res;
+           }, "The values of one point after packing and unpacking.")
+      ;
+
+  py::class_<PointBlock, std::shared_ptr<PointBlock>>(m, "PointBlock")
+      .def(py::init<std::shared_ptr<NEMLModel>, size_t, double, int, bool,
+           std::vector<std::string>, bool>(),
+           py::arg("model"), py::arg("npts"), py::arg("T") = 0.0,
+           py::arg("nthreads") = 0, py::arg("pin") = false,
+           py::arg("storage") = std::vector<std::string>(),
+           py::arg("validate") = false)
+      .def_property_readonly("npts", &PointBlock::npts, "Number of points.")
+      .def_property_readonly("nstore", &PointBlock::nstore,
+                             "Number of stored variables per point.")
+      .def_property_readonly("nthreads", &PointBlock::nthreads,
+                             "Number of threads.")
+      .def_property_readonly("nnodes", &PointBlock::nnodes,
+                             "Number of NUMA nodes available.")
+      .def_property_readonly("pinned", &PointBlock::pinned,
+                             "Were the threads pinned to CPUs?")
+      .def_property_readonly("cpus", &PointBlock::cpus,
+                             "The CPU each thread is pinned to, or -1.")
+      .def_property_readonly("ranges", &PointBlock::ranges,
+                             "The first point of each thread's range, plus npts.")
+      .def("set_strain",
+           [](PointBlock & b, py::array_t<double, py::array::c_style> e)
+           {
+            if (e.size() != (py::ssize_t) (6 * b.npts())) {
+              throw std::invalid_argument("Strain must be npts x 6");
+            }
+            b.set_strain(arr2ptr<double>(e));
+           }, "Set the strain for the next step.")
+      .def("set_temperature",
+           [](PointBlock & b, py::array_t<double, py::array::c_style> T)
+           {
+            if (T.size() == 1) {
+              b.set_temperature(*arr2ptr<double>(T));
+            }
+            else if (T.size() == (py::ssize_t) b.npts()) {
+              b.set_temperature(arr2ptr<double>(T));
+            }
+            else {
+              throw std::invalid_argument("Temperature must be a scalar or npts");
+            }
+           }, "Set the temperature for the next step.")
+      .def("step",
+           [](PointBlock & b, double t_np1)
+           {
+            int ier = b.step(t_np1);
+            py_error(ier);
+           }, "Update every point to the new time.")
+      .def_property_readonly("stress",
+           [](PointBlock & b)
+           {
+            return copy_mat<double>(b.stress(), b.npts(), 6);
+           }, "Current stress.")
+      .def_property_readonly("history",
+           [](PointBlock & b)
+           {
+            return copy_mat<double>(b.history(), b.npts(), b.nstore());
+           }, "Current stored variables.")
+      .def_property_readonly("tangent",
+           [](PointBlock & b)
+           {
+            return copy_mat<double>(b.tangent(), b.npts(), 36);
+           }, "Tangent from the last step, flattened.")
+      .def_property_readonly("strain",
+           [](PointBlock & b)
+           {
+            return copy_mat<double>(b.strain(), b.npts(), 6);
+           }, "Current strain.")
+      .def_property_readonly("temperature",
+           [](PointBlock & b)
+           {
+            auto T = alloc_vec<double>(b.npts());
+            std::copy(b.temperature(), b.temperature() + b.npts(),
+                      arr2ptr<double>(T));
+            return T;
+           }, "Current temperature.")
+      .def_property_readonly("time", &PointBlock::time, "Current time.")
+      .def_property_readonly("errors",
+           [](PointBlock & b)
+           {
+            auto ier = alloc_vec<int>(b.npts());
+            std::copy(b.errors(), b.errors() + b.npts(), arr2ptr<int>(ier));
+            return ier;
+           }, "Error code of each point from the last step.")
+      .def_property_readonly("storage", &PointBlock::storage,
+                             "How the stored variables are kept.")
+      .def_property_readonly("validating", &PointBlock::validating,
+                             "Is reduced storage checked against full precision?")
+      .def_property_readonly("stress_drift", &PointBlock::stress_drift,
+                             "Relative stress drift from full precision.")
+      .def_property_readonly("history_drift", &PointBlock::history_drift,
+                             "Relative drift of each stored variable from full precision.")
+      .def_property_readonly("bytes_per_step", &PointBlock::bytes_per_step,
+                             "Bytes of state read and written in a step.")
+      .def_property_readonly("step_time", &PointBlock::step_time,
+                             "Seconds taken by the last step.")
+      .def_property_readonly("bandwidth", &PointBlock::bandwidth,
+                             "Bandwidth of the last step in bytes per second.")
+      ;
+}
+
+} // namespace neml
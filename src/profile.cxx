@@ -0,0 +1,1043 @@
+#include "profile.h"
+
+#include "interpolate.h"
+#include "surfaces.h"
+#include "hardening.h"
+#include "visco_flow.h"
+#include "ri_flow.h"
+#include "general_flow.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace neml {
+
+/// A call in the profile tree, with the calls it made
+struct ProfileNode {
+  ProfileNode(const std::string & name) :
+      name(name), calls(0), time(0.0), child_time(0.0)
+  {
+
+  }
+
+  /// Find or add the child with a name
+  ProfileNode * child(const std::string & cname)
+  {
+    for (auto & kid : kids) {
+      if (kid->name == cname) return kid.get();
+    }
+    kids.emplace_back(new ProfileNode(cname));
+    return kids.back().get();
+  }
+
+  std::string name;
+  size_t calls;
+  double time;          // Inclusive
+  double child_time;    // Spent in the children
+  std::vector<std::unique_ptr<ProfileNode>> kids;
+};
+
+/// The call tree for one thread
+struct ProfileTree {
+  ProfileTree() : root("root"), current(&root) {}
+
+  ProfileNode root;
+  ProfileNode * current;
+};
+
+/// The trees for all the threads that have made profiled calls
+//  The trees are kept after their threads exit so the report covers them.
+struct ProfileRegistry {
+  std::mutex lock;
+  std::vector<std::shared_ptr<ProfileTree>> trees;
+};
+
+static ProfileRegistry & profile_registry()
+{
+  static ProfileRegistry registry;
+  return registry;
+}
+
+static ProfileTree & profile_tree()
+{
+  thread_local std::shared_ptr<ProfileTree> tree;
+  if (not tree) {
+    tree = std::make_shared<ProfileTree>();
+    ProfileRegistry & reg = profile_registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    reg.trees.push_back(tree);
+  }
+  return *tree;
+}
+
+ProfileScope::ProfileScope(const std::string & name)
+{
+  ProfileTree & tree = profile_tree();
+  parent_ = tree.current;
+  node_ = parent_->child(name);
+  tree.current = node_;
+  start_ = std::chrono::steady_clock::now();
+}
+
+ProfileScope::~ProfileScope()
+{
+  double dt = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start_).count();
+  node_->calls++;
+  node_->time += dt;
+  parent_->child_time += dt;
+  profile_tree().current = parent_;
+}
+
+/// Times the calls to an Interpolate
+class InterpolateProxy: public Interpolate {
+ public:
+  InterpolateProxy(std::shared_ptr<Interpolate> base,
+                   const std::string & name) :
+      base_(base), name_(name)
+  {
+    valid_ = base_->valid();
+  }
+
+  virtual double value(double x) const
+  {
+    ProfileScope scope(name_);
+    return base_->value(x);
+  }
+
+  virtual double derivative(double x) const
+  {
+    ProfileScope scope(name_);
+    return base_->derivative(x);
+  }
+
+  virtual bool constant() const
+  {
+    return base_->constant();
+  }
+
+ private:
+  std::shared_ptr<Interpolate> base_;
+  std::string name_;
+};
+
+/// Times the calls to a YieldSurface
+class YieldSurfaceProxy: public YieldSurface {
+ public:
+  YieldSurfaceProxy(std::shared_ptr<YieldSurface> base,
+                    const std::string & name) :
+      base_(base), name_(name)
+  {
+
+  }
+
+  virtual size_t nhist() const
+  {
+    return base_->nhist();
+  }
+
+  virtual int f(const double * const s, const double * const q, double T,
+                double & fv) const
+  {
+    ProfileScope scope(name_);
+    return base_->f(s, q, T, fv);
+  }
+
+  virtual int df_ds(const double * const s, const double * const q, double T,
+                    double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->df_ds(s, q, T, dv);
+  }
+
+  virtual int df_dq(const double * const s, const double * const q, double T,
+                    double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->df_dq(s, q, T, dv);
+  }
+
+  virtual int df_dsds(const double * const s, const double * const q, double T,
+                      double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->df_dsds(s, q, T, dv);
+  }
+
+  virtual int df_dqdq(const double * const s, const double * const q, double T,
+                      double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->df_dqdq(s, q, T, dv);
+  }
+
+  virtual int df_dsdq(const double * const s, const double * const q, double T,
+                      double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->df_dsdq(s, q, T, dv);
+  }
+
+  virtual int df_dqds(const double * const s, const double * const q, double T,
+                      double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->df_dqds(s, q, T, dv);
+  }
+
+ private:
+  std::shared_ptr<YieldSurface> base_;
+  std::string name_;
+};
+
+/// Times the calls to a HardeningRule
+class HardeningRuleProxy: public HardeningRule {
+ public:
+  HardeningRuleProxy(std::shared_ptr<HardeningRule> base,
+                     const std::string & name) :
+      base_(base), name_(name)
+  {
+
+  }
+
+  virtual size_t nhist() const
+  {
+    return base_->nhist();
+  }
+
+  virtual int init_hist(double * const alpha) const
+  {
+    ProfileScope scope(name_);
+    return base_->init_hist(alpha);
+  }
+
+  virtual int q(const double * const alpha, double T, double * const qv) const
+  {
+    ProfileScope scope(name_);
+    return base_->q(alpha, T, qv);
+  }
+
+  virtual int dq_da(const double * const alpha, double T,
+                    double * const dqv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dq_da(alpha, T, dqv);
+  }
+
+ private:
+  std::shared_ptr<HardeningRule> base_;
+  std::string name_;
+};
+
+/// Times the calls to a NonAssociativeHardening
+class NonAssociativeHardeningProxy: public NonAssociativeHardening {
+ public:
+  NonAssociativeHardeningProxy(std::shared_ptr<NonAssociativeHardening> base,
+                               const std::string & name) :
+      base_(base), name_(name)
+  {
+
+  }
+
+  virtual size_t ninter() const
+  {
+    return base_->ninter();
+  }
+
+  virtual size_t nhist() const
+  {
+    return base_->nhist();
+  }
+
+  virtual int init_hist(double * const alpha) const
+  {
+    ProfileScope scope(name_);
+    return base_->init_hist(alpha);
+  }
+
+  virtual int q(const double * const alpha, double T, double * const qv) const
+  {
+    ProfileScope scope(name_);
+    return base_->q(alpha, T, qv);
+  }
+
+  virtual int dq_da(const double * const alpha, double T,
+                    double * const qv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dq_da(alpha, T, qv);
+  }
+
+  virtual int h(const double * const s, const double * const alpha, double T,
+                double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->h(s, alpha, T, dv);
+  }
+
+  virtual int dh_ds(const double * const s, const double * const alpha,
+                    double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dh_ds(s, alpha, T, dv);
+  }
+
+  virtual int dh_da(const double * const s, const double * const alpha,
+                    double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dh_da(s, alpha, T, dv);
+  }
+
+  virtual int h_time(const double * const s, const double * const alpha,
+                     double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->h_time(s, alpha, T, dv);
+  }
+
+  virtual int dh_ds_time(const double * const s, const double * const alpha,
+                         double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dh_ds_time(s, alpha, T, dv);
+  }
+
+  virtual int dh_da_time(const double * const s, const double * const alpha,
+                         double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dh_da_time(s, alpha, T, dv);
+  }
+
+  virtual int h_temp(const double * const s, const double * const alpha,
+                     double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->h_temp(s, alpha, T, dv);
+  }
+
+  virtual int dh_ds_temp(const double * const s, const double * const alpha,
+                         double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dh_ds_temp(s, alpha, T, dv);
+  }
+
+  virtual int dh_da_temp(const double * const s, const double * const alpha,
+                         double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dh_da_temp(s, alpha, T, dv);
+  }
+
+ private:
+  std::shared_ptr<NonAssociativeHardening> base_;
+  std::string name_;
+};
+
+/// Times the calls to a FluidityModel
+class FluidityModelProxy: public FluidityModel {
+ public:
+  FluidityModelProxy(std::shared_ptr<FluidityModel> base,
+                     const std::string & name) :
+      base_(base), name_(name)
+  {
+
+  }
+
+  virtual double eta(double a, double T) const
+  {
+    ProfileScope scope(name_);
+    return base_->eta(a, T);
+  }
+
+  virtual double deta(double a, double T) const
+  {
+    ProfileScope scope(name_);
+    return base_->deta(a, T);
+  }
+
+ private:
+  std::shared_ptr<FluidityModel> base_;
+  std::string name_;
+};
+
+/// Times the calls to a ViscoPlasticFlowRule
+class ViscoPlasticFlowRuleProxy: public ViscoPlasticFlowRule {
+ public:
+  ViscoPlasticFlowRuleProxy(std::shared_ptr<ViscoPlasticFlowRule> base,
+                            const std::string & name) :
+      base_(base), name_(name)
+  {
+
+  }
+
+  virtual size_t nhist() const
+  {
+    return base_->nhist();
+  }
+
+  virtual int init_hist(double * const h) const
+  {
+    ProfileScope scope(name_);
+    return base_->init_hist(h);
+  }
+
+  virtual int y(const double * const s, const double * const alpha, double T,
+                double & yv) const
+  {
+    ProfileScope scope(name_);
+    return base_->y(s, alpha, T, yv);
+  }
+
+  virtual int dy_ds(const double * const s, const double * const alpha,
+                    double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dy_ds(s, alpha, T, dv);
+  }
+
+  virtual int dy_da(const double * const s, const double * const alpha,
+                    double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dy_da(s, alpha, T, dv);
+  }
+
+  virtual int g(const double * const s, const double * const alpha, double T,
+                double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->g(s, alpha, T, dv);
+  }
+
+  virtual int dg_ds(const double * const s, const double * const alpha,
+                    double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dg_ds(s, alpha, T, dv);
+  }
+
+  virtual int dg_da(const double * const s, const double * const alpha,
+                    double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dg_da(s, alpha, T, dv);
+  }
+
+  virtual int g_time(const double * const s, const double * const alpha,
+                     double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->g_time(s, alpha, T, dv);
+  }
+
+  virtual int dg_ds_time(const double * const s, const double * const alpha,
+                         double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dg_ds_time(s, alpha, T, dv);
+  }
+
+  virtual int dg_da_time(const double * const s, const double * const alpha,
+                         double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dg_da_time(s, alpha, T, dv);
+  }
+
+  virtual int g_temp(const double * const s, const double * const alpha,
+                     double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->g_temp(s, alpha, T, dv);
+  }
+
+  virtual int dg_ds_temp(const double * const s, const double * const alpha,
+                         double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dg_ds_temp(s, alpha, T, dv);
+  }
+
+  virtual int dg_da_temp(const double * const s, const double * const alpha,
+                         double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dg_da_temp(s, alpha, T, dv);
+  }
+
+  virtual int h(const double * const s, const double * const alpha, double T,
+                double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->h(s, alpha, T, dv);
+  }
+
+  virtual int dh_ds(const double * const s, const double * const alpha,
+                    double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dh_ds(s, alpha, T, dv);
+  }
+
+  virtual int dh_da(const double * const s, const double * const alpha,
+                    double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dh_da(s, alpha, T, dv);
+  }
+
+  virtual int h_time(const double * const s, const double * const alpha,
+                     double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->h_time(s, alpha, T, dv);
+  }
+
+  virtual int dh_ds_time(const double * const s, const double * const alpha,
+                         double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dh_ds_time(s, alpha, T, dv);
+  }
+
+  virtual int dh_da_time(const double * const s, const double * const alpha,
+                         double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dh_da_time(s, alpha, T, dv);
+  }
+
+  virtual int h_temp(const double * const s, const double * const alpha,
+                     double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->h_temp(s, alpha, T, dv);
+  }
+
+  virtual int dh_ds_temp(const double * const s, const double * const alpha,
+                         double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dh_ds_temp(s, alpha, T, dv);
+  }
+
+  virtual int dh_da_temp(const double * const s, const double * const alpha,
+                         double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dh_da_temp(s, alpha, T, dv);
+  }
+
+ private:
+  std::shared_ptr<ViscoPlasticFlowRule> base_;
+  std::string name_;
+};
+
+/// Times the calls to a RateIndependentFlowRule
+class RateIndependentFlowRuleProxy: public RateIndependentFlowRule {
+ public:
+  RateIndependentFlowRuleProxy(std::shared_ptr<RateIndependentFlowRule> base,
+                               const std::string & name) :
+      base_(base), name_(name)
+  {
+
+  }
+
+  virtual size_t nhist() const
+  {
+    return base_->nhist();
+  }
+
+  virtual int init_hist(double * const h) const
+  {
+    ProfileScope scope(name_);
+    return base_->init_hist(h);
+  }
+
+  virtual int f(const double * const s, const double * const alpha, double T,
+                double & fv) const
+  {
+    ProfileScope scope(name_);
+    return base_->f(s, alpha, T, fv);
+  }
+
+  virtual int df_ds(const double * const s, const double * const alpha,
+                    double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->df_ds(s, alpha, T, dv);
+  }
+
+  virtual int df_da(const double * const s, const double * const alpha,
+                    double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->df_da(s, alpha, T, dv);
+  }
+
+  virtual int g(const double * const s, const double * const alpha, double T,
+                double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->g(s, alpha, T, dv);
+  }
+
+  virtual int dg_ds(const double * const s, const double * const alpha,
+                    double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dg_ds(s, alpha, T, dv);
+  }
+
+  virtual int dg_da(const double * const s, const double * const alpha,
+                    double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dg_da(s, alpha, T, dv);
+  }
+
+  virtual int h(const double * const s, const double * const alpha, double T,
+                double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->h(s, alpha, T, dv);
+  }
+
+  virtual int dh_ds(const double * const s, const double * const alpha,
+                    double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dh_ds(s, alpha, T, dv);
+  }
+
+  virtual int dh_da(const double * const s, const double * const alpha,
+                    double T, double * const dv) const
+  {
+    ProfileScope scope(name_);
+    return base_->dh_da(s, alpha, T, dv);
+  }
+
+ private:
+  std::shared_ptr<RateIndependentFlowRule> base_;
+  std::string name_;
+};
+
+/// Times the calls to a GeneralFlowRule
+class GeneralFlowRuleProxy: public GeneralFlowRule {
+ public:
+  GeneralFlowRuleProxy(std::shared_ptr<GeneralFlowRule> base,
+                       const std::string & name) :
+      base_(base), name_(name)
+  {
+
+  }
+
+  virtual size_t nhist() const
+  {
+    return base_->nhist();
+  }
+
+  virtual int init_hist(double * const h)
+  {
+    ProfileScope scope(name_);
+    return base_->init_hist(h);
+  }
+
+  virtual int s(const double * const s, const double * const alpha,
+                const double * const edot, double T, double Tdot,
+                double * const dv)
+  {
+    ProfileScope scope(name_);
+    return base_->s(s, alpha, edot, T, Tdot, dv);
+  }
+
+  virtual int ds_ds(const double * const s, const double * const alpha,
+                    const double * const edot, double T, double Tdot,
+                    double * const dv)
+  {
+    ProfileScope scope(name_);
+    return base_->ds_ds(s, alpha, edot, T, Tdot, dv);
+  }
+
+  virtual int ds_da(const double * const s, const double * const alpha,
+                    const double * const edot, double T, double Tdot,
+                    double * const dv)
+  {
+    ProfileScope scope(name_);
+    return base_->ds_da(s, alpha, edot, T, Tdot, dv);
+  }
+
+  virtual int ds_de(const double * const s, const double * const alpha,
+                    const double * const edot, double T, double Tdot,
+                    double * const dv)
+  {
+    ProfileScope scope(name_);
+    return base_->ds_de(s, alpha, edot, T, Tdot, dv);
+  }
+
+  virtual int a(const double * const s, const double * const alpha,
+                const double * const edot, double T, double Tdot,
+                double * const dv)
+  {
+    ProfileScope scope(name_);
+    return base_->a(s, alpha, edot, T, Tdot, dv);
+  }
+
+  virtual int da_ds(const double * const s, const double * const alpha,
+                    const double * const edot, double T, double Tdot,
+                    double * const dv)
+  {
+    ProfileScope scope(name_);
+    return base_->da_ds(s, alpha, edot, T, Tdot, dv);
+  }
+
+  virtual int da_da(const double * const s, const double * const alpha,
+                    const double * const edot, double T, double Tdot,
+                    double * const dv)
+  {
+    ProfileScope scope(name_);
+    return base_->da_da(s, alpha, edot, T, Tdot, dv);
+  }
+
+  virtual int da_de(const double * const s, const double * const alpha,
+                    const double * const edot, double T, double Tdot,
+                    double * const dv)
+  {
+    ProfileScope scope(name_);
+    return base_->da_de(s, alpha, edot, T, Tdot, dv);
+  }
+
+  virtual int work_rate(const double * const s, const double * const alpha,
+                        const double * const edot, double T, double Tdot,
+                        double & p_rate)
+  {
+    ProfileScope scope(name_);
+    return base_->work_rate(s, alpha, edot, T, Tdot, p_rate);
+  }
+
+  virtual int elastic_strains(const double * const s_np1, double T_np1,
+                              double * const e_np1) const
+  {
+    ProfileScope scope(name_);
+    return base_->elastic_strains(s_np1, T_np1, e_np1);
+  }
+
+  virtual int set_elastic_model(std::shared_ptr<LinearElasticModel> emodel)
+  {
+    return base_->set_elastic_model(emodel);
+  }
+
+ private:
+  std::shared_ptr<GeneralFlowRule> base_;
+  std::string name_;
+};
+/// Times the calls to a small strain model
+//  The proxy forwards the large strain update too, so the wrapped model
+//  keeps its own objective rate.
+class NEMLModelProxy: public NEMLModel_sd {
+ public:
+  NEMLModelProxy(std::shared_ptr<NEMLModel_sd> base,
+                 const std::string & name) :
+      NEMLModel_sd(std::const_pointer_cast<LinearElasticModel>(
+          base->elastic()), std::make_shared<ConstantInterpolate>(0.0), true),
+      base_(base), name_(name)
+  {
+
+  }
+
+  virtual int update_sd(
+      const double * const e_np1, const double * const e_n,
+      double T_np1, double T_n,
+      double t_np1, double t_n,
+      double * const s_np1, const double * const s_n,
+      double * const h_np1, const double * const h_n,
+      double * const A_np1,
+      double & u_np1, double u_n,
+      double & p_np1, double p_n)
+  {
+    ProfileScope scope(name_);
+    return base_->update_sd(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1, s_n,
+                            h_np1, h_n, A_np1, u_np1, u_n, p_np1, p_n);
+  }
+
+  virtual int update_sd_scale(
+      const double * const e_np1, const double * const e_n,
+      double T_np1, double T_n,
+      double t_np1, double t_n,
+      double * const s_np1, const double * const s_n,
+      double * const h_np1, const double * const h_n,
+      double * const A_np1,
+      double & u_np1, double u_n,
+      double & p_np1, double p_n,
+      double & dt_scale)
+  {
+    ProfileScope scope(name_);
+    return base_->update_sd_scale(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1,
+                                  s_n, h_np1, h_n, A_np1, u_np1, u_n, p_np1,
+                                  p_n, dt_scale);
+  }
+
+  virtual int update_sd_batch(
+      size_t npts,
+      const double * const e_np1, const double * const e_n,
+      const double * const T_np1, const double * const T_n,
+      double t_np1, double t_n,
+      double * const s_np1, const double * const s_n,
+      double * const h_np1, const double * const h_n,
+      double * const A_np1,
+      double * const u_np1, const double * const u_n,
+      double * const p_np1, const double * const p_n,
+      int * const ier)
+  {
+    ProfileScope scope(name_);
+    return base_->update_sd_batch(npts, e_np1, e_n, T_np1, T_n, t_np1, t_n,
+                                  s_np1, s_n, h_np1, h_n, A_np1, u_np1, u_n,
+                                  p_np1, p_n, ier);
+  }
+
+  virtual int update_ld_inc(
+      const double * const d_np1, const double * const d_n,
+      const double * const w_np1, const double * const w_n,
+      double T_np1, double T_n,
+      double t_np1, double t_n,
+      double * const s_np1, const double * const s_n,
+      double * const h_np1, const double * const h_n,
+      double * const A_np1, double * const B_np1,
+      double & u_np1, double u_n,
+      double & p_np1, double p_n)
+  {
+    ProfileScope scope(name_);
+    return base_->update_ld_inc(d_np1, d_n, w_np1, w_n, T_np1, T_n, t_np1,
+                                t_n, s_np1, s_n, h_np1, h_n, A_np1, B_np1,
+                                u_np1, u_n, p_np1, p_n);
+  }
+
+  virtual size_t nstore() const
+  {
+    return base_->nstore();
+  }
+
+  virtual int init_store(double * const store) const
+  {
+    ProfileScope scope(name_);
+    return base_->init_store(store);
+  }
+
+  virtual size_t nhist() const
+  {
+    return base_->nhist();
+  }
+
+  virtual int init_hist(double * const hist) const
+  {
+    ProfileScope scope(name_);
+    return base_->init_hist(hist);
+  }
+
+  virtual double alpha(double T) const
+  {
+    return base_->alpha(T);
+  }
+
+  virtual int elastic_strains(const double * const s_np1,
+                              double T_np1, const double * const h_np1,
+                              double * const e_np1) const
+  {
+    ProfileScope scope(name_);
+    return base_->elastic_strains(s_np1, T_np1, h_np1, e_np1);
+  }
+
+  virtual double bulk(double T) const
+  {
+    return base_->bulk(T);
+  }
+
+  virtual double shear(double T) const
+  {
+    return base_->shear(T);
+  }
+
+  virtual double cost() const
+  {
+    return base_->cost();
+  }
+
+  virtual double iteration_cost() const
+  {
+    return base_->iteration_cost();
+  }
+
+  virtual double point_cost(const double * const h) const
+  {
+    return base_->point_cost(h);
+  }
+
+  virtual bool failed(const double * const h) const
+  {
+    return base_->failed(h);
+  }
+
+  virtual int set_elastic_model(std::shared_ptr<LinearElasticModel> emodel)
+  {
+    elastic_ = emodel;
+    return base_->set_elastic_model(emodel);
+  }
+
+ private:
+  std::shared_ptr<NEMLModel_sd> base_;
+  std::string name_;
+};
+
+/// Registers the proxy for objects requested as the interface I
+template<typename I, typename P>
+class RegisterProxy {
+ public:
+  RegisterProxy()
+  {
+    Factory::Creator()->register_proxy(typeid(I),
+        [](std::shared_ptr<NEMLObject> obj, const std::string & name)
+          -> std::shared_ptr<NEMLObject>
+        {
+          auto base = std::dynamic_pointer_cast<I>(obj);
+          if (base == nullptr) return obj; // Left for the caller to reject
+          return std::make_shared<P>(base, name);
+        });
+  }
+};
+
+static RegisterProxy<Interpolate, InterpolateProxy> regInterpolateProxy;
+static RegisterProxy<YieldSurface, YieldSurfaceProxy> regYieldSurfaceProxy;
+static RegisterProxy<HardeningRule, HardeningRuleProxy> regHardeningRuleProxy;
+static RegisterProxy<NonAssociativeHardening, NonAssociativeHardeningProxy>
+    regNonAssociativeHardeningProxy;
+static RegisterProxy<FluidityModel, FluidityModelProxy> regFluidityModelProxy;
+static RegisterProxy<ViscoPlasticFlowRule, ViscoPlasticFlowRuleProxy>
+    regViscoPlasticFlowRuleProxy;
+static RegisterProxy<RateIndependentFlowRule, RateIndependentFlowRuleProxy>
+    regRateIndependentFlowRuleProxy;
+static RegisterProxy<GeneralFlowRule, GeneralFlowRuleProxy>
+    regGeneralFlowRuleProxy;
+static RegisterProxy<NEMLModel_sd, NEMLModelProxy> regNEMLModelProxy;
+
+std::shared_ptr<NEMLModel> profile_model(std::shared_ptr<NEMLModel> model,
+                                         const std::string & name)
+{
+  auto base = std::dynamic_pointer_cast<NEMLModel_sd>(model);
+  if (base == nullptr) return model;
+  return std::make_shared<NEMLModelProxy>(base, name);
+}
+
+std::unique_ptr<NEMLModel> profile_model(std::unique_ptr<NEMLModel> model,
+                                         const std::string & name)
+{
+  if (dynamic_cast<NEMLModel_sd*>(model.get()) == nullptr) return model;
+  std::shared_ptr<NEMLModel_sd> base(
+      static_cast<NEMLModel_sd*>(model.release()));
+  return neml::make_unique<NEMLModelProxy>(base, name);
+}
+
+/// The same call path merged over the threads
+struct MergedNode {
+  MergedNode(const std::string & name) :
+      name(name), calls(0), time(0.0), child_time(0.0)
+  {
+
+  }
+
+  void add(const ProfileNode & node)
+  {
+    calls += node.calls;
+    time += node.time;
+    child_time += node.child_time;
+    for (auto & nkid : node.kids) {
+      size_t j = 0;
+      for (; j < kids.size(); j++) if (kids[j].name == nkid->name) break;
+      if (j == kids.size()) kids.emplace_back(nkid->name);
+      kids[j].add(*nkid);
+    }
+  }
+
+  void entries(int depth, std::vector<ProfileEntry> & res) const
+  {
+    std::vector<const MergedNode *> order;
+    for (auto & kid : kids) if (kid.calls > 0) order.push_back(&kid);
+    std::stable_sort(order.begin(), order.end(),
+                     [](const MergedNode * a, const MergedNode * b)
+                     {
+                      return a->time > b->time;
+                     });
+    for (auto kid : order) {
+      res.push_back({depth, kid->name, kid->calls, kid->time,
+                    std::max(kid->time - kid->child_time, 0.0)});
+      kid->entries(depth + 1, res);
+    }
+  }
+
+  std::string name;
+  size_t calls;
+  double time;
+  double child_time;
+  std::vector<MergedNode> kids;
+};
+
+std::vector<ProfileEntry> profile_entries()
+{
+  MergedNode root("root");
+  {
+    ProfileRegistry & reg = profile_registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    for (auto & tree : reg.trees) root.add(tree->root);
+  }
+
+  std::vector<ProfileEntry> res;
+  root.entries(0, res);
+  return res;
+}
+
+std::string profile_report()
+{
+  std::vector<ProfileEntry> entries = profile_entries();
+
+  size_t width = 6;
+  for (auto & e : entries) {
+    width = std::max(width, 2 * e.depth + e.name.size());
+  }
+
+  std::stringstream ss;
+  ss << std::left << std::setw(width + 2) << "object" << std::right
+      << std::setw(12) << "calls" << std::setw(14) << "incl (ms)"
+      << std::setw(14) << "excl (ms)" << std::endl;
+  for (auto & e : entries) {
+    ss << std::left << std::setw(width + 2)
+        << (std::string(2 * e.depth, ' ') + e.name) << std::right
+        << std::setw(12) << e.calls << std::fixed << std::setprecision(3)
+        << std::setw(14) << 1000.0 * e.inclusive
+        << std::setw(14) << 1000.0 * e.exclusive << std::endl;
+  }
+
+  return ss.str();
+}
+
+static void reset_node(ProfileNode & node)
+{
+  node.calls = 0;
+  node.time = 0.0;
+  node.child_time = 0.0;
+  for (auto & kid : node.kids) reset_node(*kid);
+}
+
+void reset_profile()
+{
+  // Zero the counts rather than dropping the nodes, which calls in flight
+  // may still point to
+  ProfileRegistry & reg = profile_registry();
+  std::lock_guard<std::mutex> guard(reg.lock);
+  for (auto & tree : reg.trees) reset_node(tree->root);
+}
+
+} // namespace neml
@@ -0,0 +1,59 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "models.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace neml {
+
+struct ProfileNode;
+
+/// One line of the profile report
+//  The lines are in the order of the call tree, each object followed by
+//  the objects it called, indented by depth.  Exclusive time leaves out
+//  the time spent in the children.
+struct ProfileEntry {
+  int depth;
+  std::string name;
+  size_t calls;
+  double inclusive;
+  double exclusive;
+};
+
+/// Time a call to a profiled object, as a child of the call it is made in
+//  Calls are grouped by their path of names through the tree, so the
+//  objects in models of the same name are counted together.
+class ProfileScope {
+ public:
+  ProfileScope(const std::string & name);
+  ~ProfileScope();
+
+ private:
+  ProfileNode * parent_;
+  ProfileNode * node_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+/// Wrap a model in a profiling proxy named name
+//  Only models derived from NEMLModel_sd have a proxy.  Other models come
+//  back as they are.
+std::shared_ptr<NEMLModel> profile_model(std::shared_ptr<NEMLModel> model,
+                                         const std::string & name);
+/// Wrap a model in a profiling proxy named name, as a unique_ptr
+std::unique_ptr<NEMLModel> profile_model(std::unique_ptr<NEMLModel> model,
+                                         const std::string & name);
+
+/// The profile of all threads so far, merged and in call tree order
+std::vector<ProfileEntry> profile_entries();
+/// The profile as a text table
+std::string profile_report();
+/// Clear the profile on all threads
+void reset_profile();
+
+} // namespace neml
+
+#endif // PROFILE_H
@@ -0,0 +1,47 @@
+#include "pyhelp.h" // include first to avoid annoying redef warning
+
+#include "profile.h"
+
+namespace py = pybind11;
+
+PYBIND11_DECLARE_HOLDER_TYPE(T, std::shared_ptr<T>)
+
+namespace neml {
+
+PYBIND11_MODULE(profile, m) {
+  py::module::import("neml.objects");
+  py::module::import("neml.models");
+
+  m.doc() = "Time the calls to the objects in a model.";
+
+  py::class_<ProfileEntry>(m, "ProfileEntry")
+      .def_readonly("depth", &ProfileEntry::depth)
+      .def_readonly("name", &ProfileEntry::name)
+      .def_readonly("calls", &ProfileEntry::calls)
+      .def_readonly("inclusive", &ProfileEntry::inclusive)
+      .def_readonly("exclusive", &ProfileEntry::exclusive)
+      ;
+
+  m.def("set_profiling",
+        [](bool profiling)
+        {
+          Factory::Creator()->set_profiling(profiling);
+        }, "Profile the objects the factory creates from now on.");
+  m.def("profiling",
+        []() -> bool
+        {
+          return Factory::Creator()->profiling();
+        }, "Is the factory profiling new objects?");
+  m.def("profile_model",
+        [](std::shared_ptr<NEMLModel> model, std::string name) -> std::shared_ptr<NEMLModel>
+        {
+          return profile_model(model, name);
+        }, "Wrap a model in a profiling proxy.");
+
+  m.def("profile_entries", &profile_entries,
+        "The profile, in call tree order.");
+  m.def("profile_report", &profile_report, "The profile as a table.");
+  m.def("reset_profile", &reset_profile, "Clear the profile.");
+}
+
+} // namespace neml
@@ -0,0 +1,418 @@
+#include "reduced.h"
+
+#include "nemlmath.h"
+#include "nemlerror.h"
+#include "trace.h"
+
+#include <algorithm>
+
+namespace neml {
+
+ReducedModel_sd::ReducedModel_sd(std::shared_ptr<LinearElasticModel> elastic,
+                                 std::shared_ptr<NEMLModel_sd> base,
+                                 std::shared_ptr<Interpolate> alpha,
+                                 std::vector<int> constrained,
+                                 std::vector<int> fixed,
+                                 double tol, int miter, bool verbose,
+                                 bool truesdell) :
+    NEMLModel_sd(elastic, alpha, truesdell), base_(base),
+    constrained_(constrained), fixed_(fixed), tol_(tol), miter_(miter),
+    verbose_(verbose)
+{
+  for (int i=0; i<6; i++) {
+    if ((std::find(constrained_.begin(), constrained_.end(), i) ==
+         constrained_.end()) && (std::find(fixed_.begin(), fixed_.end(), i) ==
+                                 fixed_.end())) {
+      free_.push_back(i);
+    }
+  }
+}
+
+int ReducedModel_sd::update_sd(
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1,
+    double & u_np1, double u_n,
+    double & p_np1, double p_n)
+{
+  NEML_TRACE_SCOPE("ReducedModel_sd::update_sd");
+  RSTrialState ts;
+  int ier = make_trial_state(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_n, h_n,
+                             u_n, p_n, ts);
+  if (ier != SUCCESS) return ier;
+
+  size_t nc = nparams();
+  std::vector<double> xv(nc);
+  double * x = xv.data();
+  if (nc > 0) {
+    ier = solve(this, x, &ts, tol_, miter_, verbose_);
+    if (ier != SUCCESS) return ier;
+  }
+
+  // The solver's last residual evaluation is usually at the converged point
+  if ((ts.x.size() != nc) || (not std::equal(x, x+nc, ts.x.begin()))) {
+    update_base_(x, &ts);
+  }
+  if (ts.ier != SUCCESS) return ts.ier;
+
+  std::copy(ts.s_np1, ts.s_np1+6, s_np1);
+  std::copy(x, x+nc, h_np1);
+  std::copy(ts.h_np1.begin(), ts.h_np1.end(), &h_np1[nc]);
+  u_np1 = ts.u_np1;
+  p_np1 = ts.p_np1;
+
+  return condense_(ts.A_np1, A_np1);
+}
+
+size_t ReducedModel_sd::nhist() const
+{
+  return constrained_.size() + base_->nhist();
+}
+
+int ReducedModel_sd::init_hist(double * const hist) const
+{
+  std::fill(hist, hist+constrained_.size(), 0.0);
+  return base_->init_hist(&hist[constrained_.size()]);
+}
+
+double ReducedModel_sd::alpha(double T) const
+{
+  return base_->alpha(T);
+}
+
+int ReducedModel_sd::elastic_strains(const double * const s_np1,
+                                     double T_np1, const double * const h_np1,
+                                     double * const e_np1) const
+{
+  return base_->elastic_strains(s_np1, T_np1, &h_np1[constrained_.size()],
+                                e_np1);
+}
+
+double ReducedModel_sd::bulk(double T) const
+{
+  return base_->bulk(T);
+}
+
+double ReducedModel_sd::shear(double T) const
+{
+  return base_->shear(T);
+}
+
+int ReducedModel_sd::set_elastic_model(std::shared_ptr<LinearElasticModel>
+                                       emodel)
+{
+  elastic_ = emodel;
+  return base_->set_elastic_model(emodel);
+}
+
+size_t ReducedModel_sd::nparams() const
+{
+  return constrained_.size();
+}
+
+double ReducedModel_sd::iteration_cost() const
+{
+  return newton_cost(nparams());
+}
+
+double ReducedModel_sd::cost() const
+{
+  return solve_cost(iteration_cost(), base_->cost());
+}
+
+bool ReducedModel_sd::failed(const double * const h) const
+{
+  return base_->failed(&h[constrained_.size()]);
+}
+
+int ReducedModel_sd::init_x(double * const x, TrialState * ts)
+{
+  RSTrialState * tss = static_cast<RSTrialState *>(ts);
+  size_t nc = nparams();
+
+  // Previous values of the constrained strains
+  for (size_t i=0; i<nc; i++) x[i] = tss->e_n[constrained_[i]];
+
+  // Elastic predictor keeping the constrained stresses fixed
+  double C[36];
+  int ier = elastic_->C(tss->T_np1, C);
+  if (ier != SUCCESS) return ier;
+
+  std::vector<double> Ccv(nc*nc);
+  double * Cc = Ccv.data();
+  std::vector<double> rv(nc);
+  double * r = rv.data();
+  for (size_t i=0; i<nc; i++) {
+    r[i] = 0.0;
+    for (size_t j=0; j<free_.size(); j++) {
+      r[i] += C[CINDEX(constrained_[i],free_[j],6)] * (
+          tss->e_np1[free_[j]] - tss->e_n[free_[j]]);
+    }
+    for (size_t j=0; j<nc; j++) {
+      Cc[CINDEX(i,j,nc)] = C[CINDEX(constrained_[i],constrained_[j],6)];
+    }
+  }
+  ier = solve_mat(Cc, nc, r);
+  if (ier != SUCCESS) return ier;
+
+  for (size_t i=0; i<nc; i++) x[i] -= r[i];
+
+  return 0;
+}
+
+int ReducedModel_sd::RJ(const double * const x, TrialState * ts,
+                        double * const R, double * const J)
+{
+  RSTrialState * tss = static_cast<RSTrialState *>(ts);
+  int ier = update_base_(x, tss);
+  if (ier != SUCCESS) return ier;
+
+  size_t nc = nparams();
+  for (size_t i=0; i<nc; i++) {
+    R[i] = tss->s_np1[constrained_[i]];
+    for (size_t j=0; j<nc; j++) {
+      J[CINDEX(i,j,nc)] = tss->A_np1[CINDEX(constrained_[i],constrained_[j],6)];
+    }
+  }
+
+  return 0;
+}
+
+int ReducedModel_sd::make_trial_state(
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n, double t_np1, double t_n,
+    const double * const s_n, const double * const h_n,
+    double u_n, double p_n,
+    RSTrialState & ts)
+{
+  NEML_TRACE_SCOPE("ReducedModel_sd::make_trial_state");
+  size_t nc = nparams();
+
+  full_strain(e_np1, h_n, ts.e_np1);
+  full_strain(e_n, h_n, ts.e_n);
+  ts.T_np1 = T_np1;
+  ts.T_n = T_n;
+  ts.t_np1 = t_np1;
+  ts.t_n = t_n;
+  ts.u_n = u_n;
+  ts.p_n = p_n;
+  std::copy(s_n, s_n+6, ts.s_n);
+  ts.h_n.resize(base_->nhist());
+  std::copy(&h_n[nc], &h_n[nc]+base_->nhist(), ts.h_n.begin());
+  ts.h_np1.resize(base_->nhist());
+  ts.x.clear();
+  ts.ier = SUCCESS;
+
+  return 0;
+}
+
+void ReducedModel_sd::full_strain(const double * const e,
+                                  const double * const x,
+                                  double * const ef) const
+{
+  std::copy(e, e+6, ef);
+  for (auto i : fixed_) ef[i] = 0.0;
+  for (size_t i=0; i<constrained_.size(); i++) ef[constrained_[i]] = x[i];
+}
+
+int ReducedModel_sd::update_base_(const double * const x, RSTrialState * ts)
+{
+  size_t nc = nparams();
+  double e_np1[6];
+  full_strain(ts->e_np1, x, e_np1);
+
+  ts->ier = base_->update_sd(e_np1, ts->e_n, ts->T_np1, ts->T_n,
+                             ts->t_np1, ts->t_n, ts->s_np1, ts->s_n,
+                             ts->h_np1.data(), ts->h_n.data(),
+                             ts->A_np1, ts->u_np1, ts->u_n,
+                             ts->p_np1, ts->p_n);
+  ts->x.assign(x, x+nc);
+
+  return ts->ier;
+}
+
+int ReducedModel_sd::condense_(const double * const A, double * const Ar) const
+{
+  size_t nc = nparams();
+  std::fill(Ar, Ar+36, 0.0);
+  for (auto i : free_) {
+    for (auto j : free_) {
+      Ar[CINDEX(i,j,6)] = A[CINDEX(i,j,6)];
+    }
+  }
+  if (nc == 0) return 0;
+
+  // Ar_uu = A_uu - A_uc A_cc^-1 A_cu
+  std::vector<double> Acv(nc*nc);
+  double * Ac = Acv.data();
+  for (size_t i=0; i<nc; i++) {
+    for (size_t j=0; j<nc; j++) {
+      Ac[CINDEX(i,j,nc)] = A[CINDEX(constrained_[i],constrained_[j],6)];
+    }
+  }
+  int ier = invert_mat(Ac, nc);
+  if (ier != SUCCESS) return ier;
+
+  for (auto i : free_) {
+    for (auto j : free_) {
+      for (size_t k=0; k<nc; k++) {
+        for (size_t l=0; l<nc; l++) {
+          Ar[CINDEX(i,j,6)] -= A[CINDEX(i,constrained_[k],6)] *
+              Ac[CINDEX(k,l,nc)] * A[CINDEX(constrained_[l],j,6)];
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
+UniaxialStressModel::UniaxialStressModel(
+    std::shared_ptr<LinearElasticModel> elastic,
+    std::shared_ptr<NEMLModel_sd> base,
+    std::shared_ptr<Interpolate> alpha,
+    double tol, int miter, bool verbose,
+    bool truesdell) :
+      ReducedModel_sd(elastic, base, alpha, {1,2,3,4,5}, {},
+                      tol, miter, verbose, truesdell)
+{
+
+}
+
+std::string UniaxialStressModel::type()
+{
+  return "UniaxialStressModel";
+}
+
+ParameterSet UniaxialStressModel::parameters()
+{
+  ParameterSet pset(UniaxialStressModel::type());
+
+  pset.add_parameter<NEMLObject>("elastic");
+  pset.add_parameter<NEMLObject>("base");
+
+  pset.add_optional_parameter<NEMLObject>("alpha",
+                                          std::make_shared<ConstantInterpolate>(0.0));
+  pset.add_optional_parameter<double>("tol", 1.0e-8);
+  pset.add_optional_parameter<int>("miter", 50);
+  pset.add_optional_parameter<bool>("verbose", false);
+
+  pset.add_optional_parameter<bool>("truesdell", true);
+
+  return pset;
+}
+
+std::unique_ptr<NEMLObject> UniaxialStressModel::initialize(ParameterSet & params)
+{
+  return neml::make_unique<UniaxialStressModel>(
+      params.get_object_parameter<LinearElasticModel>("elastic"),
+      params.get_object_parameter<NEMLModel_sd>("base"),
+      params.get_object_parameter<Interpolate>("alpha"),
+      params.get_parameter<double>("tol"),
+      params.get_parameter<int>("miter"),
+      params.get_parameter<bool>("verbose"),
+      params.get_parameter<bool>("truesdell")
+      );
+}
+
+PlaneStressModel::PlaneStressModel(
+    std::shared_ptr<LinearElasticModel> elastic,
+    std::shared_ptr<NEMLModel_sd> base,
+    std::shared_ptr<Interpolate> alpha,
+    double tol, int miter, bool verbose,
+    bool truesdell) :
+      ReducedModel_sd(elastic, base, alpha, {2,3,4}, {},
+                      tol, miter, verbose, truesdell)
+{
+
+}
+
+std::string PlaneStressModel::type()
+{
+  return "PlaneStressModel";
+}
+
+ParameterSet PlaneStressModel::parameters()
+{
+  ParameterSet pset(PlaneStressModel::type());
+
+  pset.add_parameter<NEMLObject>("elastic");
+  pset.add_parameter<NEMLObject>("base");
+
+  pset.add_optional_parameter<NEMLObject>("alpha",
+                                          std::make_shared<ConstantInterpolate>(0.0));
+  pset.add_optional_parameter<double>("tol", 1.0e-8);
+  pset.add_optional_parameter<int>("miter", 50);
+  pset.add_optional_parameter<bool>("verbose", false);
+
+  pset.add_optional_parameter<bool>("truesdell", true);
+
+  return pset;
+}
+
+std::unique_ptr<NEMLObject> PlaneStressModel::initialize(ParameterSet & params)
+{
+  return neml::make_unique<PlaneStressModel>(
+      params.get_object_parameter<LinearElasticModel>("elastic"),
+      params.get_object_parameter<NEMLModel_sd>("base"),
+      params.get_object_parameter<Interpolate>("alpha"),
+      params.get_parameter<double>("tol"),
+      params.get_parameter<int>("miter"),
+      params.get_parameter<bool>("verbose"),
+      params.get_parameter<bool>("truesdell")
+      );
+}
+
+GeneralizedPlaneStrainModel::GeneralizedPlaneStrainModel(
+    std::shared_ptr<LinearElasticModel> elastic,
+    std::shared_ptr<NEMLModel_sd> base,
+    std::shared_ptr<Interpolate> alpha,
+    double tol, int miter, bool verbose,
+    bool truesdell) :
+      ReducedModel_sd(elastic, base, alpha, {}, {3,4},
+                      tol, miter, verbose, truesdell)
+{
+
+}
+
+std::string GeneralizedPlaneStrainModel::type()
+{
+  return "GeneralizedPlaneStrainModel";
+}
+
+ParameterSet GeneralizedPlaneStrainModel::parameters()
+{
+  ParameterSet pset(GeneralizedPlaneStrainModel::type());
+
+  pset.add_parameter<NEMLObject>("elastic");
+  pset.add_parameter<NEMLObject>("base");
+
+  pset.add_optional_parameter<NEMLObject>("alpha",
+                                          std::make_shared<ConstantInterpolate>(0.0));
+  pset.add_optional_parameter<double>("tol", 1.0e-8);
+  pset.add_optional_parameter<int>("miter", 50);
+  pset.add_optional_parameter<bool>("verbose", false);
+
+  pset.add_optional_parameter<bool>("truesdell", true);
+
+  return pset;
+}
+
+std::unique_ptr<NEMLObject> GeneralizedPlaneStrainModel::initialize(
+    ParameterSet & params)
+{
+  return neml::make_unique<GeneralizedPlaneStrainModel>(
+      params.get_object_parameter<LinearElasticModel>("elastic"),
+      params.get_object_parameter<NEMLModel_sd>("base"),
+      params.get_object_parameter<Interpolate>("alpha"),
+      params.get_parameter<double>("tol"),
+      params.get_parameter<int>("miter"),
+      params.get_parameter<bool>("verbose"),
+      params.get_parameter<bool>("truesdell")
+      );
+}
+
+} // namespace neml
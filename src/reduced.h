@@ -0,0 +1,183 @@
+#ifndef REDUCED_H
+#define REDUCED_H
+
+#include "models.h"
+#include "elasticity.h"
+
+#include <memory>
+#include <vector>
+
+namespace neml {
+
+/// Reduced stress state trial state
+class RSTrialState: public TrialState {
+ public:
+  double e_np1[6];          // Next strain, constrained components filled in
+  double e_n[6];            // Previous strain, constrained components filled in
+  double T_np1, T_n, t_np1, t_n, u_n, p_n;
+  double s_n[6];            // Previous stress
+  std::vector<double> h_n;  // Previous base model history
+  // Cached base update, from the last call to RJ
+  std::vector<double> x;    // Constrained strains used for the cached update
+  double s_np1[6];
+  double A_np1[36];
+  double u_np1, p_np1;
+  std::vector<double> h_np1;
+  int ier;                  // Error code from the cached update
+};
+
+/// Reduce a 3D small strain model to a lower dimensional stress state
+//  Some strain components are solved for to make the corresponding stress
+//  components vanish, some strain components are fixed at zero, and the
+//  rest are passed through from the caller.  The constrained strain components
+//  are stored as the first history variables and used to warm start the
+//  next step.  The tangent is condensed onto the free components and the
+//  constrained and fixed rows and columns are returned as zero.
+class ReducedModel_sd: public NEMLModel_sd, public Solvable {
+ public:
+  /// Parameters are an elastic model, the base 3D model, the CTE,
+  /// the list of stress free (Mandel) components, the list of zero strain
+  /// components, and the solver tolerance, iterations, and verbosity
+  ReducedModel_sd(std::shared_ptr<LinearElasticModel> elastic,
+                  std::shared_ptr<NEMLModel_sd> base,
+                  std::shared_ptr<Interpolate> alpha,
+                  std::vector<int> constrained,
+                  std::vector<int> fixed,
+                  double tol, int miter, bool verbose,
+                  bool truesdell);
+
+  /// Stress update with the constraint solve
+  virtual int update_sd(
+      const double * const e_np1, const double * const e_n,
+      double T_np1, double T_n,
+      double t_np1, double t_n,
+      double * const s_np1, const double * const s_n,
+      double * const h_np1, const double * const h_n,
+      double * const A_np1,
+      double & u_np1, double u_n,
+      double & p_np1, double p_n);
+
+  /// Number of constrained strains + base model history
+  virtual size_t nhist() const;
+  /// Zero the constrained strains, initialize the base history
+  virtual int init_hist(double * const hist) const;
+
+  /// The CTE of the base model
+  virtual double alpha(double T) const;
+  /// Elastic strains from the base model
+  virtual int elastic_strains(const double * const s_np1,
+                              double T_np1, const double * const h_np1,
+                              double * const e_np1) const;
+  /// The bulk modulus of the base model
+  virtual double bulk(double T) const;
+  /// The shear modulus of the base model
+  virtual double shear(double T) const;
+
+  /// Override the elastic model in this object and the base model
+  virtual int set_elastic_model(std::shared_ptr<LinearElasticModel> emodel);
+
+  /// Number of constrained strain components
+  virtual size_t nparams() const;
+  /// Initialize from the stored strains plus an elastic predictor
+  virtual int init_x(double * const x, TrialState * ts);
+  /// Residual is the constrained stress components
+  virtual int RJ(const double * const x, TrialState * ts, double * const R,
+                 double * const J);
+  /// Cost of a Newton iteration, not counting the base update
+  virtual double iteration_cost() const;
+  /// Includes an update of the base model each iteration
+  virtual double cost() const;
+
+  /// Has the base model failed?
+  virtual bool failed(const double * const h) const;
+
+  /// Setup a trial state from known information
+  int make_trial_state(const double * const e_np1, const double * const e_n,
+                       double T_np1, double T_n, double t_np1, double t_n,
+                       const double * const s_n, const double * const h_n,
+                       double u_n, double p_n,
+                       RSTrialState & ts);
+
+  /// Fill in the full strain vector for a given set of constrained strains
+  void full_strain(const double * const e, const double * const x,
+                   double * const ef) const;
+
+ protected:
+  int update_base_(const double * const x, RSTrialState * ts);
+  int condense_(const double * const A, double * const Ar) const;
+
+ protected:
+  std::shared_ptr<NEMLModel_sd> base_;
+  std::vector<int> constrained_, fixed_, free_;
+  double tol_;
+  int miter_;
+  bool verbose_;
+};
+
+/// Uniaxial stress: only the 11 component of stress is nonzero
+class UniaxialStressModel: public ReducedModel_sd {
+ public:
+  /// Parameters are an elastic model, the base model, the CTE, and
+  /// the solver parameters
+  UniaxialStressModel(std::shared_ptr<LinearElasticModel> elastic,
+                      std::shared_ptr<NEMLModel_sd> base,
+                      std::shared_ptr<Interpolate> alpha,
+                      double tol, int miter, bool verbose,
+                      bool truesdell);
+
+  /// Type for the object system
+  static std::string type();
+  /// Setup parameters for the object system
+  static ParameterSet parameters();
+  /// Initialize from a parameter set
+  static std::unique_ptr<NEMLObject> initialize(ParameterSet & params);
+};
+
+static Register<UniaxialStressModel> regUniaxialStressModel;
+
+/// Plane stress: the 33, 23, and 13 components of stress are zero
+class PlaneStressModel: public ReducedModel_sd {
+ public:
+  /// Parameters are an elastic model, the base model, the CTE, and
+  /// the solver parameters
+  PlaneStressModel(std::shared_ptr<LinearElasticModel> elastic,
+                   std::shared_ptr<NEMLModel_sd> base,
+                   std::shared_ptr<Interpolate> alpha,
+                   double tol, int miter, bool verbose,
+                   bool truesdell);
+
+  /// Type for the object system
+  static std::string type();
+  /// Setup parameters for the object system
+  static ParameterSet parameters();
+  /// Initialize from a parameter set
+  static std::unique_ptr<NEMLObject> initialize(ParameterSet & params);
+};
+
+static Register<PlaneStressModel> regPlaneStressModel;
+
+/// Generalized plane strain: the 23 and 13 strains are zero and the
+/// out-of-plane normal strain is provided by the caller
+class GeneralizedPlaneStrainModel: public ReducedModel_sd {
+ public:
+  /// Parameters are an elastic model, the base model, the CTE, and
+  /// the solver parameters
+  GeneralizedPlaneStrainModel(std::shared_ptr<LinearElasticModel> elastic,
+                              std::shared_ptr<NEMLModel_sd> base,
+                              std::shared_ptr<Interpolate> alpha,
+                              double tol, int miter, bool verbose,
+                              bool truesdell);
+
+  /// Type for the object system
+  static std::string type();
+  /// Setup parameters for the object system
+  static ParameterSet parameters();
+  /// Initialize from a parameter set
+  static std::unique_ptr<NEMLObject> initialize(ParameterSet & params);
+};
+
+static Register<GeneralizedPlaneStrainModel> regGeneralizedPlaneStrainModel;
+
+} // namespace neml
+
+#endif // REDUCED_H
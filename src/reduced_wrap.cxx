@@ -0,0 +1,67 @@
+#include "pyhelp.h" // include first to avoid annoying redef warning
+
+#include "reduced.h"
+
+#include "nemlerror.h"
+
+namespace py = pybind11;
+
+PYBIND11_DECLARE_HOLDER_TYPE(T, std::shared_ptr<T>)
+
+namespace neml {
+
+PYBIND11_MODULE(reduced, m) {
+  py::module::import("neml.objects");
+  py::module::import("neml.solvers");
+  py::module::import("neml.models");
+
+  m.doc() = "Reduced stress state wrappers around 3D models.";
+
+  py::class_<RSTrialState, TrialState>(m, "RSTrialState")
+      ;
+
+  py::class_<ReducedModel_sd, NEMLModel_sd, Solvable, std::shared_ptr<ReducedModel_sd>>(m, "ReducedModel_sd")
+      .def("make_trial_state",
+           [](ReducedModel_sd & m, py::array_t<double, py::array::c_style> e_np1, py::array_t<double, py::array::c_style> e_n, double T_np1, double T_n, double t_np1, double t_n, py::array_t<double, py::array::c_style> s_n, py::array_t<double, py::array::c_style> h_n, double u_n, double p_n) -> std::unique_ptr<RSTrialState>
+           {
+              std::unique_ptr<RSTrialState> ts(new RSTrialState);
+              int ier = m.make_trial_state(arr2ptr<double>(e_np1),
+                                          arr2ptr<double>(e_n),
+                                          T_np1, T_n,
+                                          t_np1, t_n,
+                                          arr2ptr<double>(s_n),
+                                          arr2ptr<double>(h_n),
+                                          u_n, p_n,
+                                          *ts);
+              py_error(ier);
+
+              return ts;
+           }, "Setup trial state for solve.")
+      ;
+
+  py::class_<UniaxialStressModel, ReducedModel_sd, std::shared_ptr<UniaxialStressModel>>(m, "UniaxialStressModel")
+      .def(py::init([](py::args args, py::kwargs kwargs)
+        {
+          return create_object_python<UniaxialStressModel>(args, kwargs,
+                                                           {"elastic", "base"});
+        }))
+      ;
+
+  py::class_<PlaneStressModel, ReducedModel_sd, std::shared_ptr<PlaneStressModel>>(m, "PlaneStressModel")
+      .def(py::init([](py::args args, py::kwargs kwargs)
+        {
+          return create_object_python<PlaneStressModel>(args, kwargs,
+                                                        {"elastic", "base"});
+        }))
+      ;
+
+  py::class_<GeneralizedPlaneStrainModel, ReducedModel_sd, std::shared_ptr<GeneralizedPlaneStrainModel>>(m, "GeneralizedPlaneStrainModel")
+      .def(py::init([](py::args args, py::kwargs kwargs)
+        {
+          return create_object_python<GeneralizedPlaneStrainModel>(args, kwargs,
+                                                                   {"elastic", "base"});
+        }))
+      ;
+}
+
+} // namespace neml
@@ -0,0 +1,132 @@
+#include "sensitivity.h"
+
+#include "parse.h"
+#include "nemlerror.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace neml {
+
+SensitivityModel::SensitivityModel(std::string fname, std::string mname,
+                                   std::vector<std::string> params,
+                                   double step) :
+    model_(parse_xml(fname, mname)), params_(params)
+{
+  integrator_ = dynamic_cast<GeneralIntegrator*>(model_.get());
+  if ((integrator_ == nullptr) || !integrator_->forward_sensitivities()) {
+    throw std::invalid_argument("Sensitivities need a GeneralIntegrator "
+                                "with the backward Euler scheme");
+  }
+
+  for (auto & path : params_) {
+    double v = get_xml_parameter(fname, mname, path);
+    double dv = (v == 0.0) ? step : step * fabs(v);
+    values_.push_back(v);
+    steps_.push_back(dv);
+    perturbed_.push_back(parse_xml_unique(fname, mname, path, v + dv));
+    plus_.push_back(dynamic_cast<GeneralIntegrator*>(perturbed_.back().get()));
+    perturbed_.push_back(parse_xml_unique(fname, mname, path, v - dv));
+    minus_.push_back(dynamic_cast<GeneralIntegrator*>(perturbed_.back().get()));
+    if ((plus_.back() == nullptr) || (minus_.back() == nullptr)) {
+      throw std::invalid_argument("Parameter " + path + " changes the model");
+    }
+  }
+}
+
+std::shared_ptr<NEMLModel> SensitivityModel::model() const
+{
+  return model_;
+}
+
+size_t SensitivityModel::nsens() const
+{
+  return params_.size();
+}
+
+const std::vector<std::string> & SensitivityModel::params() const
+{
+  return params_;
+}
+
+const std::vector<double> & SensitivityModel::values() const
+{
+  return values_;
+}
+
+size_t SensitivityModel::nstore() const
+{
+  return model_->nstore();
+}
+
+int SensitivityModel::init_store(double * const h, double * const dh) const
+{
+  size_t nh = model_->nstore();
+  int ier = model_->init_store(h);
+  if (ier != SUCCESS) return ier;
+
+  std::vector<double> hp(nh), hm(nh);
+  for (size_t k = 0; k < nsens(); k++) {
+    ier = plus_[k]->init_store(&hp[0]);
+    if (ier != SUCCESS) return ier;
+    ier = minus_[k]->init_store(&hm[0]);
+    if (ier != SUCCESS) return ier;
+    for (size_t i = 0; i < nh; i++) {
+      dh[k*nh+i] = (hp[i] - hm[i]) / (2.0 * steps_[k]);
+    }
+  }
+
+  return SUCCESS;
+}
+
+int SensitivityModel::update_sd(
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1,
+    double & u_np1, double u_n,
+    double & p_np1, double p_n,
+    const double * const de_np1, const double * const de_n,
+    double * const ds_np1, const double * const ds_n,
+    double * const dh_np1, const double * const dh_n,
+    double * const du_np1, const double * const du_n,
+    double * const dp_np1, const double * const dp_n)
+{
+  return integrator_->update_sensitivity_sd(plus_, minus_, steps_, e_np1, e_n,
+                                            T_np1, T_n, t_np1, t_n,
+                                            s_np1, s_n, h_np1, h_n, A_np1,
+                                            u_np1, u_n, p_np1, p_n,
+                                            de_np1, de_n, ds_np1, ds_n,
+                                            dh_np1, dh_n, du_np1, du_n,
+                                            dp_np1, dp_n);
+}
+
+int SensitivityModel::sensitivity_sd(
+    size_t k,
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    const double * const s_np1, const double * const s_n,
+    const double * const h_np1, const double * const h_n,
+    double u_np1, double u_n,
+    double p_np1, double p_n,
+    const double * const de_np1, const double * const de_n,
+    double * const ds_np1, const double * const ds_n,
+    double * const dh_np1, const double * const dh_n,
+    double & du_np1, double du_n,
+    double & dp_np1, double dp_n)
+{
+  if (k >= nsens()) return UNKNOWN_ERROR;
+
+  return integrator_->sensitivity_sd({plus_[k]}, {minus_[k]}, {steps_[k]},
+                                     e_np1, e_n, T_np1, T_n, t_np1, t_n,
+                                     s_np1, s_n, h_np1, h_n,
+                                     u_np1, u_n, p_np1, p_n,
+                                     de_np1, de_n, ds_np1, ds_n,
+                                     dh_np1, dh_n, &du_np1, &du_n,
+                                     &dp_np1, &dp_n);
+}
+
+} // namespace neml
@@ -0,0 +1,102 @@
+#ifndef SENSITIVITY_H
+#define SENSITIVITY_H
+
+#include "models.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace neml {
+
+/// Forward sensitivities of the model response to a set of parameters
+//  The sensitivities of the strain, stress, stored variables, and energy
+//  are carried alongside the state from step to step, so one pass through
+//  a load history gives every sensitivity, and a driver can resolve the
+//  sensitivity of a mixed control step from its own jacobian instead of
+//  running the whole history again for each parameter.
+//
+//  Only GeneralIntegrator models with the backward Euler scheme are
+//  supported, and the constructor throws for anything else.  Each step,
+//  or each substep if the integrator subdivides it, costs two residuals
+//  and a linear solve with the jacobian of the step per parameter (see
+//  GeneralIntegrator::update_sensitivity_sd).  The objects
+//  have no derivatives with respect to their parameters, so the change in
+//  the residual is a central difference through copies of the model with
+//  the parameter moved up and down by the step.
+//
+//  Sensitivities are stored parameter by parameter, so ds is nsens x 6
+//  and dh is nsens x nstore.
+class SensitivityModel {
+ public:
+  /// Load model mname from fname, with the parameters at the XML paths
+  /// in params (see parse_xml_unique), perturbed by the relative step.
+  /// Throws std::invalid_argument unless the model is a backward Euler
+  /// GeneralIntegrator.
+  SensitivityModel(std::string fname, std::string mname,
+                   std::vector<std::string> params, double step = 1.0e-6);
+
+  /// The model at the nominal parameters
+  std::shared_ptr<NEMLModel> model() const;
+  /// Number of parameters
+  size_t nsens() const;
+  /// The parameter paths
+  const std::vector<std::string> & params() const;
+  /// The nominal parameter values
+  const std::vector<double> & values() const;
+
+  /// Number of stored variables in the model
+  size_t nstore() const;
+  /// Initial stored variables and their sensitivities (nsens x nstore)
+  int init_store(double * const h, double * const dh) const;
+
+  /// Update the state and its sensitivities to all the parameters
+  //  The strain sensitivities de_np1 and de_n are inputs, zero for strain
+  //  control.
+  int update_sd(
+      const double * const e_np1, const double * const e_n,
+      double T_np1, double T_n,
+      double t_np1, double t_n,
+      double * const s_np1, const double * const s_n,
+      double * const h_np1, const double * const h_n,
+      double * const A_np1,
+      double & u_np1, double u_n,
+      double & p_np1, double p_n,
+      const double * const de_np1, const double * const de_n,
+      double * const ds_np1, const double * const ds_n,
+      double * const dh_np1, const double * const dh_n,
+      double * const du_np1, const double * const du_n,
+      double * const dp_np1, const double * const dp_n);
+
+  /// Sensitivity of a finished update to parameter k alone
+  //  The nominal step inputs and results are given, along with the
+  //  sensitivities of the inputs to the parameter.
+  int sensitivity_sd(
+      size_t k,
+      const double * const e_np1, const double * const e_n,
+      double T_np1, double T_n,
+      double t_np1, double t_n,
+      const double * const s_np1, const double * const s_n,
+      const double * const h_np1, const double * const h_n,
+      double u_np1, double u_n,
+      double p_np1, double p_n,
+      const double * const de_np1, const double * const de_n,
+      double * const ds_np1, const double * const ds_n,
+      double * const dh_np1, const double * const dh_n,
+      double & du_np1, double du_n,
+      double & dp_np1, double dp_n);
+
+ private:
+  std::shared_ptr<NEMLModel> model_;
+  GeneralIntegrator * integrator_;
+  // The model with each parameter moved up and down by its step
+  std::vector<std::unique_ptr<NEMLModel>> perturbed_;
+  std::vector<GeneralIntegrator*> plus_, minus_;
+  std::vector<std::string> params_;
+  std::vector<double> values_;
+  std::vector<double> steps_;
+};
+
+} // namespace neml
+
+#endif // SENSITIVITY_H
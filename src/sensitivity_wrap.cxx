@@ -0,0 +1,69 @@
+#include "pyhelp.h" // include first to avoid annoying redef warning
+
+#include "sensitivity.h"
+
+namespace py = pybind11;
+
+namespace neml {
+
+PYBIND11_MODULE(sensitivity, m) {
+  py::module::import("neml.models");
+
+  m.doc() = "Forward sensitivities of the response to model parameters.";
+
+  py::class_<SensitivityModel, std::shared_ptr<SensitivityModel>>(m, "SensitivityModel")
+      .def(py::init<std::string, std::string, std::vector<std::string>, double>(),
+           py::arg("fname"), py::arg("mname"), py::arg("params"),
+           py::arg("step") = 1.0e-6)
+      .def_property_readonly("model", &SensitivityModel::model,
+                             "The model at the nominal parameters.")
+      .def_property_readonly("nsens", &SensitivityModel::nsens,
+                             "Number of parameters.")
+      .def_property_readonly("params", &SensitivityModel::params,
+                             "The parameter paths.")
+      .def_property_readonly("values", &SensitivityModel::values,
+                             "The nominal parameter values.")
+      .def_property_readonly("nstore", &SensitivityModel::nstore,
+                             "Number of stored variables.")
+      .def("init_store",
+           [](SensitivityModel & m) -> std::tuple<py::array_t<double>, py::array_t<double>>
+           {
+            auto h = alloc_vec<double>(m.nstore());
+            auto dh = alloc_mat<double>(m.nsens(), m.nstore());
+            int ier = m.init_store(arr2ptr<double>(h), arr2ptr<double>(dh));
+            py_error(ier);
+            return std::make_tuple(h, dh);
+           }, "Initialize the stored variables and their sensitivities.")
+      .def("update_sd",
+           [](SensitivityModel & m, py::array_t<double, py::array::c_style> e_np1, py::array_t<double, py::array::c_style> e_n, double T_np1, double T_n, double t_np1, double t_n, py::array_t<double, py::array::c_style> s_n, py::array_t<double, py::array::c_style> h_n, double u_n, double p_n, py::array_t<double, py::array::c_style> de_np1, py::array_t<double, py::array::c_style> de_n, py::array_t<double, py::array::c_style> ds_n, py::array_t<double, py::array::c_style> dh_n, py::array_t<double, py::array::c_style> du_n, py::array_t<double, py::array::c_style> dp_n) -> std::tuple<py::array_t<double>, py::array_t<double>, py::array_t<double>, double, double, py::array_t<double>, py::array_t<double>, py::array_t<double>, py::array_t<double>>
+           {
+            auto s_np1 = alloc_vec<double>(6);
+            auto h_np1 = alloc_vec<double>(m.nstore());
+            auto A_np1 = alloc_mat<double>(6,6);
+            double u_np1, p_np1;
+            auto ds_np1 = alloc_mat<double>(m.nsens(), 6);
+            auto dh_np1 = alloc_mat<double>(m.nsens(), m.nstore());
+            auto du_np1 = alloc_vec<double>(m.nsens());
+            auto dp_np1 = alloc_vec<double>(m.nsens());
+
+            int ier = m.update_sd(arr2ptr<double>(e_np1), arr2ptr<double>(e_n), T_np1, T_n, t_np1, t_n, arr2ptr<double>(s_np1), arr2ptr<double>(s_n), arr2ptr<double>(h_np1), arr2ptr<double>(h_n), arr2ptr<double>(A_np1), u_np1, u_n, p_np1, p_n, arr2ptr<double>(de_np1), arr2ptr<double>(de_n), arr2ptr<double>(ds_np1), arr2ptr<double>(ds_n), arr2ptr<double>(dh_np1), arr2ptr<double>(dh_n), arr2ptr<double>(du_np1), arr2ptr<double>(du_n), arr2ptr<double>(dp_np1), arr2ptr<double>(dp_n));
+            py_error(ier);
+
+            return std::make_tuple(s_np1, h_np1, A_np1, u_np1, p_np1, ds_np1, dh_np1, du_np1, dp_np1);
+           }, "Small deformation update with the sensitivities to all the parameters.")
+      .def("sensitivity_sd",
+           [](SensitivityModel & m, size_t k, py::array_t<double, py::array::c_style> e_np1, py::array_t<double, py::array::c_style> e_n, double T_np1, double T_n, double t_np1, double t_n, py::array_t<double, py::array::c_style> s_np1, py::array_t<double, py::array::c_style> s_n, py::array_t<double, py::array::c_style> h_np1, py::array_t<double, py::array::c_style> h_n, double u_np1, double u_n, double p_np1, double p_n, py::array_t<double, py::array::c_style> de_np1, py::array_t<double, py::array::c_style> de_n, py::array_t<double, py::array::c_style> ds_n, py::array_t<double, py::array::c_style> dh_n, double du_n, double dp_n) -> std::tuple<py::array_t<double>, py::array_t<double>, double, double>
+           {
+            auto ds_np1 = alloc_vec<double>(6);
+            auto dh_np1 = alloc_vec<double>(m.nstore());
+            double du_np1, dp_np1;
+
+            int ier = m.sensitivity_sd(k, arr2ptr<double>(e_np1), arr2ptr<double>(e_n), T_np1, T_n, t_np1, t_n, arr2ptr<double>(s_np1), arr2ptr<double>(s_n), arr2ptr<double>(h_np1), arr2ptr<double>(h_n), u_np1, u_n, p_np1, p_n, arr2ptr<double>(de_np1), arr2ptr<double>(de_n), arr2ptr<double>(ds_np1), arr2ptr<double>(ds_n), arr2ptr<double>(dh_np1), arr2ptr<double>(dh_n), du_np1, du_n, dp_np1, dp_n);
+            py_error(ier);
+
+            return std::make_tuple(ds_np1, dh_np1, du_np1, dp_np1);
+           }, "Sensitivity of a finished update to parameter k.")
+      ;
+}
+
+} // namespace neml
@@ -2,6 +2,7 @@
 
 #include "nemlmath.h"
 #include "nemlerror.h"
+#include "trace.h"
 
 #include <algorithm>
 #include <iostream>
@@ -11,41 +12,74 @@
 
 namespace neml {
 
+SolveStats::SolveStats()
+{
+  reset();
+}
+
+void SolveStats::reset()
+{
+  nsolves = 0;
+  niter = 0;
+  max_iter = 0;
+  rate = 0.0;
+  ndivide = 0;
+  exhausted = false;
+}
+
+SolveStats & solve_stats()
+{
+  static thread_local SolveStats stats;
+  return stats;
+}
+
+int Solvable::residual_scales(TrialState * ts, double * const scales)
+{
+  std::fill(scales, scales+nparams(), 1.0);
+  return 0;
+}
+
+// Norm of the residual with each equation scaled
+static double scaled_norm_(const double * const R, const double * const w,
+                           int n)
+{
+  double sum = 0.0;
+  for (int i=0; i<n; i++) sum += (w[i] * R[i]) * (w[i] * R[i]);
+  return sqrt(sum);
+}
+
 // This function is configured by the build
 int solve(Solvable * system, double * x, TrialState * ts,
-          double tol, int miter, bool verbose, bool relative)
+          double tol, int miter, bool verbose, bool relative,
+          double rtol, double * const J)
 {
+  NEML_TRACE_SCOPE("solve");
 #ifdef SOLVER_NOX
-  return nox(system, x, ts, tol, miter, verbose);
+  int ier = nox(system, x, ts, tol, miter, verbose);
+  if ((ier != SUCCESS) || (J == nullptr)) return ier;
+  std::vector<double> R(system->nparams());
+  return system->RJ(x, ts, &R[0], J);
 #elif SOLVER_NEWTON
   // Actually selected the newton solver
-  return newton(system, x, ts, tol, miter, verbose, relative);
+  return newton(system, x, ts, tol, miter, verbose, relative, rtol, J);
 #else
   // Default solver: plain NR
-  return newton(system, x, ts, tol, miter, verbose, relative);
+  return newton(system, x, ts, tol, miter, verbose, relative, rtol, J);
 #endif
 }
 
-int newton(Solvable * system, double * x, TrialState * ts,
-          double tol, int miter, bool verbose, bool relative)
+// The Newton iterations, starting from the residual and jacobian at x
+static int newton_loop_(Solvable * system, double * x, TrialState * ts,
+                        double * const R, double * const J,
+                        const double * const w, double nR, double nR0,
+                        int i, double tol, int miter, bool verbose,
+                        bool relative, double rtol)
 {
   int n = system->nparams();
-  system->init_x(x, ts);
-
-  std::vector<double> Rv(n);
-  std::vector<double> Jv(n*n);
-
-  double * R = &Rv[0];
-  double * J = &Jv[0];
-
-  int ier = 0;
-
-  ier = system->RJ(x, ts, R, J);
-  if (ier != SUCCESS) return ier;
-
-  double nR = norm2_vec(R, n);
-  double nR0 = nR;
-  int i = 0;
+  double ctol = tol + rtol * nR0;
+  double nR_prev = nR;
+  int i0 = i;
+  NEML_TRACE_INSTANT2("iteration", "i", i, "norm", nR);
 
   if (verbose) {
     std::cout << "Iter.\tnR\t\tJe\t\tcn" << std::endl;
@@ -58,7 +92,7 @@ int newton(Solvable * system, double * x, TrialState * ts,
         << std::endl;
   }
 
-  while ((nR > tol) && (i < miter))
+  while ((nR > ctol) && (i < miter))
   {
     if (relative) {
       if ((nR / nR0) < tol) break;
@@ -68,8 +102,10 @@ int newton(Solvable * system, double * x, TrialState * ts,
     for (int j=0; j<n; j++) x[j] -= R[j];
 
     system->RJ(x, ts, R, J);
-    nR = norm2_vec(R, n);
+    nR_prev = nR;
+    nR = scaled_norm_(R, w, n);
     i++;
+    NEML_TRACE_INSTANT2("iteration", "i", i, "norm", nR);
 
     if (verbose) {
       double Jf = diff_jac_check(system, x, ts, J);
@@ -82,9 +118,314 @@ int newton(Solvable * system, double * x, TrialState * ts,
     std::cout << std::endl;
   }
 
+  SolveStats & stats = solve_stats();
+  stats.nsolves++;
+  stats.niter += i;
+  stats.max_iter = std::max(stats.max_iter, i);
+  if ((i > i0) && (nR_prev > 0.0)) {
+    stats.rate = std::max(stats.rate, nR / nR_prev);
+  }
+
+  if (i == miter) {
+    NEML_TRACE_ERROR(MAX_ITERATIONS);
+    return MAX_ITERATIONS;
+  }
+
+  return SUCCESS;
+}
+
+int newton(Solvable * system, double * x, TrialState * ts,
+          double tol, int miter, bool verbose, bool relative,
+          double rtol, double * const Jx)
+{
+  int n = system->nparams();
+  system->init_x(x, ts);
+
+  // The last evaluation is at the solution, so the caller's jacobian
+  // can be used directly
+  std::vector<double> Rv(n);
+  std::vector<double> Jv(Jx == nullptr ? n*n : 0);
+  std::vector<double> wv(n);
+
+  double * R = &Rv[0];
+  double * J = (Jx == nullptr) ? &Jv[0] : Jx;
+  double * w = &wv[0];
+
+  int ier = system->residual_scales(ts, w);
+  if (ier != SUCCESS) return ier;
+
+  ier = system->RJ(x, ts, R, J);
   if (ier != SUCCESS) return ier;
 
-  if (i == miter) return MAX_ITERATIONS;
+  double nR = scaled_norm_(R, w, n);
+
+  return newton_loop_(system, x, ts, R, J, w, nR, nR, 0, tol, miter,
+                      verbose, relative, rtol);
+}
+
+void Solvable::RJ_batch(size_t nbatch, const double * const x,
+                        TrialState * const * ts, const bool * const active,
+                        double * const R, double * const J,
+                        int * const ier)
+{
+  size_t n = nparams();
+  std::vector<double> xv(n);
+  std::vector<double> Rv(n);
+  std::vector<double> Jv(n*n);
+
+  for (size_t b=0; b<nbatch; b++) {
+    if (!active[b]) continue;
+    for (size_t i=0; i<n; i++) xv[i] = x[i*nbatch+b];
+    ier[b] = RJ(&xv[0], ts[b], &Rv[0], &Jv[0]);
+    if (ier[b] != SUCCESS) continue;
+    for (size_t i=0; i<n; i++) R[i*nbatch+b] = Rv[i];
+    for (size_t i=0; i<n*n; i++) J[i*nbatch+b] = Jv[i];
+  }
+}
+
+// Solve J dx = R in place for every lane of an interleaved batch with
+// partial pivoting.  Lanes with a singular matrix are marked in ier; the
+// caller sets the matrix of inactive lanes to the identity.
+static void batch_lu_solve_(size_t n, double * const J, double * const R,
+                            int * const ier)
+{
+  const size_t W = batch_width;
+  double piv[W];
+
+  for (size_t k=0; k<n; k++) {
+    // Pivot selection and row swaps are lane by lane
+    for (size_t b=0; b<W; b++) {
+      size_t p = k;
+      double big = fabs(J[CINDEX(k,k,n)*W+b]);
+      for (size_t i=k+1; i<n; i++) {
+        double v = fabs(J[CINDEX(i,k,n)*W+b]);
+        if (v > big) {
+          big = v;
+          p = i;
+        }
+      }
+      if (p != k) {
+        for (size_t j=0; j<n; j++) {
+          std::swap(J[CINDEX(k,j,n)*W+b], J[CINDEX(p,j,n)*W+b]);
+        }
+        std::swap(R[k*W+b], R[p*W+b]);
+      }
+      if (big == 0.0) {
+        ier[b] = LINALG_FAILURE;
+        piv[b] = 1.0;
+      }
+      else {
+        piv[b] = 1.0 / J[CINDEX(k,k,n)*W+b];
+      }
+    }
+
+    // The elimination runs across the lanes
+    for (size_t i=k+1; i<n; i++) {
+      double l[W];
+      for (size_t b=0; b<W; b++) l[b] = J[CINDEX(i,k,n)*W+b] * piv[b];
+      for (size_t j=k+1; j<n; j++) {
+        double * Jij = &J[CINDEX(i,j,n)*W];
+        const double * Jkj = &J[CINDEX(k,j,n)*W];
+        for (size_t b=0; b<W; b++) Jij[b] -= l[b] * Jkj[b];
+      }
+      for (size_t b=0; b<W; b++) R[i*W+b] -= l[b] * R[k*W+b];
+    }
+  }
+
+  // Back substitution
+  for (size_t ii=n; ii>0; ii--) {
+    size_t i = ii - 1;
+    for (size_t j=i+1; j<n; j++) {
+      const double * Jij = &J[CINDEX(i,j,n)*W];
+      for (size_t b=0; b<W; b++) R[i*W+b] -= Jij[b] * R[j*W+b];
+    }
+    const double * Jii = &J[CINDEX(i,i,n)*W];
+    for (size_t b=0; b<W; b++) {
+      if (Jii[b] != 0.0) R[i*W+b] /= Jii[b];
+    }
+  }
+}
+
+int solve_batch(Solvable * system, size_t nsys, double * x,
+                TrialState * const * ts, int * const ier,
+                double tol, int miter, bool verbose, double rtol)
+{
+  size_t n = system->nparams();
+
+#ifdef SOLVER_NOX
+  bool lockstep = false;
+#else
+  bool lockstep = !verbose;
+#endif
+
+  // The verbose output only makes sense one system at a time
+  if (!lockstep) {
+    for (size_t p=0; p<nsys; p++) {
+      ier[p] = solve(system, &x[p*n], ts[p], tol, miter, verbose, false,
+                     rtol);
+    }
+  }
+  else {
+    const size_t W = batch_width;
+    std::vector<double> xb(n*W), Rb(n*W), Jb(n*n*W), wb(n*W);
+    std::vector<double> Rs(n), Js(n*n), ws(n);
+    double nR[W], nR0[W], nR_prev[W];
+    bool active[W];
+    int lier[W];
+    int iters[W];
+    TrialState * lts[W];
+
+    SolveStats & stats = solve_stats();
+
+    for (size_t c=0; c<nsys; c+=W) {
+      size_t nb = std::min(W, nsys - c);
+
+      // Setup each lane
+      for (size_t b=0; b<W; b++) {
+        active[b] = b < nb;
+        lier[b] = SUCCESS;
+        iters[b] = 0;
+        nR[b] = 0.0;
+        nR0[b] = 0.0;
+        nR_prev[b] = 0.0;
+        lts[b] = active[b] ? ts[c+b] : nullptr;
+        for (size_t i=0; i<n; i++) {
+          xb[i*W+b] = 0.0;
+          wb[i*W+b] = 1.0;
+        }
+        if (!active[b]) continue;
+
+        double * xp = &x[(c+b)*n];
+        system->init_x(xp, lts[b]);
+        lier[b] = system->residual_scales(lts[b], &ws[0]);
+        for (size_t i=0; i<n; i++) {
+          xb[i*W+b] = xp[i];
+          wb[i*W+b] = ws[i];
+        }
+        if (lier[b] != SUCCESS) active[b] = false;
+      }
+
+      system->RJ_batch(W, &xb[0], lts, active, &Rb[0], &Jb[0], lier);
+
+      for (size_t b=0; b<W; b++) {
+        if (!active[b]) continue;
+        if (lier[b] != SUCCESS) {
+          active[b] = false;
+          continue;
+        }
+        double sum = 0.0;
+        for (size_t i=0; i<n; i++) {
+          sum += (wb[i*W+b] * Rb[i*W+b]) * (wb[i*W+b] * Rb[i*W+b]);
+        }
+        nR[b] = sqrt(sum);
+        nR0[b] = nR[b];
+        nR_prev[b] = nR[b];
+      }
+
+      int i = 0;
+      while (true) {
+        // Mask off the converged lanes, treating the last iteration like
+        // the scalar solver does
+        size_t nactive = 0;
+        for (size_t b=0; b<W; b++) {
+          if (active[b] && (nR[b] <= tol + rtol * nR0[b])) {
+            active[b] = false;
+            iters[b] = i;
+            if (i == miter) lier[b] = MAX_ITERATIONS;
+          }
+          if (active[b]) nactive++;
+        }
+        if ((nactive == 0) || (i >= miter)) break;
+
+        // Hand the last few stragglers to the scalar solver
+        if (4 * nactive <= W) {
+          for (size_t b=0; b<W; b++) {
+            if (!active[b]) continue;
+            double * xp = &x[(c+b)*n];
+            for (size_t j=0; j<n; j++) {
+              xp[j] = xb[j*W+b];
+              Rs[j] = Rb[j*W+b];
+              ws[j] = wb[j*W+b];
+            }
+            for (size_t j=0; j<n*n; j++) Js[j] = Jb[j*W+b];
+            lier[b] = newton_loop_(system, xp, lts[b], &Rs[0], &Js[0],
+                                   &ws[0], nR[b], nR0[b], i, tol, miter,
+                                   false, false, rtol);
+            active[b] = false;
+            iters[b] = -1;
+            for (size_t j=0; j<n; j++) xb[j*W+b] = xp[j];
+          }
+          break;
+        }
+
+        // Inactive lanes get a trivial system
+        for (size_t b=0; b<W; b++) {
+          if (active[b]) continue;
+          for (size_t j=0; j<n; j++) Rb[j*W+b] = 0.0;
+          for (size_t j=0; j<n*n; j++) Jb[j*W+b] = 0.0;
+          for (size_t j=0; j<n; j++) Jb[CINDEX(j,j,n)*W+b] = 1.0;
+        }
+
+        batch_lu_solve_(n, &Jb[0], &Rb[0], lier);
+        for (size_t b=0; b<W; b++) {
+          if (active[b] && (lier[b] != SUCCESS)) {
+            active[b] = false;
+            iters[b] = i;
+          }
+        }
+
+        for (size_t j=0; j<n; j++) {
+          for (size_t b=0; b<W; b++) {
+            if (active[b]) xb[j*W+b] -= Rb[j*W+b];
+          }
+        }
+
+        system->RJ_batch(W, &xb[0], lts, active, &Rb[0], &Jb[0], lier);
+        i++;
+
+        for (size_t b=0; b<W; b++) {
+          if (!active[b]) continue;
+          if (lier[b] != SUCCESS) {
+            active[b] = false;
+            iters[b] = i;
+            continue;
+          }
+          double sum = 0.0;
+          for (size_t j=0; j<n; j++) {
+            sum += (wb[j*W+b] * Rb[j*W+b]) * (wb[j*W+b] * Rb[j*W+b]);
+          }
+          nR_prev[b] = nR[b];
+          nR[b] = sqrt(sum);
+        }
+      }
+
+      // Copy out and record the lanes the scalar solver did not finish
+      for (size_t b=0; b<nb; b++) {
+        if (iters[b] < 0) {
+          ier[c+b] = lier[b];
+          continue;
+        }
+        if (active[b]) {
+          lier[b] = MAX_ITERATIONS;
+          iters[b] = i;
+        }
+        ier[c+b] = lier[b];
+        double * xp = &x[(c+b)*n];
+        for (size_t j=0; j<n; j++) xp[j] = xb[j*W+b];
+
+        stats.nsolves++;
+        stats.niter += iters[b];
+        stats.max_iter = std::max(stats.max_iter, iters[b]);
+        if ((iters[b] > 0) && (nR_prev[b] > 0.0)) {
+          stats.rate = std::max(stats.rate, nR[b] / nR_prev[b]);
+        }
+      }
+    }
+  }
+
+  for (size_t p=0; p<nsys; p++) {
+    if (ier[p] != SUCCESS) return ier[p];
+  }
 
   return SUCCESS;
 }
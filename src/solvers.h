@@ -17,6 +17,27 @@ class TrialState {
 
 };
 
+/// Statistics on the nonlinear solves and substeps in a material update
+//  These are accumulated per thread.  Whoever wants the statistics for an
+//  update resets them first and reads them back afterwards.
+class SolveStats {
+ public:
+  SolveStats();
+
+  /// Clear the statistics
+  void reset();
+
+  size_t nsolves;   // Number of nonlinear solves
+  size_t niter;     // Total number of iterations over all the solves
+  int max_iter;     // Most iterations taken by a single solve
+  double rate;      // Worst residual contraction ratio in a final iteration
+  int ndivide;      // Deepest substep subdivision used
+  bool exhausted;   // A substepping loop ran out of subdivisions
+};
+
+/// Solver statistics for the calling thread
+SolveStats & solve_stats();
+
 /// Generic nonlinear solver interface
 class Solvable {
  public:
@@ -27,16 +48,50 @@ class Solvable {
   /// Nonlinear residual equations and corresponding jacobian
   virtual int RJ(const double * const x, TrialState * ts, double * const R,
                  double * const J) = 0;
+  /// Scale factor for each residual equation used in the convergence check
+  //  The default is one for every equation.  Systems mixing equations with
+  //  different units should bring them to a common scale here.
+  virtual int residual_scales(TrialState * ts, double * const scales);
+  /// Residual equations and jacobians for a batch of systems
+  //  The batch is interleaved so that each lane holds one system: entry i
+  //  of the residual for lane b is R[i*nbatch+b] and entry (i,j) of the
+  //  jacobian is J[CINDEX(i,j,n)*nbatch+b], with the same layout for x.
+  //  Only the active lanes are evaluated and each gets its own error code.
+  //  The default calls RJ lane by lane.
+  virtual void RJ_batch(size_t nbatch, const double * const x,
+                        TrialState * const * ts, const bool * const active,
+                        double * const R, double * const J,
+                        int * const ier);
 };
 
+/// Number of systems the batch solver advances in lockstep
+const size_t batch_width = 8;
+
 /// Call the built-in solver
+//  Converges when the norm of the scaled residual is less than 
+//  tol + rtol times its initial value.  If J is given it returns the
+//  jacobian at the solution, so callers can form tangents without
+//  evaluating the system again.
 int solve(Solvable * system, double * x, TrialState * ts, 
           double tol = 1.0e-8, int miter = 50,
-          bool verbose = false, bool relative = false);
+          bool verbose = false, bool relative = false,
+          double rtol = 0.0, double * const J = nullptr);
 
 /// Default solver: plain NR
 int newton(Solvable * system, double * x, TrialState * ts,
-          double tol, int miter, bool verbose, bool relative);
+          double tol, int miter, bool verbose, bool relative,
+          double rtol = 0.0, double * const J = nullptr);
+
+/// Solve a batch of systems with the same structure
+//  The systems are stored one after the other in x, each has its own trial
+//  state, and each gets its own error code.  Newton runs for batch_width
+//  systems at a time in lockstep, with converged systems masked off and
+//  the last few stragglers finished by the scalar solver.  Returns the
+//  first error, or success if every system converged.
+int solve_batch(Solvable * system, size_t nsys, double * x,
+                TrialState * const * ts, int * const ier,
+                double tol = 1.0e-8, int miter = 50,
+                bool verbose = false, double rtol = 0.0);
 
 #ifdef SOLVER_NOX
 /// NOX object-oriented interface
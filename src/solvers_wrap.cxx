@@ -17,6 +17,22 @@ PYBIND11_MODULE(solvers, m) {
       .def(py::init<>())
       ;
 
+  py::class_<SolveStats>(m, "SolveStats")
+      .def(py::init<>())
+      .def("reset", &SolveStats::reset, "Clear the statistics.")
+      .def_readwrite("nsolves", &SolveStats::nsolves)
+      .def_readwrite("niter", &SolveStats::niter)
+      .def_readwrite("max_iter", &SolveStats::max_iter)
+      .def_readwrite("rate", &SolveStats::rate)
+      .def_readwrite("ndivide", &SolveStats::ndivide)
+      .def_readwrite("exhausted", &SolveStats::exhausted)
+      ;
+
+  m.def("solve_stats", []() -> SolveStats
+        {
+          return solve_stats();
+        }, "Copy of the solver statistics for the calling thread.");
+
   py::class_<Solvable, std::shared_ptr<Solvable>>(m, "Solvable")
       .def_property_readonly("nparams", &Solvable::nparams, "Number of variables in nonlinear equations.")
       .def("init_x",
@@ -38,21 +54,29 @@ PYBIND11_MODULE(solvers, m) {
 
             return std::make_tuple(R, J);
            }, "Residual and jacobian.")
+      .def("residual_scales",
+           [](Solvable & m, TrialState & ts) -> py::array_t<double>
+           {
+            auto scales = alloc_vec<double>(m.nparams());
+            int ier = m.residual_scales(&ts, arr2ptr<double>(scales));
+            py_error(ier);
+            return scales;
+           }, "Scale factors for the residual equations.")
       ;
 
   m.def("solve",
-        [](std::shared_ptr<Solvable> system, TrialState & ts, double tol, int miter, bool verbose) -> py::array_t<double>
+        [](std::shared_ptr<Solvable> system, TrialState & ts, double tol, int miter, bool verbose, double rtol) -> py::array_t<double>
         {
           auto x = alloc_vec<double>(system->nparams());
           
-          int ier = solve(system.get(), arr2ptr<double>(x), &ts, tol, miter, verbose);
+          int ier = solve(system.get(), arr2ptr<double>(x), &ts, tol, miter, verbose, false, rtol);
           py_error(ier);
 
           return x;
         }, "Solve a nonlinear system", 
         py::arg("solvable"), py::arg("trial_state"), py::arg("tol") = 1.0e-8,
         py::arg("miter") = 50,
-        py::arg("verbose") = false);
+        py::arg("verbose") = false, py::arg("rtol") = 0.0);
 }
 
 } // namespace neml
@@ -267,7 +267,7 @@ int IsoKinJ2I1::f(const double* const s, const double* const q, double T,
   dev_vec(sdev);
   add_vec(sdev, &q[1], 6, sdev);
   fv = norm2_vec(sdev, 6) + sqrt(2.0/3.0) * q[0] + 
-      copysign(h_->value(T) * pow( fabs(s[0] + s[1] + s[2]), l_->value(T) ),
+      copysign((*h_)(T) * pow( fabs(s[0] + s[1] + s[2]), (*l_)(T) ),
                s[0] + s[1] + s[2]);
   return 0;
 }
@@ -283,8 +283,8 @@ int IsoKinJ2I1::df_ds(const double* const s, const double* const q, double T,
   // Compute dsh/ds
   double dsh[6];
   for (int i=0; i<3; i++) {
-    dsh[i] = h_->value(T) * l_->value(T) * pow( fabs(s[0] + s[1] + s[2]),
-                                               l_->value(T) - 1.0 );
+    dsh[i] = (*h_)(T) * (*l_)(T) * pow( fabs(s[0] + s[1] + s[2]),
+                                               (*l_)(T) - 1.0 );
   }
   for (int i=3; i<6; i++) {
     dsh[i] = 0.0;
@@ -342,8 +342,8 @@ int IsoKinJ2I1::df_dsds(const double* const s, const double* const q, double T,
   // Compute ddsh/dsds
   double iv2[6];
   for (int i=0; i<3; i++) {
-    iv2[i] = copysign(h_->value(T) * l_->value(T) * (l_->value(T) - 1.0) *
-                      pow( fabs(s[0]+s[1]+s[2]), l_->value(T) - 2.0),
+    iv2[i] = copysign((*h_)(T) * (*l_)(T) * ((*l_)(T) - 1.0) *
+                      pow( fabs(s[0]+s[1]+s[2]), (*l_)(T) - 2.0),
                       s[0] + s[1] + s[2]);    
   }
   for (int i=3; i<6; i++) {
@@ -0,0 +1,296 @@
+#include "trace.h"
+
+#include "nemlerror.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+namespace neml {
+
+typedef std::chrono::steady_clock Clock;
+
+// One event, with up to two values
+struct TraceEvent {
+  const char * name;
+  char phase;             // 'X' for a block, 'i' for an instant
+  Clock::time_point start;
+  double dur;             // Microseconds
+  int nargs;
+  const char * keys[2];
+  double values[2];
+};
+
+// The filters and time origin of one trace, fixed once it starts
+struct TraceFilter {
+  std::vector<long> points;   // Sorted, empty for all points
+  bool failures;
+  Clock::time_point t0;
+};
+
+// The running trace
+struct TraceState {
+  TraceState() : active(false), nthreads(0), nevents(0) {}
+
+  std::mutex lock;
+  std::atomic<bool> active;
+  std::ofstream out;
+  std::shared_ptr<const TraceFilter> filter;
+  std::atomic<int> nthreads;
+  size_t nevents;
+};
+
+static TraceState & trace_state()
+{
+  static TraceState state;
+  return state;
+}
+
+// The update in progress on a thread
+struct TraceBuffer {
+  TraceBuffer() : depth(0), failed(false), point(-1),
+    tid(trace_state().nthreads++) {}
+
+  int depth;
+  bool failed;
+  long point;
+  int tid;
+  std::vector<TraceEvent> events;
+};
+
+static TraceBuffer & trace_buffer()
+{
+  static thread_local TraceBuffer buffer;
+  return buffer;
+}
+
+static void write_value(std::ostream & os, double v)
+{
+  if (std::isfinite(v)) os << v;
+  else os << "\"" << v << "\"";
+}
+
+// Write the update if the filters keep it, and start the next one
+static void finish_update(TraceBuffer & buf)
+{
+  TraceState & state = trace_state();
+  std::shared_ptr<const TraceFilter> filter;
+  {
+    std::lock_guard<std::mutex> guard(state.lock);
+    filter = state.filter;
+  }
+
+  bool keep = (filter != nullptr) && (filter->points.empty() ||
+      std::binary_search(filter->points.begin(), filter->points.end(),
+                         buf.point));
+  if (keep && filter->failures && !buf.failed) keep = false;
+
+  if (keep && !buf.events.empty()) {
+    // Format outside the lock
+    std::stringstream ss;
+    ss << std::setprecision(10);
+    for (auto & e : buf.events) {
+      double ts = std::chrono::duration<double, std::micro>(
+          e.start - filter->t0).count();
+      ss << ",\n{\"name\":\"" << e.name << "\",\"ph\":\"" << e.phase
+          << "\",\"ts\":" << ts;
+      if (e.phase == 'X') ss << ",\"dur\":" << e.dur;
+      else ss << ",\"s\":\"t\"";
+      ss << ",\"pid\":" << buf.point << ",\"tid\":" << buf.tid;
+      if (e.nargs > 0) {
+        ss << ",\"args\":{";
+        for (int i = 0; i < e.nargs; i++) {
+          if (i > 0) ss << ",";
+          ss << "\"" << e.keys[i] << "\":";
+          write_value(ss, e.values[i]);
+        }
+        ss << "}";
+      }
+      ss << "}";
+    }
+
+    // Drop the update if the trace restarted while formatting
+    std::lock_guard<std::mutex> guard(state.lock);
+    if (state.active && (state.filter == filter)) {
+      std::string text = ss.str();
+      // The first event in the file has no comma before it
+      if (state.nevents == 0) text = text.substr(1);
+      state.out << text;
+      state.nevents += buf.events.size();
+    }
+  }
+
+  buf.events.clear();
+  buf.failed = false;
+}
+
+static void add_instant(const char * name, int nargs, const char * key1,
+                        double value1, const char * key2, double value2)
+{
+  if (!trace_state().active) return;
+
+  TraceBuffer & buf = trace_buffer();
+  TraceEvent e;
+  e.name = name;
+  e.phase = 'i';
+  e.start = Clock::now();
+  e.dur = 0.0;
+  e.nargs = nargs;
+  e.keys[0] = key1;
+  e.values[0] = value1;
+  e.keys[1] = key2;
+  e.values[1] = value2;
+  buf.events.push_back(e);
+
+  if (buf.depth == 0) finish_update(buf);
+}
+
+bool trace_compiled()
+{
+#ifdef NEML_TRACE
+  return true;
+#else
+  return false;
+#endif
+}
+
+void start_trace(const std::string & fname, const std::vector<long> & points,
+                 bool failures)
+{
+  TraceState & state = trace_state();
+  std::lock_guard<std::mutex> guard(state.lock);
+
+  state.active = false;
+  if (state.out.is_open()) {
+    state.out << "\n]}\n";
+    state.out.close();
+  }
+  state.out.open(fname, std::ios::trunc);
+  if (!state.out.good()) {
+    throw std::runtime_error("Cannot open trace file " + fname);
+  }
+  state.out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+  auto filter = std::make_shared<TraceFilter>();
+  filter->points = points;
+  std::sort(filter->points.begin(), filter->points.end());
+  filter->failures = failures;
+  filter->t0 = Clock::now();
+  state.filter = filter;
+  state.nevents = 0;
+  state.active = true;
+}
+
+void stop_trace()
+{
+  TraceState & state = trace_state();
+  std::lock_guard<std::mutex> guard(state.lock);
+
+  state.active = false;
+  if (state.out.is_open()) {
+    state.out << "\n]}\n";
+    state.out.close();
+  }
+}
+
+bool tracing()
+{
+  return trace_state().active;
+}
+
+void trace_from_environment()
+{
+  static std::once_flag once;
+  std::call_once(once, []() {
+    const char * fname = std::getenv("NEML_TRACE_FILE");
+    if ((fname == nullptr) || (std::strlen(fname) == 0)) return;
+
+    std::vector<long> points;
+    const char * plist = std::getenv("NEML_TRACE_POINTS");
+    if (plist != nullptr) {
+      std::stringstream ss(plist);
+      std::string item;
+      while (std::getline(ss, item, ',')) {
+        if (!item.empty()) points.push_back(std::atol(item.c_str()));
+      }
+    }
+    const char * failures = std::getenv("NEML_TRACE_FAILURES");
+    start_trace(fname, points,
+                (failures != nullptr) && (std::atoi(failures) != 0));
+  });
+}
+
+void trace_set_point(long id)
+{
+  trace_buffer().point = id;
+}
+
+void trace_error(int ier)
+{
+  if ((ier == SUCCESS) || !trace_state().active) return;
+  trace_buffer().failed = true;
+  add_instant("error", 1, "ier", ier, nullptr, 0.0);
+}
+
+void trace_instant(const char * name, const char * key, double value)
+{
+  add_instant(name, 1, key, value, nullptr, 0.0);
+}
+
+void trace_instant(const char * name, const char * key1, double value1,
+                   const char * key2, double value2)
+{
+  add_instant(name, 2, key1, value1, key2, value2);
+}
+
+TraceScope::TraceScope(const char * name) :
+    TraceScope(name, nullptr, 0.0)
+{
+
+}
+
+TraceScope::TraceScope(const char * name, const char * key, double value) :
+    active_(trace_state().active), index_(0)
+{
+  if (!active_) return;
+
+  TraceBuffer & buf = trace_buffer();
+  buf.depth++;
+  index_ = buf.events.size();
+  start_ = Clock::now();
+
+  TraceEvent e;
+  e.name = name;
+  e.phase = 'X';
+  e.start = start_;
+  e.dur = 0.0;
+  e.nargs = (key == nullptr) ? 0 : 1;
+  e.keys[0] = key;
+  e.values[0] = value;
+  e.keys[1] = nullptr;
+  e.values[1] = 0.0;
+  buf.events.push_back(e);
+}
+
+TraceScope::~TraceScope()
+{
+  if (!active_) return;
+
+  TraceBuffer & buf = trace_buffer();
+  // The trace may have been restarted under this scope
+  if (index_ < buf.events.size()) {
+    buf.events[index_].dur = std::chrono::duration<double, std::micro>(
+        Clock::now() - start_).count();
+  }
+  buf.depth--;
+  if (buf.depth == 0) finish_update(buf);
+}
+
+} // namespace neml
@@ -0,0 +1,89 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/// Trace events in the material point update
+//  The events are only compiled in with the USE_TRACE build option, which
+//  defines NEML_TRACE.  Otherwise the macros are empty and their arguments
+//  are never evaluated.
+#ifdef NEML_TRACE
+#define NEML_TRACE_CAT_(a, b) a ## b
+#define NEML_TRACE_VAR_(line) NEML_TRACE_CAT_(neml_trace_scope_, line)
+/// Time the rest of the enclosing block
+#define NEML_TRACE_SCOPE(name) \
+  neml::TraceScope NEML_TRACE_VAR_(__LINE__)(name)
+/// Time the rest of the enclosing block, with a value to show with it
+#define NEML_TRACE_SCOPE_ARG(name, key, value) \
+  neml::TraceScope NEML_TRACE_VAR_(__LINE__)(name, key, value)
+/// Mark a moment in the update with a value
+#define NEML_TRACE_INSTANT(name, key, value) \
+  neml::trace_instant(name, key, value)
+/// Mark a moment in the update with two values
+#define NEML_TRACE_INSTANT2(name, key1, value1, key2, value2) \
+  neml::trace_instant(name, key1, value1, key2, value2)
+/// Note an error code, which keeps the update when tracing failures
+#define NEML_TRACE_ERROR(ier) neml::trace_error(ier)
+/// Set the point the next updates on this thread belong to
+#define NEML_TRACE_POINT(id) neml::trace_set_point(id)
+#else
+#define NEML_TRACE_SCOPE(name)
+#define NEML_TRACE_SCOPE_ARG(name, key, value)
+#define NEML_TRACE_INSTANT(name, key, value)
+#define NEML_TRACE_INSTANT2(name, key1, value1, key2, value2)
+#define NEML_TRACE_ERROR(ier)
+#define NEML_TRACE_POINT(id)
+#endif
+
+namespace neml {
+
+/// Were the trace events compiled in?
+bool trace_compiled();
+
+/// Start writing the traced updates to a Chrome trace event (JSON) file,
+/// which Perfetto and chrome://tracing can display
+//  Updates are kept if their point is in points, or for any point if
+//  points is empty.  With failures set only updates that returned an
+//  error are kept.  Throws std::runtime_error if the file cannot be opened.
+void start_trace(const std::string & fname,
+                 const std::vector<long> & points = std::vector<long>(),
+                 bool failures = false);
+/// Stop tracing and close the file
+void stop_trace();
+/// Is a trace running?
+bool tracing();
+/// Start a trace to NEML_TRACE_FILE if it is set, keeping the comma
+/// separated points in NEML_TRACE_POINTS and only failures if
+/// NEML_TRACE_FAILURES is set to 1
+void trace_from_environment();
+
+/// Set the point the next updates on this thread belong to
+void trace_set_point(long id);
+/// Note an error code in the current update
+void trace_error(int ier);
+/// Mark a moment in the current update
+void trace_instant(const char * name, const char * key, double value);
+/// Mark a moment in the current update with two values
+void trace_instant(const char * name, const char * key1, double value1,
+                   const char * key2, double value2);
+
+/// Time a block of the update
+//  An update is the time from the outermost scope opening to it closing,
+//  and its events are written or dropped together at the end.
+class TraceScope {
+ public:
+  TraceScope(const char * name);
+  TraceScope(const char * name, const char * key, double value);
+  ~TraceScope();
+
+ private:
+  bool active_;
+  size_t index_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace neml
+
+#endif // TRACE_H
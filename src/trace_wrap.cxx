@@ -0,0 +1,24 @@
+#include "pyhelp.h" // include first to avoid annoying redef warning
+
+#include "trace.h"
+
+namespace py = pybind11;
+
+namespace neml {
+
+PYBIND11_MODULE(trace, m) {
+  m.doc() = "Trace events inside material point updates.";
+
+  m.def("trace_compiled", &trace_compiled,
+        "Were the trace events compiled in?");
+  m.def("start_trace", &start_trace,
+        "Start writing traced updates to a Chrome trace file.",
+        py::arg("fname"), py::arg("points") = std::vector<long>(),
+        py::arg("failures") = false);
+  m.def("stop_trace", &stop_trace, "Stop tracing and close the file.");
+  m.def("tracing", &tracing, "Is a trace running?");
+  m.def("trace_set_point", &trace_set_point,
+        "Set the point the next updates on this thread belong to.");
+}
+
+} // namespace neml
@@ -140,23 +140,23 @@ std::unique_ptr<NEMLObject> GPowerLaw::initialize(ParameterSet & params)
 
 double GPowerLaw::g(double f, double T) const
 {
-  return pow(f / eta_->value(T), n_->value(T));
+  return pow(f / (*eta_)(T), (*n_)(T));
 }
 
 double GPowerLaw::dg(double f, double T) const
 {
-  return n_->value(T) * pow(f / eta_->value(T), n_->value(T) - 1.0) / 
-      eta_->value(T);
+  return (*n_)(T) * pow(f / (*eta_)(T), (*n_)(T) - 1.0) / 
+      (*eta_)(T);
 }
 
 double GPowerLaw::n(double T) const
 {
-  return n_->value(T);
+  return (*n_)(T);
 }
 
 double GPowerLaw::eta(double T) const
 {
-  return eta_->value(T);
+  return (*eta_)(T);
 }
 
 PerzynaFlowRule::PerzynaFlowRule(std::shared_ptr<YieldSurface> surface,
@@ -412,7 +412,7 @@ std::unique_ptr<NEMLObject> ConstantFluidity::initialize(ParameterSet & params)
 
 double ConstantFluidity::eta(double a, double T) const
 {
-  return eta_->value(T);
+  return (*eta_)(T);
 }
 
 double ConstantFluidity::deta(double a, double T) const
@@ -456,17 +456,17 @@ std::unique_ptr<NEMLObject> SaturatingFluidity::initialize(ParameterSet & params
 
 double SaturatingFluidity::eta(double a, double T) const
 {
-  double K0 = K0_->value(T);
-  double A = A_->value(T);
-  double b = b_->value(T);
+  double K0 = (*K0_)(T);
+  double A = (*A_)(T);
+  double b = (*b_)(T);
 
   return K0 + A * (1.0 - exp(-b * a));
 }
 
 double SaturatingFluidity::deta(double a, double T) const
 {
-  double A = A_->value(T);
-  double b = b_->value(T);
+  double A = (*A_)(T);
+  double b = (*b_)(T);
 
   return A * b * exp(-b * a);
 }
@@ -536,7 +536,7 @@ int ChabocheFlowRule::y(const double* const s, const double* const alpha, double
 
   if (fv > 0.0) {
     double eta = sqrt(2.0/3.0) * fluidity_->eta(alpha[0], T);
-    yv = sqrt(3.0/2.0) * pow(fv/eta, n_->value(T));
+    yv = sqrt(3.0/2.0) * pow(fv/eta, (*n_)(T));
   }
   else {
     yv = 0.0;
@@ -563,7 +563,7 @@ int ChabocheFlowRule::dy_ds(const double* const s, const double* const alpha, do
     ier = surface_->df_ds(s, q, T, dyv);
     if (ier != SUCCESS) return ier;
     double eta = sqrt(2.0/3.0) * fluidity_->eta(alpha[0], T);
-    double mv = sqrt(3.0/2.0) * pow(fv/eta, n_->value(T) - 1.0) * n_->value(T) / eta;
+    double mv = sqrt(3.0/2.0) * pow(fv/eta, (*n_)(T) - 1.0) * (*n_)(T) / eta;
     for (int i=0; i<6; i++) dyv[i] *= mv;
   }
 
@@ -599,10 +599,10 @@ int ChabocheFlowRule::dy_da(const double* const s, const double* const alpha, do
     if (ier != SUCCESS) return ier;
 
     double eta = sqrt(2.0/3.0) * fluidity_->eta(alpha[0], T);
-    double mv = sqrt(3.0/2.0) * pow(fv/eta, n_->value(T) - 1.0) * n_->value(T) / eta;
+    double mv = sqrt(3.0/2.0) * pow(fv/eta, (*n_)(T) - 1.0) * (*n_)(T) / eta;
     for (size_t i=0; i<nhist(); i++) dyv[i] *= mv;
 
-    double mv2 = -sqrt(3.0/2.0) * fv * pow(fv/eta, n_->value(T) - 1.0) * n_->value(T) / (eta * eta);
+    double mv2 = -sqrt(3.0/2.0) * fv * pow(fv/eta, (*n_)(T) - 1.0) * (*n_)(T) / (eta * eta);
     double deta = sqrt(2.0/3.0) * fluidity_->deta(alpha[0], T);
     dyv[0] += deta * mv2;
   }
@@ -763,18 +763,18 @@ int YaguchiGr91FlowRule::init_hist(double * const h) const
 }
 
 // Rate rule
-int YaguchiGr91FlowRule::y(const double* const s, const double* const alpha, double T,
-              double & yv) const
+template <class V>
+int YaguchiGr91FlowRule::y_(const V * const s, const V * const alpha,
+                            double T, V & yv) const
 {
   double nT = n(T);
   double DT = D(T);
-  double sa = alpha[13];
+  V sa = alpha[13];
 
-  double X[6];
-  std::fill(X, X+6, 0.0);
-  add_vec(&alpha[0], &alpha[6], 6, X);
-  double dS[6];
-  sub_vec(s, X, 6, dS);
+  V dS[6];
+  for (int i=0; i<6; i++) {
+    dS[i] = s[i] - (alpha[i] + alpha[i+6]);
+  }
 
   yv = (J2_(dS) - sa) / DT;
   if (yv > 0.0) {
@@ -874,20 +874,23 @@ int YaguchiGr91FlowRule::dy_da(const double* const s, const double* const alpha,
 }
 
 // Flow rule
-int YaguchiGr91FlowRule::g(const double * const s, const double * const alpha, double T,
-              double * const gv) const
+template <class V>
+int YaguchiGr91FlowRule::g_(const V * const s, const V * const alpha,
+                            double T, V * const gv) const
 {
-  std::fill(gv, gv+6, 0.0);
+  std::fill(gv, gv+6, V(0.0));
 
-  double X[6];
-  std::fill(X, X+6, 0.0);
-  add_vec(&alpha[0], &alpha[6], 6, X);
-  double dS[6];
-  sub_vec(s, X, 6, dS);
+  V dS[6];
+  for (int i=0; i<6; i++) {
+    dS[i] = s[i] - (alpha[i] + alpha[i+6]);
+  }
 
-  double Jn = J2_(dS);
+  V Jn = J2_(dS);
 
-  dev_vec(dS);
+  V m = (dS[0] + dS[1] + dS[2]) / 3.0;
+  for (int i=0; i<3; i++) {
+    dS[i] -= m;
+  }
 
   if (Jn > 0.0) {
     for (int i=0; i<6; i++) {
@@ -963,27 +966,27 @@ int YaguchiGr91FlowRule::dg_da(const double * const s, const double * const alph
 }
 
 // Hardening rule
-int YaguchiGr91FlowRule::h(const double * const s, const double * const alpha, double T,
-              double * const hv) const
+template <class V>
+int YaguchiGr91FlowRule::h_(const V * const s, const V * const alpha,
+                            double T, V * const hv) const
 {
-  std::fill(hv, hv+nhist(), 0.0);
+  std::fill(hv, hv+nhist(), V(0.0));
 
-  double X[6];
-  std::fill(X, X+6, 0.0);
-  add_vec(&alpha[0], &alpha[6], 6, X);
-  double dS[6];
-  sub_vec(s, X, 6, dS);
+  V dS[6];
+  for (int i=0; i<6; i++) {
+    dS[i] = s[i] - (alpha[i] + alpha[i+6]);
+  }
 
-  double Jn = J2_(dS);
+  V Jn = J2_(dS);
   
-  double n[6];
-  dev_vec(dS);
+  V n[6];
+  V mean = (dS[0] + dS[1] + dS[2]) / 3.0;
   for (int i=0; i<6; i++) {
-    n[i] = 3.0/2.0 * dS[i] / Jn;
+    n[i] = 3.0/2.0 * ((i < 3) ? dS[i] - mean : dS[i]) / Jn;
   }
 
   double C1i = C1(T);
-  double a1i = a10(T) - alpha[12];
+  V a1i = a10(T) - alpha[12];
 
   double C2i = C2(T);
   double a2i = a2(T);
@@ -1008,11 +1011,11 @@ int YaguchiGr91FlowRule::h(const double * const s, const double * const alpha, d
   double bhi = bh(T);
   double Ai = A(T);
   double Bi = B(T);
-  double yi;
-  y(s, alpha, T, yi);
+  V yi;
+  y_(s, alpha, T, yi);
 
   if (fabs(yi) > log_tol_) {
-    double sas = Ai + Bi * log10(yi);
+    V sas = Ai + Bi * log10(yi);
     
     if (sas < 0.0) {
       sas = 0.0;
@@ -1174,26 +1177,27 @@ int YaguchiGr91FlowRule::dh_da(const double * const s, const double * const alph
 }
 
 // Hardening rule wrt to time
-int YaguchiGr91FlowRule::h_time(const double * const s, 
-                                const double * const alpha, double T,
-                                double * const hv) const
+template <class V>
+int YaguchiGr91FlowRule::h_time_(const V * const s, const V * const alpha,
+                                 double T, V * const hv) const
 {
-  std::fill(hv, hv+nhist(), 0.0);
+  std::fill(hv, hv+nhist(), V(0.0));
   
   double mi = m(T);
 
-  // X1
+  // X1, with J^(m-1) written as (J^2)^((m-1)/2) so it differentiates
+  // cleanly at zero
   double g1i = g1(T);
-  double J1 = J2_(&alpha[0]);
+  V J1 = pow(J2sq_(&alpha[0]), (mi-1.0)/2.0);
   for (int i=0; i<6; i++) {
-    hv[i+0] = -g1i * pow(J1, mi-1.0) * alpha[i+0];
+    hv[i+0] = -g1i * J1 * alpha[i+0];
   }
   
   // X2
   double g2i = g2(T);
-  double J2 = J2_(&alpha[6]);
+  V J2 = pow(J2sq_(&alpha[6]), (mi-1.0)/2.0);
   for (int i=0; i<6; i++) {
-    hv[i+6] = -g2i * pow(J2, mi-1.0) * alpha[i+6];
+    hv[i+6] = -g2i * J2 * alpha[i+6];
   }
 
   return 0;
@@ -1405,12 +1409,24 @@ double YaguchiGr91FlowRule::C1(double T) const
 }
 
 // Couple of helpers
-double YaguchiGr91FlowRule::J2_(const double * const v) const
+template <class V>
+V YaguchiGr91FlowRule::J2_(const V * const v) const
+{
+  return sqrt(J2sq_(v));
+}
+
+template <class V>
+V YaguchiGr91FlowRule::J2sq_(const V * const v) const
 {
-  double cv[6];
-  std::copy(v, v+6, cv);
-  dev_vec(cv);
-  return sqrt(3.0/2.0 * dot_vec(cv, cv, 6));
+  V m = (v[0] + v[1] + v[2]) / 3.0;
+  V sum = 0.0;
+  for (int i=0; i<3; i++) {
+    sum += (v[i] - m) * (v[i] - m);
+  }
+  for (int i=3; i<6; i++) {
+    sum += v[i] * v[i];
+  }
+  return 3.0/2.0 * sum;
 }
 
 void YaguchiGr91FlowRule::dev_vec_deriv_(const double * const a, 
@@ -1429,4 +1445,6 @@ void YaguchiGr91FlowRule::dev_vec_deriv_(const double * const a,
 
 }
 
+template class DualViscoPlasticFlowRule<YaguchiGr91FlowRule, 14>;
+
 } // namespace neml
@@ -6,6 +6,7 @@
 #include "surfaces.h"
 #include "hardening.h"
 #include "interpolate.h"
+#include "dual.h"
 
 #include <memory>
 
@@ -91,6 +92,352 @@ class ViscoPlasticFlowRule: public NEMLObject {
                 double * const dhv) const;
 };
 
+/// A viscoplastic flow rule with its derivatives from automatic differentiation
+//  Derived classes write the rate, flow, and hardening functions once, as
+//  templates on the number type V (double or Dual<N>):
+//
+//    template <class V> int y_(const V * s, const V * alpha, double T,
+//                              V & yv) const;
+//    template <class V> int g_(const V * s, const V * alpha, double T,
+//                              V * gv) const;
+//    template <class V> int h_(const V * s, const V * alpha, double T,
+//                              V * hv) const;
+//
+//  and optionally g_time_, h_time_, g_temp_, and h_temp_, which default to
+//  zero.  This class provides the double functions and all their
+//  derivatives, the stress derivatives in one pass with Dual<6> and the
+//  history derivatives N directions at a time with Dual<N>.  A derived class can
+//  still override a derivative by hand where that is faster.  Derived
+//  classes befriend this class so the templates can stay private.
+template <class Derived, size_t N>
+class DualViscoPlasticFlowRule: public ViscoPlasticFlowRule {
+ public:
+  /// Scalar flow rate
+  virtual int y(const double* const s, const double* const alpha, double T,
+                double & yv) const;
+  /// Derivative of scalar flow wrt stress
+  virtual int dy_ds(const double* const s, const double* const alpha, double T,
+                double * const dyv) const;
+  /// Derivative of scalar flow wrt history
+  virtual int dy_da(const double* const s, const double* const alpha, double T,
+                double * const dyv) const;
+
+  /// Flow proportional to the scalar inelastic strain rate
+  virtual int g(const double * const s, const double * const alpha, double T,
+                double * const gv) const;
+  /// Derivative of g wrt stress
+  virtual int dg_ds(const double * const s, const double * const alpha, double T,
+                double * const dgv) const;
+  /// Derivative of g wrt history
+  virtual int dg_da(const double * const s, const double * const alpha, double T,
+               double * const dgv) const;
+
+  /// Flow proportional to time
+  virtual int g_time(const double * const s, const double * const alpha, double T,
+                double * const gv) const;
+  /// Derivative of g_time wrt stress
+  virtual int dg_ds_time(const double * const s, const double * const alpha, double T,
+                double * const dgv) const;
+  /// Derivative of g_time wrt history
+  virtual int dg_da_time(const double * const s, const double * const alpha, double T,
+               double * const dgv) const;
+
+  /// Flow proportional to the temperature rate
+  virtual int g_temp(const double * const s, const double * const alpha, double T,
+                double * const gv) const;
+  /// Derivative of g_temp wrt stress
+  virtual int dg_ds_temp(const double * const s, const double * const alpha, double T,
+                double * const dgv) const;
+  /// Derivative of g_temp wrt history
+  virtual int dg_da_temp(const double * const s, const double * const alpha, double T,
+               double * const dgv) const;
+
+  /// Hardening rate proportional to the scalar inelastic strain rate
+  virtual int h(const double * const s, const double * const alpha, double T,
+                double * const hv) const;
+  /// Derivative of h wrt stress
+  virtual int dh_ds(const double * const s, const double * const alpha, double T,
+                double * const dhv) const;
+  /// Derivative of h wrt history
+  virtual int dh_da(const double * const s, const double * const alpha, double T,
+                double * const dhv) const;
+
+  /// Hardening rate proportional to time
+  virtual int h_time(const double * const s, const double * const alpha, double T,
+                double * const hv) const;
+  /// Derivative of h_time wrt stress
+  virtual int dh_ds_time(const double * const s, const double * const alpha, double T,
+                double * const dhv) const;
+  /// Derivative of h_time wrt history
+  virtual int dh_da_time(const double * const s, const double * const alpha, double T,
+                double * const dhv) const;
+
+  /// Hardening rate proportional to the temperature rate
+  virtual int h_temp(const double * const s, const double * const alpha, double T,
+                double * const hv) const;
+  /// Derivative of h_temp wrt stress
+  virtual int dh_ds_temp(const double * const s, const double * const alpha, double T,
+                double * const dhv) const;
+  /// Derivative of h_temp wrt history
+  virtual int dh_da_temp(const double * const s, const double * const alpha, double T,
+                double * const dhv) const;
+
+ protected:
+  /// Default flow proportional to time: none
+  template <class V>
+  int g_time_(const V * const s, const V * const alpha, double T,
+              V * const gv) const
+  {
+    std::fill(gv, gv+6, V(0.0));
+    return 0;
+  }
+  /// Default flow proportional to the temperature rate: none
+  template <class V>
+  int g_temp_(const V * const s, const V * const alpha, double T,
+              V * const gv) const
+  {
+    std::fill(gv, gv+6, V(0.0));
+    return 0;
+  }
+  /// Default hardening proportional to time: none
+  template <class V>
+  int h_time_(const V * const s, const V * const alpha, double T,
+              V * const hv) const
+  {
+    std::fill(hv, hv+nhist(), V(0.0));
+    return 0;
+  }
+  /// Default hardening proportional to the temperature rate: none
+  template <class V>
+  int h_temp_(const V * const s, const V * const alpha, double T,
+              V * const hv) const
+  {
+    std::fill(hv, hv+nhist(), V(0.0));
+    return 0;
+  }
+
+ private:
+  const Derived & derived_() const
+  {
+    return static_cast<const Derived &>(*this);
+  }
+
+  // Jacobian of one of the functions wrt the stress, in one pass, or the
+  // history, N directions at a time
+  template <class F>
+  int jac_(const F & f, const double * const s, const double * const alpha,
+           size_t m, bool wrt_s, double * const J) const
+  {
+    if (wrt_s) return dual_jacobian<6>(f, s, 6, alpha, nhist(), m, true, J);
+    return dual_jacobian<N>(f, s, 6, alpha, nhist(), m, false, J);
+  }
+
+  // The functions, in the form dual_jacobian takes
+  struct Y_ {
+    const Derived & d; double T;
+    template <class V> int operator()(const V * s, const V * a, V * o) const
+    {return d.y_(s, a, T, o[0]);}
+  };
+  struct G_ {
+    const Derived & d; double T;
+    template <class V> int operator()(const V * s, const V * a, V * o) const
+    {return d.g_(s, a, T, o);}
+  };
+  struct GTime_ {
+    const Derived & d; double T;
+    template <class V> int operator()(const V * s, const V * a, V * o) const
+    {return d.g_time_(s, a, T, o);}
+  };
+  struct GTemp_ {
+    const Derived & d; double T;
+    template <class V> int operator()(const V * s, const V * a, V * o) const
+    {return d.g_temp_(s, a, T, o);}
+  };
+  struct H_ {
+    const Derived & d; double T;
+    template <class V> int operator()(const V * s, const V * a, V * o) const
+    {return d.h_(s, a, T, o);}
+  };
+  struct HTime_ {
+    const Derived & d; double T;
+    template <class V> int operator()(const V * s, const V * a, V * o) const
+    {return d.h_time_(s, a, T, o);}
+  };
+  struct HTemp_ {
+    const Derived & d; double T;
+    template <class V> int operator()(const V * s, const V * a, V * o) const
+    {return d.h_temp_(s, a, T, o);}
+  };
+};
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::y(
+    const double * const s, const double * const alpha, double T,
+    double & yv) const
+{
+  return derived_().y_(s, alpha, T, yv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::dy_ds(
+    const double * const s, const double * const alpha, double T,
+    double * const dyv) const
+{
+  return jac_(Y_{derived_(), T}, s, alpha, 1, true, dyv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::dy_da(
+    const double * const s, const double * const alpha, double T,
+    double * const dyv) const
+{
+  return jac_(Y_{derived_(), T}, s, alpha, 1, false, dyv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::g(
+    const double * const s, const double * const alpha, double T,
+    double * const gv) const
+{
+  return derived_().g_(s, alpha, T, gv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::dg_ds(
+    const double * const s, const double * const alpha, double T,
+    double * const dgv) const
+{
+  return jac_(G_{derived_(), T}, s, alpha, 6, true, dgv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::dg_da(
+    const double * const s, const double * const alpha, double T,
+    double * const dgv) const
+{
+  return jac_(G_{derived_(), T}, s, alpha, 6, false, dgv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::g_time(
+    const double * const s, const double * const alpha, double T,
+    double * const gv) const
+{
+  return derived_().g_time_(s, alpha, T, gv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::dg_ds_time(
+    const double * const s, const double * const alpha, double T,
+    double * const dgv) const
+{
+  return jac_(GTime_{derived_(), T}, s, alpha, 6, true, dgv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::dg_da_time(
+    const double * const s, const double * const alpha, double T,
+    double * const dgv) const
+{
+  return jac_(GTime_{derived_(), T}, s, alpha, 6, false, dgv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::g_temp(
+    const double * const s, const double * const alpha, double T,
+    double * const gv) const
+{
+  return derived_().g_temp_(s, alpha, T, gv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::dg_ds_temp(
+    const double * const s, const double * const alpha, double T,
+    double * const dgv) const
+{
+  return jac_(GTemp_{derived_(), T}, s, alpha, 6, true, dgv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::dg_da_temp(
+    const double * const s, const double * const alpha, double T,
+    double * const dgv) const
+{
+  return jac_(GTemp_{derived_(), T}, s, alpha, 6, false, dgv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::h(
+    const double * const s, const double * const alpha, double T,
+    double * const hv) const
+{
+  return derived_().h_(s, alpha, T, hv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::dh_ds(
+    const double * const s, const double * const alpha, double T,
+    double * const dhv) const
+{
+  return jac_(H_{derived_(), T}, s, alpha, nhist(), true, dhv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::dh_da(
+    const double * const s, const double * const alpha, double T,
+    double * const dhv) const
+{
+  return jac_(H_{derived_(), T}, s, alpha, nhist(), false, dhv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::h_time(
+    const double * const s, const double * const alpha, double T,
+    double * const hv) const
+{
+  return derived_().h_time_(s, alpha, T, hv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::dh_ds_time(
+    const double * const s, const double * const alpha, double T,
+    double * const dhv) const
+{
+  return jac_(HTime_{derived_(), T}, s, alpha, nhist(), true, dhv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::dh_da_time(
+    const double * const s, const double * const alpha, double T,
+    double * const dhv) const
+{
+  return jac_(HTime_{derived_(), T}, s, alpha, nhist(), false, dhv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::h_temp(
+    const double * const s, const double * const alpha, double T,
+    double * const hv) const
+{
+  return derived_().h_temp_(s, alpha, T, hv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::dh_ds_temp(
+    const double * const s, const double * const alpha, double T,
+    double * const dhv) const
+{
+  return jac_(HTemp_{derived_(), T}, s, alpha, nhist(), true, dhv);
+}
+
+template <class Derived, size_t N>
+int DualViscoPlasticFlowRule<Derived, N>::dh_da_temp(
+    const double * const s, const double * const alpha, double T,
+    double * const dhv) const
+{
+  return jac_(HTemp_{derived_(), T}, s, alpha, nhist(), false, dhv);
+}
+
 /// The "g" function in the Perzyna model -- often a power law
 class GFlow: public NEMLObject {
  public:
@@ -349,8 +696,18 @@ static Register<ChabocheFlowRule> regChabocheFlowRule;
 //  Interpolations are hard-coded because of their complexity
 //  They are public so I can easily test them
 //
-class YaguchiGr91FlowRule: public ViscoPlasticFlowRule {
+//  The rate, flow, and hardening functions are written once for
+//  DualViscoPlasticFlowRule, and the hand-coded derivatives below override
+//  the automatic ones.  DualBase gives the automatic versions for checking.
+//
+class YaguchiGr91FlowRule:
+    public DualViscoPlasticFlowRule<YaguchiGr91FlowRule, 14> {
  public:
+  /// The base class with the automatic derivatives
+  typedef DualViscoPlasticFlowRule<YaguchiGr91FlowRule, 14> DualBase;
+  friend class DualViscoPlasticFlowRule<YaguchiGr91FlowRule, 14>;
+
+
   /// All parameters are hard coded to those given in the paper
   YaguchiGr91FlowRule();
   
@@ -367,9 +724,6 @@ class YaguchiGr91FlowRule: public ViscoPlasticFlowRule {
   /// 1 value for sigma_a)
   virtual int init_hist(double * const h) const;
   
-  /// Scalar inelastic strain rate
-  virtual int y(const double* const s, const double* const alpha, double T,
-                double & yv) const;
   /// Derivative of y wrt stress
   virtual int dy_ds(const double* const s, const double* const alpha, double T,
                 double * const dyv) const;
@@ -377,9 +731,6 @@ class YaguchiGr91FlowRule: public ViscoPlasticFlowRule {
   virtual int dy_da(const double* const s, const double* const alpha, double T,
                 double * const dyv) const;
 
-  /// Flow rule proportional to the scalar strain rate
-  virtual int g(const double * const s, const double * const alpha, double T,
-                double * const gv) const;
   /// Derivative of g wrt stress
   virtual int dg_ds(const double * const s, const double * const alpha, double T,
                 double * const dgv) const;
@@ -387,9 +738,6 @@ class YaguchiGr91FlowRule: public ViscoPlasticFlowRule {
   virtual int dg_da(const double * const s, const double * const alpha, double T,
                double * const dgv) const;
 
-  /// Hardening rule proportional to scalar inelastic strain rate
-  virtual int h(const double * const s, const double * const alpha, double T,
-                double * const hv) const;
   /// Derivative of h wrt stress
   virtual int dh_ds(const double * const s, const double * const alpha, double T,
                 double * const dhv) const;
@@ -397,9 +745,6 @@ class YaguchiGr91FlowRule: public ViscoPlasticFlowRule {
   virtual int dh_da(const double * const s, const double * const alpha, double T,
                 double * const dhv) const;
 
-  /// Hardening rule proportional to time
-  virtual int h_time(const double * const s, const double * const alpha, double T,
-                double * const hv) const;
   /// Derivative of h_time wrt stress
   virtual int dh_ds_time(const double * const s, const double * const alpha, double T,
                 double * const dhv) const;
@@ -439,13 +784,34 @@ class YaguchiGr91FlowRule: public ViscoPlasticFlowRule {
   double C1(double T) const;
 
  private:
+  // Scalar inelastic strain rate
+  template <class V>
+  int y_(const V * const s, const V * const alpha, double T, V & yv) const;
+  // Flow rule proportional to the scalar strain rate
+  template <class V>
+  int g_(const V * const s, const V * const alpha, double T,
+         V * const gv) const;
+  // Hardening rule proportional to scalar inelastic strain rate
+  template <class V>
+  int h_(const V * const s, const V * const alpha, double T,
+         V * const hv) const;
+  // Hardening rule proportional to time
+  template <class V>
+  int h_time_(const V * const s, const V * const alpha, double T,
+              V * const hv) const;
+
   // A few helpers
-  double J2_(const double * const v) const;
+  template <class V>
+  V J2_(const V * const v) const;
+  template <class V>
+  V J2sq_(const V * const v) const;
   void dev_vec_deriv_(const double * const a, double * const b) const;
 
   double log_tol_ = 1.0e-15;
 };
 
+extern template class DualViscoPlasticFlowRule<YaguchiGr91FlowRule, 14>;
+
 static Register<YaguchiGr91FlowRule> regYaguchiGr91FlowRule;
 
 } // namespace neml
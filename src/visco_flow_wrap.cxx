@@ -273,6 +273,70 @@ PYBIND11_MODULE(visco_flow, m) {
       .def("d", &YaguchiGr91FlowRule::d)
       .def("q", &YaguchiGr91FlowRule::q)
       .def("C1", &YaguchiGr91FlowRule::C1)
+      .def("auto_dy_ds",
+           [](YaguchiGr91FlowRule & m, py::array_t<double, py::array::c_style> s, py::array_t<double, py::array::c_style> alpha, double T) -> py::array_t<double>
+           {
+            auto f = alloc_vec<double>(6);
+            int ier = m.YaguchiGr91FlowRule::DualBase::dy_ds(arr2ptr<double>(s), arr2ptr<double>(alpha), T, arr2ptr<double>(f));
+            py_error(ier);
+            return f;
+           }, "Automatic plastic multiplier derivative with respect to stress.")
+      .def("auto_dy_da",
+           [](YaguchiGr91FlowRule & m, py::array_t<double, py::array::c_style> s, py::array_t<double, py::array::c_style> alpha, double T) -> py::array_t<double>
+           {
+            auto f = alloc_vec<double>(m.nhist());
+            int ier = m.YaguchiGr91FlowRule::DualBase::dy_da(arr2ptr<double>(s), arr2ptr<double>(alpha), T, arr2ptr<double>(f));
+            py_error(ier);
+            return f;
+           }, "Automatic plastic multiplier derivative with respect to history.")
+      .def("auto_dg_ds",
+           [](YaguchiGr91FlowRule & m, py::array_t<double, py::array::c_style> s, py::array_t<double, py::array::c_style> alpha, double T) -> py::array_t<double>
+           {
+            auto f = alloc_mat<double>(6,6);
+            int ier = m.YaguchiGr91FlowRule::DualBase::dg_ds(arr2ptr<double>(s), arr2ptr<double>(alpha), T, arr2ptr<double>(f));
+            py_error(ier);
+            return f;
+           }, "Automatic flow rule (rate) derivative with respect to stress.")
+      .def("auto_dg_da",
+           [](YaguchiGr91FlowRule & m, py::array_t<double, py::array::c_style> s, py::array_t<double, py::array::c_style> alpha, double T) -> py::array_t<double>
+           {
+            auto f = alloc_mat<double>(6,m.nhist());
+            int ier = m.YaguchiGr91FlowRule::DualBase::dg_da(arr2ptr<double>(s), arr2ptr<double>(alpha), T, arr2ptr<double>(f));
+            py_error(ier);
+            return f;
+           }, "Automatic flow rule (rate) derivative with respect to history.")
+      .def("auto_dh_ds",
+           [](YaguchiGr91FlowRule & m, py::array_t<double, py::array::c_style> s, py::array_t<double, py::array::c_style> alpha, double T) -> py::array_t<double>
+           {
+            auto f = alloc_mat<double>(m.nhist(),6);
+            int ier = m.YaguchiGr91FlowRule::DualBase::dh_ds(arr2ptr<double>(s), arr2ptr<double>(alpha), T, arr2ptr<double>(f));
+            py_error(ier);
+            return f;
+           }, "Automatic hardening rule (rate) derivative with respect to stress.")
+      .def("auto_dh_da",
+           [](YaguchiGr91FlowRule & m, py::array_t<double, py::array::c_style> s, py::array_t<double, py::array::c_style> alpha, double T) -> py::array_t<double>
+           {
+            auto f = alloc_mat<double>(m.nhist(),m.nhist());
+            int ier = m.YaguchiGr91FlowRule::DualBase::dh_da(arr2ptr<double>(s), arr2ptr<double>(alpha), T, arr2ptr<double>(f));
+            py_error(ier);
+            return f;
+           }, "Automatic hardening rule (rate) derivative with respect to history.")
+      .def("auto_dh_ds_time",
+           [](YaguchiGr91FlowRule & m, py::array_t<double, py::array::c_style> s, py::array_t<double, py::array::c_style> alpha, double T) -> py::array_t<double>
+           {
+            auto f = alloc_mat<double>(m.nhist(),6);
+            int ier = m.YaguchiGr91FlowRule::DualBase::dh_ds_time(arr2ptr<double>(s), arr2ptr<double>(alpha), T, arr2ptr<double>(f));
+            py_error(ier);
+            return f;
+           }, "Automatic hardening rule (time) derivative with respect to stress.")
+      .def("auto_dh_da_time",
+           [](YaguchiGr91FlowRule & m, py::array_t<double, py::array::c_style> s, py::array_t<double, py::array::c_style> alpha, double T) -> py::array_t<double>
+           {
+            auto f = alloc_mat<double>(m.nhist(),m.nhist());
+            int ier = m.YaguchiGr91FlowRule::DualBase::dh_da_time(arr2ptr<double>(s), arr2ptr<double>(alpha), T, arr2ptr<double>(f));
+            py_error(ier);
+            return f;
+           }, "Automatic hardening rule (time) derivative with respect to history.")
       ;
 }
 
@@ -242,5 +242,37 @@ def differentiate(fn, x0, eps = 1.5e-6):
   else:
     return Df
 
+def strain_path(model, strains, times = None, T = 300.0, update = None):
+  """
+    Step a small strain model from zero through a list of strains
+
+    The steps are at times 1, 2, ... unless times are given, and use
+    update, with the arguments of update_sd, in place of model.update_sd
+    if given.  Yields the arguments and the results of each update.
+  """
+  if times is None:
+    times = [float(i) for i in range(1, len(strains)+1)]
+  if update is None:
+    update = model.update_sd
+
+  e_n = np.zeros((6,))
+  s_n = np.zeros((6,))
+  h_n = model.init_store()
+  t_n = 0.0
+  u_n = 0.0
+  p_n = 0.0
+  for e_np1, t_np1 in zip(strains, times):
+    args = (e_np1, e_n, T, T, t_np1, t_n, s_n, h_n, u_n, p_n)
+    res = update(*args)
+    yield args, res
+    e_n, t_n = e_np1, t_np1
+    s_n, h_n, u_n, p_n = res[0], res[1], res[3], res[4]
+
+def ramp(efinal, nsteps):
+  """
+    Strains for a proportional ramp to efinal in nsteps steps
+  """
+  return [efinal * i / nsteps for i in range(1, nsteps+1)]
+
 def make_dev(s):
   return s - np.array([1,1,1,0,0,0]) * np.sum(s[:3]) / 3.0
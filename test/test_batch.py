@@ -0,0 +1,123 @@
+import sys
+sys.path.append('..')
+
+from neml import models, elasticity, surfaces, hardening, visco_flow, general_flow
+from common import *
+
+import unittest
+import numpy as np
+import numpy.linalg as la
+
+class CommonBatch(object):
+  """
+    Batched updates have to match the point by point updates
+  """
+  def points(self, npts):
+    rng = np.random.RandomState(42)
+    self.T = 300.0
+    e_np1 = rng.uniform(-1.0, 1.0, (npts,6)) * self.emax
+    # A few elastic points
+    e_np1[::5] *= 1.0e-3
+    return e_np1
+
+  def compare(self, model, e_np1, e_n, s_n, h_n):
+    npts = e_np1.shape[0]
+    T = np.ones((npts,)) * self.T
+    u_n = np.zeros((npts,))
+    p_n = np.zeros((npts,))
+    s, h, A, u, p, ier = model.update_sd_batch(e_np1, e_n, T, T,
+        self.t_np1, self.t_n, s_n, h_n, u_n, p_n)
+    self.assertTrue(np.all(ier == 0))
+
+    for i in range(npts):
+      s1, h1, A1, u1, p1 = model.update_sd(e_np1[i], e_n[i], self.T, self.T,
+          self.t_np1, self.t_n, s_n[i], h_n[i], 0.0, 0.0)
+      self.assertTrue(np.allclose(s[i], s1, rtol = 1.0e-8))
+      self.assertTrue(np.allclose(h[i], h1, rtol = 1.0e-8))
+      self.assertTrue(np.allclose(A[i], A1, rtol = 1.0e-6))
+      self.assertTrue(np.isclose(u[i], u1, rtol = 1.0e-8))
+      self.assertTrue(np.isclose(p[i], p1, rtol = 1.0e-8))
+
+    return s, h
+
+  def test_first_step(self):
+    for npts in [1, 7, 8, 21]:
+      e_np1 = self.points(npts)
+      h_n = np.array([self.model.init_store() for i in range(npts)])
+      self.compare(self.model, e_np1, np.zeros((npts,6)), np.zeros((npts,6)),
+          h_n)
+
+  def test_second_step(self):
+    npts = 13
+    e_n = self.points(npts)
+    h_n = np.array([self.model.init_store() for i in range(npts)])
+    s_n, h_n = self.compare(self.model, e_n, np.zeros((npts,6)),
+        np.zeros((npts,6)), h_n)
+    self.t_n = self.t_np1
+    self.t_np1 = 2.0 * self.t_np1
+    self.compare(self.model, 1.5 * e_n, e_n, s_n, h_n)
+
+  def test_empty(self):
+    res = self.model.update_sd_batch(np.zeros((0,6)), np.zeros((0,6)),
+        np.zeros((0,)), np.zeros((0,)), 1.0, 0.0, np.zeros((0,6)),
+        np.zeros((0,self.model.nstore)), np.zeros((0,)), np.zeros((0,)))
+    self.assertEqual(len(res[-1]), 0)
+
+class TestBatchPerfect(CommonBatch, unittest.TestCase):
+  def setUp(self):
+    elastic = elasticity.IsotropicLinearElasticModel(150000.0, "youngs",
+        0.3, "poissons")
+    self.model = models.SmallStrainPerfectPlasticity(elastic,
+        surfaces.IsoJ2(), 200.0)
+    self.emax = 0.01
+    self.t_n = 0.0
+    self.t_np1 = 1.0
+
+  def test_failures(self):
+    # Points the scalar update cannot do fail the same way in the batch
+    elastic = elasticity.IsotropicLinearElasticModel(150000.0, "youngs",
+        0.3, "poissons")
+    model = models.SmallStrainPerfectPlasticity(elastic,
+        surfaces.IsoJ2I1(1.0, 2.0), 200.0, miter = 3)
+    npts = 9
+    e_np1 = self.points(npts)
+    T = np.ones((npts,)) * self.T
+    h_n = np.array([model.init_store() for i in range(npts)])
+    s, h, A, u, p, ier = model.update_sd_batch(e_np1, np.zeros((npts,6)),
+        T, T, self.t_np1, self.t_n, np.zeros((npts,6)), h_n,
+        np.zeros((npts,)), np.zeros((npts,)))
+    self.assertTrue(np.any(ier != 0))
+    self.assertTrue(np.any(ier == 0))
+
+    for i in range(npts):
+      if ier[i] != 0:
+        with self.assertRaises(Exception):
+          model.update_sd(e_np1[i], np.zeros((6,)), self.T, self.T,
+              self.t_np1, self.t_n, np.zeros((6,)), h_n[i], 0.0, 0.0)
+      else:
+        s1 = model.update_sd(e_np1[i], np.zeros((6,)), self.T, self.T,
+            self.t_np1, self.t_n, np.zeros((6,)), h_n[i], 0.0, 0.0)[0]
+        self.assertTrue(np.allclose(s[i], s1))
+
+class TestBatchGeneral(CommonBatch, unittest.TestCase):
+  def setUp(self):
+    elastic = elasticity.IsotropicLinearElasticModel(92000.0, "youngs",
+        0.3, "poissons")
+    surface = surfaces.IsoJ2()
+    hrule = hardening.VoceIsotropicHardeningRule(100.0, 150.0, 10.0)
+    vmodel = visco_flow.PerzynaFlowRule(surface, hrule,
+        visco_flow.GPowerLaw(3.0, 500.0))
+    flow = general_flow.TVPFlowRule(elastic, vmodel)
+    self.model = models.GeneralIntegrator(elastic, flow)
+    self.trap = models.GeneralIntegrator(elastic, flow,
+        scheme = "trapezoidal")
+    self.emax = 0.005
+    self.t_n = 0.0
+    self.t_np1 = 10.0
+
+  def test_scheme(self):
+    npts = 5
+    e_np1 = self.points(npts)
+    h_n = np.array([self.trap.init_store() for i in range(npts)])
+    self.compare(self.trap, e_np1, np.zeros((npts,6)), np.zeros((npts,6)),
+        h_n)
@@ -0,0 +1,150 @@
+import sys
+sys.path.append('..')
+
+from neml import capture, parse, models, elasticity, surfaces
+from common import *
+
+import unittest
+import tempfile
+import os
+import numpy as np
+
+class TestCapture(unittest.TestCase):
+  """
+    Recording the inputs to material point updates
+  """
+  def setUp(self):
+    self.fname = "test/examples.xml"
+    self.model = parse.parse_xml(self.fname, "test_j2iso")
+    capture.capture_model(self.model, self.fname, "test_j2iso")
+    self.T = 300.0
+    self.efinal = np.array([0.01,-0.005,-0.005,0.002,0,0])
+    fd, self.log = tempfile.mkstemp(suffix = ".log")
+    os.close(fd)
+
+  def tearDown(self):
+    capture.stop_capture()
+    os.remove(self.log)
+
+  def path(self, model, nsteps = 10):
+    update = lambda *args: capture.captured_update_sd(model, *args)
+    return [res[0] for args, res in strain_path(model,
+      ramp(self.efinal, nsteps), T = self.T, update = update)]
+
+  def test_all(self):
+    capture.start_capture(self.log)
+    self.assertTrue(capture.capturing())
+    stresses = self.path(self.model)
+    capture.stop_capture()
+    self.assertFalse(capture.capturing())
+
+    names, records = capture.read_capture(self.log)
+    self.assertEqual(len(names), 1)
+    self.assertEqual(names[0].fname, self.fname)
+    self.assertEqual(names[0].mname, "test_j2iso")
+    self.assertEqual(len(records), 10)
+    for i, (rec, s) in enumerate(zip(records, stresses)):
+      self.assertFalse(rec.large)
+      self.assertEqual(rec.id, 0)
+      self.assertEqual(rec.ier, 0)
+      self.assertTrue(np.array_equal(rec.e_np1, self.efinal * (i+1) / 10))
+      self.assertTrue(np.array_equal(rec.s_np1, s))
+      self.assertEqual(len(rec.h_n), self.model.nstore)
+
+  def test_replay(self):
+    capture.start_capture(self.log)
+    self.path(self.model)
+    capture.stop_capture()
+
+    names, records = capture.read_capture(self.log)
+    model = parse.parse_xml(names[0].fname, names[0].mname)
+    for rec in records:
+      s_np1 = model.update_sd(rec.e_np1, rec.e_n, rec.T_np1, rec.T_n,
+          rec.t_np1, rec.t_n, rec.s_n, rec.h_n, rec.u_n, rec.p_n)[0]
+      self.assertTrue(np.array_equal(s_np1, rec.s_np1))
+
+  def test_sampled(self):
+    capture.start_capture(self.log, 0.5, 1)
+    self.path(self.model, 200)
+    capture.stop_capture()
+    n = len(capture.read_capture(self.log)[1])
+    self.assertTrue(60 < n < 140)
+
+    # The same calls each time
+    capture.start_capture(self.log, 0.5, 1)
+    self.path(self.model, 200)
+    capture.stop_capture()
+    self.assertEqual(len(capture.read_capture(self.log)[1]), n)
+
+  def test_sampled_order(self):
+    # The choice follows the update, not the order of the calls
+    updates = [args for args, res in strain_path(self.model,
+      ramp(self.efinal, 200), T = self.T)]
+
+    capture.start_capture(self.log, 0.5, 1)
+    for args in updates:
+      capture.captured_update_sd(self.model, *args)
+    capture.stop_capture()
+    forward = sorted(rec.t_np1 for rec in capture.read_capture(self.log)[1])
+
+    capture.start_capture(self.log, 0.5, 1)
+    for args in reversed(updates):
+      capture.captured_update_sd(self.model, *args)
+    capture.stop_capture()
+    backward = sorted(rec.t_np1 for rec in capture.read_capture(self.log)[1])
+
+    self.assertTrue(0 < len(forward) < 200)
+    self.assertEqual(forward, backward)
+
+  def test_forget(self):
+    capture.capture_forget_model(self.model)
+    capture.start_capture(self.log)
+    self.path(self.model, 1)
+    capture.stop_capture()
+    names, records = capture.read_capture(self.log)
+    self.assertEqual(names[records[0].id].mname, "")
+
+  def test_failures(self):
+    # Failures are kept even when nothing else is
+    elastic = elasticity.IsotropicLinearElasticModel(150000.0, "youngs",
+        0.3, "poissons")
+    model = models.SmallStrainPerfectPlasticity(elastic,
+        surfaces.IsoJ2I1(1.0, 2.0), 200.0, miter = 3)
+    capture.start_capture(self.log, 0.0)
+    self.path(self.model)
+    with self.assertRaises(Exception):
+      capture.captured_update_sd(model, np.array([0.01,0.01,0.01,0,0,0]),
+          np.zeros((6,)), self.T, self.T, 1.0, 0.0, np.zeros((6,)),
+          model.init_store(), 0.0, 0.0)
+    capture.stop_capture()
+
+    names, records = capture.read_capture(self.log)
+    self.assertEqual(len(records), 1)
+    self.assertNotEqual(records[0].ier, 0)
+    self.assertEqual(names[records[0].id].mname, "")
+
+  def test_large(self):
+    capture.start_capture(self.log)
+    d = np.array([0.01,0,0,0,0,0])
+    w = np.array([0.0,0.0,0.01])
+    capture.captured_update_ld_inc(self.model, d, np.zeros((6,)), w,
+        np.zeros((3,)), self.T, self.T, 1.0, 0.0, np.zeros((6,)),
+        self.model.init_store(), 0.0, 0.0)
+    capture.stop_capture()
+
+    names, records = capture.read_capture(self.log)
+    self.assertEqual(len(records), 1)
+    self.assertTrue(records[0].large)
+    self.assertTrue(np.array_equal(records[0].e_np1, d))
+
+  def test_off(self):
+    self.path(self.model)
+    capture.start_capture(self.log)
+    capture.stop_capture()
+    self.assertEqual(len(capture.read_capture(self.log)[1]), 0)
+
+  def test_bad_file(self):
+    with open(self.log, "w") as f:
+      f.write("not a log")
+    with self.assertRaises(Exception):
+      capture.read_capture(self.log)
@@ -0,0 +1,132 @@
+import sys
+sys.path.append('..')
+
+from neml import models, elasticity, surfaces, hardening, ri_flow, parse, interpolate
+from common import *
+
+import unittest
+import numpy as np
+
+class TestStaticCost(unittest.TestCase):
+  """
+    Static cost estimates of each class of model
+  """
+  def setUp(self):
+    self.fname = "test/examples.xml"
+
+  def model(self, name):
+    return parse.parse_xml(self.fname, name)
+
+  def test_elastic(self):
+    elastic = elasticity.IsotropicLinearElasticModel(200000.0, "youngs",
+        0.3, "poissons")
+    model = models.SmallStrainElasticity(elastic)
+    self.assertTrue(np.isclose(model.cost, 1.0))
+    self.assertTrue(np.isclose(model.iteration_cost, 0.0))
+
+  def test_ordering(self):
+    elastic = elasticity.IsotropicLinearElasticModel(200000.0, "youngs",
+        0.3, "poissons")
+    c_elastic = models.SmallStrainElasticity(elastic).cost
+    c_j2 = self.model("test_j2iso").cost
+    c_chaboche = self.model("test_nonassri").cost
+    c_creep = self.model("test_creep_plasticity").cost
+    self.assertTrue(c_elastic < c_j2)
+    self.assertTrue(c_j2 < c_chaboche)
+    self.assertTrue(c_j2 < c_creep)
+
+  def test_solve_cost(self):
+    model = self.model("test_nonassri")
+    self.assertTrue(np.isclose(model.cost,
+      models.solve_cost(model.iteration_cost)))
+    self.assertTrue(np.isclose(model.iteration_cost,
+      models.newton_cost(model.nparams)))
+    self.assertTrue(np.isclose(model.update_cost(0), 1.0))
+
+  def test_point_cost(self):
+    model = self.model("test_j2iso")
+    self.assertTrue(np.isclose(model.point_cost(model.init_store()),
+      model.cost))
+
+class TestCostTrackingModel(unittest.TestCase):
+  """
+    Learning the cost of each point from its updates
+  """
+  def setUp(self):
+    self.elastic = elasticity.IsotropicLinearElasticModel(200000.0, "youngs",
+        0.3, "poissons")
+    surface = surfaces.IsoJ2()
+    iso = hardening.LinearIsotropicHardeningRule(100.0, 2500.0)
+    self.flow = ri_flow.RateIndependentAssociativeFlow(surface, iso)
+    self.base = models.SmallStrainRateIndependentPlasticity(self.elastic,
+        self.flow)
+    self.model = models.CostTrackingModel(self.elastic, self.base,
+        weight = 0.5)
+
+    self.T = 300.0
+    self.direction = np.array([1.0,-0.5,-0.5,0,0,0])
+
+  def path(self, model, strains):
+    h = model.init_store()
+    s = np.zeros((6,))
+    e_n = np.zeros((6,))
+    res = []
+    for i, e in enumerate(strains):
+      e_np1 = e * self.direction
+      r = model.update_sd(e_np1, e_n, self.T, self.T, float(i+1), float(i),
+          s, h, 0.0, 0.0)
+      res.append(r)
+      s, h = r[:2]
+      e_n = e_np1
+    return res
+
+  def test_history(self):
+    self.assertEqual(self.model.nhist, self.base.nhist + 1)
+    h = self.model.init_store()
+    self.assertTrue(np.allclose(h[:self.base.nhist],
+      self.base.init_store()[:self.base.nhist]))
+    self.assertTrue(np.isclose(self.model.point_cost(h), self.base.cost))
+    self.assertTrue(np.isclose(self.model.cost, self.base.cost))
+
+  def test_forwarded(self):
+    base = models.SmallStrainRateIndependentPlasticity(self.elastic,
+        self.flow, alpha = interpolate.ConstantInterpolate(1.0e-5))
+    other = elasticity.IsotropicLinearElasticModel(50000.0, "youngs",
+        0.25, "poissons")
+    model = models.CostTrackingModel(other, base)
+
+    self.assertTrue(np.isclose(model.alpha(self.T), base.alpha(self.T)))
+    self.assertTrue(np.isclose(model.bulk(self.T), base.bulk(self.T)))
+    self.assertTrue(np.isclose(model.shear(self.T), base.shear(self.T)))
+
+    s = np.array([100.0,-50.0,20.0,10.0,0,5.0])
+    self.assertTrue(np.allclose(
+      model.elastic_strains(s, self.T, model.init_store()),
+      base.elastic_strains(s, self.T, base.init_store())))
+
+  def test_same_response(self):
+    strains = np.linspace(0, 0.01, 11)[1:]
+    r1 = self.path(self.base, strains)
+    r2 = self.path(self.model, strains)
+    nh = self.base.nhist
+    for a, b in zip(r1, r2):
+      self.assertTrue(np.allclose(a[0], b[0]))
+      self.assertTrue(np.allclose(a[1][:nh], b[1][:nh]))
+      self.assertTrue(np.allclose(a[2], b[2]))
+
+  def test_learns(self):
+    # Elastic steps decay toward the elastic cost
+    elastic = self.path(self.model, np.linspace(0, 1.0e-5, 21)[1:])
+    c_elastic = self.model.point_cost(elastic[-1][1])
+    self.assertTrue(c_elastic < self.base.cost)
+    self.assertTrue(np.isclose(c_elastic, 1.0, rtol = 1.0e-4))
+
+    # Plastic steps cost more
+    plastic = self.path(self.model, np.linspace(0, 0.02, 21)[1:])
+    c_plastic = self.model.point_cost(plastic[-1][1])
+    self.assertTrue(c_plastic > c_elastic)
+    self.assertTrue(c_plastic > 1.0 + self.base.iteration_cost)
+
+  def test_weight(self):
+    with self.assertRaises(Exception):
+      models.CostTrackingModel(self.elastic, self.base, weight = 0.0)
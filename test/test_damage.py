@@ -438,3 +438,105 @@ class TestCombinedDamage(unittest.TestCase, CommonScalarDamageModel,
     self.nsteps = 10
     self.etarget = np.array([0.1,-0.025,0.02,0.015,-0.02,-0.05])
     self.ttarget = 10.0
+
+class TestFailedDamage(unittest.TestCase):
+  def setUp(self):
+    self.elastic = elasticity.IsotropicLinearElasticModel(92000.0, "youngs",
+        0.3, "poissons")
+    surface = surfaces.IsoKinJ2()
+    iso = hardening.LinearIsotropicHardeningRule(180.0, 1000.0)
+    kin = hardening.LinearKinematicHardeningRule(1000.0)
+    hrule = hardening.CombinedHardeningRule(iso, kin)
+    flow = ri_flow.RateIndependentAssociativeFlow(surface, hrule)
+    self.bmodel = models.SmallStrainRateIndependentPlasticity(self.elastic, 
+        flow)
+
+    self.w_fail = 0.5
+    self.model = damage.NEMLPowerLawDamagedModel_sd(self.elastic, 8.0e-6,
+        2.2, self.bmodel, w_fail = self.w_fail)
+    self.T = 300.0
+
+  def test_initial(self):
+    self.assertFalse(self.model.failed(self.model.init_store()))
+
+  def test_failed_update(self):
+    h_n = self.model.init_store()
+    h_n[0] = 0.6
+    h_n[3] = 0.01
+    self.assertTrue(self.model.failed(h_n))
+
+    e_n = np.array([0.05,-0.02,-0.02,0.01,0,0])
+    e_np1 = e_n + np.array([0.001,0,-0.0005,0,0.0002,0])
+    s_n = np.array([10.0,-5.0,2.0,1.0,0,0])
+    s_np1, h_np1, A_np1, u_np1, p_np1 = self.model.update_sd(e_np1, e_n,
+        self.T, self.T, 1.0, 0.0, s_n, h_n, 0.0, 1.0)
+
+    C = (1.0 - 0.6) * self.elastic.C(self.T)
+    self.assertTrue(np.allclose(A_np1, C))
+    self.assertTrue(np.allclose(s_np1, s_n + np.dot(C, e_np1 - e_n)))
+    self.assertTrue(np.allclose(h_np1[:self.model.nhist],
+      h_n[:self.model.nhist]))
+    self.assertTrue(np.isclose(p_np1, 1.0))
+
+  def test_path(self):
+    etarget = np.array([0.2,-0.1,-0.1,0,0,0])
+    nfailed = 0
+    for args, res in strain_path(self.model, ramp(etarget, 100), T = self.T):
+      h_n, h_np1 = args[7], res[1]
+      if self.model.failed(h_n):
+        nfailed += 1
+        self.assertTrue(np.isclose(h_np1[0], h_n[0]))
+    h_n = h_np1
+
+    self.assertTrue(nfailed > 0)
+    self.assertTrue(self.model.failed(h_n))
+    self.assertTrue(h_n[0] >= self.w_fail)
+
+class TestBaseUpdate(unittest.TestCase):
+  """
+    The base model is updated once per step, not once per damage iteration
+  """
+  def setUp(self):
+    self.elastic = elasticity.IsotropicLinearElasticModel(92000.0, "youngs",
+        0.3, "poissons")
+    surface = surfaces.IsoKinJ2()
+    iso = hardening.LinearIsotropicHardeningRule(180.0, 1000.0)
+    kin = hardening.LinearKinematicHardeningRule(1000.0)
+    hrule = hardening.CombinedHardeningRule(iso, kin)
+    flow = ri_flow.RateIndependentAssociativeFlow(surface, hrule)
+    self.bmodel = models.SmallStrainRateIndependentPlasticity(self.elastic, 
+        flow)
+    self.cached = models.MemoizedModel(self.elastic, self.bmodel)
+    self.T = 300.0
+
+  def check(self, model, cmodel):
+    e_np1 = np.array([0.02,-0.01,-0.01,0.005,0,0])
+    self.cached.clear_cache()
+    h_n = model.init_store()
+    r1 = model.update_sd(e_np1, np.zeros((6,)), self.T, self.T, 10.0, 0.0,
+        np.zeros((6,)), h_n, 0.0, 0.0)
+    r2 = cmodel.update_sd(e_np1, np.zeros((6,)), self.T, self.T, 10.0, 0.0,
+        np.zeros((6,)), h_n, 0.0, 0.0)
+    self.assertTrue(r1[0][0] > 0.0)
+    self.assertTrue(r1[1][0] > 0.0)
+    for a, b in zip(r1, r2):
+      self.assertTrue(np.allclose(a, b))
+
+    stats = self.cached.cache_stats()
+    self.assertEqual(stats.misses, 1)
+    self.assertEqual(stats.hits, 0)
+
+  def test_power_law(self):
+    self.check(
+        damage.NEMLPowerLawDamagedModel_sd(self.elastic, 8.0e-6, 2.2,
+          self.bmodel),
+        damage.NEMLPowerLawDamagedModel_sd(self.elastic, 8.0e-6, 2.2,
+          self.cached))
+
+  def test_combined(self):
+    def make(base):
+      d1 = damage.NEMLPowerLawDamagedModel_sd(self.elastic, 8.0e-6, 2.2, base)
+      d2 = damage.ClassicalCreepDamageModel_sd(self.elastic, 1.0e7, 0.478,
+          1.914, base)
+      return damage.CombinedDamageModel_sd(self.elastic, [d1, d2], base)
+    self.check(make(self.bmodel), make(self.cached))
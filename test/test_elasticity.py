@@ -39,6 +39,29 @@ class TestIsotropicConstantModel(CommonElasticity, unittest.TestCase):
     self.assertTrue(np.isclose(S[0,1], -nu/E))
     self.assertTrue(np.isclose(S[3,3], (1+nu)/E))
 
+  def test_constant(self):
+    self.assertTrue(self.model.constant)
+
+class TestIsotropicTemperatureModel(CommonElasticity, unittest.TestCase):
+  def setUp(self):
+    self.mu = interpolate.PolynomialInterpolate([-10.0, 32000.0])
+    self.nu = 0.3
+    self.T = 325.0
+
+    self.model = elasticity.IsotropicLinearElasticModel(self.mu,
+        "shear", self.nu, "poissons")
+
+  def test_constant(self):
+    self.assertFalse(self.model.constant)
+
+  def test_modulii(self):
+    for T in [300.0, 600.0]:
+      self.assertTrue(np.isclose(self.model.G(T), self.mu(T)))
+      self.assertTrue(np.isclose(self.model.nu(T), self.nu))
+      S = self.model.S(T)
+      E = 2.0 * self.mu(T) * (1.0 + self.nu)
+      self.assertTrue(np.isclose(S[0,0], 1/E))
+
 
 class TestEquivalentDefinitions(unittest.TestCase):
   def setUp(self):
@@ -0,0 +1,110 @@
+import sys
+sys.path.append('..')
+
+from neml import models, elasticity, surfaces, hardening, visco_flow, general_flow, creep
+from common import *
+
+import unittest
+import numpy as np
+import numpy.linalg as la
+
+class TestExplicitGeneralIntegrator(unittest.TestCase):
+  """
+    Explicit Cash-Karp integration of the general flow rules
+  """
+  def setUp(self):
+    self.elastic = elasticity.IsotropicLinearElasticModel(92000.0, "youngs",
+        0.3, "poissons")
+    surface = surfaces.IsoJ2()
+    hrule = hardening.LinearIsotropicHardeningRule(0.0, 1000.0)
+    vmodel = visco_flow.PerzynaFlowRule(surface, hrule,
+        visco_flow.GPowerLaw(3.0, 2000.0))
+    self.flow = general_flow.TVPFlowRule(self.elastic, vmodel)
+    self.T = 300.0
+
+  def make(self, **kwargs):
+    return models.GeneralIntegrator(self.elastic, self.flow, **kwargs)
+
+  def hold(self, model, nsteps):
+    efinal = np.array([0.01,-0.005,-0.005,0,0,0])
+    times = list(np.linspace(0, 1.0, 11)[1:]) + list(
+        1.0 + np.linspace(0, 100.0, nsteps+1)[1:])
+
+    strains = [efinal * min(t, 1.0) for t in times]
+    for args, res in strain_path(model, strains, times = times, T = self.T):
+      pass
+
+    return res[0], res[2]
+
+  def test_accuracy(self):
+    ref = self.hold(self.make(scheme = "explicit", etol = 1.0e-10), 100)[0]
+    be = self.hold(self.make(), 5)[0]
+    ex = self.hold(self.make(scheme = "explicit"), 5)[0]
+    self.assertTrue(la.norm(ex - ref) < la.norm(be - ref) / 100.0)
+
+  def test_fallback(self):
+    # The stability guard only allows two substeps, so this stiff step
+    # goes to backward Euler
+    e_np1 = np.array([0.01,-0.005,-0.005,0,0,0])
+    res = []
+    for model in [self.make(max_divide = 1),
+        self.make(scheme = "explicit", max_divide = 1)]:
+      res.append(model.update_sd(e_np1, np.zeros((6,)), self.T, self.T,
+        100.0, 0.0, np.zeros((6,)), model.init_store(), 0.0, 0.0))
+    self.assertTrue(np.allclose(res[0][0], res[1][0], rtol = 1.0e-12))
+    self.assertTrue(np.allclose(res[0][2], res[1][2]))
+
+  def test_tangent(self):
+    s, A = self.hold(self.make(scheme = "explicit"), 5)
+    self.assertTrue(np.allclose(A, self.elastic.C(self.T)))
+
+  def test_elastic(self):
+    model = self.make(scheme = "explicit")
+    e_np1 = np.array([0.001,0,0,0,0,0.0005])
+    s_np1, h_np1, A_np1, u_np1, p_np1 = model.update_sd(e_np1,
+        np.zeros((6,)), self.T, self.T, 1.0e-3, 0.0, np.zeros((6,)),
+        model.init_store(), 0.0, 0.0)
+    self.assertTrue(np.allclose(s_np1, np.dot(self.elastic.C(self.T), e_np1),
+      rtol = 1.0e-4))
+
+class TestExplicitCreepPlasticity(unittest.TestCase):
+  """
+    Explicit integration of the creep strain
+  """
+  def setUp(self):
+    self.elastic = elasticity.IsotropicLinearElasticModel(92000.0, "youngs",
+        0.3, "poissons")
+    self.plastic = models.SmallStrainPerfectPlasticity(self.elastic,
+        surfaces.IsoJ2(), 300.0)
+    self.creep = creep.J2CreepModel(creep.PowerLawCreep(1.0e-12, 4.0))
+    self.T = 300.0
+    self.efinal = np.array([0.0025,-0.001,-0.001,0.0005,0,0])
+    self.tfinal = 1000.0
+
+  def make(self, **kwargs):
+    return models.SmallStrainCreepPlasticity(self.elastic, self.plastic,
+        self.creep, **kwargs)
+
+  def ramp(self, model, nsteps):
+    for args, res in strain_path(model, ramp(self.efinal, nsteps),
+        times = ramp(self.tfinal, nsteps), T = self.T):
+      pass
+
+    return res[0], res[1], res[2]
+
+  def test_accuracy(self):
+    ref = self.ramp(self.make(), 4000)[0]
+    be = self.ramp(self.make(), 10)[0]
+    ex = self.ramp(self.make(explicit = True), 10)[0]
+    self.assertTrue(la.norm(ex - ref) < la.norm(be - ref) / 100.0)
+
+  def test_fallback(self):
+    self.tfinal = 1.0e6
+    s1, h1, A1 = self.ramp(self.make(), 2)
+    s2, h2, A2 = self.ramp(self.make(explicit = True, max_divide = 1), 2)
+    self.assertTrue(np.allclose(s1, s2, rtol = 1.0e-12))
+    self.assertTrue(np.allclose(A1, A2))
+
+  def test_tangent(self):
+    s, h, A = self.ramp(self.make(explicit = True), 10)
+    self.assertTrue(np.allclose(A, self.elastic.C(self.T)))
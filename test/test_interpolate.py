@@ -27,6 +27,16 @@ class TestPolynomialInterpolate(unittest.TestCase, BaseInterpolate):
     self.assertTrue(np.isclose(np.polyval(self.coefs, self.x),
       self.interpolate(self.x)))
 
+  def test_constant(self):
+    self.assertFalse(self.interpolate.constant)
+    folded = interpolate.PolynomialInterpolate([2.0])
+    self.assertTrue(folded.constant)
+    self.assertTrue(np.isclose(folded(100.0), 2.0))
+    self.assertTrue(np.isclose(folded.derivative(100.0), 0.0))
+    empty = interpolate.PolynomialInterpolate([])
+    self.assertTrue(empty.constant)
+    self.assertTrue(np.isclose(empty(100.0), 0.0))
+
 class TestPiecewiseLinearInterpolate(unittest.TestCase, BaseInterpolate):
   def setUp(self):
     self.validx = [-10.0, -2.0, 1.0, 2.0, 5.0, 15.0]
@@ -49,6 +59,14 @@ class TestPiecewiseLinearInterpolate(unittest.TestCase, BaseInterpolate):
     self.assertFalse(self.invalid1.valid)
     self.assertFalse(self.invalid2.valid)
 
+  def test_constant(self):
+    self.assertFalse(self.valid.constant)
+    folded = interpolate.PiecewiseLinearInterpolate(self.validx,
+      [3.0] * len(self.validx))
+    self.assertTrue(folded.constant)
+    for x in [-20.0, 0.0, 20.0]:
+      self.assertTrue(np.isclose(folded(x), 3.0))
+
   def test_interpolate(self):
     testinter = inter.interp1d(self.validx, self.points,
         bounds_error = False)
@@ -123,6 +141,9 @@ class TestConstantInterpolate(unittest.TestCase, BaseInterpolate):
   def test_interpolate(self):
     self.assertTrue(np.isclose(self.v, self.interpolate(self.x)))
 
+  def test_constant(self):
+    self.assertTrue(self.interpolate.constant)
+
 class TestExpInterpolate(unittest.TestCase, BaseInterpolate):
   def setUp(self):
     self.A = 1.2
@@ -0,0 +1,113 @@
+import sys
+sys.path.append('..')
+
+from neml import models, elasticity, surfaces, hardening, visco_flow, general_flow, interpolate
+from common import *
+
+import unittest
+import numpy as np
+import numpy.linalg as la
+
+class TestMemoizedModel(unittest.TestCase):
+  """
+    Caching repeated stress updates
+  """
+  def setUp(self):
+    self.elastic = elasticity.IsotropicLinearElasticModel(92000.0, "youngs",
+        0.3, "poissons")
+    surface = surfaces.IsoJ2()
+    hrule = hardening.VoceIsotropicHardeningRule(180.0, 150.0, 10.0)
+    vmodel = visco_flow.PerzynaFlowRule(surface, hrule,
+        visco_flow.GPowerLaw(2.0, 200.0))
+    self.flow = general_flow.TVPFlowRule(self.elastic, vmodel)
+    self.base = models.GeneralIntegrator(self.elastic, self.flow)
+    self.model = models.MemoizedModel(self.elastic, self.base)
+
+    self.T = 300.0
+    self.e_np1 = np.array([0.01,-0.005,0,0.002,0,0])
+
+  def update(self, model, e_np1, h_n = None):
+    if h_n is None:
+      h_n = model.init_store()
+    return model.update_sd(e_np1, np.zeros((6,)), self.T, self.T, 1.0, 0.0,
+        np.zeros((6,)), h_n, 0.0, 0.0)
+
+  def test_history(self):
+    self.assertEqual(self.model.nhist, self.base.nhist)
+    self.assertTrue(np.allclose(self.model.init_store(),
+      self.base.init_store()))
+
+  def test_forwarded(self):
+    base = models.GeneralIntegrator(self.elastic, self.flow,
+        alpha = interpolate.ConstantInterpolate(1.0e-5))
+    other = elasticity.IsotropicLinearElasticModel(50000.0, "youngs",
+        0.25, "poissons")
+    model = models.MemoizedModel(other, base)
+
+    self.assertTrue(np.isclose(model.alpha(self.T), base.alpha(self.T)))
+    self.assertTrue(np.isclose(model.bulk(self.T), base.bulk(self.T)))
+    self.assertTrue(np.isclose(model.shear(self.T), base.shear(self.T)))
+
+    s = np.array([100.0,-50.0,20.0,10.0,0,5.0])
+    h = base.init_store()
+    self.assertTrue(np.allclose(model.elastic_strains(s, self.T, h),
+      base.elastic_strains(s, self.T, h)))
+
+  def test_path(self):
+    strains = ramp(self.e_np1, 10)
+    for (a1, r1), (a2, r2) in zip(
+        strain_path(self.base, strains, T = self.T),
+        strain_path(self.model, strains, T = self.T)):
+      for a, b in zip(r1, r2):
+        self.assertTrue(np.array_equal(a, b))
+
+  def test_hit(self):
+    self.model.clear_cache()
+    r1 = self.update(self.model, self.e_np1)
+    r2 = self.update(self.model, self.e_np1)
+    for a, b in zip(r1, r2):
+      self.assertTrue(np.array_equal(a, b))
+
+    stats = self.model.cache_stats()
+    self.assertEqual(stats.hits, 1)
+    self.assertEqual(stats.misses, 1)
+
+  def test_bitwise(self):
+    self.model.clear_cache()
+    self.update(self.model, self.e_np1)
+    e_np1 = np.copy(self.e_np1)
+    e_np1[0] = np.nextafter(e_np1[0], 1.0)
+    self.update(self.model, e_np1)
+
+    stats = self.model.cache_stats()
+    self.assertEqual(stats.hits, 0)
+    self.assertEqual(stats.misses, 2)
+
+  def test_eviction(self):
+    model = models.MemoizedModel(self.elastic, self.base, size = 1)
+    self.update(model, self.e_np1)
+    self.update(model, self.e_np1 * 2)
+    self.update(model, self.e_np1)
+
+    stats = model.cache_stats()
+    self.assertEqual(stats.hits, 0)
+    self.assertEqual(stats.misses, 3)
+    self.assertEqual(stats.evictions, 2)
+
+  def test_clear(self):
+    self.update(self.model, self.e_np1)
+    self.model.clear_cache()
+    stats = self.model.cache_stats()
+    self.assertEqual(stats.hits + stats.misses, 0)
+    self.update(self.model, self.e_np1)
+    self.assertEqual(self.model.cache_stats().misses, 1)
+
+  def test_separate(self):
+    other = models.MemoizedModel(self.elastic, self.base)
+    self.update(self.model, self.e_np1)
+    self.update(other, self.e_np1)
+    self.assertEqual(other.cache_stats().hits, 0)
+
+  def test_size(self):
+    with self.assertRaises(Exception):
+      models.MemoizedModel(self.elastic, self.base, size = 0)
@@ -328,10 +328,10 @@ class TestRIChebocheLinear(unittest.TestCase, CommonMatModel, CommonJacobian):
     hmodel = hardening.Chaboche(iso, self.cs, self.gmodels, 
         self.As, self.ns)
 
-    flow = ri_flow.RateIndependentNonAssociativeHardening(surface, hmodel)
+    self.flow = ri_flow.RateIndependentNonAssociativeHardening(surface, hmodel)
 
-    self.model = models.SmallStrainRateIndependentPlasticity(self.elastic, flow,
-        check_kt = False)
+    self.model = models.SmallStrainRateIndependentPlasticity(self.elastic,
+        self.flow, check_kt = False)
 
     self.efinal = np.array([0.1,-0.05,0.02,-0.03,0.1,-0.15])
     self.tfinal = 10.0
@@ -348,6 +348,15 @@ class TestRIChebocheLinear(unittest.TestCase, CommonMatModel, CommonJacobian):
   def gen_x(self):
     return np.array(list(self.gen_hist()) + [0.1])
 
+class TestRIChebocheCuttingPlane(TestRIChebocheLinear):
+  """
+    Test Cheboche with the cutting plane return
+  """
+  def setUp(self):
+    super(TestRIChebocheCuttingPlane, self).setUp()
+    self.model = models.SmallStrainRateIndependentPlasticity(self.elastic,
+        self.flow, check_kt = False, algorithm = "cutting_plane")
+
 # Something funny with the Jacobian here
 class TestCreepPlasticityJ2LinearPowerLaw(unittest.TestCase, CommonMatModel):
   """
@@ -678,3 +687,181 @@ class TestKMSwitch(unittest.TestCase, CommonMatModel):
     h = np.array([40.0,20,-30,40.0,5.0,2.0,40.0])
     h[:6] = make_dev(h[:6])
     return h
+
+class TestResidualScaling(unittest.TestCase):
+  """
+    Automatic scaling of the residual equations by the elastic modulus
+  """
+  def setUp(self):
+    self.E = 92000.0
+    self.nu = 0.3
+
+    self.elastic = elasticity.IsotropicLinearElasticModel(self.E, "youngs",
+        self.nu, "poissons")
+
+    surface = surfaces.IsoJ2()
+    hrule = hardening.VoceIsotropicHardeningRule(180.0, 150.0, 10.0)
+    g = visco_flow.GPowerLaw(2.0, 200.0)
+    vmodel = visco_flow.PerzynaFlowRule(surface, hrule, g)
+    self.flow = general_flow.TVPFlowRule(self.elastic, vmodel)
+
+    self.efinal = np.array([0.05,0,0,0.02,0,-0.01])
+    self.tfinal = 10.0
+    self.T = 300.0
+    self.nsteps = 20
+
+  def run_model(self, model):
+    stresses = []
+    histories = []
+    for args, res in strain_path(model, ramp(self.efinal, self.nsteps),
+        times = ramp(self.tfinal, self.nsteps), T = self.T,
+        update = model.update_sd_scale):
+      stresses.append(res[0])
+      histories.append(res[1])
+    return np.array(stresses), np.array(histories)
+
+  def test_default_scales(self):
+    model = models.GeneralIntegrator(self.elastic, self.flow)
+    ts = model.make_trial_state(self.efinal / self.nsteps, np.zeros((6,)),
+        self.T, self.T, self.tfinal / self.nsteps, 0.0, np.zeros((6,)),
+        model.init_store())
+    self.assertTrue(np.allclose(model.residual_scales(ts), 1.0))
+
+  def test_auto_scales(self):
+    model = models.GeneralIntegrator(self.elastic, self.flow, auto_scale = True)
+    ts = model.make_trial_state(self.efinal / self.nsteps, np.zeros((6,)),
+        self.T, self.T, self.tfinal / self.nsteps, 0.0, np.zeros((6,)),
+        model.init_store())
+    scales = model.residual_scales(ts)
+    self.assertTrue(np.allclose(scales[:6], 1.0 / self.E))
+    self.assertTrue(np.allclose(scales[6:], 1.0))
+
+  def test_perfect_scales(self):
+    model = models.SmallStrainPerfectPlasticity(self.elastic, surfaces.IsoJ2(),
+        180.0, auto_scale = True)
+    ts = model.make_trial_state(self.efinal / self.nsteps, np.zeros((6,)),
+        self.T, self.T, self.tfinal / self.nsteps, 0.0, np.zeros((6,)),
+        model.init_store())
+    scales = model.residual_scales(ts)
+    self.assertTrue(np.allclose(scales[:6], 1.0))
+    self.assertTrue(np.isclose(scales[6], 1.0 / self.E))
+
+  def test_same_answer(self):
+    ref = models.GeneralIntegrator(self.elastic, self.flow)
+    auto = models.GeneralIntegrator(self.elastic, self.flow, auto_scale = True,
+        rtol = 1.0e-6)
+
+    # The stress equations are scaled to strain units, the history is not
+    ts = auto.make_trial_state(self.efinal / self.nsteps, np.zeros((6,)),
+        self.T, self.T, self.tfinal / self.nsteps, 0.0, np.zeros((6,)),
+        auto.init_store())
+    scales = auto.residual_scales(ts)
+    self.assertTrue(np.allclose(scales[:6], 1.0 / self.E))
+    self.assertTrue(np.allclose(scales[6:], 1.0))
+
+    s_ref, h_ref = self.run_model(ref)
+    s_auto, h_auto = self.run_model(auto)
+    self.assertTrue(np.allclose(s_auto, s_ref, rtol = 0,
+      atol = 1.0e-7 * np.max(np.abs(s_ref))))
+    self.assertTrue(np.allclose(h_auto, h_ref, rtol = 0,
+      atol = 1.0e-7 * np.max(np.abs(h_ref))))
+
+class TestCreepPlasticityScaling(unittest.TestCase):
+  """
+    The creep-plasticity scale factor now acts through the residual scales
+  """
+  def setUp(self):
+    self.elastic = elasticity.IsotropicLinearElasticModel(150000.0, "youngs", 
+        0.3, "poissons")
+    surface = surfaces.IsoJ2()
+    iso = hardening.LinearIsotropicHardeningRule(200.0, 3000.0)
+    flow = ri_flow.RateIndependentAssociativeFlow(surface, iso)
+    self.pmodel = models.SmallStrainRateIndependentPlasticity(self.elastic, 
+        flow)
+    self.cmodel = creep.J2CreepModel(creep.PowerLawCreep(1.85e-10, 2.5))
+
+  def trial_state(self, model):
+    return model.make_trial_state(np.array([0.01,0,0,0,0,0]), np.zeros((6,)),
+        300.0, 300.0, 1.0, 0.0, np.zeros((6,)), model.init_store())
+
+  def test_sf(self):
+    model = models.SmallStrainCreepPlasticity(self.elastic, self.pmodel,
+        self.cmodel, sf = 1.0e5)
+    self.assertTrue(np.allclose(model.residual_scales(self.trial_state(model)),
+      1.0e5))
+
+  def test_auto(self):
+    model = models.SmallStrainCreepPlasticity(self.elastic, self.pmodel,
+        self.cmodel, auto_scale = True)
+    self.assertTrue(np.allclose(model.residual_scales(self.trial_state(model)),
+      1.0))
+
+class TestReturnAlgorithms(unittest.TestCase):
+  """
+    The cutting plane return against closest point projection
+  """
+  def setUp(self):
+    self.elastic = elasticity.IsotropicLinearElasticModel(92000.0, "youngs",
+        0.3, "poissons")
+    surface = surfaces.IsoKinJ2()
+    iso = hardening.VoceIsotropicHardeningRule(180.0, 100.0, 50.0)
+    gmodels = [hardening.ConstantGamma(g) for g in [500.0, 50.0]]
+    hmodel = hardening.Chaboche(iso, [20000.0, 2000.0], gmodels, [0.0, 0.0],
+        [1.0, 1.0])
+    self.chaboche = ri_flow.RateIndependentNonAssociativeHardening(surface,
+        hmodel)
+    self.j2 = ri_flow.RateIndependentAssociativeFlow(surfaces.IsoJ2(),
+        hardening.VoceIsotropicHardeningRule(180.0, 100.0, 50.0))
+
+    self.T = 300.0
+    self.nsteps = 40
+
+  def strains(self):
+    return [np.array([1.0,-0.5,-0.5,0.2,0,0]) * 0.01 * np.sin(
+      4 * np.pi * i / self.nsteps) for i in range(1, self.nsteps+1)]
+
+  def run_model(self, model):
+    nsolves = 0
+    stresses = []
+    n0 = solvers.solve_stats().nsolves
+    for args, res in strain_path(model, self.strains(), T = self.T):
+      nsolves = max(nsolves, solvers.solve_stats().nsolves - n0)
+      n0 = solvers.solve_stats().nsolves
+      stresses.append(res[0])
+    return np.array(stresses), nsolves
+
+  def test_associative_same(self):
+    s_cp, n_cp = self.run_model(models.SmallStrainRateIndependentPlasticity(
+      self.elastic, self.j2))
+    s_ct, n_ct = self.run_model(models.SmallStrainRateIndependentPlasticity(
+      self.elastic, self.j2, algorithm = "cutting_plane"))
+    self.assertTrue(np.allclose(s_cp, s_ct, rtol = 1.0e-6))
+    self.assertEqual(n_ct, 1)
+
+  def test_chaboche_close(self):
+    # The corrected cutting plane return is close to closest point projection
+    self.nsteps = 200
+    s_cp, n_cp = self.run_model(models.SmallStrainRateIndependentPlasticity(
+      self.elastic, self.chaboche))
+    s_ct, n_ct = self.run_model(models.SmallStrainRateIndependentPlasticity(
+      self.elastic, self.chaboche, algorithm = "cutting_plane"))
+    self.assertTrue(np.allclose(s_cp, s_ct, rtol = 0,
+      atol = 2.5e-4 * np.max(np.abs(s_cp))))
+    self.assertEqual(n_ct, 1)
+
+  def test_chaboche_tangent(self):
+    # The tangent is exact for the corrected state, so it matches the
+    # numerical derivative up to the residual left by the correction
+    self.nsteps = 200
+    model = models.SmallStrainRateIndependentPlasticity(self.elastic,
+        self.chaboche, algorithm = "cutting_plane")
+    for args, res in strain_path(model, self.strains(), T = self.T):
+      dfn = lambda e: model.update_sd(e, *args[1:])[0]
+      num_A = differentiate(dfn, args[0], eps = 1.0e-9)
+      self.assertTrue(np.allclose(num_A, res[2], rtol = 0,
+        atol = 1.0e-3 * np.max(np.abs(res[2]))))
+
+  def test_bad_algorithm(self):
+    with self.assertRaises(RuntimeError):
+      models.SmallStrainRateIndependentPlasticity(self.elastic, self.j2,
+          algorithm = "bogus")
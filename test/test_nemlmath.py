@@ -4,7 +4,7 @@ sys.path.append('..')
 from neml.nemlmath import *
 from common import *
 
-from neml import nemlmath
+from neml import nemlmath, elasticity, surfaces
 
 import unittest
 import numpy as np
@@ -303,3 +303,65 @@ class TestPoly(unittest.TestCase):
     npv = np.polyval(self.poly, self.x)
     mv  = polyval(self.poly, self.x)
     self.assertTrue(np.isclose(npv, mv))
+
+class TestStructured(unittest.TestCase):
+  def setUp(self):
+    self.J = np.zeros((6,6))
+    self.J[:3,:3] = 1.0 / 3.0
+    self.K = np.eye(6) - self.J
+    self.u = ra.random((6,))
+    self.v = ra.random((6,))
+    self.B = ra.random((6,4))
+
+  def test_rank_one(self):
+    X = rank_one_solve(self.u, self.v, self.B)
+    self.assertTrue(np.allclose(X,
+      la.solve(np.eye(6) + np.outer(self.u, self.v), self.B)))
+
+  def test_split(self):
+    A = 3.0 * self.J + 2.0 * self.K - 0.5 * np.outer(self.u, self.u)
+    ok, a, b, u, v = iso_rank_one(A, self.u)
+    self.assertTrue(ok)
+    self.assertTrue(np.allclose(a * self.J + b * self.K + np.outer(u, v), A))
+
+  def test_split_isotropic(self):
+    ok, a, b, u, v = iso_rank_one(3.0 * self.J + 2.0 * self.K, np.zeros((6,)))
+    self.assertTrue(ok)
+    self.assertTrue(np.isclose(a, 3.0))
+    self.assertTrue(np.isclose(b, 2.0))
+    self.assertTrue(np.allclose(u, 0.0))
+
+  def test_split_direction(self):
+    A = 3.0 * self.J + 2.0 * self.K - 0.5 * np.outer(self.u, self.u)
+    ok, a, b, u, v = iso_rank_one(A, self.v)
+    self.assertFalse(ok)
+
+  def test_split_general(self):
+    ok, a, b, u, v = iso_rank_one(ra.random((6,6)), self.u)
+    self.assertFalse(ok)
+
+  def test_split_j2(self):
+    # The perfect plasticity tangent with a von Mises surface
+    elastic = elasticity.IsotropicLinearElasticModel(150000.0, "youngs",
+        0.3, "poissons")
+    surface = surfaces.IsoJ2()
+    s = ra.random((6,)) * 200.0
+    A = la.inv(elastic.C(300.0)) + 1.0e-4 * surface.df_dsds(s,
+        np.array([100.0]), 300.0)
+    n = surface.df_ds(s, np.array([100.0]), 300.0)
+    ok, a, b, u, v = iso_rank_one(A, n)
+    self.assertTrue(ok)
+    self.assertTrue(np.allclose(a * self.J + b * self.K + np.outer(u, v), A))
+
+  def test_woodbury(self):
+    U = ra.random((6,2))
+    V = ra.random((6,2))
+    A = 3.0 * self.J + 2.0 * self.K + np.dot(U, V.T)
+    X = iso_low_rank_solve(3.0, 2.0, U, V, self.B)
+    self.assertTrue(np.allclose(X, la.solve(A, self.B)))
+
+  def test_isotropic(self):
+    X = iso_low_rank_solve(3.0, 2.0, np.zeros((6,0)), np.zeros((6,0)),
+        self.B)
+    self.assertTrue(np.allclose(X, la.solve(3.0 * self.J + 2.0 * self.K,
+      self.B)))
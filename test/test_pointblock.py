@@ -0,0 +1,206 @@
+import sys
+import os
+sys.path.append('..')
+
+from neml import models, pointblock, parse, elasticity, surfaces
+from common import *
+
+import unittest
+import numpy as np
+
+class TestTopology(unittest.TestCase):
+  """
+    The NUMA topology is always usable, with at least one node
+  """
+  def test_nodes(self):
+    nodes = pointblock.numa_topology()
+    self.assertTrue(len(nodes) >= 1)
+    cpus = [c for n in nodes for c in n]
+    self.assertTrue(len(cpus) >= 1)
+    self.assertEqual(len(cpus), len(set(cpus)))
+
+class TestPointBlock(unittest.TestCase):
+  """
+    A block owning its state has to match point by point updates
+  """
+  def setUp(self):
+    self.model = parse.parse_xml("test/examples.xml", "test_j2iso")
+    self.npts = 37
+    self.T = 300.0
+    rng = np.random.RandomState(42)
+    self.efinal = rng.uniform(-1.0, 1.0, (self.npts, 6)) * 0.01
+    self.nsteps = 5
+
+  def run_block(self, block):
+    for i in range(1, self.nsteps+1):
+      block.set_strain(self.efinal * i / self.nsteps)
+      block.step(float(i))
+
+  def run_points(self):
+    stress = np.zeros((self.npts, 6))
+    hist = np.zeros((self.npts, self.model.nstore))
+    for k in range(self.npts):
+      h = self.model.init_store()
+      s = np.zeros((6,))
+      e_n = np.zeros((6,))
+      for i in range(1, self.nsteps+1):
+        e_np1 = self.efinal[k] * i / self.nsteps
+        s, h, A, u, p = self.model.update_sd(e_np1, e_n, self.T, self.T,
+            float(i), float(i-1), s, h, 0.0, 0.0)
+        e_n = e_np1
+      stress[k] = s
+      hist[k] = h
+    return stress, hist
+
+  def test_ranges(self):
+    block = pointblock.PointBlock(self.model, self.npts, self.T,
+        nthreads = 3)
+    self.assertEqual(block.nthreads, 3)
+    self.assertEqual(block.ranges, [0, 12, 24, 37])
+    self.assertTrue(block.nnodes >= 1)
+    self.assertFalse(block.pinned)
+    self.assertEqual(block.cpus, [-1, -1, -1])
+
+  def test_initial(self):
+    block = pointblock.PointBlock(self.model, self.npts, self.T)
+    self.assertEqual(block.nstore, self.model.nstore)
+    self.assertTrue(np.allclose(block.history,
+      np.tile(self.model.init_store(), (self.npts, 1))))
+    self.assertTrue(np.allclose(block.stress, 0.0))
+    self.assertTrue(np.allclose(block.temperature, self.T))
+
+  def test_same(self):
+    stress, hist = self.run_points()
+    for pin in (False, True):
+      block = pointblock.PointBlock(self.model, self.npts, self.T,
+          nthreads = 2, pin = pin)
+      self.run_block(block)
+      self.assertTrue(np.allclose(block.stress, stress))
+      self.assertTrue(np.allclose(block.history, hist))
+      self.assertTrue(np.allclose(block.strain, self.efinal))
+      self.assertTrue(np.all(block.errors == 0))
+      self.assertEqual(block.time, float(self.nsteps))
+
+  @unittest.skipUnless(hasattr(os, "sched_getaffinity"), "needs affinity")
+  def test_unpinned(self):
+    mask = os.sched_getaffinity(0)
+    block = pointblock.PointBlock(self.model, self.npts, self.T,
+        nthreads = 2, pin = True)
+    self.run_block(block)
+    self.assertEqual(os.sched_getaffinity(0), mask)
+
+  def test_bandwidth(self):
+    block = pointblock.PointBlock(self.model, self.npts, self.T)
+    self.run_block(block)
+    self.assertTrue(block.step_time > 0.0)
+    self.assertTrue(np.isclose(block.bandwidth,
+      block.bytes_per_step / block.step_time))
+    self.assertTrue(block.bytes_per_step > self.npts * 8 *
+        (66 + 2 * self.model.nstore))
+
+  def test_failure(self):
+    # Points the perfect plasticity update cannot do in a few iterations
+    elastic = elasticity.IsotropicLinearElasticModel(150000.0, "youngs",
+        0.3, "poissons")
+    model = models.SmallStrainPerfectPlasticity(elastic,
+        surfaces.IsoJ2I1(1.0, 2.0), 200.0, miter = 3)
+    block = pointblock.PointBlock(model, self.npts, self.T)
+    block.set_strain(self.efinal * 1.0e-3)
+    block.step(1.0)
+    stress = block.stress
+    block.set_strain(self.efinal)
+    with self.assertRaises(Exception):
+      block.step(2.0)
+    self.assertTrue(np.any(block.errors != 0))
+    self.assertTrue(np.array_equal(block.stress, stress))
+    self.assertEqual(block.time, 1.0)
+
+  def test_bad_size(self):
+    block = pointblock.PointBlock(self.model, self.npts, self.T)
+    with self.assertRaises(ValueError):
+      block.set_strain(np.zeros((self.npts-1, 6)))
+
+class TestHistoryStorage(unittest.TestCase):
+  """
+    Packing the stored variables rounds each to its precision
+  """
+  def setUp(self):
+    self.storage = pointblock.HistoryStorage(["bfloat16", "double", "single"])
+    self.h = np.array([np.pi, np.pi, np.pi])
+
+  def test_layout(self):
+    self.assertEqual(self.storage.nstore, 3)
+    self.assertEqual(self.storage.bytes, 14)
+    self.assertFalse(self.storage.full)
+    self.assertEqual(self.storage.precisions, ["bfloat16", "double", "single"])
+    self.assertTrue(pointblock.HistoryStorage(4).full)
+    self.assertEqual(pointblock.HistoryStorage(4).bytes, 32)
+
+  def test_round(self):
+    r = self.storage.round(self.h)
+    self.assertEqual(r[1], np.pi)
+    self.assertEqual(r[2], float(np.float32(np.pi)))
+    self.assertTrue(r[0] != np.pi)
+    self.assertTrue(np.abs(r[0] - np.pi) <= np.pi * 2.0**-9)
+
+  def test_bad(self):
+    with self.assertRaises(Exception):
+      pointblock.HistoryStorage(["double", "half"])
+
+class TestReducedStorage(unittest.TestCase):
+  """
+    A block with reduced storage tracks its full precision copy
+  """
+  def setUp(self):
+    self.model = parse.parse_xml("test/examples.xml", "test_j2comb")
+    self.npts = 23
+    self.T = 300.0
+    rng = np.random.RandomState(7)
+    self.efinal = rng.uniform(-1.0, 1.0, (self.npts, 6)) * 0.01
+    self.nsteps = 10
+    # The isotropic hardening variable in double, the backstress single
+    self.storage = ["double"] + ["single"] * (self.model.nstore - 1)
+
+  def run_block(self, block):
+    for i in range(1, self.nsteps+1):
+      block.set_strain(self.efinal * np.sin(np.pi * i / self.nsteps))
+      block.step(float(i))
+
+  def test_full(self):
+    block = pointblock.PointBlock(self.model, self.npts, self.T,
+        validate = True)
+    self.run_block(block)
+    self.assertEqual(block.stress_drift, 0.0)
+    self.assertTrue(np.all(np.array(block.history_drift) == 0.0))
+
+  def test_reduced(self):
+    ref = pointblock.PointBlock(self.model, self.npts, self.T)
+    self.run_block(ref)
+    block = pointblock.PointBlock(self.model, self.npts, self.T,
+        storage = self.storage, validate = True)
+    self.assertTrue(block.validating)
+    self.run_block(block)
+
+    self.assertTrue(block.stress_drift > 0.0)
+    self.assertTrue(block.stress_drift < 1.0e-5)
+    self.assertTrue(np.all(np.array(block.history_drift) < 1.0e-5))
+    self.assertTrue(np.allclose(block.stress, ref.stress, rtol = 1.0e-5))
+    self.assertTrue(np.allclose(block.history, ref.history, rtol = 1.0e-5))
+
+    # The history comes back exactly as stored
+    h = block.history
+    for k in range(self.npts):
+      self.assertTrue(np.array_equal(block.storage.round(h[k]), h[k]))
+
+  def test_bytes(self):
+    full = pointblock.PointBlock(self.model, self.npts, self.T)
+    reduced = pointblock.PointBlock(self.model, self.npts, self.T,
+        storage = self.storage)
+    self.assertEqual(full.storage.bytes, 8 * self.model.nstore)
+    self.assertEqual(reduced.storage.bytes, 8 + 4 * (self.model.nstore - 1))
+    self.assertTrue(reduced.bytes_per_step < full.bytes_per_step)
+
+  def test_bad_size(self):
+    with self.assertRaises(Exception):
+      pointblock.PointBlock(self.model, self.npts, self.T,
+          storage = self.storage[1:])
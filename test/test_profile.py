@@ -0,0 +1,87 @@
+import sys
+sys.path.append('..')
+
+from neml import profile, parse, models
+from common import *
+
+import unittest
+import numpy as np
+
+class TestProfile(unittest.TestCase):
+  """
+    Timing the calls to the objects in a model
+  """
+  def setUp(self):
+    self.fname = "test/examples.xml"
+    self.T = 300.0
+    self.efinal = np.array([0.01,-0.005,-0.005,0.002,0,0])
+    profile.reset_profile()
+
+  def path(self, model, nsteps = 10):
+    return [res[0] for args, res in strain_path(model,
+      ramp(self.efinal, nsteps), T = self.T)]
+
+  def entries(self):
+    return [(e.depth, e.name) for e in profile.profile_entries()]
+
+  def test_same(self):
+    plain = self.path(parse.parse_xml(self.fname, "test_j2iso"))
+    profiled = self.path(parse.parse_xml(self.fname, "test_j2iso", 
+      profile = True))
+    for a, b in zip(plain, profiled):
+      self.assertTrue(np.array_equal(a, b))
+
+  def test_off(self):
+    self.path(parse.parse_xml(self.fname, "test_j2iso"))
+    self.assertEqual(len(profile.profile_entries()), 0)
+    self.assertFalse(profile.profiling())
+
+  def test_tree(self):
+    self.path(parse.parse_xml(self.fname, "test_j2iso", profile = True))
+    self.assertFalse(profile.profiling())
+    entries = self.entries()
+    self.assertEqual(entries[0], (0, "test_j2iso"))
+    self.assertIn((1, "flow (RateIndependentAssociativeFlow)"), entries)
+    self.assertIn((2, "surface (IsoJ2)"), entries)
+    self.assertIn((2, "hardening (LinearIsotropicHardeningRule)"), entries)
+    
+    es = profile.profile_entries()
+    self.assertEqual(es[0].calls, 11) # init_store and ten updates
+    for e in es:
+      self.assertTrue(e.calls > 0)
+      self.assertTrue(e.exclusive <= e.inclusive)
+
+  def test_base(self):
+    self.path(parse.parse_xml(self.fname, "test_powerdamage", 
+      profile = True))
+    entries = self.entries()
+    self.assertEqual(entries[0], (0, "test_powerdamage"))
+    self.assertIn((1, "base (SmallStrainRateIndependentPlasticity)"), 
+        entries)
+
+  def test_failed(self):
+    plain = parse.parse_xml(self.fname, "test_powerdamage")
+    profiled = parse.parse_xml(self.fname, "test_powerdamage", profile = True)
+    h = profiled.init_store()
+    self.assertFalse(profiled.failed(h))
+    h[0] = 1.0
+    self.assertTrue(plain.failed(h))
+    self.assertTrue(profiled.failed(h))
+
+  def test_general(self):
+    self.path(parse.parse_xml(self.fname, "test_perzyna", profile = True))
+    entries = self.entries()
+    self.assertIn((1, "rule (TVPFlowRule)"), entries)
+    self.assertIn((2, "flow (PerzynaFlowRule)"), entries)
+    self.assertIn((3, "surface (IsoKinJ2)"), entries)
+
+  def test_reset(self):
+    self.path(parse.parse_xml(self.fname, "test_j2iso", profile = True))
+    profile.reset_profile()
+    self.assertEqual(len(profile.profile_entries()), 0)
+
+  def test_report(self):
+    self.path(parse.parse_xml(self.fname, "test_j2iso", profile = True))
+    report = profile.profile_report()
+    self.assertIn("test_j2iso", report)
+    self.assertIn("  flow (RateIndependentAssociativeFlow)", report)
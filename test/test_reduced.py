@@ -0,0 +1,144 @@
+import sys
+sys.path.append('..')
+
+from neml import interpolate, solvers, models, elasticity, ri_flow, hardening, surfaces, visco_flow, general_flow, creep, uniaxial, reduced
+from common import *
+
+import unittest
+import numpy as np
+import numpy.linalg as la
+
+class CommonReduced(object):
+  """
+    Common tests for the reduced stress state models
+  """
+  def run_steps(self, check):
+    t_n = 0.0
+    e_n = np.zeros((6,))
+    s_n = np.zeros((6,))
+    h_n = self.model.init_store()
+    u_n = 0.0
+    p_n = 0.0
+
+    for i in range(1, self.nsteps+1):
+      t_np1 = self.tfinal * i / self.nsteps
+      e_np1 = self.efinal * i / self.nsteps
+      s_np1, h_np1, A_np1, u_np1, p_np1 = self.model.update_sd(e_np1, e_n,
+          self.T, self.T, t_np1, t_n, s_n, h_n, u_n, p_n)
+
+      check(e_np1, e_n, t_np1, t_n, s_n, h_n, u_n, p_n,
+          s_np1, h_np1, A_np1)
+
+      e_n = np.copy(e_np1)
+      e_n[self.constrained] = h_np1[:len(self.constrained)]
+      s_n = s_np1
+      h_n = np.copy(h_np1)
+      t_n = t_np1
+      u_n = u_np1
+      p_n = p_np1
+
+  def test_constraint(self):
+    def check(e_np1, e_n, t_np1, t_n, s_n, h_n, u_n, p_n, s_np1, h_np1, A_np1):
+      self.assertTrue(np.allclose(s_np1[self.constrained], 0.0, atol = 1.0e-6))
+    self.run_steps(check)
+
+  def test_tangent(self):
+    def check(e_np1, e_n, t_np1, t_n, s_n, h_n, u_n, p_n, s_np1, h_np1, A_np1):
+      dfn = lambda e: self.model.update_sd(e, e_n, self.T, self.T, t_np1, t_n,
+          s_n, h_n, u_n, p_n)[0]
+      nA = differentiate(dfn, e_np1, eps = 1.0e-9)
+      free = [i for i in range(6) if i not in self.constrained
+          and i not in self.fixed]
+      self.assertTrue(np.allclose(A_np1[np.ix_(free,free)], nA[np.ix_(free,free)],
+        rtol = 1.0e-3, atol = 1.0e-1))
+      zero = [i for i in range(6) if i not in free]
+      self.assertTrue(np.allclose(A_np1[zero,:], 0.0))
+      self.assertTrue(np.allclose(A_np1[:,zero], 0.0))
+    self.run_steps(check)
+
+  def test_forwarded(self):
+    base = models.SmallStrainRateIndependentPlasticity(self.elastic,
+        self.flow,
+        alpha = interpolate.ConstantInterpolate(1.0e-5))
+    other = elasticity.IsotropicLinearElasticModel(50000.0, "youngs",
+        0.25, "poissons")
+    model = type(self.model)(other, base)
+
+    self.assertTrue(np.isclose(model.alpha(self.T), base.alpha(self.T)))
+    self.assertTrue(np.isclose(model.bulk(self.T), base.bulk(self.T)))
+    self.assertTrue(np.isclose(model.shear(self.T), base.shear(self.T)))
+
+class CommonBase(object):
+  """
+    Base 3D model
+  """
+  def make_base(self):
+    E = 200000.0
+    nu = 0.27
+
+    mu = E / (2 * (1.0 + nu))
+    K = E / (3 * (1 - 2 * nu))
+
+    s0 = 300.0
+    Kp = 0.0
+    c = [30000.0]
+    r = [60.0]
+    A = [0.0]
+    n = [1.0]
+
+    self.elastic = elasticity.IsotropicLinearElasticModel(mu, "shear",
+        K, "bulk")
+    surface = surfaces.IsoKinJ2()
+    iso = hardening.LinearIsotropicHardeningRule(s0, Kp)
+    gmodels = [hardening.ConstantGamma(g) for g in r]
+    hrule = hardening.Chaboche(iso, c, gmodels, A, n)
+
+    self.flow = ri_flow.RateIndependentNonAssociativeHardening(surface,
+        hrule)
+    self.base = models.SmallStrainRateIndependentPlasticity(self.elastic,
+        self.flow)
+
+    self.tfinal = 10.0
+    self.T = 300.0
+    self.nsteps = 20
+
+class TestUniaxialStress(CommonBase, CommonReduced, unittest.TestCase):
+  def setUp(self):
+    self.make_base()
+    self.model = reduced.UniaxialStressModel(self.elastic, self.base)
+    self.constrained = [1,2,3,4,5]
+    self.fixed = []
+    self.efinal = np.array([0.02,0,0,0,0,0])
+
+  def test_python(self):
+    umodel = uniaxial.UniaxialModel(self.base)
+    def check(e_np1, e_n, t_np1, t_n, s_n, h_n, u_n, p_n, s_np1, h_np1, A_np1):
+      su_np1, hu_np1, Au_np1, uu_np1, pu_np1 = umodel.update(e_np1[0], e_n[0],
+          self.T, self.T, t_np1, t_n, s_n[0], h_n[:self.model.nhist], u_n, p_n)
+      self.assertTrue(np.isclose(su_np1, s_np1[0]))
+      self.assertTrue(np.isclose(Au_np1, A_np1[0,0], rtol = 1.0e-4))
+      self.assertTrue(np.allclose(hu_np1[:5], h_np1[:5]))
+    self.run_steps(check)
+
+class TestPlaneStress(CommonBase, CommonReduced, unittest.TestCase):
+  def setUp(self):
+    self.make_base()
+    self.model = reduced.PlaneStressModel(self.elastic, self.base)
+    self.constrained = [2,3,4]
+    self.fixed = []
+    self.efinal = np.array([0.02,-0.01,0,0,0,0.015])
+
+class TestGeneralizedPlaneStrain(CommonBase, CommonReduced, unittest.TestCase):
+  def setUp(self):
+    self.make_base()
+    self.model = reduced.GeneralizedPlaneStrainModel(self.elastic, self.base)
+    self.constrained = []
+    self.fixed = [3,4]
+    self.efinal = np.array([0.02,-0.01,0.005,0,0,0.015])
+
+  def test_shear_strains(self):
+    e_np1 = np.array([0.0,0,0,0.01,0.01,0])
+    s_np1, h_np1, A_np1, u_np1, p_np1 = self.model.update_sd(e_np1,
+        np.zeros((6,)), self.T, self.T, 1.0, 0.0, np.zeros((6,)),
+        self.model.init_store(), 0.0, 0.0)
+    self.assertTrue(np.allclose(s_np1, 0.0))
@@ -0,0 +1,154 @@
+import sys
+sys.path.append('..')
+
+from neml import models, elasticity, surfaces, creep, interpolate
+from common import *
+
+import unittest
+import numpy as np
+import numpy.linalg as la
+
+class TestJ2Relax(unittest.TestCase):
+  """
+    Semi-analytic stress relaxation for J2 creep
+  """
+  def setUp(self):
+    self.A = 1.0e-12
+    self.n = 4.0
+    self.model = creep.J2CreepModel(creep.PowerLawCreep(self.A, self.n))
+
+    self.G = 40000.0
+    self.T = 300.0
+    self.s_n = np.array([200.0,-50.0,10.0,30.0,-20.0,15.0])
+    self.e_n = np.array([0.001,-0.0005,-0.0005,0.0002,0,0.0001])
+
+  def seq(self, s):
+    sdev = s - np.array([1,1,1,0,0,0]) * np.sum(s[:3]) / 3.0
+    return np.sqrt(3.0/2.0) * la.norm(sdev)
+
+  def test_power_law(self):
+    dt = 1.0e4
+    s_np1, e_np1, A_np1, valid = self.model.relax(self.s_n, self.e_n, self.G,
+        self.T, dt, 0.0)
+    self.assertTrue(valid)
+
+    se0 = self.seq(self.s_n)
+    exact = (se0**(1-self.n) + (self.n - 1) * 3 * self.G * self.A * dt)**(
+        1.0 / (1 - self.n))
+    self.assertTrue(np.isclose(self.seq(s_np1), exact, rtol = 1.0e-8))
+
+  def test_direction(self):
+    s_np1, e_np1, A_np1, valid = self.model.relax(self.s_n, self.e_n, self.G,
+        self.T, 100.0, 0.0)
+    ds = s_np1 - self.s_n
+    de = e_np1 - self.e_n
+
+    self.assertTrue(np.isclose(np.sum(ds[:3]), 0.0))
+    self.assertTrue(np.isclose(np.sum(de[:3]), 0.0))
+    self.assertTrue(np.allclose(ds, -2.0 * self.G * de))
+
+    sdev = self.s_n - np.array([1,1,1,0,0,0]) * np.sum(self.s_n[:3]) / 3.0
+    self.assertTrue(np.isclose(np.dot(ds, sdev) / (la.norm(ds) * la.norm(sdev)),
+      -1.0))
+
+  def test_zero_stress(self):
+    s_n = np.array([50.0,50.0,50.0,0,0,0])
+    s_np1, e_np1, A_np1, valid = self.model.relax(s_n, self.e_n, self.G,
+        self.T, 100.0, 0.0)
+    self.assertTrue(valid)
+    self.assertTrue(np.allclose(s_np1, s_n))
+    self.assertTrue(np.allclose(e_np1, self.e_n))
+
+  def test_strain_hardening(self):
+    rule = creep.NortonBaileyCreep(1.0e-10, 0.5, 4.0)
+    model = creep.J2CreepModel(rule, relax_tol = 1.0e-8)
+    t_n = 10.0
+    dt = 100.0
+    s_np1, e_np1, A_np1, valid = model.relax(self.s_n, self.e_n, self.G,
+        self.T, t_n + dt, t_n)
+    self.assertTrue(valid)
+
+    fine = creep.J2CreepModel(rule, relax_tol = 1.0e-11)
+    s_ref, e_ref, A_ref, valid = fine.relax(self.s_n, self.e_n, self.G,
+        self.T, t_n + dt, t_n)
+    self.assertTrue(np.allclose(s_np1, s_ref, rtol = 1.0e-5))
+    self.assertTrue(np.allclose(e_np1, e_ref, rtol = 1.0e-5))
+
+  def test_zero_time(self):
+    s_np1, e_np1, A_np1, valid = self.model.relax(self.s_n, self.e_n, self.G,
+        self.T, 0.0, 0.0)
+    self.assertTrue(valid)
+    self.assertTrue(np.allclose(s_np1, self.s_n))
+    self.assertTrue(np.allclose(e_np1, self.e_n))
+
+class TestCreepPlasticityHolds(unittest.TestCase):
+  """
+    Strain holds with the semi-analytic relaxation
+  """
+  def setUp(self):
+    self.E = 150000.0
+    self.nu = 0.3
+    self.elastic = elasticity.IsotropicLinearElasticModel(self.E, "youngs",
+        self.nu, "poissons")
+    surface = surfaces.IsoJ2()
+    self.plastic = models.SmallStrainPerfectPlasticity(self.elastic, surface,
+        300.0)
+    self.creep = creep.J2CreepModel(creep.PowerLawCreep(1.0e-12, 4.0))
+
+    self.T = 300.0
+
+  def make(self, relax):
+    return models.SmallStrainCreepPlasticity(self.elastic, self.plastic,
+        self.creep, relax_holds = relax)
+
+  def run_path(self, model, efinal, nhold, thold = 1.0e5):
+    times = list(np.linspace(0, 1.0, 11)[1:]) + list(
+        1.0 + np.linspace(0, thold, nhold+1)[1:])
+    strains = [efinal * min(t, 1.0) for t in times]
+    for args, res in strain_path(model, strains, times = times, T = self.T):
+      pass
+
+    s_np1, h_np1, A_np1, u_np1, p_np1 = res
+    return s_np1, h_np1, A_np1, p_np1
+
+  def test_same_ramp(self):
+    efinal = np.array([0.0015,-0.0005,-0.0005,0.0002,0,0])
+    s1, h1, A1, p1 = self.run_path(self.make(False), efinal, 0)
+    s2, h2, A2, p2 = self.run_path(self.make(True), efinal, 0)
+    self.assertTrue(np.allclose(s1, s2))
+    self.assertTrue(np.allclose(h1, h2))
+
+  def test_large_steps(self):
+    efinal = np.array([0.0015,-0.0005,-0.0005,0.0002,0,0])
+    ref = self.run_path(self.make(False), efinal, 2000)[0]
+    be = self.run_path(self.make(False), efinal, 5)[0]
+    relax = self.run_path(self.make(True), efinal, 5)[0]
+
+    err_be = la.norm(be - ref)
+    err_relax = la.norm(relax - ref)
+    self.assertTrue(err_relax < err_be / 10.0)
+
+  def test_tangent(self):
+    model = self.make(True)
+    efinal = np.array([0.0015,-0.0005,-0.0005,0.0002,0,0])
+    s_n, h_n, A_n, p_n = self.run_path(model, efinal, 1)
+    e_n = efinal
+    t_n = 1.0 + 1.0e5
+    t_np1 = t_n + 100.0
+
+    s_np1, h_np1, A_np1, u_np1, p_np1 = model.update_sd(e_n, e_n, self.T,
+        self.T, t_np1, t_n, s_n, h_n, 0.0, 0.0)
+    dfn = lambda e: model.update_sd(e, e_n, self.T, self.T, t_np1, t_n,
+        s_n, h_n, 0.0, 0.0)[0]
+    num_A = differentiate(dfn, e_n, eps = 1.0e-8)
+    # Perturbing the strain leaves the hold, so this only matches the
+    # backward Euler tangent approximately
+    self.assertTrue(np.allclose(num_A, A_np1, rtol = 1.0e-2, atol = 1.0e2))
+
+  def test_yielded(self):
+    # Relaxing from the yield surface unloads elastically
+    efinal = np.array([0.01,-0.005,-0.005,0,0,0])
+    ref = self.run_path(self.make(False), efinal, 2000, thold = 10.0)[0]
+    be = self.run_path(self.make(False), efinal, 2, thold = 10.0)[0]
+    relax = self.run_path(self.make(True), efinal, 2, thold = 10.0)[0]
+    self.assertTrue(la.norm(relax - ref) < la.norm(be - ref) / 10.0)
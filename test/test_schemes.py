@@ -0,0 +1,122 @@
+import sys
+sys.path.append('..')
+
+from neml import models, elasticity, surfaces, hardening, visco_flow, general_flow
+from common import *
+
+import unittest
+import numpy as np
+import numpy.linalg as la
+
+class CommonScheme(object):
+  """
+    Common tests for the GeneralIntegrator time integration schemes
+  """
+  def make_flow(self, s0, n, eta):
+    E = 92000.0
+    nu = 0.3
+
+    self.elastic = elasticity.IsotropicLinearElasticModel(E, "youngs",
+        nu, "poissons")
+    surface = surfaces.IsoJ2()
+    hrule = hardening.LinearIsotropicHardeningRule(s0, 1000.0)
+    g = visco_flow.GPowerLaw(n, eta)
+    vmodel = visco_flow.PerzynaFlowRule(surface, hrule, g)
+    return general_flow.TVPFlowRule(self.elastic, vmodel)
+
+  def setUp(self):
+    self.flow = self.make_flow(0.0, 3.0, 2000.0)
+    self.model = models.GeneralIntegrator(self.elastic, self.flow,
+        scheme = self.scheme)
+    self.T = 300.0
+
+  def hold(self, model, nsteps):
+    """
+      Ramp to a fixed strain and then relax with growing time steps
+    """
+    efinal = np.array([0.01,-0.005,-0.005,0,0,0])
+    times = list(np.linspace(0, 1.0, 11)[1:]) + list(
+        1.0 + 100.0 * (np.geomspace(1, 1.0e4, nsteps+1)[1:] - 1) / (1.0e4 - 1))
+
+    strains = [efinal * min(t, 1.0) for t in times]
+    for args, res in strain_path(model, strains, times = times, T = self.T):
+      pass
+
+    return res[0][0]
+
+  def test_order(self):
+    ref = self.hold(self.model, 640)
+    coarse = abs(self.hold(self.model, 20) - ref)
+    fine = abs(self.hold(self.model, 40) - ref)
+    self.assertTrue(coarse / fine > self.min_ratio)
+
+  def test_tangent(self):
+    model = models.GeneralIntegrator(self.elastic,
+        self.make_flow(100.0, 2.0, 200.0), scheme = self.scheme)
+    efinal = np.array([0.05,0,0,0.02,0,-0.01])
+    tfinal = 10.0
+    nsteps = 20
+
+    for args, res in strain_path(model, ramp(efinal, nsteps),
+        times = ramp(tfinal, nsteps), T = self.T):
+      dfn = lambda e: model.update_sd(e, *args[1:])[0]
+      num_A = differentiate(dfn, args[0], eps = 1.0e-7)
+      self.assertTrue(np.allclose(num_A, res[2], rtol = 1.0e-3, atol = 1.0))
+
+  def test_elastic(self):
+    e_np1 = np.array([0.001,0,0,0,0,0.0005])
+    h_n = self.model.init_store()
+    s_np1, h_np1, A_np1, u_np1, p_np1 = self.model.update_sd(e_np1,
+        np.zeros((6,)), self.T, self.T, 1.0e-3, 0.0, np.zeros((6,)), h_n,
+        0.0, 0.0)
+    self.assertTrue(np.allclose(s_np1, np.dot(self.elastic.C(self.T), e_np1),
+      rtol = 1.0e-4))
+
+class TestBackwardEuler(CommonScheme, unittest.TestCase):
+  scheme = "backward_euler"
+  min_ratio = 1.5
+
+  def test_max_ratio(self):
+    ref = self.hold(self.model, 640)
+    coarse = abs(self.hold(self.model, 20) - ref)
+    fine = abs(self.hold(self.model, 40) - ref)
+    self.assertTrue(coarse / fine < 3.0)
+
+class TestTrapezoidal(CommonScheme, unittest.TestCase):
+  scheme = "trapezoidal"
+  min_ratio = 3.0
+
+class TestBDF2(CommonScheme, unittest.TestCase):
+  scheme = "bdf2"
+  min_ratio = 3.0
+
+  def test_history(self):
+    be = models.GeneralIntegrator(self.elastic, self.flow)
+    self.assertEqual(self.model.nhist, 2 * be.nhist + 13)
+
+  def test_restart(self):
+    be = models.GeneralIntegrator(self.elastic, self.flow)
+    e_np1 = np.array([0.01,-0.005,-0.005,0,0,0])
+    s1, h1, A1, u1, p1 = self.model.update_sd(e_np1, np.zeros((6,)), self.T,
+        self.T, 1.0, 0.0, np.zeros((6,)), self.model.init_store(), 0.0, 0.0)
+    s2, h2, A2, u2, p2 = be.update_sd(e_np1, np.zeros((6,)), self.T,
+        self.T, 1.0, 0.0, np.zeros((6,)), be.init_store(), 0.0, 0.0)
+    self.assertTrue(np.allclose(s1, s2))
+    self.assertTrue(np.allclose(h1[:be.nhist], h2[:be.nhist]))
+    self.assertTrue(np.isclose(h1[self.model.nhist-1], 1.0))
+
+class TestSDIRK(CommonScheme, unittest.TestCase):
+  scheme = "sdirk"
+  min_ratio = 3.0
+
+class TestBadScheme(unittest.TestCase):
+  def test_raises(self):
+    elastic = elasticity.IsotropicLinearElasticModel(92000.0, "youngs",
+        0.3, "poissons")
+    surface = surfaces.IsoJ2()
+    hrule = hardening.LinearIsotropicHardeningRule(100.0, 1000.0)
+    vmodel = visco_flow.PerzynaFlowRule(surface, hrule,
+        visco_flow.GPowerLaw(2.0, 200.0))
+    flow = general_flow.TVPFlowRule(elastic, vmodel)
+    with self.assertRaises(Exception):
+      models.GeneralIntegrator(elastic, flow, scheme = "rk4")
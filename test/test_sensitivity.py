@@ -0,0 +1,221 @@
+import sys
+sys.path.append('..')
+
+from neml import sensitivity, parse, drivers, solvers
+from common import *
+
+import unittest
+import numpy as np
+
+class CommonSensitivity(object):
+  """
+    Compare the sensitivities carried through a simulation to finite
+    differences of whole simulations
+  """
+  def fd_path(self, k, run):
+    v = self.sens.values[k]
+    dv = 1.0e-4 * np.abs(v)
+    model = parse.parse_xml(self.fname, self.mname, self.params[k],
+        v + dv)
+    return (run(model) - run(self.sens.model)) / dv
+
+  def test_values(self):
+    for k, p in enumerate(self.params):
+      self.assertTrue(np.isclose(self.sens.values[k],
+        parse.get_xml_parameter(self.fname, self.mname, p)))
+
+  def test_strain_control(self):
+    efinal = np.array([0.01,-0.004,-0.005,0.002,0,0.001])
+    nsteps = 20
+    def run(model):
+      driver = drivers.Driver_sd(model, T_init = self.T)
+      for i in range(1, nsteps+1):
+        driver.strain_step(efinal * i / nsteps, float(i), self.T)
+      return driver.stress[-1]
+
+    driver = drivers.SensitivityDriver_sd(self.sens, T_init = self.T)
+    for i in range(1, nsteps+1):
+      driver.strain_step(efinal * i / nsteps, float(i), self.T)
+
+    for k in range(self.sens.nsens):
+      fd = self.fd_path(k, run)
+      self.assertTrue(np.allclose(driver.dstress[-1][k], fd,
+        rtol = 1.0e-3, atol = 1.0e-3 * np.max(np.abs(fd))))
+
+  def test_uniaxial(self):
+    run = lambda m: drivers.uniaxial_test(m, 1.0e-2, T = self.T,
+        emax = 0.02, nsteps = 40)['stress']
+    res = drivers.uniaxial_test(self.sens, 1.0e-2, T = self.T, emax = 0.02,
+        nsteps = 40)
+    self.assertTrue(np.allclose(res['stress'], run(self.sens.model)))
+    self.assertEqual(res['dstress'].shape, (41, self.sens.nsens))
+
+    for k in range(self.sens.nsens):
+      fd = self.fd_path(k, run)
+      self.assertTrue(np.allclose(res['dstress'][:,k], fd,
+        rtol = 1.0e-3, atol = 1.0e-3 * np.max(np.abs(fd))))
+
+  def test_stress_control(self):
+    sfinal = np.array([150.0,20.0,0,0,0,10.0])
+    nsteps = 20
+    def run(model):
+      driver = drivers.Driver_sd(model, T_init = self.T)
+      for i in range(1, nsteps+1):
+        driver.stress_step(sfinal * i / nsteps, float(i), self.T)
+      return driver.strain[-1]
+
+    driver = drivers.SensitivityDriver_sd(self.sens, T_init = self.T)
+    for i in range(1, nsteps+1):
+      driver.stress_step(sfinal * i / nsteps, float(i), self.T)
+
+    for k in range(self.sens.nsens):
+      self.assertTrue(np.allclose(driver.dstress[-1][k], 0.0,
+        atol = 1.0e-6 * np.max(np.abs(sfinal))))
+      fd = self.fd_path(k, run)
+      self.assertTrue(np.allclose(driver.dstrain[-1][k], fd,
+        rtol = 1.0e-3, atol = 1.0e-3 * np.max(np.abs(fd))))
+
+  def test_strain_hold(self):
+    sfinal = np.array([150.0,0,0,0,0,0])
+    nsteps = 10
+    def run(model):
+      driver = drivers.Driver_sd(model, T_init = self.T)
+      for i in range(1, nsteps+1):
+        driver.stress_step(sfinal * i / nsteps, float(i), self.T)
+      for i in range(1, nsteps+1):
+        driver.strain_hold_step(0, float(nsteps + 10*i), self.T)
+      return driver.stress[-1]
+
+    driver = drivers.SensitivityDriver_sd(self.sens, T_init = self.T)
+    for i in range(1, nsteps+1):
+      driver.stress_step(sfinal * i / nsteps, float(i), self.T)
+    for i in range(1, nsteps+1):
+      driver.strain_hold_step(0, float(nsteps + 10*i), self.T)
+
+    for k in range(self.sens.nsens):
+      self.assertTrue(np.allclose(driver.dstress[-1][k][1:], 0.0,
+        atol = 1.0e-6 * np.max(np.abs(sfinal))))
+      self.assertTrue(np.isclose(driver.dstrain[-1][k][0],
+        driver.dstrain[nsteps][k][0]))
+      # Rate independent models do not relax, leaving only noise
+      fd = self.fd_path(k, run)
+      self.assertTrue(np.allclose(driver.dstress[-1][k], fd,
+        rtol = 1.0e-3, atol = 1.0e-3 * np.max(np.abs(fd)) + 
+        1.0e-6 * np.max(np.abs(sfinal))))
+
+class TestPerzynaSensitivity(unittest.TestCase, CommonSensitivity):
+  def setUp(self):
+    self.fname = "test/examples.xml"
+    self.mname = "test_perzyna"
+    self.params = ["rule/flow/g/n", "rule/flow/hardening/iso/s0",
+        "rule/elastic/m2"]
+    self.sens = sensitivity.SensitivityModel(self.fname, self.mname,
+        self.params)
+    self.T = 300.0
+
+class TestChabocheSensitivity(unittest.TestCase, CommonSensitivity):
+  def setUp(self):
+    self.fname = "test/examples.xml"
+    self.mname = "test_rd_chaboche"
+    self.params = ["rule/flow/n", "rule/flow/fluidity/eta",
+        "rule/elastic/m1"]
+    self.sens = sensitivity.SensitivityModel(self.fname, self.mname,
+        self.params)
+    self.T = 300.0
+
+  def test_all_parameters(self):
+    """
+      The update for all the parameters at once matches the updates for
+      each one, with the stored variables at a stride of nstore
+    """
+    e_np1 = np.array([0.01,-0.004,-0.005,0.002,0,0.001])
+    n = self.sens.nsens
+    h_n, dh_n = self.sens.init_store()
+    self.assertEqual(dh_n.shape, (n, self.sens.nstore))
+    args = (e_np1, np.zeros((6,)), self.T, self.T, 1.0, 0.0, np.zeros((6,)),
+        h_n, 0.0, 0.0)
+    s, h, A, u, p, ds, dh, du, dp = self.sens.update_sd(*args,
+        np.zeros((n,6)), np.zeros((n,6)), np.zeros((n,6)), dh_n,
+        np.zeros((n,)), np.zeros((n,)))
+    self.assertEqual(dh.shape, (n, self.sens.nstore))
+    self.assertTrue(np.allclose(dh[:,self.sens.model.nhist:], 0.0))
+
+    for k in range(n):
+      dsk, dhk, duk, dpk = self.sens.sensitivity_sd(k, e_np1, np.zeros((6,)),
+          self.T, self.T, 1.0, 0.0, s, np.zeros((6,)), h, h_n, u, 0.0, p,
+          0.0, np.zeros((6,)), np.zeros((6,)), np.zeros((6,)), dh_n[k],
+          0.0, 0.0)
+      self.assertTrue(np.allclose(ds[k], dsk))
+      self.assertTrue(np.allclose(dh[k], dhk))
+      self.assertTrue(np.isclose(du[k], duk))
+      self.assertTrue(np.isclose(dp[k], dpk))
+
+class TestSubstepSensitivity(unittest.TestCase):
+  """
+    Few Newton iterations force the integrator to subdivide a large step,
+    and the sensitivities have to follow the substeps
+  """
+  def setUp(self):
+    self.fname = "test/examples.xml"
+    self.mname = "test_perzyna_substep"
+    self.params = ["rule/flow/g/n", "rule/flow/hardening/iso/s0"]
+    self.sens = sensitivity.SensitivityModel(self.fname, self.mname,
+        self.params)
+    self.T = 300.0
+    self.e_np1 = np.array([0.02,-0.01,-0.01,0,0,0])
+
+  def update(self, model):
+    return model.update_sd_scale(self.e_np1, np.zeros((6,)), self.T, self.T,
+        1.0, 0.0, np.zeros((6,)), model.init_store(), 0.0, 0.0)
+
+  def test_substeps(self):
+    self.update(self.sens.model)
+    self.assertTrue(solvers.solve_stats().ndivide > 0)
+
+    n = self.sens.nsens
+    h_n, dh_n = self.sens.init_store()
+    z = np.zeros((n,6))
+    s, h, A, u, p, ds, dh, du, dp = self.sens.update_sd(self.e_np1,
+        np.zeros((6,)), self.T, self.T, 1.0, 0.0, np.zeros((6,)), h_n, 0.0,
+        0.0, z, z, z, dh_n, np.zeros((n,)), np.zeros((n,)))
+
+    for k, path in enumerate(self.params):
+      v = self.sens.values[k]
+      dv = 1.0e-5 * np.abs(v)
+      sp = self.update(parse.parse_xml(self.fname, self.mname, path, v + dv))[0]
+      sm = self.update(parse.parse_xml(self.fname, self.mname, path, v - dv))[0]
+      fd = (sp - sm) / (2.0 * dv)
+      self.assertTrue(np.allclose(ds[k], fd, rtol = 1.0e-4,
+        atol = 1.0e-4 * np.max(np.abs(fd))))
+
+      # The same from the finished step alone
+      dsk, dhk, duk, dpk = self.sens.sensitivity_sd(k, self.e_np1,
+          np.zeros((6,)), self.T, self.T, 1.0, 0.0, s, np.zeros((6,)), h, h_n,
+          u, 0.0, p, 0.0, np.zeros((6,)), np.zeros((6,)), np.zeros((6,)),
+          dh_n[k], 0.0, 0.0)
+      self.assertTrue(np.allclose(dsk, ds[k]))
+      self.assertTrue(np.allclose(dhk, dh[k]))
+
+class TestUnsupported(unittest.TestCase):
+  """
+    Only backward Euler GeneralIntegrator models carry sensitivities
+  """
+  def test_unsupported(self):
+    for mname, path in [("test_j2iso", "flow/hardening/s0"),
+        ("test_creep_plasticity", "creep/rule/A")]:
+      with self.assertRaises(ValueError):
+        sensitivity.SensitivityModel("test/examples.xml", mname, [path])
+
+class TestParameterPaths(unittest.TestCase):
+  def setUp(self):
+    self.fname = "test/examples.xml"
+
+  def test_bad_path(self):
+    for path in ["flow/hardening/x", "flow", "flow/hardening/K[1]",
+        "flow/hardening/K[0"]:
+      with self.assertRaises(ValueError):
+        sensitivity.SensitivityModel(self.fname, "test_j2iso", [path])
+
+  def test_list_entry(self):
+    self.assertTrue(np.isclose(parse.get_xml_parameter(self.fname,
+      "test_j2iso", "flow/hardening/K[0]"), 1000.0))
@@ -0,0 +1,151 @@
+import sys
+sys.path.append('..')
+
+from neml import solvers, models, elasticity, surfaces, hardening, visco_flow, general_flow
+from common import *
+
+import unittest
+import numpy as np
+import numpy.linalg as la
+
+class TestSuggestScale(unittest.TestCase):
+  """
+    Check the step size heuristic directly
+  """
+  def setUp(self):
+    self.stats = solvers.SolveStats()
+
+  def test_easy(self):
+    self.assertTrue(np.isclose(models.suggest_step_scale(self.stats, 0.0, 0),
+      1.5))
+
+  def test_failed(self):
+    self.assertTrue(np.isclose(models.suggest_step_scale(self.stats, 0.0, -1),
+      0.5))
+
+  def test_exhausted(self):
+    self.stats.exhausted = True
+    self.assertTrue(np.isclose(models.suggest_step_scale(self.stats, 0.0, -1),
+      0.25))
+
+  def test_diverged(self):
+    self.stats.rate = 2.0
+    self.assertTrue(np.isclose(models.suggest_step_scale(self.stats, 0.0, -1),
+      0.25))
+
+  def test_substeps(self):
+    self.stats.ndivide = 1
+    self.assertTrue(np.isclose(models.suggest_step_scale(self.stats, 0.0, 0),
+      0.5))
+    self.stats.ndivide = 5
+    self.assertTrue(np.isclose(models.suggest_step_scale(self.stats, 0.0, 0),
+      0.25))
+
+  def test_iterations(self):
+    self.stats.max_iter = 24
+    self.assertTrue(np.isclose(models.suggest_step_scale(self.stats, 0.0, 0),
+      0.5))
+
+  def test_rate(self):
+    self.stats.rate = 0.5
+    self.assertTrue(np.isclose(models.suggest_step_scale(self.stats, 0.0, 0),
+      np.sqrt(0.5)))
+
+  def test_inelastic(self):
+    self.assertTrue(np.isclose(models.suggest_step_scale(self.stats, 1.0e-2, 0),
+      0.5))
+
+class CommonStepScale(object):
+  """
+    Common tests for the suggested step scale
+  """
+  def scale(self, nsteps):
+    t_n = 0.0
+    e_n = np.zeros((6,))
+    s_n = np.zeros((6,))
+    h_n = self.model.init_store()
+    u_n = 0.0
+    p_n = 0.0
+
+    scales = []
+    for i in range(1, nsteps+1):
+      t_np1 = self.tfinal * i / nsteps
+      e_np1 = self.efinal * i / nsteps
+      s_np1, h_np1, A_np1, u_np1, p_np1 = self.model.update_sd(e_np1, e_n,
+          self.T, self.T, t_np1, t_n, s_n, h_n, u_n, p_n)
+      ss_np1, hs_np1, As_np1, us_np1, ps_np1, scale = self.model.update_sd_scale(
+          e_np1, e_n, self.T, self.T, t_np1, t_n, s_n, h_n, u_n, p_n)
+
+      self.assertTrue(np.allclose(s_np1, ss_np1))
+      self.assertTrue(np.allclose(h_np1, hs_np1))
+      self.assertTrue(np.allclose(A_np1, As_np1))
+      self.assertTrue(scale >= 0.25)
+      self.assertTrue(scale <= 1.5)
+      scales.append(scale)
+
+      e_n = e_np1
+      s_n = s_np1
+      h_n = h_np1
+      t_n = t_np1
+      u_n = u_np1
+      p_n = p_np1
+
+    return scales
+
+  def test_elastic(self):
+    e_np1 = self.efinal * 1.0e-4
+    res = self.model.update_sd_scale(e_np1, np.zeros((6,)), self.T, self.T,
+        self.tfinal * 1.0e-4, 0.0, np.zeros((6,)), self.model.init_store(),
+        0.0, 0.0)
+    self.assertTrue(res[-1] > 1.0)
+
+  def test_refine(self):
+    coarse = min(self.scale(self.nsteps))
+    fine = min(self.scale(self.nsteps * 10))
+    self.assertTrue(coarse < 1.0)
+    self.assertTrue(fine > coarse)
+
+class TestPerfectPlasticity(CommonStepScale, unittest.TestCase):
+  def setUp(self):
+    E = 92000.0
+    nu = 0.3
+    mu = E/(2*(1+nu))
+    K = E/(3*(1-2*nu))
+
+    elastic = elasticity.IsotropicLinearElasticModel(mu, "shear", K, "bulk")
+    surface = surfaces.IsoJ2()
+    self.model = models.SmallStrainPerfectPlasticity(elastic, surface, 180.0)
+
+    self.efinal = np.array([0.1,-0.05,0.02,-0.03,0.1,-0.15])
+    self.tfinal = 10.0
+    self.T = 300.0
+    self.nsteps = 10
+
+class TestGeneralIntegrator(CommonStepScale, unittest.TestCase):
+  def setUp(self):
+    E = 92000.0
+    nu = 0.3
+    mu = E/(2*(1+nu))
+    K = E/(3*(1-2*nu))
+
+    elastic = elasticity.IsotropicLinearElasticModel(mu, "shear", K, "bulk")
+    surface = surfaces.IsoJ2()
+    hrule = hardening.VoceIsotropicHardeningRule(180.0, 150.0, 10.0)
+    g = visco_flow.GPowerLaw(2.0, 200.0)
+    vmodel = visco_flow.PerzynaFlowRule(surface, hrule, g)
+    flow = general_flow.TVPFlowRule(elastic, vmodel)
+    self.model = models.GeneralIntegrator(elastic, flow)
+
+    self.efinal = np.array([0.05,0,0,0.02,0,-0.01])
+    self.tfinal = 10.0
+    self.T = 300.0
+    self.nsteps = 10
+
+  def test_stats(self):
+    e_np1 = self.efinal / self.nsteps
+    self.model.update_sd_scale(e_np1, np.zeros((6,)), self.T, self.T,
+        self.tfinal / self.nsteps, 0.0, np.zeros((6,)), self.model.init_store(),
+        0.0, 0.0)
+    stats = solvers.solve_stats()
+    self.assertTrue(stats.nsolves > 0)
+    self.assertTrue(stats.niter >= stats.max_iter)
@@ -0,0 +1,99 @@
+import sys
+sys.path.append('..')
+
+from neml import trace, parse, models, elasticity, surfaces
+from common import *
+
+import unittest
+import tempfile
+import json
+import os
+import numpy as np
+
+class TestTrace(unittest.TestCase):
+  """
+    Chrome trace events from inside the material point updates
+  """
+  def setUp(self):
+    self.model = parse.parse_xml("test/examples.xml", "test_j2iso")
+    self.T = 300.0
+    self.efinal = np.array([0.01,-0.005,-0.005,0.002,0,0])
+    fd, self.fname = tempfile.mkstemp(suffix = ".json")
+    os.close(fd)
+
+  def tearDown(self):
+    trace.stop_trace()
+    os.remove(self.fname)
+
+  def path(self, model, nsteps = 10):
+    # Steps are at times 1, 2, ..., so the time numbers the point
+    def update(*args):
+      trace.trace_set_point(int(args[4]))
+      return model.update_sd(*args)
+    for args, res in strain_path(model, ramp(self.efinal, nsteps),
+        T = self.T, update = update):
+      pass
+
+  def events(self):
+    with open(self.fname) as f:
+      return json.load(f)["traceEvents"]
+
+  def test_file(self):
+    trace.start_trace(self.fname)
+    self.assertTrue(trace.tracing())
+    self.path(self.model)
+    trace.stop_trace()
+    self.assertFalse(trace.tracing())
+    events = self.events()
+    if not trace.trace_compiled():
+      self.assertEqual(len(events), 0)
+
+  @unittest.skipUnless(trace.trace_compiled(), "tracing not compiled in")
+  def test_events(self):
+    trace.start_trace(self.fname)
+    self.path(self.model)
+    trace.stop_trace()
+    events = self.events()
+    names = set(e["name"] for e in events)
+    for n in ["SmallStrainRateIndependentPlasticity::update_sd",
+        "SmallStrainRateIndependentPlasticity::make_trial_state",
+        "SmallStrainRateIndependentPlasticity::calc_tangent_",
+        "yield check", "solve", "iteration"]:
+      self.assertIn(n, names)
+    updates = [e for e in events 
+        if e["name"] == "SmallStrainRateIndependentPlasticity::update_sd"]
+    self.assertEqual(len(updates), 10)
+    self.assertEqual(sorted(e["pid"] for e in updates), list(range(1,11)))
+    for e in events:
+      if e["name"] == "iteration":
+        self.assertIn("norm", e["args"])
+
+  @unittest.skipUnless(trace.trace_compiled(), "tracing not compiled in")
+  def test_points(self):
+    trace.start_trace(self.fname, [3, 7])
+    self.path(self.model)
+    trace.stop_trace()
+    events = self.events()
+    self.assertTrue(len(events) > 0)
+    self.assertEqual(set(e["pid"] for e in events), set([3, 7]))
+
+  @unittest.skipUnless(trace.trace_compiled(), "tracing not compiled in")
+  def test_failures(self):
+    elastic = elasticity.IsotropicLinearElasticModel(150000.0, "youngs",
+        0.3, "poissons")
+    model = models.SmallStrainPerfectPlasticity(elastic,
+        surfaces.IsoJ2I1(1.0, 2.0), 200.0, miter = 3)
+    trace.start_trace(self.fname, failures = True)
+    self.path(self.model)
+    trace.trace_set_point(100)
+    with self.assertRaises(Exception):
+      model.update_sd(np.array([0.01,0.01,0.01,0,0,0]), np.zeros((6,)),
+          self.T, self.T, 1.0, 0.0, np.zeros((6,)), model.init_store(), 
+          0.0, 0.0)
+    trace.stop_trace()
+    events = self.events()
+    self.assertTrue(len(events) > 0)
+    self.assertEqual(set(e["pid"] for e in events), set([100]))
+    names = [e["name"] for e in events]
+    self.assertIn("error", names)
+    self.assertIn("subdivide", names)
@@ -5,6 +5,7 @@ from neml import visco_flow, surfaces, hardening
 from common import *
 
 import unittest
+import json
 import numpy as np
 import numpy.linalg as la
 
@@ -675,3 +676,105 @@ class TestYaguchiGr91Flow(unittest.TestCase, CommonFlowRule):
     C1s_direct = np.piecewise(self.pTrange, [self.pTrange < 673.0, np.logical_and(673.0 <= self.pTrange, self.pTrange < 773.0), self.pTrange >= 773.0], [lambda x: 1.50e3, lambda x: -2.879e4 + 45.0*x, lambda x: 6.000e3])
     self.assertTrue(np.allclose(C1s_model, C1s_direct))
 
+
+class TestYaguchiGr91DualDerivatives(unittest.TestCase):
+  """
+    The automatic derivatives from dual numbers, which the hand coded
+    derivatives override, against finite differences and the hand coded
+    versions.
+  """
+  def setUp(self):
+    self.model = visco_flow.YaguchiGr91FlowRule()
+    self.T = 500.0
+    self.stress = np.array([200,75,100,50,-50,100])*0.1
+    X1 = make_dev([15.0,-20.0,-30.0,50.0,-10.0,5])
+    X2 = make_dev([-25,10,15,30,-15,20])
+    self.hist = np.array(list(X1) + list(X2) + [50.0] + [5.0]) / 10.0
+
+  def check(self, fname):
+    f = getattr(self.model, fname)
+    auto_s = getattr(self.model, "auto_d" + fname + "_ds")
+    auto_a = getattr(self.model, "auto_d" + fname + "_da")
+    hand_s = getattr(self.model, "d" + fname + "_ds")
+    hand_a = getattr(self.model, "d" + fname + "_da")
+
+    num = differentiate(lambda s: f(s, self.hist, self.T), self.stress)
+    exact = auto_s(self.stress, self.hist, self.T)
+    self.assertTrue(np.allclose(num, exact, rtol = 1.0e-3, atol = 1.0e-6))
+    self.assertTrue(np.allclose(exact, hand_s(self.stress, self.hist, self.T),
+      rtol = 1.0e-12, atol = 1.0e-12))
+
+    num = differentiate(lambda a: f(self.stress, a, self.T), self.hist)
+    exact = auto_a(self.stress, self.hist, self.T)
+    self.assertTrue(np.allclose(num, exact, rtol = 1.0e-3, atol = 1.0e-6))
+    self.assertTrue(np.allclose(exact, hand_a(self.stress, self.hist, self.T),
+      rtol = 1.0e-12, atol = 1.0e-12))
+
+  def test_y(self):
+    self.check("y")
+
+  def test_g(self):
+    self.check("g")
+
+  def test_h(self):
+    self.check("h")
+
+  def test_h_time(self):
+    num = differentiate(lambda s: self.model.h_time(s, self.hist, self.T),
+        self.stress)
+    exact = self.model.auto_dh_ds_time(self.stress, self.hist, self.T)
+    self.assertTrue(np.allclose(num, exact, rtol = 1.0e-3, atol = 1.0e-6))
+    self.assertTrue(np.allclose(exact,
+      self.model.dh_ds_time(self.stress, self.hist, self.T),
+      rtol = 1.0e-12, atol = 1.0e-12))
+
+    num = differentiate(lambda a: self.model.h_time(self.stress, a, self.T),
+        self.hist)
+    exact = self.model.auto_dh_da_time(self.stress, self.hist, self.T)
+    self.assertTrue(np.allclose(num, exact, rtol = 1.0e-3, atol = 1.0e-6))
+    self.assertTrue(np.allclose(exact,
+      self.model.dh_da_time(self.stress, self.hist, self.T),
+      rtol = 1.0e-12, atol = 1.0e-12))
+
+class TestYaguchiGr91ReferenceDerivatives(unittest.TestCase):
+  """
+    The hand coded and automatic derivatives against recorded values, at
+    states that cover the temperature ranges of the interpolated parameters.
+  """
+  def setUp(self):
+    self.model = visco_flow.YaguchiGr91FlowRule()
+    with open("test/yaguchi_derivatives.json") as f:
+      self.states = json.load(f)
+
+  def check(self, fname):
+    for st in self.states:
+      s = np.array(st["stress"])
+      h = np.array(st["hist"])
+      for prefix in ["", "auto_"]:
+        exact = getattr(self.model, prefix + fname)(s, h, st["T"])
+        self.assertTrue(np.allclose(np.array(exact).flatten(), st[fname],
+          rtol = 1.0e-12, atol = 1.0e-12))
+
+  def test_dy_ds(self):
+    self.check("dy_ds")
+
+  def test_dy_da(self):
+    self.check("dy_da")
+
+  def test_dg_ds(self):
+    self.check("dg_ds")
+
+  def test_dg_da(self):
+    self.check("dg_da")
+
+  def test_dh_ds(self):
+    self.check("dh_ds")
+
+  def test_dh_da(self):
+    self.check("dh_da")
+
+  def test_dh_ds_time(self):
+    self.check("dh_ds_time")
+
+  def test_dh_da_time(self):
+    self.check("dh_da_time")
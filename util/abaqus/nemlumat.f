@@ -90,7 +90,7 @@ c
       double precision, dimension(6,6) :: A_np1
       double precision, dimension(NSTATV) :: h_np1, h_n
       double precision :: temp_np1, temp_n, time_np1, time_n,
-     1 u_np1, u_n, p_np1, p_n
+     1 u_np1, u_n, p_np1, p_n, dt_scale
 c
 c           Setup the names as C strings
 c
@@ -166,18 +166,24 @@ c
       u_n = SSE + SPD
       p_n = SPD
 c
-      call update_sd_nemlmodel(model, e_np1, e_n, temp_np1, temp_n,
-     1 time_np1, time_n, s_np1, s_n, h_np1, h_n, A_np1, u_np1, u_n,
-     2 p_np1, p_n, ier)
+      call update_sd_scale_nemlmodel(model, e_np1, e_n, temp_np1,
+     1 temp_n, time_np1, time_n, s_np1, s_n, h_np1, h_n, A_np1, u_np1,
+     2 u_n, p_np1, p_n, dt_scale, ier)
 c
-c           Only thing to do is reduce the timestep
+c           Only thing to do is reduce the timestep, by the amount the
+c           model suggests
 c
       if (ier .ne. 0) then
             write(*,*) "WARNING: Model requested step reduction!"
-            PNEWDT = 0.5
+            PNEWDT = dt_scale
             return
       end if
 c
+c           A value less than one would throw away a converged
+c           increment, so only pass on growth (or holding the step)
+c
+      PNEWDT = max(dt_scale, 1.0d0)
+c
 c     Translate back
 c
       call bconvertt(transpose(A_np1), imap, smult, emult, DDSDDE)
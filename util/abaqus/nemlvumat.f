@@ -0,0 +1,83 @@
+      subroutine vumat(
+C Read only -
+     1  nblock, ndir, nshr, nstatev, nfieldv, nprops, lanneal,
+     2  stepTime, totalTime, dt, cmname, coordMp, charLength,
+     3  props, density, strainInc, relSpinInc,
+     4  tempOld, stretchOld, defgradOld, fieldOld,
+     5  stressOld, stateOld, enerInternOld, enerInelasOld,
+     6  tempNew, stretchNew, defgradNew, fieldNew,
+C Write only -
+     7  stressNew, stateNew, enerInternNew, enerInelasNew)
+C
+      use, intrinsic :: iso_c_binding
+      include 'vaba_param.inc'
+      include 'neml_interface.f'
+C
+      dimension props(nprops), density(nblock), coordMp(nblock,*),
+     1  charLength(nblock), strainInc(nblock,ndir+nshr),
+     2  relSpinInc(nblock,nshr), tempOld(nblock),
+     3  stretchOld(nblock,ndir+nshr),
+     4  defgradOld(nblock,ndir+nshr+nshr),
+     5  fieldOld(nblock,nfieldv), stressOld(nblock,ndir+nshr),
+     6  stateOld(nblock,nstatev), enerInternOld(nblock),
+     7  enerInelasOld(nblock), tempNew(nblock),
+     8  stretchNew(nblock,ndir+nshr),
+     9  defgradNew(nblock,ndir+nshr+nshr),
+     1  fieldNew(nblock,nfieldv),
+     2  stressNew(nblock,ndir+nshr), stateNew(nblock,nstatev),
+     3  enerInternNew(nblock), enerInelasNew(nblock)
+C
+      character*80 cmname
+c
+c           Default model names, the NEML_XML_FILE and NEML_MODEL_NAME
+c           environment variables override them
+c
+      character(len=64) :: fname_hc, mname_hc
+      parameter(fname_hc='neml.xml')
+      parameter(mname_hc='abaqus')
+c
+c           Used for NEML call
+c
+      character(len=256) :: fname_env, mname_env
+      character(len=257,kind=c_char) :: fname, mname
+      type(c_ptr) :: model
+      integer :: ier, lenv, istat
+c
+c           Setup the names as C strings
+c
+      call get_environment_variable('NEML_XML_FILE', fname_env, lenv,
+     1 istat)
+      if (istat .ne. 0) fname_env = fname_hc
+      call get_environment_variable('NEML_MODEL_NAME', mname_env, lenv,
+     1 istat)
+      if (istat .ne. 0) mname_env = mname_hc
+      fname = trim(fname_env)//C_NULL_CHAR
+      mname = trim(mname_env)//C_NULL_CHAR
+c
+c           The model is loaded on the first call and then reused
+c
+      model = cached_nemlmodel(fname, mname, ier)
+      if (ier .ne. 0) then
+            write(*,*) "ERROR: Could not load NEML model!"
+            stop
+      end if
+c
+c           The state variables hold the NEML history followed by the
+c           six components of total strain, so NSTATEV must be at
+c           least nstore + 6.  The whole block is updated at once,
+c           threaded over the points if NEML was built with OpenMP.
+c
+      call vumat_nemlmodel(model, nblock, ndir, nshr, nstatev,
+     1 stepTime, totalTime, dt, density, strainInc, tempOld,
+     2 stressOld, stateOld, enerInternOld, enerInelasOld, tempNew,
+     3 stressNew, stateNew, enerInternNew, enerInelasNew, ier)
+c
+c           Explicit cannot cut back, failed points keep their old state
+c
+      if (ier .ne. 0) then
+            write(*,*) "WARNING: NEML update failed in VUMAT block!"
+      end if
+c
+      return
+
+      end
@@ -4,20 +4,26 @@
 
 #include "parse.h"
 
+#include <string>
+
 int main(int argc, char ** argv) {
 
-  if (argc != 3) {
+  if ((argc != 3) && (argc != 4)) {
     std::cout << "Need two command line arguments: file and model name." << std::endl;
+    std::cout << "Add a third argument, vumat, to report for the VUMAT." << std::endl;
     return -1;
   }
 
   auto model = neml::parse_xml(argv[1], argv[2]);
 
-  int n = model->nstore();
+  // The VUMAT also stores the total strain
+  bool vumat = (argc == 4) && (std::string(argv[3]) == "vumat");
+  int n = model->nstore() + (vumat ? 6 : 0);
 
   double * ihist = new double[n];
   
-  model->init_hist(ihist);
+  model->init_store(ihist);
+  for (int i=model->nstore(); i<n; i++) ihist[i] = 0.0;
 
   std::cout << std::endl;
   
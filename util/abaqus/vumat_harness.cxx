@@ -0,0 +1,216 @@
+#include "vumat_harness.h"
+
+#include "cinterface.h"
+#include "nemlerror.h"
+#include "reduced.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Drive the VUMAT the way Abaqus/Explicit does, with blocks of points in
+// column major arrays, and compare against point by point updates of the
+// reference model
+static bool run_block(neml::NEMLModel & model, neml::NEMLModel & ref,
+                      int ndir, int nshr, int nblock, int nsteps, double T,
+                      double rtol)
+{
+  int nstore = model.nstore();
+  int nref = ref.nstore();
+
+  int ntens = ndir + nshr;
+  int nstatev = nstore + 6;
+  int nfieldv = 0;
+  int nprops = 0;
+  int lanneal = 0;
+
+  double emax = 0.02;
+  double tmax = 100.0;
+  double dt = tmax / nsteps;
+
+  // Unused by the VUMAT, but part of the calling convention
+  char cmname[80];
+  std::fill(cmname, cmname+80, ' ');
+  std::vector<double> props(1), coordMp(nblock*3), charLength(nblock),
+      relSpinInc(nblock*nshr), stretchOld(nblock*ntens),
+      defgradOld(nblock*(ndir+2*nshr)), fieldOld(nblock),
+      stretchNew(nblock*ntens), defgradNew(nblock*(ndir+2*nshr)),
+      fieldNew(nblock);
+
+  std::vector<double> density(nblock, 1.0), strainInc(nblock*ntens),
+      tempOld(nblock, T), tempNew(nblock, T),
+      stressOld(nblock*ntens, 0.0), stressNew(nblock*ntens),
+      stateOld(nblock*nstatev, 0.0), stateNew(nblock*nstatev),
+      enerInternOld(nblock, 0.0), enerInelasOld(nblock, 0.0),
+      enerInternNew(nblock), enerInelasNew(nblock);
+
+  // Reference point by point data, in Mandel notation
+  std::vector<double> e_n(nblock*6, 0.0), e_np1(nblock*6),
+      s_n(nblock*6, 0.0), s_np1(nblock*6), h_n(nblock*nref),
+      h_np1(nblock*nref), A_np1(36);
+
+  // Each point gets a different proportional strain direction in the
+  // components the VUMAT is given
+  const int shear[3] = {5, 3, 4};
+  int imap[6];
+  double mult[6];
+  for (int k=0; k<ndir; k++) {
+    imap[k] = k;
+    mult[k] = 1.0;
+  }
+  for (int k=0; k<nshr; k++) {
+    imap[ndir+k] = shear[k];
+    mult[ndir+k] = sqrt(2.0);
+  }
+  std::vector<double> direction(nblock*ntens);
+  unsigned int seed = 12345;
+  for (int i=0; i<nblock; i++) {
+    double norm = 0.0;
+    for (int k=0; k<ntens; k++) {
+      seed = 1103515245 * seed + 12345;
+      direction[i+k*nblock] = ((seed >> 16) % 2001) / 1000.0 - 1.0;
+      norm += pow(direction[i+k*nblock] * mult[k], 2.0);
+    }
+    for (int k=0; k<ntens; k++) direction[i+k*nblock] /= sqrt(norm);
+  }
+
+  // Equivalent of *INITIAL CONDITIONS, TYPE=SOLUTION
+  std::vector<double> store(nstore), rstore(nref);
+  model.init_store(&store[0]);
+  ref.init_store(&rstore[0]);
+  for (int i=0; i<nblock; i++) {
+    for (int j=0; j<nstore; j++) stateOld[i+j*nblock] = store[j];
+    for (int j=0; j<nref; j++) h_n[i*nref+j] = rstore[j];
+  }
+
+  // Packager call with fictitious strains
+  double stepTime = 0.0;
+  double totalTime = 0.0;
+  double dt0 = 0.0;
+  for (int i=0; i<nblock*ntens; i++) strainInc[i] = 1.0e-6 * direction[i];
+  vumat_(&nblock, &ndir, &nshr, &nstatev, &nfieldv, &nprops, &lanneal,
+         &stepTime, &totalTime, &dt0, cmname, &coordMp[0], &charLength[0],
+         &props[0], &density[0], &strainInc[0], &relSpinInc[0],
+         &tempOld[0], &stretchOld[0], &defgradOld[0], &fieldOld[0],
+         &stressOld[0], &stateOld[0], &enerInternOld[0], &enerInelasOld[0],
+         &tempNew[0], &stretchNew[0], &defgradNew[0], &fieldNew[0],
+         &stressNew[0], &stateNew[0], &enerInternNew[0], &enerInelasNew[0],
+         80);
+
+  double max_diff = 0.0;
+  double max_stress = 0.0;
+  int nfail = 0;
+  double vumat_time = 0.0;
+
+  for (int step=1; step<=nsteps; step++) {
+    stepTime = dt * step;
+    totalTime = dt * step;
+    for (int i=0; i<nblock*ntens; i++) {
+      strainInc[i] = emax / nsteps * direction[i];
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    vumat_(&nblock, &ndir, &nshr, &nstatev, &nfieldv, &nprops, &lanneal,
+           &stepTime, &totalTime, &dt, cmname, &coordMp[0], &charLength[0],
+           &props[0], &density[0], &strainInc[0], &relSpinInc[0],
+           &tempOld[0], &stretchOld[0], &defgradOld[0], &fieldOld[0],
+           &stressOld[0], &stateOld[0], &enerInternOld[0], &enerInelasOld[0],
+           &tempNew[0], &stretchNew[0], &defgradNew[0], &fieldNew[0],
+           &stressNew[0], &stateNew[0], &enerInternNew[0], &enerInelasNew[0],
+           80);
+    auto end = std::chrono::steady_clock::now();
+    vumat_time += std::chrono::duration<double>(end - start).count();
+
+    for (int i=0; i<nblock; i++) {
+      for (int k=0; k<ntens; k++) {
+        e_np1[i*6+imap[k]] = e_n[i*6+imap[k]] + strainInc[i+k*nblock] *
+            mult[k];
+      }
+      double u_np1, p_np1;
+      int ier = ref.update_sd(&e_np1[i*6], &e_n[i*6], T, T,
+                              totalTime + dt, totalTime,
+                              &s_np1[i*6], &s_n[i*6],
+                              &h_np1[i*nref], &h_n[i*nref],
+                              &A_np1[0], u_np1, 0.0, p_np1, 0.0);
+      if (ier != neml::SUCCESS) {
+        nfail++;
+        continue;
+      }
+      for (int k=0; k<ntens; k++) {
+        double ref = s_np1[i*6+imap[k]] / mult[k];
+        max_diff = std::max(max_diff, fabs(stressNew[i+k*nblock] - ref));
+        max_stress = std::max(max_stress, fabs(ref));
+      }
+    }
+
+    std::swap(stressOld, stressNew);
+    std::swap(stateOld, stateNew);
+    std::swap(enerInternOld, enerInternNew);
+    std::swap(enerInelasOld, enerInelasNew);
+    std::swap(e_n, e_np1);
+    std::swap(s_n, s_np1);
+    std::swap(h_n, h_np1);
+  }
+
+  std::cout << "Direct, shear components:\t" << ndir << ", " << nshr
+      << std::endl;
+  std::cout << "Points per block:\t\t" << nblock << std::endl;
+  std::cout << "Steps:\t\t\t\t" << nsteps << std::endl;
+  std::cout << "Failed updates:\t\t\t" << nfail << std::endl;
+  std::cout << "Max stress difference:\t\t" << max_diff << std::endl;
+  std::cout << "Updates per second:\t\t" << nblock * nsteps / vumat_time
+      << std::endl;
+
+  return (nfail == 0) && (max_diff <= rtol * std::max(max_stress, 1.0));
+}
+
+int main(int argc, char ** argv) {
+
+  if ((argc < 3) || (argc > 6)) {
+    std::cout << "Arguments: file, model name, and optionally the block size, "
+        << "number of steps, and temperature." << std::endl;
+    return -1;
+  }
+
+  int nblock = (argc > 3) ? atoi(argv[3]) : 136;
+  int nsteps = (argc > 4) ? atoi(argv[4]) : 100;
+  double T = (argc > 5) ? atof(argv[5]) : 300.0;
+
+  // The VUMAT reads the model from these
+  setenv("NEML_XML_FILE", argv[1], 1);
+  setenv("NEML_MODEL_NAME", argv[2], 1);
+
+  std::shared_ptr<neml::NEMLModel> model = neml::parse_xml(argv[1], argv[2]);
+
+  // 3D elements
+  bool passed = run_block(*model, *model, 3, 3, nblock, nsteps, T, 1.0e-10);
+  std::cout << std::endl;
+
+  // Plane stress elements, checked against the native plane stress wrapper,
+  // which also holds the (here zero) out of plane shear stresses at zero
+  auto base = std::dynamic_pointer_cast<neml::NEMLModel_sd>(model);
+  if (base) {
+    neml::PlaneStressModel ps(
+        std::const_pointer_cast<neml::LinearElasticModel>(base->elastic()),
+        base, std::make_shared<neml::ConstantInterpolate>(0.0), 1.0e-10, 50,
+        false, true);
+    passed = run_block(*model, ps, 2, 1, nblock, nsteps, T, 1.0e-8)
+        && passed;
+  }
+  else {
+    std::cout << "Skipping plane stress, the model is not small strain"
+        << std::endl;
+  }
+
+  if (not passed) {
+    std::cout << "FAILED" << std::endl;
+    return 1;
+  }
+
+  std::cout << "PASSED" << std::endl;
+  return 0;
+}
@@ -0,0 +1,22 @@
+#ifndef VUMAT_HARNESS_H
+#define VUMAT_HARNESS_H
+
+#include <cstddef>
+
+// The Fortran VUMAT, called with the same arguments Abaqus/Explicit passes
+extern "C" void vumat_(int * nblock, int * ndir, int * nshr, int * nstatev,
+                       int * nfieldv, int * nprops, int * lanneal,
+                       double * stepTime, double * totalTime, double * dt,
+                       char * cmname, double * coordMp, double * charLength,
+                       double * props, double * density, double * strainInc,
+                       double * relSpinInc, double * tempOld,
+                       double * stretchOld, double * defgradOld,
+                       double * fieldOld, double * stressOld,
+                       double * stateOld, double * enerInternOld,
+                       double * enerInelasOld, double * tempNew,
+                       double * stretchNew, double * defgradNew,
+                       double * fieldNew, double * stressNew,
+                       double * stateNew, double * enerInternNew,
+                       double * enerInelasNew, size_t cmname_len);
+
+#endif
@@ -0,0 +1,216 @@
+// Cost and accuracy of the derivatives of a viscoplastic flow rule found
+// three ways: the hand-coded derivatives, forward mode automatic
+// differentiation through DualViscoPlasticFlowRule, and forward finite
+// differences like diff_jac, for the Yaguchi Gr. 91 flow rule.  Times are
+// per call, with the cost of the function itself for reference, and the
+// differences are the largest relative differences from the hand-coded
+// derivatives.  Returns 1 if the automatic derivatives do not match.
+//
+// Usage: bench_dual_flow [repeats]
+
+#include "visco_flow.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace neml;
+
+typedef std::chrono::high_resolution_clock Clock;
+
+// f(s, alpha, out)
+typedef std::function<int(const double *, const double *, double *)> Fn;
+
+// A state with inelastic flow
+struct State {
+  double s[6];
+  std::vector<double> alpha;
+};
+
+static std::vector<State> make_states(const ViscoPlasticFlowRule & rule,
+                                      int nstate)
+{
+  std::vector<State> states;
+  size_t nh = rule.nhist();
+  for (int k=0; k<nstate; k++) {
+    double f = (double) k / nstate;
+    State st;
+    const double dir[6] = {1.0, -0.3, -0.4, 0.2, -0.1, 0.3};
+    for (int i=0; i<6; i++) st.s[i] = (250.0 + 100.0 * f) * dir[i]
+        + 10.0 * sin(i + 7.0 * f);
+    // Deviatoric backstresses
+    st.alpha.resize(nh);
+    for (size_t i=0; i<12; i++) st.alpha[i] = 20.0 * cos(i + 3.0 * f)
+        * (1.0 + f);
+    for (size_t b=0; b<12; b+=6) {
+      double m = (st.alpha[b] + st.alpha[b+1] + st.alpha[b+2]) / 3.0;
+      for (size_t i=0; i<3; i++) st.alpha[b+i] -= m;
+    }
+    st.alpha[12] = 10.0 * f;
+    st.alpha[13] = 5.0 + 40.0 * f;
+    states.push_back(st);
+  }
+  return states;
+}
+
+// Time calls to fn over the states
+static double time_calls(const Fn & fn, const std::vector<State> & states,
+                         size_t nout, int repeats)
+{
+  std::vector<double> out(nout);
+  auto t0 = Clock::now();
+  for (int r=0; r<repeats; r++) {
+    for (auto & st : states) fn(st.s, &st.alpha[0], &out[0]);
+  }
+  auto t1 = Clock::now();
+  return std::chrono::duration<double, std::micro>(t1-t0).count()
+      / (repeats * states.size());
+}
+
+// Forward difference jacobian of f wrt s or alpha, like diff_jac
+static Fn fd_jacobian(const Fn & f, size_t m, size_t nh, bool wrt_s,
+                      double eps = 1.0e-7)
+{
+  return [=](const double * s, const double * alpha, double * J) -> int
+  {
+    size_t n = wrt_s ? 6 : nh;
+    std::vector<double> x0(s, s+6), a0(alpha, alpha+nh);
+    std::vector<double> f0(m), f1(m);
+    f(&x0[0], &a0[0], &f0[0]);
+    std::vector<double> & v = wrt_s ? x0 : a0;
+    for (size_t j=0; j<n; j++) {
+      double save = v[j];
+      double dx = std::max(eps * fabs(save), eps);
+      v[j] += dx;
+      f(&x0[0], &a0[0], &f1[0]);
+      v[j] = save;
+      for (size_t i=0; i<m; i++) J[i*n+j] = (f1[i] - f0[i]) / dx;
+    }
+    return 0;
+  };
+}
+
+// Largest difference relative to the largest entry of a
+static double difference(const Fn & a, const Fn & b,
+                         const std::vector<State> & states, size_t nout)
+{
+  std::vector<double> va(nout), vb(nout);
+  double diff = 0.0;
+  for (auto & st : states) {
+    a(st.s, &st.alpha[0], &va[0]);
+    b(st.s, &st.alpha[0], &vb[0]);
+    double scale = 0.0, d = 0.0;
+    for (size_t i=0; i<nout; i++) {
+      scale = std::max(scale, fabs(va[i]));
+      d = std::max(d, fabs(va[i] - vb[i]));
+    }
+    diff = std::max(diff, d / std::max(scale, 1.0e-30));
+  }
+  return diff;
+}
+
+int main(int argc, char** argv)
+{
+  int repeats = (argc > 1) ? std::atoi(argv[1]) : 200;
+  double T = 823.0;
+
+  YaguchiGr91FlowRule rule;
+  size_t nh = rule.nhist();
+  std::vector<State> states = make_states(rule, 50);
+
+  Fn y = [&](const double * s, const double * a, double * o)
+  {return rule.y(s, a, T, o[0]);};
+  Fn g = [&](const double * s, const double * a, double * o)
+  {return rule.g(s, a, T, o);};
+  Fn h = [&](const double * s, const double * a, double * o)
+  {return rule.h(s, a, T, o);};
+  Fn h_time = [&](const double * s, const double * a, double * o)
+  {return rule.h_time(s, a, T, o);};
+
+  struct Case {
+    std::string name;
+    Fn value;
+    size_t m;
+    bool wrt_s;
+    Fn hand;
+    Fn dual;
+  };
+
+  std::vector<Case> cases = {
+    {"dy_ds", y, 1, true,
+      [&](const double * s, const double * a, double * o)
+      {return rule.dy_ds(s, a, T, o);},
+      [&](const double * s, const double * a, double * o)
+      {return rule.DualBase::dy_ds(s, a, T, o);}},
+    {"dy_da", y, 1, false,
+      [&](const double * s, const double * a, double * o)
+      {return rule.dy_da(s, a, T, o);},
+      [&](const double * s, const double * a, double * o)
+      {return rule.DualBase::dy_da(s, a, T, o);}},
+    {"dg_ds", g, 6, true,
+      [&](const double * s, const double * a, double * o)
+      {return rule.dg_ds(s, a, T, o);},
+      [&](const double * s, const double * a, double * o)
+      {return rule.DualBase::dg_ds(s, a, T, o);}},
+    {"dg_da", g, 6, false,
+      [&](const double * s, const double * a, double * o)
+      {return rule.dg_da(s, a, T, o);},
+      [&](const double * s, const double * a, double * o)
+      {return rule.DualBase::dg_da(s, a, T, o);}},
+    {"dh_ds", h, nh, true,
+      [&](const double * s, const double * a, double * o)
+      {return rule.dh_ds(s, a, T, o);},
+      [&](const double * s, const double * a, double * o)
+      {return rule.DualBase::dh_ds(s, a, T, o);}},
+    {"dh_da", h, nh, false,
+      [&](const double * s, const double * a, double * o)
+      {return rule.dh_da(s, a, T, o);},
+      [&](const double * s, const double * a, double * o)
+      {return rule.DualBase::dh_da(s, a, T, o);}},
+    {"dh_da_time", h_time, nh, false,
+      [&](const double * s, const double * a, double * o)
+      {return rule.dh_da_time(s, a, T, o);},
+      [&](const double * s, const double * a, double * o)
+      {return rule.DualBase::dh_da_time(s, a, T, o);}}
+  };
+
+  std::cout << std::setw(12) << "derivative" << std::setw(10) << "value"
+      << std::setw(10) << "hand" << std::setw(10) << "dual"
+      << std::setw(10) << "fd" << std::setw(12) << "dual/value"
+      << std::setw(12) << "dual diff" << std::setw(12) << "fd diff"
+      << std::endl;
+  std::cout << std::setw(12) << "" << std::setw(10) << "(us)"
+      << std::setw(10) << "(us)" << std::setw(10) << "(us)"
+      << std::setw(10) << "(us)" << std::endl;
+
+  bool ok = true;
+  for (auto & c : cases) {
+    size_t n = c.wrt_s ? 6 : nh;
+    Fn fd = fd_jacobian(c.value, c.m, nh, c.wrt_s);
+
+    double t_value = time_calls(c.value, states, c.m, repeats);
+    double t_hand = time_calls(c.hand, states, c.m*n, repeats);
+    double t_dual = time_calls(c.dual, states, c.m*n, repeats);
+    double t_fd = time_calls(fd, states, c.m*n, repeats);
+    double d_dual = difference(c.hand, c.dual, states, c.m*n);
+    double d_fd = difference(c.hand, fd, states, c.m*n);
+    if (!(d_dual < 1.0e-8)) ok = false;
+
+    std::cout << std::setw(12) << c.name << std::fixed
+        << std::setprecision(3) << std::setw(10) << t_value
+        << std::setw(10) << t_hand << std::setw(10) << t_dual
+        << std::setw(10) << t_fd << std::setprecision(1)
+        << std::setw(12) << t_dual / t_value
+        << std::scientific << std::setprecision(1)
+        << std::setw(12) << d_dual << std::setw(12) << d_fd << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+// Memory bandwidth of a block of material points owning its state, with
+// and without the threads pinned next to their memory, for an elastic
+// model and rate independent J2 plasticity, where the updates do little
+// work per byte of state.  Each run drives every point through the same
+// cyclic strain path with the points' amplitudes scattered.  Times are
+// per step, best over the steps, and the bandwidth is the state read and
+// written in a step over that time.  Returns 1 if the pinned and unpinned
+// runs differ.
+//
+// Usage: bench_point_block [npts] [nsteps] [nthreads]
+
+#include "pointblock.h"
+#include "models.h"
+#include "elasticity.h"
+#include "hardening.h"
+#include "ri_flow.h"
+#include "surfaces.h"
+#include "interpolate.h"
+#include "nemlerror.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace neml;
+
+static std::shared_ptr<Interpolate> cnst(double v)
+{
+  return std::make_shared<ConstantInterpolate>(v);
+}
+
+static std::shared_ptr<NEMLModel> make_model(const std::string & name)
+{
+  auto elastic = std::make_shared<IsotropicLinearElasticModel>(
+      cnst(200000.0), "youngs", cnst(0.3), "poissons");
+  if (name == "elastic") {
+    return std::make_shared<SmallStrainElasticity>(elastic, cnst(0.0), true);
+  }
+  auto iso = std::make_shared<LinearIsotropicHardeningRule>(cnst(200.0),
+                                                            cnst(5000.0));
+  auto flow = std::make_shared<RateIndependentAssociativeFlow>(
+      std::make_shared<IsoJ2>(), iso);
+  return std::make_shared<SmallStrainRateIndependentPlasticity>(elastic,
+      flow, cnst(0.0), 1.0e-8, 50, false, 1.0e-2, false, 0.0, false, true,
+      "closest_point");
+}
+
+// Results of one run
+struct Run {
+  double time;
+  double bandwidth;
+  std::vector<double> stress;
+};
+
+static Run run_block(PointBlock & block, int nsteps)
+{
+  size_t npts = block.npts();
+  const double dir[6] = {1.0, -0.5, -0.5, 0.1, 0.0, 0.0};
+  std::vector<double> e(6*npts);
+
+  Run run;
+  run.time = 1.0e30;
+  for (int i=1; i<=nsteps; i++) {
+    double f = 0.01 * sin(4.0 * M_PI * i / nsteps);
+    for (size_t k=0; k<npts; k++) {
+      double a = 0.5 + (double) ((k * 7919) % 101) / 100.0;
+      for (int j=0; j<6; j++) e[6*k+j] = a * f * dir[j];
+    }
+    block.set_strain(&e[0]);
+    int ier = block.step((double) i);
+    if (ier != SUCCESS) {
+      std::cerr << "Step failed: " << string_error(ier) << std::endl;
+      std::exit(1);
+    }
+    if (block.step_time() < run.time) {
+      run.time = block.step_time();
+      run.bandwidth = block.bandwidth();
+    }
+  }
+  run.stress.assign(block.stress(), block.stress() + 6*npts);
+
+  return run;
+}
+
+int main(int argc, char** argv)
+{
+  size_t npts = (argc > 1) ? std::atol(argv[1]) : 100000;
+  int nsteps = (argc > 2) ? std::atoi(argv[2]) : 10;
+  int nthreads = (argc > 3) ? std::atoi(argv[3]) : 0;
+
+  std::cout << std::setw(10) << "model" << std::setw(8) << "pinned"
+      << std::setw(9) << "threads" << std::setw(7) << "nodes"
+      << std::setw(12) << "step" << std::setw(12) << "bandwidth"
+      << std::endl;
+  std::cout << std::setw(10) << "" << std::setw(8) << ""
+      << std::setw(9) << "" << std::setw(7) << ""
+      << std::setw(12) << "(ms)" << std::setw(12) << "(GB/s)" << std::endl;
+
+  bool ok = true;
+  for (std::string name : {"elastic", "j2"}) {
+    auto model = make_model(name);
+    std::vector<double> ref;
+    for (bool pin : {false, true}) {
+      PointBlock block(model, npts, 300.0, nthreads, pin);
+      Run run = run_block(block, nsteps);
+      if (!pin) ref = run.stress;
+      else if (run.stress != ref) ok = false;
+
+      std::cout << std::setw(10) << name << std::setw(8)
+          << (block.pinned() ? "yes" : "no") << std::setw(9)
+          << block.nthreads() << std::setw(7) << block.nnodes()
+          << std::fixed << std::setprecision(2)
+          << std::setw(12) << run.time * 1.0e3
+          << std::setw(12) << run.bandwidth / 1.0e9 << std::endl;
+      std::cout.unsetf(std::ios::floatfield);
+    }
+  }
+
+  return ok ? 0 : 1;
+}
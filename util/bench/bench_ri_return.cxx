@@ -0,0 +1,163 @@
+// Cost of the closest point and cutting plane returns for rate independent
+// nonassociative Chaboche plasticity, for the two backstress model in the
+// test examples and with an increasing number of backstresses.  Each
+// algorithm integrates the same cyclic uniaxial strain path.  Times are per
+// step over the whole path, best of the repeats, iterations are per plastic
+// step, fallbacks count the cutting plane returns that stalled and went on
+// to closest point projection, and the difference is the largest stress
+// difference along the path relative to the largest stress.
+//
+// Usage: bench_ri_return [repeats]
+
+#include "models.h"
+#include "elasticity.h"
+#include "hardening.h"
+#include "ri_flow.h"
+#include "surfaces.h"
+#include "interpolate.h"
+#include "solvers.h"
+#include "nemlerror.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace neml;
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static std::shared_ptr<Interpolate> cnst(double v)
+{
+  return std::make_shared<ConstantInterpolate>(v);
+}
+
+// The test_nonassri example for nback = 2, otherwise nback/2 copies of its
+// pair of backstresses, scaled down and with slower recovery
+static std::shared_ptr<SmallStrainRateIndependentPlasticity> make_model(
+    int nback, const std::string & algorithm)
+{
+  auto elastic = std::make_shared<IsotropicLinearElasticModel>(
+      cnst(103333.0), "bulk", cnst(40000.0), "shear");
+  auto iso = std::make_shared<VoceIsotropicHardeningRule>(cnst(100.0),
+                                                          cnst(100.0),
+                                                          cnst(1000.0));
+  std::vector<std::shared_ptr<Interpolate>> cs, As, as;
+  std::vector<std::shared_ptr<GammaModel>> gs;
+  for (int i=0; i<nback; i++) {
+    double C = (i % 2 == 0) ? 5.0 : 10.0;
+    cs.push_back(cnst(C * 2.0 / nback));
+    gs.push_back(std::make_shared<ConstantGamma>(cnst(1000.0 / (1 + i/2))));
+    As.push_back(cnst(0.0));
+    as.push_back(cnst(1.0));
+  }
+  auto hard = std::make_shared<Chaboche>(iso, cs, gs, As, as);
+  auto flow = std::make_shared<RateIndependentNonAssociativeHardening>(
+      std::make_shared<IsoKinJ2>(), hard);
+
+  return std::make_shared<SmallStrainRateIndependentPlasticity>(elastic,
+      flow, cnst(0.0), 1.0e-8, 50, false, 1.0e-2, false, 0.0, false, true,
+      algorithm);
+}
+
+// Results of running the path once
+struct Run {
+  std::vector<double> stress;
+  int nplastic;
+  double time;
+};
+
+// Cyclic uniaxial strain path
+static Run run_path(SmallStrainRateIndependentPlasticity & model)
+{
+  Run run;
+  run.nplastic = 0;
+  size_t ns = model.nstore();
+  std::vector<double> h_n(ns), h_np1(ns);
+  model.init_store(&h_n[0]);
+  double e_n[6] = {0,0,0,0,0,0}, s_n[6] = {0,0,0,0,0,0};
+  double e_np1[6], s_np1[6], A_np1[36], u_np1, p_np1, p_n = 0.0;
+  const double dir[6] = {1.0, -0.5, -0.5, 0.0, 0.0, 0.0};
+
+  int nstep = 400;
+  auto t0 = Clock::now();
+  for (int i=1; i<=nstep; i++) {
+    double e = 0.01 * sin(4.0 * M_PI * i / nstep);
+    for (int j=0; j<6; j++) e_np1[j] = e * dir[j];
+    int ier = model.update_sd(e_np1, e_n, 300.0, 300.0, i, i-1, s_np1, s_n,
+                              &h_np1[0], &h_n[0], A_np1, u_np1, 0.0, p_np1,
+                              p_n);
+    if (ier != SUCCESS) {
+      std::cerr << "Update failed: " << string_error(ier) << std::endl;
+      std::exit(1);
+    }
+    if (p_np1 != p_n) run.nplastic++;
+    run.stress.push_back(s_np1[0]);
+    std::copy(e_np1, e_np1+6, e_n);
+    std::copy(s_np1, s_np1+6, s_n);
+    std::swap(h_n, h_np1);
+    p_n = p_np1;
+  }
+  auto t1 = Clock::now();
+  run.time = std::chrono::duration<double, std::micro>(t1-t0).count()
+      / nstep;
+
+  return run;
+}
+
+int main(int argc, char** argv)
+{
+  int repeats = (argc > 1) ? std::atoi(argv[1]) : 20;
+
+  std::cout << std::setw(8) << "nback" << std::setw(12) << "algorithm"
+      << std::setw(10) << "step" << std::setw(10) << "iter"
+      << std::setw(11) << "fallback" << std::setw(10) << "speedup"
+      << std::setw(10) << "diff" << std::endl;
+  std::cout << std::setw(8) << "" << std::setw(12) << ""
+      << std::setw(10) << "(us)" << std::endl;
+
+  for (int nback : {2, 4, 8, 16, 32}) {
+    double t_cpp = 0.0;
+    std::vector<double> s_cpp;
+    for (std::string alg : {"closest_point", "cutting_plane"}) {
+      auto model = make_model(nback, alg);
+
+      solve_stats().reset();
+      Run run = run_path(*model);
+      SolveStats stats = solve_stats();
+      double t = run.time;
+      for (int r=1; r<repeats; r++) t = std::min(t, run_path(*model).time);
+
+      double diff = 0.0;
+      if (alg == "closest_point") {
+        t_cpp = t;
+        s_cpp = run.stress;
+      }
+      else {
+        double smax = 0.0;
+        for (size_t i=0; i<s_cpp.size(); i++) {
+          smax = std::max(smax, fabs(s_cpp[i]));
+          diff = std::max(diff, fabs(s_cpp[i] - run.stress[i]));
+        }
+        diff /= smax;
+      }
+
+      std::cout << std::setw(8) << nback << std::setw(12)
+          << (alg == "closest_point" ? "closest" : "cutting")
+          << std::setw(10) << std::fixed << std::setprecision(2) << t
+          << std::setw(10) << (double) stats.niter / run.nplastic
+          << std::setw(11) << stats.nsolves - run.nplastic
+          << std::setw(10) << t_cpp / t
+          << std::setw(10) << std::scientific << std::setprecision(1)
+          << diff << std::endl;
+      std::cout.unsetf(std::ios::floatfield);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,238 @@
+// Cost of the return map solve and the consistent tangent for
+// rate independent Chaboche plasticity with an increasing number of
+// backstresses.  The old tangent, which evaluated the residual again and
+// inverted the blocks of the jacobian, is kept here for comparison with
+// the current tangent, which reuses the jacobian from the solve.
+//
+// Usage: bench_ri_tangent [repeats]
+
+#include "models.h"
+#include "elasticity.h"
+#include "hardening.h"
+#include "ri_flow.h"
+#include "surfaces.h"
+#include "interpolate.h"
+#include "nemlmath.h"
+#include "nemlerror.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace neml;
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static std::shared_ptr<Interpolate> cnst(double v)
+{
+  return std::make_shared<ConstantInterpolate>(v);
+}
+
+// A step of the load path where the point is plastic
+struct Step {
+  double e_np1[6], e_n[6], s_n[6];
+  std::vector<double> h_n;
+};
+
+static std::shared_ptr<SmallStrainRateIndependentPlasticity> make_model(
+    int nback, std::shared_ptr<RateIndependentFlowRule> & flow)
+{
+  auto elastic = std::make_shared<IsotropicLinearElasticModel>(
+      cnst(92000.0), "youngs", cnst(0.3), "poissons");
+  auto iso = std::make_shared<LinearIsotropicHardeningRule>(cnst(180.0),
+                                                            cnst(1000.0));
+  std::vector<std::shared_ptr<Interpolate>> cs, As, as;
+  std::vector<std::shared_ptr<GammaModel>> gs;
+  for (int i=0; i<nback; i++) {
+    cs.push_back(cnst(20000.0 / (i+1)));
+    gs.push_back(std::make_shared<ConstantGamma>(cnst(500.0 / (i+1))));
+    As.push_back(cnst(0.0));
+    as.push_back(cnst(1.0));
+  }
+  auto hard = std::make_shared<Chaboche>(iso, cs, gs, As, as);
+  flow = std::make_shared<RateIndependentNonAssociativeHardening>(
+      std::make_shared<IsoKinJ2>(), hard);
+
+  return std::make_shared<SmallStrainRateIndependentPlasticity>(elastic,
+      flow, cnst(0.0), 1.0e-8, 50, false, 1.0e-2, false, 0.0, false, true,
+      "closest_point");
+}
+
+// The tangent as it was: evaluate the residual again at the solution,
+// copy out the blocks, invert twice, and chain the products
+static int old_tangent(SmallStrainRateIndependentPlasticity & model,
+                       RateIndependentFlowRule & flow, const double * const x,
+                       SSRIPTrialState & ts, double * const A_np1)
+{
+  int n = model.nparams();
+  int nk = 6;
+  int ne = n - nk;
+  int nh = flow.nhist();
+
+  std::vector<double> R(n), J(n*n);
+  int ier = model.RJ(x, &ts, &R[0], &J[0]);
+  if (ier != SUCCESS) return ier;
+
+  double ee[6], s[6];
+  sub_vec(ts.e_np1, x, 6, ee);
+  mat_vec(ts.C, 6, ee, 6, s);
+  const double * h = &x[6];
+  double dg = x[6+nh];
+
+  std::vector<double> Jkk(nk*nk), Jke(nk*ne), Jek(ne*nk), Jee(ne*ne);
+  for (int i=0; i<nk; i++) {
+    for (int j=0; j<nk; j++) Jkk[CINDEX(i,j,nk)] = J[CINDEX(i,j,n)];
+    for (int j=0; j<ne; j++) Jke[CINDEX(i,j,ne)] = J[CINDEX(i,(j+nk),n)];
+  }
+  for (int i=0; i<ne; i++) {
+    for (int j=0; j<nk; j++) Jek[CINDEX(i,j,nk)] = J[CINDEX((i+nk),j,n)];
+    for (int j=0; j<ne; j++) {
+      Jee[CINDEX(i,j,ne)] = J[CINDEX((i+nk),(j+nk),n)];
+    }
+  }
+  ier = invert_mat(&Jee[0], ne);
+  if (ier != SUCCESS) return ier;
+
+  std::vector<double> A(nk*6), B(ne*6), dg_ds(36), dh_ds(nh*6);
+  double df_ds[6];
+  flow.dg_ds(s, h, ts.T, &dg_ds[0]);
+  flow.dh_ds(s, h, ts.T, &dh_ds[0]);
+  flow.df_ds(s, h, ts.T, df_ds);
+
+  mat_mat(6, 6, 6, &dg_ds[0], ts.C, &A[0]);
+  for (int i=0; i<nk*6; i++) A[i] *= dg;
+  mat_mat(nh, 6, 6, &dh_ds[0], ts.C, &B[0]);
+  for (int i=0; i<nh*6; i++) B[i] *= dg;
+  mat_vec_trans(ts.C, 6, df_ds, 6, &B[nh*6]);
+
+  std::vector<double> T1(ne*nk), T2(nk*nk), T3(ne*nk), T4(nk*nk);
+  mat_mat(ne, nk, ne, &Jee[0], &Jek[0], &T1[0]);
+  mat_mat(nk, nk, ne, &Jke[0], &T1[0], &T2[0]);
+  for (int i=0; i<nk*nk; i++) T2[i] = Jkk[i] - T2[i];
+  ier = invert_mat(&T2[0], nk);
+  if (ier != SUCCESS) return ier;
+  mat_mat(ne, nk, ne, &Jee[0], &B[0], &T3[0]);
+  mat_mat(nk, nk, ne, &Jke[0], &T3[0], &T4[0]);
+  for (int i=0; i<nk*nk; i++) T4[i] -= A[i];
+
+  double dep[36];
+  mat_mat(6, 6, 6, &T2[0], &T4[0], dep);
+  for (int i=0; i<36; i++) dep[i] = -dep[i];
+  for (int i=0; i<6; i++) dep[CINDEX(i,i,6)] += 1.0;
+  mat_mat(6, 6, 6, ts.C, dep, A_np1);
+
+  return 0;
+}
+
+// Cyclic uniaxial strain path, keeping the plastic steps
+static std::vector<Step> plastic_steps(SmallStrainRateIndependentPlasticity &
+                                       model)
+{
+  std::vector<Step> steps;
+  size_t ns = model.nstore();
+  std::vector<double> h_n(ns), h_np1(ns);
+  model.init_store(&h_n[0]);
+  double e_n[6] = {0,0,0,0,0,0}, s_n[6] = {0,0,0,0,0,0};
+  double e_np1[6], s_np1[6], A_np1[36], u_np1, p_np1;
+  const double dir[6] = {1.0, -0.5, -0.5, 0.0, 0.0, 0.0};
+
+  int nstep = 200;
+  for (int i=1; i<=nstep; i++) {
+    double e = 0.01 * sin(4.0 * M_PI * i / nstep);
+    for (int j=0; j<6; j++) e_np1[j] = e * dir[j];
+    int ier = model.update_sd(e_np1, e_n, 300.0, 300.0, i, i-1, s_np1, s_n,
+                              &h_np1[0], &h_n[0], A_np1, u_np1, 0.0, p_np1,
+                              0.0);
+    if (ier != SUCCESS) break;
+    if (p_np1 > 0.0) {
+      Step st;
+      std::copy(e_np1, e_np1+6, st.e_np1);
+      std::copy(e_n, e_n+6, st.e_n);
+      std::copy(s_n, s_n+6, st.s_n);
+      st.h_n = h_n;
+      steps.push_back(st);
+    }
+    std::copy(e_np1, e_np1+6, e_n);
+    std::copy(s_np1, s_np1+6, s_n);
+    std::swap(h_n, h_np1);
+  }
+
+  return steps;
+}
+
+int main(int argc, char** argv)
+{
+  int repeats = (argc > 1) ? std::atoi(argv[1]) : 20;
+
+  std::cout << std::setw(8) << "nback" << std::setw(12) << "solve"
+      << std::setw(14) << "old tangent" << std::setw(14) << "new tangent"
+      << std::setw(12) << "speedup" << std::setw(12) << "diff" << std::endl;
+  std::cout << std::setw(8) << "" << std::setw(12) << "(us)"
+      << std::setw(14) << "(us)" << std::setw(14) << "(us)" << std::endl;
+
+  for (int nback : {1, 2, 4, 8, 16}) {
+    std::shared_ptr<RateIndependentFlowRule> flow;
+    auto model = make_model(nback, flow);
+    std::vector<Step> steps = plastic_steps(*model);
+    int n = model->nparams();
+    size_t ns = model->nstore();
+
+    double t_solve = 0.0, t_update = 0.0, t_old = 0.0, diff = 0.0;
+    std::vector<double> x(n), h_np1(ns);
+    double s_np1[6], A_new[36], A_old[36], u_np1, p_np1;
+    size_t count = 0;
+
+    for (int r=0; r<repeats; r++) {
+      for (auto & st : steps) {
+        // The whole update, with the current tangent
+        auto t0 = Clock::now();
+        model->update_sd(st.e_np1, st.e_n, 300.0, 300.0, 1.0, 0.0, s_np1,
+                         st.s_n, &h_np1[0], &st.h_n[0], A_new, u_np1, 0.0,
+                         p_np1, 0.0);
+        auto t1 = Clock::now();
+
+        // Just the return map
+        SSRIPTrialState ts;
+        model->make_trial_state(st.e_np1, st.e_n, 300.0, 300.0, 1.0, 0.0,
+                                st.s_n, &st.h_n[0], ts);
+        solve(model.get(), &x[0], &ts, 1.0e-8, 50);
+        auto t2 = Clock::now();
+
+        // The old tangent at the same solution
+        old_tangent(*model, *flow, &x[0], ts, A_old);
+        auto t3 = Clock::now();
+
+        t_update += std::chrono::duration<double, std::micro>(t1-t0).count();
+        t_solve += std::chrono::duration<double, std::micro>(t2-t1).count();
+        t_old += std::chrono::duration<double, std::micro>(t3-t2).count();
+        count++;
+
+        double nA = 0.0, dA = 0.0;
+        for (int i=0; i<36; i++) {
+          nA = std::max(nA, fabs(A_old[i]));
+          dA = std::max(dA, fabs(A_old[i] - A_new[i]));
+        }
+        diff = std::max(diff, dA / nA);
+      }
+    }
+
+    if (count == 0) continue;
+    // The update also forms the stress and energies, which are cheap
+    double t_new = std::max(t_update - t_solve, 0.0);
+    std::cout << std::setw(8) << nback
+        << std::setw(12) << std::fixed << std::setprecision(2)
+        << t_solve / count
+        << std::setw(14) << t_old / count
+        << std::setw(14) << t_new / count
+        << std::setw(12) << t_old / std::max(t_new, 1.0e-12)
+        << std::setw(12) << std::scientific << std::setprecision(1) << diff
+        << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,661 @@
+#include "ensemble.h"
+
+#include "parse.h"
+#include "reduced.h"
+#include "interpolate.h"
+#include "nemlerror.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef NEML_MPI
+#include <mpi.h>
+#endif
+
+typedef std::chrono::steady_clock Clock;
+
+const double required = std::numeric_limits<double>::quiet_NaN();
+
+// The settings of each protocol with their defaults, NaN if required
+const std::map<std::string, std::map<std::string, double>> protocol_defaults = {
+  {"tension", {{"erate", 1.0e-4}, {"emax", 0.05}, {"nsteps", 100},
+               {"T", 300.0}}},
+  {"cyclic", {{"emax", required}, {"R", -1.0}, {"erate", 1.0e-4},
+              {"ncycles", 10}, {"nsteps", 50}, {"hold", 0.0},
+              {"nhold", 25}, {"T", 300.0}}},
+  {"creep", {{"smax", required}, {"srate", 1.0}, {"hold", required},
+             {"nsteps", 250}, {"nsteps_up", 150}, {"elimit", 1.0},
+             {"T", 300.0}}},
+  {"bree", {{"sp", required}, {"dT", required}, {"period", 3600.0},
+            {"ncycles", 10}, {"nsteps", 20}, {"T", 300.0}}}};
+
+// Settings for the stress controlled steps
+const double stress_tol = 1.0e-8;
+const int stress_miter = 50;
+
+// Messages between the ranks
+const int tag_result = 1;
+const int tag_task = 2;
+
+static std::vector<std::string> split(std::string s, char delim)
+{
+  std::vector<std::string> res;
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, delim)) {
+    if (!item.empty()) res.push_back(item);
+  }
+  return res;
+}
+
+Uniaxial::Uniaxial(std::shared_ptr<neml::NEMLModel_sd> model, double T) :
+    strain(0.0), stress(0.0), time(0.0), temperature(T), strain_trial(0.0),
+    stress_trial(0.0), tangent_trial(0.0), base_(model), e_th_(0.0),
+    e_th_trial_(0.0), t_trial_(0.0), T_trial_(T), u_n_(0.0), p_n_(0.0),
+    u_np1_(0.0), p_np1_(0.0)
+{
+  model_ = std::make_shared<neml::UniaxialStressModel>(
+      std::const_pointer_cast<neml::LinearElasticModel>(model->elastic()),
+      model, std::make_shared<neml::ConstantInterpolate>(0.0), 1.0e-8, 50,
+      false, true);
+  h_n_.resize(model_->nstore());
+  h_np1_.resize(model_->nstore());
+  model_->init_store(&h_n_[0]);
+  std::fill(e_n_, e_n_+6, 0.0);
+  std::fill(s_n_, s_n_+6, 0.0);
+}
+
+int Uniaxial::trial(double e, double t, double T)
+{
+  e_th_trial_ = e_th_ + (T - temperature) * (base_->alpha(T) +
+                                             base_->alpha(temperature)) / 2.0;
+  std::copy(e_n_, e_n_+6, e_np1_);
+  e_np1_[0] = e - e_th_trial_;
+
+  int ier = model_->update_sd(e_np1_, e_n_, T, temperature, t, time, s_np1_,
+                              s_n_, &h_np1_[0], &h_n_[0], A_np1_, u_np1_,
+                              u_n_, p_np1_, p_n_);
+  strain_trial = e;
+  stress_trial = s_np1_[0];
+  tangent_trial = A_np1_[0];
+  t_trial_ = t;
+  T_trial_ = T;
+
+  return ier;
+}
+
+void Uniaxial::accept()
+{
+  std::copy(e_np1_, e_np1_+6, e_n_);
+  std::copy(s_np1_, s_np1_+6, s_n_);
+  std::swap(h_n_, h_np1_);
+  u_n_ = u_np1_;
+  p_n_ = p_np1_;
+  e_th_ = e_th_trial_;
+  strain = strain_trial;
+  stress = stress_trial;
+  time = t_trial_;
+  temperature = T_trial_;
+}
+
+int Uniaxial::strain_step(double e, double t, double T)
+{
+  int ier = trial(e, t, T);
+  if (ier == neml::SUCCESS) accept();
+  return ier;
+}
+
+int Uniaxial::stress_step(double s, double t, double T)
+{
+  double e = strain;
+  for (int i=0; i<stress_miter; i++) {
+    int ier = trial(e, t, T);
+    if (ier != neml::SUCCESS) return ier;
+    double R = stress_trial - s;
+    if (fabs(R) <= stress_tol * std::max(fabs(s), 1.0)) {
+      accept();
+      return neml::SUCCESS;
+    }
+    if (!std::isfinite(tangent_trial) || (tangent_trial == 0.0)) break;
+    e -= R / tangent_trial;
+  }
+  return neml::MAX_ITERATIONS;
+}
+
+// Step two bars held at the same strain to the mean stress s
+static int bars_step(Uniaxial & a, Uniaxial & b, double s, double t,
+                     double Ta, double Tb)
+{
+  double e = a.strain;
+  for (int i=0; i<stress_miter; i++) {
+    int ier = a.trial(e, t, Ta);
+    if (ier == neml::SUCCESS) ier = b.trial(e, t, Tb);
+    if (ier != neml::SUCCESS) return ier;
+    double R = (a.stress_trial + b.stress_trial) / 2.0 - s;
+    double k = (a.tangent_trial + b.tangent_trial) / 2.0;
+    if (fabs(R) <= stress_tol * std::max(fabs(s), 1.0)) {
+      a.accept();
+      b.accept();
+      return neml::SUCCESS;
+    }
+    if (!std::isfinite(k) || (k == 0.0)) break;
+    e -= R / k;
+  }
+  return neml::MAX_ITERATIONS;
+}
+
+void read_tasks(std::string fname, std::vector<Variant> & variants,
+                std::vector<Protocol> & protocols)
+{
+  std::ifstream in(fname);
+  if (!in) throw std::runtime_error("Cannot open task file " + fname);
+
+  // Model files are relative to the task file
+  size_t slash = fname.rfind('/');
+  std::string dir = (slash == std::string::npos) ? "" :
+      fname.substr(0, slash + 1);
+
+  std::string line;
+  int lineno = 0;
+  while (std::getline(in, line)) {
+    lineno++;
+    std::string where = fname + ":" + std::to_string(lineno) + ": ";
+    line = line.substr(0, line.find('#'));
+    std::vector<std::string> words = split(line, ' ');
+    if (words.empty()) continue;
+
+    if (words[0] == "model") {
+      if (words.size() < 4) {
+        throw std::runtime_error(where + "model needs a label, a file, and "
+                                 "a model name");
+      }
+      Variant base;
+      base.label = words[1];
+      base.fname = (words[2][0] == '/') ? words[2] : dir + words[2];
+      base.mname = words[3];
+
+      // Every combination of the listed values
+      std::vector<std::string> paths;
+      std::vector<std::vector<double>> lists;
+      for (size_t i=4; i<words.size(); i++) {
+        size_t eq = words[i].find('=');
+        if (eq == std::string::npos) {
+          throw std::runtime_error(where + "expected path=values, got " +
+                                   words[i]);
+        }
+        paths.push_back(words[i].substr(0, eq));
+        std::vector<double> vals;
+        for (auto & v : split(words[i].substr(eq+1), ',')) {
+          vals.push_back(std::stod(v));
+        }
+        if (vals.empty()) {
+          throw std::runtime_error(where + "no values for " + paths.back());
+        }
+        lists.push_back(vals);
+      }
+
+      // Check the model and the paths once
+      try {
+        auto model = neml::parse_xml(base.fname, base.mname);
+        if (std::dynamic_pointer_cast<neml::NEMLModel_sd>(model) == nullptr) {
+          throw std::runtime_error("not a small strain model");
+        }
+        for (auto & p : paths) neml::get_xml_parameter(base.fname, base.mname,
+                                                       p);
+      }
+      catch (std::exception & e) {
+        throw std::runtime_error(where + "cannot load " + base.mname +
+                                 " from " + base.fname + ": " + e.what());
+      }
+
+      size_t ncomb = 1;
+      for (auto & l : lists) ncomb *= l.size();
+      for (size_t c=0; c<ncomb; c++) {
+        Variant v = base;
+        v.paths = paths;
+        size_t rem = c;
+        for (auto & l : lists) {
+          v.values.push_back(l[rem % l.size()]);
+          rem /= l.size();
+        }
+        variants.push_back(v);
+      }
+    }
+    else if (words[0] == "protocol") {
+      if (words.size() < 3) {
+        throw std::runtime_error(where + "protocol needs a label and a kind");
+      }
+      Protocol p;
+      p.label = words[1];
+      p.kind = words[2];
+      auto defaults = protocol_defaults.find(p.kind);
+      if (defaults == protocol_defaults.end()) {
+        throw std::runtime_error(where + "unknown protocol " + p.kind);
+      }
+      p.settings = defaults->second;
+      for (size_t i=3; i<words.size(); i++) {
+        size_t eq = words[i].find('=');
+        std::string key = words[i].substr(0, eq);
+        if ((eq == std::string::npos) || (p.settings.count(key) == 0)) {
+          throw std::runtime_error(where + "unknown setting " + words[i] +
+                                   " for " + p.kind);
+        }
+        p.settings[key] = std::stod(words[i].substr(eq+1));
+      }
+      for (auto & s : p.settings) {
+        if (std::isnan(s.second)) {
+          throw std::runtime_error(where + p.kind + " needs " + s.first);
+        }
+      }
+      protocols.push_back(p);
+    }
+    else {
+      throw std::runtime_error(where + "unknown line " + words[0]);
+    }
+  }
+}
+
+// Uniaxial tension at a constant strain rate
+static int run_tension(std::shared_ptr<neml::NEMLModel_sd> model,
+                       std::map<std::string, double> & c, Outcome & out)
+{
+  Uniaxial d(model, c["T"]);
+  int n = (int) c["nsteps"];
+  double E = model->elastic()->E(c["T"]);
+  double smax = 0.0;
+  double ys = std::numeric_limits<double>::quiet_NaN();
+
+  double s_n = 0.0;
+  double f_n = 0.0;
+  for (int i=1; i<=n; i++) {
+    double e = c["emax"] * i / n;
+    int ier = d.strain_step(e, e / c["erate"], c["T"]);
+    if (ier != neml::SUCCESS) return ier;
+    smax = std::max(smax, d.stress);
+
+    // 0.2% offset yield stress, interpolated to where the curve crosses
+    // the offset line
+    double f = d.stress - E * (e - 0.002);
+    if (std::isnan(ys) && (f < 0.0) && (i > 1)) {
+      ys = s_n + f_n / (f_n - f) * (d.stress - s_n);
+    }
+    s_n = d.stress;
+    f_n = f;
+  }
+
+  out.values.push_back({"max_stress", smax});
+  out.values.push_back({"final_stress", d.stress});
+  out.values.push_back({"yield_stress", ys});
+
+  return neml::SUCCESS;
+}
+
+// Strain controlled cycles, like the python strain_cyclic
+static int run_cyclic(std::shared_ptr<neml::NEMLModel_sd> model,
+                      std::map<std::string, double> & c, Outcome & out)
+{
+  Uniaxial d(model, c["T"]);
+  double T = c["T"];
+  double emax = c["emax"];
+  double emin = emax * c["R"];
+  int n = (int) c["nsteps"];
+  int nh = (int) c["nhold"];
+  double smax, smin;
+
+  auto ramp = [&](double e0, double e1) -> int
+  {
+    double dt = fabs(e1 - e0) / c["erate"] / n;
+    for (int i=1; i<=n; i++) {
+      int ier = d.strain_step(e0 + (e1 - e0) * i / n, d.time + dt, T);
+      if (ier != neml::SUCCESS) return ier;
+      smax = std::max(smax, d.stress);
+      smin = std::min(smin, d.stress);
+    }
+    return neml::SUCCESS;
+  };
+  auto hold = [&]() -> int
+  {
+    if (c["hold"] <= 0.0) return neml::SUCCESS;
+    for (int i=1; i<=nh; i++) {
+      int ier = d.strain_step(d.strain, d.time + c["hold"] / nh, T);
+      if (ier != neml::SUCCESS) return ier;
+      smax = std::max(smax, d.stress);
+      smin = std::min(smin, d.stress);
+    }
+    return neml::SUCCESS;
+  };
+
+  smax = smin = 0.0;
+  int ier = ramp(0.0, emax);
+  if (ier != neml::SUCCESS) return ier;
+
+  for (int k=0; k<(int) c["ncycles"]; k++) {
+    smax = smin = d.stress;
+    if ((ier = hold()) != neml::SUCCESS) return ier;
+    if ((ier = ramp(emax, emin)) != neml::SUCCESS) return ier;
+    if ((ier = hold()) != neml::SUCCESS) return ier;
+    if ((ier = ramp(emin, emax)) != neml::SUCCESS) return ier;
+
+    std::string i = "[" + std::to_string(k) + "]";
+    out.values.push_back({"max" + i, smax});
+    out.values.push_back({"min" + i, smin});
+    out.values.push_back({"mean" + i, (smax + smin) / 2.0});
+  }
+
+  return neml::SUCCESS;
+}
+
+// Load to a stress and hold, like the python creep
+//  A failure during the hold is rupture, not an error.
+static int run_creep(std::shared_ptr<neml::NEMLModel_sd> model,
+                     std::map<std::string, double> & c, Outcome & out)
+{
+  Uniaxial d(model, c["T"]);
+  double T = c["T"];
+  double smax = c["smax"];
+  int nup = (int) c["nsteps_up"];
+  int n = (int) c["nsteps"];
+
+  for (int i=1; i<=nup; i++) {
+    int ier = d.stress_step(smax * i / nup, smax * i / nup / c["srate"], T);
+    if (ier != neml::SUCCESS) return ier;
+  }
+
+  double e0 = d.strain;
+  double t0 = d.time;
+  double rate = std::numeric_limits<double>::infinity();
+  bool failed = false;
+  for (int i=1; i<=n; i++) {
+    double e_n = d.strain;
+    double t_n = d.time;
+    int ier = d.stress_step(smax, t0 + c["hold"] * i / n, T);
+    if ((ier != neml::SUCCESS) || !std::isfinite(d.strain)
+        || (fabs(d.strain) > c["elimit"]) || (d.strain < e_n)) {
+      failed = true;
+      break;
+    }
+    rate = std::min(rate, (d.strain - e_n) / (d.time - t_n));
+  }
+
+  out.values.push_back({"failed", failed ? 1.0 : 0.0});
+  out.values.push_back({"hold_time", d.time - t0});
+  out.values.push_back({"creep_strain", d.strain - e0});
+  out.values.push_back({"final_strain", d.strain});
+  out.values.push_back({"min_rate", rate});
+
+  return neml::SUCCESS;
+}
+
+// The Bree two bar problem: two bars held at the same strain carry a
+// constant mean stress while one cycles in temperature
+static int run_bree(std::shared_ptr<neml::NEMLModel_sd> model,
+                    std::map<std::string, double> & c, Outcome & out)
+{
+  double T = c["T"];
+  Uniaxial hot(model, T);
+  Uniaxial cold(model, T);
+  int n = (int) c["nsteps"];
+  double dt = c["period"] / (2.0 * n);
+
+  for (int i=1; i<=n; i++) {
+    int ier = bars_step(hot, cold, c["sp"] * i / n, hot.time + dt, T, T);
+    if (ier != neml::SUCCESS) return ier;
+  }
+
+  double e_n = hot.strain;
+  for (int k=0; k<(int) c["ncycles"]; k++) {
+    for (int i=1; i<=2*n; i++) {
+      double f = (i <= n) ? (double) i / n : (double) (2*n - i) / n;
+      int ier = bars_step(hot, cold, c["sp"], hot.time + dt, T + f * c["dT"],
+                          T);
+      if (ier != neml::SUCCESS) return ier;
+    }
+    out.values.push_back({"strain[" + std::to_string(k) + "]", hot.strain});
+    if (k == (int) c["ncycles"] - 1) {
+      out.values.push_back({"ratchet", hot.strain - e_n});
+    }
+    e_n = hot.strain;
+  }
+
+  return neml::SUCCESS;
+}
+
+Outcome run_task(const Variant & variant, const Protocol & protocol)
+{
+  Outcome out;
+  auto start = Clock::now();
+  try {
+    auto model = std::shared_ptr<neml::NEMLModel>(neml::parse_xml_unique(
+        variant.fname, variant.mname, variant.paths, variant.values));
+    auto sd = std::dynamic_pointer_cast<neml::NEMLModel_sd>(model);
+    if (sd == nullptr) throw std::runtime_error("not a small strain model");
+    std::map<std::string, double> c = protocol.settings;
+    if (protocol.kind == "tension") out.ier = run_tension(sd, c, out);
+    else if (protocol.kind == "cyclic") out.ier = run_cyclic(sd, c, out);
+    else if (protocol.kind == "creep") out.ier = run_creep(sd, c, out);
+    else out.ier = run_bree(sd, c, out);
+  }
+  catch (std::exception & e) {
+    out.ier = neml::UNKNOWN_ERROR;
+  }
+  if (out.ier != neml::SUCCESS) out.values.clear();
+  out.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  return out;
+}
+
+std::string format_outcome(size_t task, const Variant & variant,
+                           const Protocol & protocol,
+                           const Outcome & outcome)
+{
+  std::stringstream params;
+  params << std::setprecision(17);
+  for (size_t i=0; i<variant.paths.size(); i++) {
+    params << ((i > 0) ? ";" : "") << variant.paths[i] << "="
+        << variant.values[i];
+  }
+
+  std::stringstream prefix;
+  prefix << std::setprecision(6) << task << "," << variant.label << ",\""
+      << params.str() << "\"," << protocol.label << ",\""
+      << ((outcome.ier == neml::SUCCESS) ? "ok" :
+          neml::string_error(outcome.ier)) << "\"," << outcome.seconds
+      << ",";
+
+  std::stringstream rows;
+  rows << std::setprecision(12);
+  if (outcome.values.empty()) rows << prefix.str() << "," << std::endl;
+  for (auto & v : outcome.values) {
+    rows << prefix.str() << v.first << "," << v.second << std::endl;
+  }
+  return rows.str();
+}
+
+// Each task gives its error code and its rows
+typedef std::function<std::pair<int, std::string>(size_t)> TaskFn;
+
+// Threads take the next task as they finish
+static void run_threads(size_t ntask, int nthreads, const TaskFn & run,
+                        std::vector<int> & iers,
+                        std::vector<std::string> & rows)
+{
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> pool;
+  for (int t=0; t<nthreads; t++) {
+    pool.emplace_back([&]()
+    {
+      for (size_t k=next++; k<ntask; k=next++) {
+        auto res = run(k);
+        iers[k] = res.first;
+        rows[k] = res.second;
+      }
+    });
+  }
+  for (auto & th : pool) th.join();
+}
+
+#ifdef NEML_MPI
+// Hand out tasks to the other ranks as they ask and collect the results
+//  A request carries the last result as "task ier\nrows", or a task of -1
+//  for the first request.
+static void mpi_master(size_t ntask, int nranks, std::vector<int> & iers,
+                       std::vector<std::string> & rows)
+{
+  size_t next = 0;
+  int active = nranks - 1;
+  while (active > 0) {
+    MPI_Status status;
+    MPI_Probe(MPI_ANY_SOURCE, tag_result, MPI_COMM_WORLD, &status);
+    int len;
+    MPI_Get_count(&status, MPI_CHAR, &len);
+    std::vector<char> buf(len);
+    MPI_Recv(buf.data(), len, MPI_CHAR, status.MPI_SOURCE, tag_result,
+             MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+    std::string msg(buf.begin(), buf.end());
+    size_t nl = msg.find('\n');
+    std::stringstream head(msg.substr(0, nl));
+    long k;
+    int ier;
+    head >> k >> ier;
+    if (k >= 0) {
+      iers[k] = ier;
+      rows[k] = msg.substr(nl + 1);
+    }
+
+    long task = (next < ntask) ? (long) next++ : -1;
+    MPI_Send(&task, 1, MPI_LONG, status.MPI_SOURCE, tag_task,
+             MPI_COMM_WORLD);
+    if (task < 0) active--;
+  }
+}
+
+// Ask for tasks until there are none left
+static void mpi_worker(const TaskFn & run)
+{
+  std::string msg = "-1 0\n";
+  while (true) {
+    MPI_Send(const_cast<char*>(msg.data()), (int) msg.size(), MPI_CHAR, 0,
+             tag_result, MPI_COMM_WORLD);
+    long task;
+    MPI_Recv(&task, 1, MPI_LONG, 0, tag_task, MPI_COMM_WORLD,
+             MPI_STATUS_IGNORE);
+    if (task < 0) break;
+    auto res = run(task);
+    msg = std::to_string(task) + " " + std::to_string(res.first) + "\n"
+        + res.second;
+  }
+}
+#endif
+
+int main(int argc, char** argv)
+{
+  int rank = 0;
+  int nranks = 1;
+#ifdef NEML_MPI
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+#endif
+
+  auto finish = [&](int code) -> int
+  {
+#ifdef NEML_MPI
+    MPI_Finalize();
+#endif
+    return code;
+  };
+
+  if ((argc < 2) || (argc % 2 == 1)) {
+    if (rank == 0) {
+      std::cout << "Arguments: task file, and then options:" << std::endl;
+      std::cout << "  --output file        results CSV (ensemble.csv)"
+          << std::endl;
+      std::cout << "  --threads n          threads without MPI (all cores)"
+          << std::endl;
+    }
+    return finish(-1);
+  }
+
+  std::map<std::string, std::string> options;
+  for (int i=2; i<argc; i+=2) {
+    std::string key = argv[i];
+    if ((key != "--output") && (key != "--threads")) {
+      if (rank == 0) std::cout << "Unknown argument " << key << std::endl;
+      return finish(-1);
+    }
+    options[key.substr(2)] = argv[i+1];
+  }
+  std::string output = options.count("output") ? options["output"]
+      : "ensemble.csv";
+  int nthreads = options.count("threads") ? std::stoi(options["threads"])
+      : (int) std::max(1u, std::thread::hardware_concurrency());
+
+  // Every rank reads the tasks, so only task numbers need to be sent
+  std::vector<Variant> variants;
+  std::vector<Protocol> protocols;
+  try {
+    read_tasks(argv[1], variants, protocols);
+  }
+  catch (std::exception & e) {
+    if (rank == 0) std::cout << e.what() << std::endl;
+    return finish(1);
+  }
+  size_t ntask = variants.size() * protocols.size();
+
+  TaskFn run = [&](size_t k) -> std::pair<int, std::string>
+  {
+    const Variant & v = variants[k / protocols.size()];
+    const Protocol & p = protocols[k % protocols.size()];
+    Outcome out = run_task(v, p);
+    return std::make_pair(out.ier, format_outcome(k, v, p, out));
+  };
+
+  std::vector<int> iers(ntask, neml::SUCCESS);
+  std::vector<std::string> rows(ntask);
+  auto start = Clock::now();
+  std::string workers;
+  if (nranks > 1) {
+#ifdef NEML_MPI
+    if (rank == 0) mpi_master(ntask, nranks, iers, rows);
+    else mpi_worker(run);
+#endif
+    workers = std::to_string(nranks - 1) + " worker ranks";
+  }
+  else {
+    run_threads(ntask, nthreads, run, iers, rows);
+    workers = std::to_string(nthreads) + " threads";
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() -
+                                                 start).count();
+
+  if (rank == 0) {
+    std::ofstream out(output);
+    if (!out) {
+      std::cout << "Cannot write " << output << std::endl;
+      return finish(1);
+    }
+    out << "task,model,parameters,protocol,status,seconds,quantity,value"
+        << std::endl;
+    for (auto & r : rows) out << r;
+
+    size_t nfail = std::count_if(iers.begin(), iers.end(),
+                                 [](int ier) {return ier != neml::SUCCESS;});
+    std::cout << ntask << " tasks (" << variants.size() << " models x "
+        << protocols.size() << " protocols) on " << workers << " in "
+        << std::setprecision(4) << seconds << " s, " << nfail
+        << " failed" << std::endl;
+  }
+
+  return finish(0);
+}
@@ -0,0 +1,76 @@
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include "models.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A model from an XML file with some parameters changed
+struct Variant {
+  std::string label;
+  std::string fname;
+  std::string mname;
+  std::vector<std::string> paths;
+  std::vector<double> values;
+};
+
+// A load protocol and its settings
+struct Protocol {
+  std::string label;
+  std::string kind;                        // tension, cyclic, creep, or bree
+  std::map<std::string, double> settings;
+};
+
+// The result of running one protocol on one variant
+struct Outcome {
+  int ier;
+  double seconds;
+  std::vector<std::pair<std::string, double>> values;
+};
+
+// Uniaxial stress driver for a single material point
+//  The lateral stresses are kept at zero and the thermal strain is
+//  subtracted from the axial strain, like the python drivers.
+class Uniaxial {
+ public:
+  Uniaxial(std::shared_ptr<neml::NEMLModel_sd> model, double T);
+
+  // Step to the total axial strain e at time t and temperature T
+  int strain_step(double e, double t, double T);
+  // Step to the axial stress s at time t and temperature T
+  int stress_step(double s, double t, double T);
+
+  // Try the total axial strain e without accepting the step
+  int trial(double e, double t, double T);
+  // Accept the last trial
+  void accept();
+
+  double strain, stress, time, temperature;
+  double strain_trial, stress_trial, tangent_trial;
+
+ private:
+  std::shared_ptr<neml::NEMLModel> model_;
+  std::shared_ptr<neml::NEMLModel_sd> base_;
+  double e_th_, e_th_trial_, t_trial_, T_trial_;
+  double e_n_[6], s_n_[6], e_np1_[6], s_np1_[6], A_np1_[36];
+  std::vector<double> h_n_, h_np1_;
+  double u_n_, p_n_, u_np1_, p_np1_;
+};
+
+// Read the variants and protocols from a task file
+void read_tasks(std::string fname, std::vector<Variant> & variants,
+                std::vector<Protocol> & protocols);
+
+// Run a protocol on a variant
+Outcome run_task(const Variant & variant, const Protocol & protocol);
+
+// CSV rows for a finished task
+std::string format_outcome(size_t task, const Variant & variant,
+                           const Protocol & protocol,
+                           const Outcome & outcome);
+
+#endif
@@ -63,6 +63,33 @@
 
             end subroutine
 
+            subroutine update_sd_scale_nemlmodel(model, e_np1, e_n,
+     &                  Temp_np1, Temp_n, time_np1, time_n, s_np1, s_n,
+     &                  h_np1, h_n,
+     &                  A_np1, u_np1, u_n, p_np1, p_n, dt_scale, ier)
+     &                  bind(C)
+                  use iso_c_binding
+                  implicit none
+                  type(c_ptr), value :: model
+
+                  double precision, intent(in), dimension(6) ::
+     &                  e_np1, e_n, s_n
+                  double precision, intent(out), dimension(6) ::
+     &                  s_np1
+                  double precision, intent(out), dimension(6,6) ::
+     &                  A_np1
+                  double precision, intent(in), dimension(*) ::
+     &                  h_n
+                  double precision, intent(out), dimension(*) ::
+     &                  h_np1
+                  double precision, intent(in), value ::
+     &                  Temp_np1, Temp_n, time_np1, time_n, u_n, p_n
+                  double precision, intent(out) :: u_np1, p_np1
+                  double precision, intent(out) :: dt_scale
+                  integer, intent(out) :: ier
+
+            end subroutine
+
             subroutine elastic_strains_nemlmodel(model, s_np1, Temp_np1,
      &                        h_np1, e_np1, ier) bind(C)
                   use iso_c_binding
@@ -75,4 +102,67 @@
                   integer, intent(out) :: ier
 
             end subroutine
+
+            function failed_nemlmodel(model, h, ier) bind(C)
+                  use iso_c_binding
+                  implicit none
+                  integer :: failed_nemlmodel
+                  type(c_ptr), value :: model
+                  double precision, intent(in), dimension(*) :: h
+                  integer, intent(out) :: ier
+            end function
+
+            function cached_nemlmodel(fname, mname, ier) bind(C)
+                  use iso_c_binding
+                  implicit none
+                  type(c_ptr) :: cached_nemlmodel
+                  character(kind=c_char) :: fname(*)
+                  character(kind=c_char) :: mname(*)
+                  integer :: ier
+            end function
+
+            subroutine vumat_nemlmodel(model, nblock, ndir, nshr,
+     &                  nstatev, stepTime, totalTime, dt, density,
+     &                  strainInc, tempOld, stressOld, stateOld,
+     &                  enerInternOld, enerInelasOld, tempNew,
+     &                  stressNew, stateNew, enerInternNew,
+     &                  enerInelasNew, ier) bind(C)
+                  use iso_c_binding
+                  implicit none
+                  type(c_ptr), value :: model
+                  integer, intent(in), value :: nblock, ndir, nshr,
+     &                  nstatev
+                  double precision, intent(in), value :: stepTime,
+     &                  totalTime, dt
+                  double precision, intent(in), dimension(*) ::
+     &                  density, strainInc, tempOld, stressOld,
+     &                  stateOld, enerInternOld, enerInelasOld,
+     &                  tempNew
+                  double precision, intent(out), dimension(*) ::
+     &                  stressNew, stateNew, enerInternNew,
+     &                  enerInelasNew
+                  integer, intent(out) :: ier
+
+            end subroutine
+
+            subroutine start_capture_nemlmodel(fname, fraction, ier)
+     &                  bind(C)
+                  use iso_c_binding
+                  implicit none
+                  character(kind=c_char) :: fname(*)
+                  double precision, intent(in), value :: fraction
+                  integer, intent(out) :: ier
+            end subroutine
+
+            subroutine stop_capture_nemlmodel(ier) bind(C)
+                  use iso_c_binding
+                  implicit none
+                  integer, intent(out) :: ier
+            end subroutine
+
+            subroutine trace_point_nemlmodel(id) bind(C)
+                  use iso_c_binding
+                  implicit none
+                  integer, intent(in), value :: id
+            end subroutine
       end interface
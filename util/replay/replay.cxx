@@ -0,0 +1,210 @@
+// Run the updates in a capture log again and report the throughput, the
+// Newton iterations, the failures, and how far the stresses moved from the
+// captured run.
+//
+// Usage: replay log [--xml file] [--model name] [--repeat n]
+
+#include "capture.h"
+#include "parse.h"
+#include "solvers.h"
+#include "nemlerror.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace neml;
+
+typedef std::chrono::high_resolution_clock Clock;
+
+// Totals for one model
+struct Report {
+  Report() : nupdate(0), time(0.0), niter(0), max_iter(0), nfail_log(0),
+    nfail(0), nnew(0), nfixed(0), diff(0.0) {}
+
+  size_t nupdate;
+  double time;
+  size_t niter;
+  int max_iter;
+  size_t nfail_log;   // Failed when captured
+  size_t nfail;       // Failed on replay
+  size_t nnew;        // Failed on replay but not when captured
+  size_t nfixed;      // Failed when captured but not on replay
+  double diff;        // Largest relative stress difference
+};
+
+static int run(NEMLModel & model, const CaptureRecord & rec,
+               double * const s_np1, std::vector<double> & h_np1)
+{
+  double A_np1[36], B_np1[18], u_np1, p_np1;
+  h_np1.resize(rec.h_n.size());
+  try {
+    if (rec.kind == CAPTURE_LD) {
+      return model.update_ld_inc(rec.e_np1, rec.e_n, rec.w_np1, rec.w_n,
+                                 rec.T_np1, rec.T_n, rec.t_np1, rec.t_n,
+                                 s_np1, rec.s_n, h_np1.data(), rec.h_n.data(),
+                                 A_np1, B_np1, u_np1, rec.u_n, p_np1,
+                                 rec.p_n);
+    }
+    return model.update_sd(rec.e_np1, rec.e_n, rec.T_np1, rec.T_n,
+                           rec.t_np1, rec.t_n, s_np1, rec.s_n, h_np1.data(),
+                           rec.h_n.data(), A_np1, u_np1, rec.u_n, p_np1,
+                           rec.p_n);
+  }
+  catch (...) {
+    return UNKNOWN_ERROR;
+  }
+}
+
+static void print(const std::string & name, const Report & r)
+{
+  std::cout << std::setw(20) << name
+      << std::setw(10) << r.nupdate
+      << std::setw(14) << std::fixed << std::setprecision(0)
+      << ((r.time > 0.0) ? r.nupdate / r.time : 0.0)
+      << std::setw(10) << std::setprecision(2)
+      << ((r.nupdate > 0) ? (double) r.niter / r.nupdate : 0.0)
+      << std::setw(6) << r.max_iter
+      << std::setw(8) << r.nfail_log
+      << std::setw(8) << r.nfail
+      << std::setw(6) << r.nnew
+      << std::setw(6) << r.nfixed
+      << std::setw(10) << std::scientific << std::setprecision(1) << r.diff
+      << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+  if ((argc < 2) || (argc % 2 != 0)) {
+    std::cout << "Arguments: capture log, and then options:" << std::endl;
+    std::cout << "  --xml file           model file, instead of the ones in "
+        << "the log" << std::endl;
+    std::cout << "  --model name         model name, instead of the ones in "
+        << "the log" << std::endl;
+    std::cout << "  --repeat n           times to run the log for timing (1)"
+        << std::endl;
+    return -1;
+  }
+
+  std::map<std::string, std::string> options;
+  for (int i=2; i<argc; i+=2) {
+    std::string key = argv[i];
+    if (key.substr(0,2) != "--") {
+      std::cout << "Unknown argument " << key << std::endl;
+      return -1;
+    }
+    options[key.substr(2)] = argv[i+1];
+  }
+  int repeat = options.count("repeat") ? std::stoi(options["repeat"]) : 1;
+
+  std::map<int, CaptureModel> names;
+  std::vector<CaptureRecord> records;
+  try {
+    read_capture(argv[1], names, records);
+  }
+  catch (std::exception & e) {
+    std::cout << e.what() << std::endl;
+    return -1;
+  }
+
+  // Load each model
+  std::map<int, std::unique_ptr<NEMLModel>> models;
+  for (auto & it : names) {
+    std::string fname = options.count("xml") ? options["xml"]
+        : it.second.fname;
+    std::string mname = options.count("model") ? options["model"]
+        : it.second.mname;
+    try {
+      models[it.first] = parse_xml_unique(fname, mname);
+    }
+    catch (std::exception & e) {
+      std::cout << "Skipping model " << it.first << ": cannot load "
+          << mname << " from " << fname << std::endl;
+    }
+  }
+
+  std::map<int, Report> reports;
+  double s_np1[6];
+  std::vector<double> h_np1;
+  size_t nskip = 0;
+  for (int r=0; r<repeat; r++) {
+    for (auto & rec : records) {
+      auto it = models.find(rec.id);
+      if (it == models.end()) {
+        if (r == 0) nskip++;
+        continue;
+      }
+      if (rec.h_n.size() != it->second->nstore()) {
+        if (r == 0) nskip++;
+        continue;
+      }
+      Report & rep = reports[rec.id];
+
+      solve_stats().reset();
+      auto t0 = Clock::now();
+      int ier = run(*it->second, rec, s_np1, h_np1);
+      auto t1 = Clock::now();
+      rep.time += std::chrono::duration<double>(t1-t0).count();
+
+      // The rest only depends on the log, so count it once
+      if (r > 0) continue;
+      SolveStats & stats = solve_stats();
+      rep.nupdate++;
+      rep.niter += stats.niter;
+      rep.max_iter = std::max(rep.max_iter, stats.max_iter);
+      if (rec.ier != SUCCESS) rep.nfail_log++;
+      if (ier != SUCCESS) rep.nfail++;
+      if ((ier != SUCCESS) && (rec.ier == SUCCESS)) rep.nnew++;
+      if ((ier == SUCCESS) && (rec.ier != SUCCESS)) rep.nfixed++;
+      if ((ier == SUCCESS) && (rec.ier == SUCCESS)) {
+        double ns = 0.0, ds = 0.0;
+        for (int i=0; i<6; i++) {
+          ns = std::max(ns, fabs(rec.s_np1[i]));
+          ds = std::max(ds, fabs(rec.s_np1[i] - s_np1[i]));
+        }
+        rep.diff = std::max(rep.diff, ds / std::max(ns, 1.0));
+      }
+    }
+  }
+
+  // Throughput is per pass through the log
+  for (auto & it : reports) it.second.time /= repeat;
+
+  std::cout << std::setw(20) << "model" << std::setw(10) << "updates"
+      << std::setw(14) << "updates/s" << std::setw(10) << "iter/upd"
+      << std::setw(6) << "max" << std::setw(8) << "failed" << std::setw(8)
+      << "replay" << std::setw(6) << "new" << std::setw(6) << "fixed"
+      << std::setw(10) << "diff" << std::endl;
+
+  Report total;
+  for (auto & it : reports) {
+    const CaptureModel & cm = names[it.first];
+    std::string name = cm.mname.empty() ? std::to_string(it.first)
+        : cm.mname;
+    print(name, it.second);
+
+    const Report & r = it.second;
+    total.nupdate += r.nupdate;
+    total.time += r.time;
+    total.niter += r.niter;
+    total.max_iter = std::max(total.max_iter, r.max_iter);
+    total.nfail_log += r.nfail_log;
+    total.nfail += r.nfail;
+    total.nnew += r.nnew;
+    total.nfixed += r.nfixed;
+    total.diff = std::max(total.diff, r.diff);
+  }
+  if (reports.size() > 1) print("total", total);
+  if (nskip > 0) {
+    std::cout << nskip << " updates skipped for models that did not load or "
+        << "do not match the log" << std::endl;
+  }
+
+  return (total.nnew > 0) ? 1 : 0;
+}
@@ -0,0 +1,556 @@
+#include "tune.h"
+
+#include "reduced.h"
+#include "interpolate.h"
+#include "nemlerror.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+// The integrator settings we know how to sweep, with default values
+const std::vector<std::pair<std::string, std::string>> knob_defaults = {
+  {"tol", "1.0e-4,1.0e-6,1.0e-8"},
+  {"miter", "10,25,50"},
+  {"max_divide", "2,4,8"},
+  {"kttol", "1.0e-2,1.0e-1"},
+  {"sf", "1.0e4,1.0e6"}};
+
+// Settings that only act when a boolean setting of the same object is on,
+// so they are not swept where it is off
+const std::map<std::string, std::string> knob_switches = {
+  {"kttol", "check_kt"}};
+
+// Settings for the tightly converged reference solution
+//  The solvers test the norm of sf times the residual, so a large sf is
+//  the tighter test, and rtol only ever loosens it.
+const std::map<std::string, std::string> reference_settings = {
+  {"tol", "1.0e-10"},
+  {"rtol", "0.0"},
+  {"miter", "500"},
+  {"max_divide", "12"},
+  {"sf", "1.0e6"}};
+
+static std::vector<std::string> split(std::string s, char delim)
+{
+  std::vector<std::string> res;
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, delim)) {
+    item.erase(std::remove_if(item.begin(), item.end(),
+                              [](char c) {return c == ' ' || c == '"' ||
+                                c == '\r';}), item.end());
+    res.push_back(item);
+  }
+  return res;
+}
+
+// Proportional strain path from zero to emax and back as needed
+static void add_ramp(LoadPath & path, const double * const dir, double e0,
+                     double e1, double dt, int n, double T)
+{
+  double t0 = path.time.empty() ? 0.0 : path.time.back();
+  for (int i=1; i<=n; i++) {
+    double e = e0 + (e1 - e0) * i / n;
+    path.time.push_back(t0 + dt * i / n);
+    path.temperature.push_back(T);
+    for (int j=0; j<6; j++) path.strain.push_back(e * dir[j]);
+  }
+}
+
+std::vector<LoadPath> standard_paths(double T)
+{
+  const double axial[6] = {1.0, -0.5, -0.5, 0.0, 0.0, 0.0};
+  const double shear[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 1.0};
+  const double erate = 1.0e-4;
+
+  std::vector<LoadPath> paths(4);
+
+  paths[0].name = "tension";
+  add_ramp(paths[0], axial, 0.0, 0.02, 0.02 / erate, 50, T);
+
+  paths[1].name = "cyclic";
+  double a = 0.01;
+  for (int i=0; i<3; i++) {
+    add_ramp(paths[1], axial, 0.0, a, a / erate, 20, T);
+    add_ramp(paths[1], axial, a, 0.0, a / erate, 20, T);
+    add_ramp(paths[1], axial, 0.0, -a, a / erate, 20, T);
+    add_ramp(paths[1], axial, -a, 0.0, a / erate, 20, T);
+  }
+
+  paths[2].name = "shear";
+  add_ramp(paths[2], shear, 0.0, 0.02, 0.02 / erate, 50, T);
+
+  paths[3].name = "hold";
+  add_ramp(paths[3], axial, 0.0, 0.01, 10.0, 10, T);
+  add_ramp(paths[3], axial, 0.01, 0.01, 1.0e4, 40, T);
+
+  for (auto & path : paths) path.uniaxial = false;
+
+  return paths;
+}
+
+LoadPath read_reference(std::string fname, double T)
+{
+  std::ifstream file(fname);
+  if (!file.good()) {
+    throw std::runtime_error("Could not open reference file " + fname);
+  }
+
+  // Column names are matched ignoring case and with - the same as _, so
+  // ParaView exports like Strain-xx and Temperature read directly
+  std::string line;
+  std::getline(file, line);
+  auto header = split(line, ',');
+  for (auto & name : header) {
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](char c) {return (c == '-') ? '_' : (char) tolower(c);});
+  }
+
+  // Full strain and stress components, with engineering shear strains
+  // and tensor shear stresses, to Mandel notation
+  const std::vector<std::string> comps = {"xx", "yy", "zz", "yz", "xz", "xy"};
+  const double strain_mult[6] = {1.0, 1.0, 1.0, 1.0/sqrt(2.0), 1.0/sqrt(2.0),
+    1.0/sqrt(2.0)};
+  const double stress_mult[6] = {1.0, 1.0, 1.0, sqrt(2.0), sqrt(2.0),
+    sqrt(2.0)};
+
+  auto column = [&header](std::string name) -> int {
+    auto it = std::find(header.begin(), header.end(), name);
+    return (it == header.end()) ? -1 : (int) (it - header.begin());
+  };
+
+  LoadPath path;
+  path.name = fname;
+  int it = column("time");
+  int iT = column("temperature");
+  if (iT < 0) iT = column("temp");
+  path.uniaxial = column("strain") >= 0;
+
+  std::vector<int> ie, is;
+  if (path.uniaxial) {
+    ie.push_back(column("strain"));
+    is.push_back(column("stress"));
+  }
+  else {
+    for (auto c : comps) {
+      ie.push_back(column("strain_" + c));
+      is.push_back(column("stress_" + c));
+    }
+  }
+  for (size_t i=0; i<ie.size(); i++) {
+    if ((ie[i] < 0) || (is[i] < 0)) {
+      throw std::runtime_error("Reference file " + fname + " needs either "
+                               "strain and stress columns or a full set of "
+                               "strain_ij and stress_ij columns, with ij "
+                               "from xx, yy, zz, yz, xz, and xy");
+    }
+  }
+
+  int row = 0;
+  while (std::getline(file, line)) {
+    if (line.empty()) continue;
+    auto vals = split(line, ',');
+    row++;
+    path.time.push_back((it >= 0) ? std::stod(vals[it]) : (double) row);
+    path.temperature.push_back((iT >= 0) ? std::stod(vals[iT]) : T);
+    if (path.uniaxial) {
+      path.strain.push_back(std::stod(vals[ie[0]]));
+      for (int j=1; j<6; j++) path.strain.push_back(0.0);
+      path.reference.push_back(std::stod(vals[is[0]]));
+    }
+    else {
+      for (int j=0; j<6; j++) {
+        path.strain.push_back(std::stod(vals[ie[j]]) * strain_mult[j]);
+        path.reference.push_back(std::stod(vals[is[j]]) * stress_mult[j]);
+      }
+    }
+  }
+
+  return path;
+}
+
+// Is the switch for a setting on for an object, if it has one?
+static bool switched_on(const rapidxml::xml_node<> * node,
+                        neml::ParameterSet & pset, const std::string & name)
+{
+  auto sw = knob_switches.find(name);
+  if (sw == knob_switches.end()) return true;
+  auto param = node->first_node(sw->second.c_str());
+  if (param != nullptr) return neml::get_bool(param);
+  return pset.get_parameter<bool>(sw->second);
+}
+
+void find_knobs(rapidxml::xml_node<> * node, std::vector<Knob> & knobs)
+{
+  std::string type = neml::get_type_of_node(node);
+  if (type != "none") {
+    neml::ParameterSet pset = neml::Factory::Creator()->provide_parameters(type);
+    for (auto & knob : knobs) {
+      if (pset.is_parameter(knob.name) && switched_on(node, pset, knob.name)) {
+        knob.nodes.push_back(node);
+      }
+    }
+  }
+
+  for (auto child = node->first_node(); child; child = child->next_sibling()) {
+    if (child->type() == rapidxml::node_element) find_knobs(child, knobs);
+  }
+}
+
+void set_parameter(rapidxml::xml_document<> & doc, rapidxml::xml_node<> * node,
+                   std::string name, std::string value)
+{
+  char * v = doc.allocate_string(value.c_str());
+  rapidxml::xml_node<> * param = node->first_node(name.c_str());
+  if (param == nullptr) {
+    param = doc.allocate_node(rapidxml::node_element,
+                              doc.allocate_string(name.c_str()));
+    node->append_node(param);
+  }
+  rapidxml::xml_node<> * data = param->first_node();
+  if (data == nullptr) {
+    param->append_node(doc.allocate_node(rapidxml::node_data, nullptr, v));
+  }
+  else {
+    data->value(v);
+  }
+}
+
+bool run_path(std::shared_ptr<neml::NEMLModel> model, const LoadPath & path,
+              std::vector<double> & stress)
+{
+  // Uniaxial cases solve for the stress free lateral strains
+  if (path.uniaxial) {
+    auto sd = std::dynamic_pointer_cast<neml::NEMLModel_sd>(model);
+    if (sd == nullptr) return false;
+    model = std::make_shared<neml::UniaxialStressModel>(
+        std::const_pointer_cast<neml::LinearElasticModel>(sd->elastic()), sd,
+        std::make_shared<neml::ConstantInterpolate>(0.0), 1.0e-8, 50, false,
+        true);
+  }
+
+  size_t n = path.time.size();
+  size_t nstore = model->nstore();
+  stress.resize(6*n);
+
+  std::vector<double> h_n(nstore), h_np1(nstore);
+  model->init_store(h_n.empty() ? nullptr : &h_n[0]);
+  double e_n[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  double s_n[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  double A_np1[36];
+  double t_n = 0.0;
+  double T_n = path.temperature[0];
+  double u_n = 0.0, p_n = 0.0;
+  double u_np1, p_np1;
+
+  for (size_t i=0; i<n; i++) {
+    int ier = model->update_sd(&path.strain[6*i], e_n, path.temperature[i],
+                               T_n, path.time[i], t_n, &stress[6*i], s_n,
+                               h_np1.empty() ? nullptr : &h_np1[0],
+                               h_n.empty() ? nullptr : &h_n[0],
+                               A_np1, u_np1, u_n, p_np1, p_n);
+    if (ier != neml::SUCCESS) return false;
+
+    std::copy(&path.strain[6*i], &path.strain[6*i]+6, e_n);
+    std::copy(&stress[6*i], &stress[6*i]+6, s_n);
+    std::swap(h_n, h_np1);
+    t_n = path.time[i];
+    T_n = path.temperature[i];
+    u_n = u_np1;
+    p_n = p_np1;
+  }
+
+  return true;
+}
+
+// Maximum stress difference over the path, relative to the largest stress
+static double path_error(const LoadPath & path,
+                         const std::vector<double> & stress,
+                         const std::vector<double> & reference)
+{
+  int nc = path.uniaxial ? 1 : 6;
+  double diff = 0.0;
+  double mag = 0.0;
+  for (size_t i=0; i<path.time.size(); i++) {
+    double d = 0.0;
+    double m = 0.0;
+    for (int j=0; j<nc; j++) {
+      d += pow(stress[6*i+j] - reference[nc*i+j], 2.0);
+      m += pow(reference[nc*i+j], 2.0);
+    }
+    diff = std::max(diff, sqrt(d));
+    mag = std::max(mag, sqrt(m));
+  }
+  return diff / std::max(mag, 1.0);
+}
+
+void print_node(std::ostream & os, const rapidxml::xml_node<> * node,
+                int indent)
+{
+  std::string pad(indent, ' ');
+  os << pad << "<" << node->name();
+  for (auto a = node->first_attribute(); a; a = a->next_attribute()) {
+    os << " " << a->name() << "=\"" << a->value() << "\"";
+  }
+
+  bool has_elements = false;
+  const rapidxml::xml_node<> * data = nullptr;
+  for (auto child = node->first_node(); child; child = child->next_sibling()) {
+    if (child->type() == rapidxml::node_element) has_elements = true;
+    if (child->type() == rapidxml::node_data) data = child;
+  }
+
+  if (has_elements) {
+    os << ">" << std::endl;
+    for (auto child = node->first_node(); child;
+         child = child->next_sibling()) {
+      if (child->type() == rapidxml::node_element) {
+        print_node(os, child, indent + 2);
+      }
+    }
+    os << pad << "</" << node->name() << ">" << std::endl;
+  }
+  else if (data != nullptr) {
+    os << ">" << data->value() << "</" << node->name() << ">" << std::endl;
+  }
+  else {
+    os << "/>" << std::endl;
+  }
+}
+
+// Sweep the integrator settings for a model over a set of load paths and
+// report the tradeoff between accuracy and throughput
+int main(int argc, char ** argv) {
+
+  if ((argc < 3) || (argc % 2 == 0)) {
+    std::cout << "Arguments: file, model name, and then options:" << std::endl;
+    std::cout << "  --T value            temperature (300)" << std::endl;
+    std::cout << "  --paths a,b          standard paths: tension, cyclic, "
+        << "shear, hold, or none (all)" << std::endl;
+    std::cout << "  --reference file     reference CSV, can be repeated"
+        << std::endl;
+    std::cout << "  --target value       error target for tuning (1.0e-4)"
+        << std::endl;
+    std::cout << "  --time value         minimum timing run in seconds (0.05)"
+        << std::endl;
+    std::cout << "  --xml file           write the tuned model to a file"
+        << std::endl;
+    for (auto & kd : knob_defaults) {
+      std::cout << "  --" << kd.first << " a,b          values to sweep ("
+          << kd.second << ")" << std::endl;
+    }
+    return -1;
+  }
+
+  std::map<std::string, std::string> options;
+  std::vector<std::string> references;
+  for (int i=3; i<argc; i+=2) {
+    std::string key = argv[i];
+    if (key.substr(0,2) != "--") {
+      std::cout << "Unknown argument " << key << std::endl;
+      return -1;
+    }
+    if (key == "--reference") references.push_back(argv[i+1]);
+    else options[key.substr(2)] = argv[i+1];
+  }
+
+  double T = options.count("T") ? std::stod(options["T"]) : 300.0;
+  double target = options.count("target") ? std::stod(options["target"])
+      : 1.0e-4;
+  double min_time = options.count("time") ? std::stod(options["time"]) : 0.05;
+
+  // Setup the load paths
+  std::vector<LoadPath> paths;
+  std::string pnames = options.count("paths") ? options["paths"]
+      : "tension,cyclic,shear,hold";
+  auto wanted = split(pnames, ',');
+  for (auto & path : standard_paths(T)) {
+    if (std::find(wanted.begin(), wanted.end(), path.name) != wanted.end()) {
+      paths.push_back(path);
+    }
+  }
+  for (auto & fname : references) paths.push_back(read_reference(fname, T));
+  if (paths.empty()) {
+    std::cout << "No load paths selected." << std::endl;
+    return -1;
+  }
+
+  // Read the model definition
+  rapidxml::file<> xml_file(argv[1]);
+  rapidxml::xml_document<> doc;
+  doc.parse<0>(xml_file.data());
+  rapidxml::xml_node<> * root = doc.first_node()->first_node(argv[2]);
+  if (root == nullptr) {
+    std::cout << "Model " << argv[2] << " not found." << std::endl;
+    return -1;
+  }
+
+  // Find out which settings this model has
+  std::vector<Knob> all_knobs;
+  for (auto & kd : knob_defaults) {
+    Knob knob;
+    knob.name = kd.first;
+    knob.values = split(options.count(kd.first) ? options[kd.first]
+                        : kd.second, ',');
+    all_knobs.push_back(knob);
+  }
+  find_knobs(root, all_knobs);
+  std::vector<Knob> knobs;
+  for (auto & knob : all_knobs) {
+    if (!knob.nodes.empty()) knobs.push_back(knob);
+  }
+
+  auto build = [&](const std::vector<Knob> & which,
+                   const std::map<std::string, std::string> & values)
+      -> std::shared_ptr<neml::NEMLModel> {
+    for (auto & knob : which) {
+      auto v = values.find(knob.name);
+      if (v == values.end()) continue;
+      for (auto node : knob.nodes) {
+        set_parameter(doc, node, knob.name, v->second);
+      }
+    }
+    return std::dynamic_pointer_cast<neml::NEMLModel>(neml::get_object(root));
+  };
+
+  // Converged reference for the paths without data
+  //  This also tightens settings that are not swept, like rtol, and then
+  //  puts the document back for the sweep.
+  std::vector<Knob> ref_knobs;
+  for (auto & rs : reference_settings) {
+    Knob knob;
+    knob.name = rs.first;
+    ref_knobs.push_back(knob);
+  }
+  find_knobs(root, ref_knobs);
+  std::vector<std::pair<rapidxml::xml_node<> *, rapidxml::xml_node<> *>>
+      saved;
+  for (auto & knob : ref_knobs) {
+    for (auto node : knob.nodes) {
+      auto param = node->first_node(knob.name.c_str());
+      saved.push_back({node, param ? doc.clone_node(param) : nullptr});
+    }
+  }
+  auto model = build(ref_knobs, reference_settings);
+  size_t k = 0;
+  for (auto & knob : ref_knobs) {
+    for (auto node : knob.nodes) {
+      auto param = node->first_node(knob.name.c_str());
+      if (saved[k].second) node->insert_node(param, saved[k].second);
+      node->remove_node(param);
+      k++;
+    }
+  }
+  for (auto & path : paths) {
+    if (!path.reference.empty()) continue;
+    if (!run_path(model, path, path.reference)) {
+      std::cout << "Reference solution failed on path " << path.name
+          << std::endl;
+      return 1;
+    }
+  }
+
+  // Sweep every combination
+  size_t ntotal = 1;
+  for (auto & knob : knobs) ntotal *= knob.values.size();
+  size_t nupdates = 0;
+  for (auto & path : paths) nupdates += path.time.size();
+
+  std::vector<Result> results;
+  for (size_t c=0; c<ntotal; c++) {
+    Result res;
+    size_t rem = c;
+    for (auto & knob : knobs) {
+      res.values[knob.name] = knob.values[rem % knob.values.size()];
+      rem /= knob.values.size();
+    }
+    model = build(knobs, res.values);
+
+    res.failed = false;
+    res.error = 0.0;
+    std::vector<double> stress;
+    for (auto & path : paths) {
+      if (!run_path(model, path, stress)) {
+        res.failed = true;
+        break;
+      }
+      res.error = std::max(res.error, path_error(path, stress,
+                                                 path.reference));
+    }
+    if (res.failed) {
+      res.error = std::numeric_limits<double>::infinity();
+      res.rate = 0.0;
+      results.push_back(res);
+      continue;
+    }
+
+    int nrep = 0;
+    double elapsed = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    while ((elapsed < min_time) || (nrep == 0)) {
+      for (auto & path : paths) run_path(model, path, stress);
+      nrep++;
+      elapsed = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - start).count();
+    }
+    res.rate = nupdates * nrep / elapsed;
+    results.push_back(res);
+  }
+
+  // Pareto front: no other setting is both faster and more accurate
+  std::sort(results.begin(), results.end(),
+            [](const Result & a, const Result & b) {return a.rate > b.rate;});
+  std::vector<Result> front;
+  int nfailed = 0;
+  for (auto & res : results) {
+    if (res.failed) {
+      nfailed++;
+      continue;
+    }
+    if (front.empty() || (res.error < front.back().error)) {
+      front.push_back(res);
+    }
+  }
+
+  std::cout << "Settings tried:\t\t" << results.size() << std::endl;
+  std::cout << "Settings that failed:\t" << nfailed << std::endl;
+  std::cout << "Updates per trial:\t" << nupdates << std::endl;
+  std::cout << std::endl << "Pareto front:" << std::endl;
+  for (auto & knob : knobs) std::cout << knob.name << "\t";
+  std::cout << "error\t\tupdates/s" << std::endl;
+  for (auto & res : front) {
+    for (auto & knob : knobs) std::cout << res.values[knob.name] << "\t";
+    std::cout << std::scientific << res.error << "\t" << res.rate
+        << std::defaultfloat << std::endl;
+  }
+
+  // Fastest setting meeting the target
+  auto best = std::find_if(front.begin(), front.end(),
+                           [target](const Result & r)
+                           {return r.error <= target;});
+  if (best == front.end()) {
+    std::cout << std::endl << "No setting meets the error target " << target
+        << std::endl;
+    return 1;
+  }
+
+  build(knobs, best->values);
+  std::cout << std::endl << "Tuned model (error <= " << target << "):"
+      << std::endl;
+  print_node(std::cout, root, 0);
+
+  if (options.count("xml")) {
+    std::ofstream out(options["xml"]);
+    out << "<materials>" << std::endl;
+    print_node(out, root, 2);
+    out << "</materials>" << std::endl;
+  }
+
+  return 0;
+}
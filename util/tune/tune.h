@@ -0,0 +1,59 @@
+#ifndef TUNE_H
+#define TUNE_H
+
+#include "parse.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// A strain controlled load path, in Mandel notation
+struct LoadPath {
+  std::string name;
+  std::vector<double> time;
+  std::vector<double> temperature;
+  std::vector<double> strain;      // 6 per step
+  bool uniaxial;                   // Drive only the 11 component, stress free
+  std::vector<double> reference;   // Reference stress, 6 per step (or 1 if
+                                   // uniaxial), empty if computed
+};
+
+// One point in the sweep
+struct Result {
+  std::map<std::string, std::string> values;
+  double error;
+  double rate;
+  bool failed;
+};
+
+// An integrator setting that appears somewhere in the model definition
+struct Knob {
+  std::string name;
+  std::vector<std::string> values;
+  std::vector<rapidxml::xml_node<> *> nodes;  // Objects taking the setting
+};
+
+// The standard load paths
+std::vector<LoadPath> standard_paths(double T);
+
+// Read a reference case from a CSV file with a header
+LoadPath read_reference(std::string fname, double T);
+
+// Find the settings in the model tree, skipping objects where a setting
+// is switched off
+void find_knobs(rapidxml::xml_node<> * node, std::vector<Knob> & knobs);
+
+// Set a parameter on an object node, adding it if needed
+void set_parameter(rapidxml::xml_document<> & doc, rapidxml::xml_node<> * node,
+                   std::string name, std::string value);
+
+// Run a load path, returning false if any update failed
+bool run_path(std::shared_ptr<neml::NEMLModel> model, const LoadPath & path,
+              std::vector<double> & stress);
+
+// Print an object node as XML
+void print_node(std::ostream & os, const rapidxml::xml_node<> * node,
+                int indent);
+
+#endif